@@ -176,6 +176,8 @@ extern "C" {
 #error "BW_DRAM_DST_BASE+BW_DRAM_BYTES exceeds DRAM region"
 #endif
 
+// Raw SRAM bases, not hal_region.h: like the DRAM windows above, the copy loops own the whole
+// region they measure, so nothing else may be placed there (REGION_*_DATA or region_alloc()).
 #ifndef BW_SCRATCHPAD_BASE
 #define BW_SCRATCHPAD_BASE       0x08000000UL
 #endif
@@ -30,6 +30,11 @@
 #define BENCH_ENABLE_VEC 1
 #endif
 
+// vecnn on pre-panelized weights (vecnn_pack_weights_int8), next to VEC
+#ifndef BENCH_ENABLE_VEC_PACKED
+#define BENCH_ENABLE_VEC_PACKED 1
+#endif
+
 #ifndef BENCH_HAS_VECNN
 #define BENCH_HAS_VECNN 0
 #endif
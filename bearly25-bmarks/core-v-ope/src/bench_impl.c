@@ -25,6 +25,13 @@ void int8_qgemm(
     int8_t* C, size_t c_row_stride,
     size_t c_col_stride,
     requantization_params_t requant_params);
+
+void int8_qgemm_packed(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu);
 #endif
 
 typedef struct {
@@ -73,6 +80,11 @@ typedef struct {
   int8_t *vec_C;
   int8_t *vec_C_ref;
   float *vec_scale;
+#if BENCH_ENABLE_VEC_PACKED
+  void *vec_panels_buf;                // Backing store for vec_panels
+  vecnn_packed_weights_int8_t vec_panels;
+  uint64_t vec_pack_cycles;
+#endif
 #endif
 } bench_case_ctx_t;
 
@@ -136,6 +148,9 @@ static void bench_case_ctx_destroy(bench_case_ctx_t *ctx) {
   if (ctx->vec_C) free(ctx->vec_C);
   if (ctx->vec_C_ref) free(ctx->vec_C_ref);
   if (ctx->vec_scale) free(ctx->vec_scale);
+#if BENCH_ENABLE_VEC_PACKED
+  if (ctx->vec_panels_buf) free(ctx->vec_panels_buf);
+#endif
 #endif
   memset(ctx, 0, sizeof(*ctx));
 }
@@ -186,6 +201,22 @@ static int bench_case_ctx_init(bench_case_ctx_t *ctx, const OuterSizeCase *cs) {
   for (int j = 0; j < ctx->N; ++j) {
     ctx->vec_scale[j] = 1.0f;
   }
+
+#if BENCH_ENABLE_VEC_PACKED
+  // Panelize B once (zero bias, same scales); this is load-time work
+  ctx->vec_panels_buf = malloc(vecnn_packed_weights_int8_size((size_t)ctx->K, (size_t)ctx->N));
+  if (!ctx->vec_panels_buf) {
+    printf("ERROR: vec panel allocation failed\n");
+    bench_case_ctx_destroy(ctx);
+    return -1;
+  }
+  uint64_t p0 = rdcycle64();
+  vecnn_pack_weights_int8(&ctx->vec_panels, ctx->vec_panels_buf,
+                          (size_t)ctx->K, (size_t)ctx->N,
+                          ctx->vec_B, (size_t)ctx->N,
+                          NULL, ctx->vec_scale);
+  ctx->vec_pack_cycles = rdcycle64() - p0;
+#endif
 #endif
 
   ctx->C_ref = (int32_t *)malloc((size_t)ctx->M * (size_t)ctx->N * sizeof(int32_t));
@@ -254,6 +285,16 @@ static void run_vec_once(bench_case_ctx_t *ctx, requantization_params_t rqp) {
              (size_t)1,
              rqp);
 }
+
+#if BENCH_ENABLE_VEC_PACKED
+static void run_vec_packed_once(bench_case_ctx_t *ctx) {
+  int8_qgemm_packed((size_t)ctx->M,
+                    ctx->vec_A, (size_t)ctx->K,
+                    &ctx->vec_panels,
+                    ctx->vec_C, (size_t)ctx->N,
+                    0, 0);
+}
+#endif
 #endif
 
 // Run scalar reference GEMM and return cycles
@@ -457,6 +498,51 @@ void bench_run_case(const OuterSizeCase *cs) {
       printf("  VEC: skipped due to correctness failure\n");
     }
   }
+
+#if BENCH_ENABLE_VEC_PACKED
+  if (ctx.vec_panels_buf && ctx.vec_C && ctx.vec_C_ref) {
+    bool packed_can_run = true;
+#if BENCH_VERIFY
+    printf("  VEC_PACKED correctness...");
+    bench_fill_int8_zero(ctx.vec_C, ctx.M, ctx.N, ctx.N);
+    run_vec_packed_once(&ctx);
+    int packed_errs = bench_compare_i8(ctx.vec_C, ctx.N,
+                                       ctx.vec_C_ref, ctx.N,
+                                       ctx.M, ctx.N, 1);
+    if (packed_errs != 0) {
+      printf("FAIL\n  Correctness run FAILED; skipping VEC_PACKED runs.\n");
+      packed_can_run = false;
+    } else {
+      printf("PASS\n");
+    }
+#endif
+
+    if (packed_can_run) {
+      bench_stats_t packed_stats;
+      bench_stats_init(&packed_stats);
+      for (int r = 0; r < BENCH_RUNS; ++r) {
+        bench_fill_int8_zero(ctx.vec_C, ctx.M, ctx.N, ctx.N);
+        uint64_t t0 = rdcycle64();
+        run_vec_packed_once(&ctx);
+        uint64_t t1 = rdcycle64();
+        bench_stats_update(&packed_stats, t1 - t0);
+      }
+
+      if (packed_stats.runs > 0) {
+        uint64_t avg_packed = packed_stats.sum / (uint64_t)packed_stats.runs;
+        printf("  VEC_PACKED: runs=%d, best_total=%llu, avg_total=%llu, pack=%llu\n",
+               packed_stats.runs,
+               (unsigned long long)packed_stats.best,
+               (unsigned long long)avg_packed,
+               (unsigned long long)ctx.vec_pack_cycles);
+      } else {
+        printf("  VEC_PACKED: no valid runs\n");
+      }
+    } else {
+      printf("  VEC_PACKED: skipped due to correctness failure\n");
+    }
+  }
+#endif
 #else
   printf("  VEC: skipped (vecnn not built)\n");
 #endif
@@ -6,6 +6,10 @@
  *   memory@8010000   -> Core 0 TCM   8 KB  (2 banks)
  *   memory@8012000   -> Core 1 TCM   8 KB  (2 banks)
  *   memory@80000000  -> DRAM
+ *
+ * Raw addresses rather than hal_region.h on purpose: the chases walk each SRAM from its first byte
+ * to its last, so this benchmark owns the whole region and places nothing there through the linker
+ * (REGION_*_DATA) or region_alloc(). Keep it that way, or the chase overwrites that data.
 */
 
 #ifndef MEMLAT_ADDRS_H
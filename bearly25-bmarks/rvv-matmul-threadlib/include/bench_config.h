@@ -89,6 +89,24 @@
 #define RVV_BENCH_MC_ROWS_HART1 29u
 #endif
 
+// Hart-scaling sweep: run the i8->i32 GEMM with M split evenly across each
+// hart count in RVV_BENCH_SCALING_HARTS. Counts above N_HARTS (thread-lib's
+// HTHREAD_N_HARTS from chip_config.h, override with -DHTHREAD_N_HARTS=<n>) are
+// reported as disabled.
+#ifndef RVV_BENCH_ENABLE_HART_SCALING
+#define RVV_BENCH_ENABLE_HART_SCALING 1
+#endif
+
+#ifndef RVV_BENCH_SCALING_HARTS
+#define RVV_BENCH_SCALING_HARTS 1u, 2u, 4u
+#endif
+
+// The sweep also runs the GEMM through hthread_parallel_for on all N_HARTS,
+// in row bands of this many rows, and reports its speedup over 1 hart.
+#ifndef RVV_BENCH_PFOR_ROW_GRAIN
+#define RVV_BENCH_PFOR_ROW_GRAIN 7u
+#endif
+
 // Number of harts participating in post-GEMM synchronization.
 // With multicore enabled, hart 1 is in WFI (hthread __main) and does
 // not participate in the barrier loop, so set to 1 to avoid deadlock.
@@ -336,6 +336,66 @@ static void run_i32_once_mc(const rvv_case_ctx_t *ctx, bool packed) {
   hthread_join(1);
   asm volatile("fence rw, rw" ::: "memory");
 }
+
+#if RVV_BENCH_ENABLE_HART_SCALING
+static const uint32_t k_scaling_harts[] = {
+  RVV_BENCH_SCALING_HARTS
+};
+
+/* Same i8->i32 GEMM as run_i32_once(), rows split evenly over `harts`. */
+static void run_i32_once_scaled(const rvv_case_ctx_t *ctx, uint32_t harts) {
+  mc_i8_worker_arg_t args[N_HARTS];
+
+  const size_t base = ctx->M / harts;
+  const size_t rem = ctx->M % harts;
+  size_t row = 0;
+
+  for (uint32_t h = 0; h < harts; ++h) {
+    const size_t rows = base + ((h < rem) ? 1u : 0u);
+
+    args[h].M = rows;
+    args[h].N = ctx->N;
+    args[h].K = ctx->K;
+    args[h].A = ctx->A_i8 + row * ctx->K;
+    args[h].a_row_stride = ctx->K;
+    args[h].B = ctx->B_i8;
+    args[h].C = ctx->C_i32 + row * ctx->N;
+    args[h].c_row_stride = ctx->N;
+    args[h].c_col_stride = 1;
+    args[h].packed = false;
+    args[h].widen_i16 = false;
+    row += rows;
+  }
+
+  asm volatile("fence rw, rw" ::: "memory");
+  for (uint32_t h = 1; h < harts; ++h) {
+    hthread_issue(h, mc_i8_worker, &args[h]);
+  }
+  mc_i8_worker(&args[0]);
+  for (uint32_t h = 1; h < harts; ++h) {
+    hthread_join(h);
+  }
+  asm volatile("fence rw, rw" ::: "memory");
+}
+
+/* hthread_parallel_for body: rows [begin, end) of the i8->i32 GEMM. */
+static void pfor_i32_rows(size_t begin, size_t end, void *arg) {
+  const rvv_case_ctx_t *ctx = (const rvv_case_ctx_t *)arg;
+
+  int8_gemm(end - begin, ctx->N, ctx->K,
+            ctx->A_i8 + begin * ctx->K, ctx->K,
+            ctx->B_i8,
+            ctx->C_i32 + begin * ctx->N, ctx->N, 1);
+}
+
+/* Same GEMM through hthread_parallel_for over all harts; `harts` is unused. */
+static void run_i32_once_pfor(const rvv_case_ctx_t *ctx, uint32_t harts) {
+  (void)harts;
+  asm volatile("fence rw, rw" ::: "memory");
+  hthread_parallel_for(0, ctx->M, RVV_BENCH_PFOR_ROW_GRAIN, pfor_i32_rows, (void *)ctx);
+  asm volatile("fence rw, rw" ::: "memory");
+}
+#endif /* RVV_BENCH_ENABLE_HART_SCALING */
 #endif /* RVV_BENCH_ENABLE_MULTICORE */
 
 static void print_stats_line(const char *tag,
@@ -547,6 +607,86 @@ static void bench_run_i32_impl_mc(const rvv_case_ctx_t *ctx, const char *tag, bo
 }
 #endif /* RVV_BENCH_ENABLE_MULTICORE */
 
+#if RVV_BENCH_ENABLE_MULTICORE && RVV_BENCH_ENABLE_HART_SCALING
+typedef void (*i32_scaled_runner_t)(const rvv_case_ctx_t *ctx, uint32_t harts);
+
+/* Cold/hot sweep of one scaled i8->i32 variant; returns the best HOT cycles. */
+static uint64_t bench_run_i32_scaled(const rvv_case_ctx_t *ctx, const char *tag,
+                                     i32_scaled_runner_t run, uint32_t harts) {
+  bench_stats_t cold;
+  bench_stats_t hot;
+  bench_stats_init(&cold);
+  bench_stats_init(&hot);
+  memset(ctx->C_i32, 0, ctx->c_elems * sizeof(int32_t));
+
+  for (int r = 0; r < RVV_BENCH_RUNS_COLD; ++r) {
+    bench_cache_flush();
+
+    uint64_t t0 = rdcycle64();
+    run(ctx, harts);
+    uint64_t t1 = rdcycle64();
+    rvv_post_gemm_barrier();
+    bench_stats_update(&cold, t1 - t0);
+  }
+
+  bench_cache_flush();
+  run(ctx, harts);  // warm-up run
+  rvv_post_gemm_barrier();
+
+  for (int r = 0; r < RVV_BENCH_RUNS_HOT; ++r) {
+    uint64_t t0 = rdcycle64();
+    run(ctx, harts);
+    uint64_t t1 = rdcycle64();
+    rvv_post_gemm_barrier();
+    bench_stats_update(&hot, t1 - t0);
+  }
+
+  print_stats_line(tag, &cold, &hot);
+  return hot.best;
+}
+
+static void print_speedup_line(const char *tag, uint64_t base_best, uint64_t best) {
+  if (base_best == 0u || best == 0u || !rvv_bench_is_print_hart()) {
+    return;
+  }
+  // Fixed-point x100 to keep soft-float printf out of the timing build.
+  const uint64_t speedup_x100 = (base_best * 100u) / best;
+  printf("  %-20s HOT speedup vs 1 hart = %llu.%02llux\n",
+         tag,
+         (unsigned long long)(speedup_x100 / 100u),
+         (unsigned long long)(speedup_x100 % 100u));
+}
+
+static void bench_run_i32_hart_scaling(const rvv_case_ctx_t *ctx) {
+  const size_t num_counts = sizeof(k_scaling_harts) / sizeof(k_scaling_harts[0]);
+  uint64_t base_best = 0;
+  char tag[24];
+
+  for (size_t i = 0; i < num_counts; ++i) {
+    const uint32_t harts = k_scaling_harts[i];
+    snprintf(tag, sizeof(tag), "i8_i32_x%uh", (unsigned)harts);
+
+    if (harts == 0u || harts > N_HARTS) {
+      print_disabled_line(tag, "exceeds N_HARTS");
+      continue;
+    }
+
+    const uint64_t best = bench_run_i32_scaled(ctx, tag, run_i32_once_scaled, harts);
+    if (harts == 1u) {
+      base_best = best;
+    } else {
+      print_speedup_line(tag, base_best, best);
+    }
+  }
+
+  // Work-stealing split (hthread_parallel_for over row bands) on all harts,
+  // against the same single-hart baseline as the static splits above.
+  snprintf(tag, sizeof(tag), "i8_i32_pfor_x%uh", (unsigned)N_HARTS);
+  print_speedup_line(tag, base_best,
+                     bench_run_i32_scaled(ctx, tag, run_i32_once_pfor, N_HARTS));
+}
+#endif
+
 void bench_run_case(const RvvMatmulCase *cs) {
   if (rvv_bench_is_print_hart()) {
     printf("\n=== Case: %s (M=%llu N=%llu K=%llu) ===\n",
@@ -654,5 +794,9 @@ void bench_run_case(const RvvMatmulCase *cs) {
   }
 #endif
 
+#if RVV_BENCH_ENABLE_MULTICORE && RVV_BENCH_ENABLE_HART_SCALING && RVV_BENCH_ENABLE_I8_I32
+  bench_run_i32_hart_scaling(&ctx);
+#endif
+
   rvv_case_ctx_destroy(&ctx);
 }
@@ -16,9 +16,12 @@ static void mc_nop_worker(void *arg) {
 static void init_multicore_runtime(void) {
   hthread_init();
 
-  /* Warm-up: wake hart1 once so it is in the scheduler loop before kernels. */
-  hthread_issue(1, mc_nop_worker, NULL);
-  hthread_join(1);
+  /* Warm-up: wake every secondary hart once so it is in the scheduler loop
+   * before kernels (the hart-scaling sweep uses all N_HARTS). */
+  for (uint32_t h = 1; h < N_HARTS; ++h) {
+    hthread_issue(h, mc_nop_worker, NULL);
+    hthread_join(h);
+  }
 }
 #endif
 
@@ -39,6 +42,9 @@ static void run_suite_for_frequency(uint64_t frequency_hz) {
 
     printf("\n--- SQUARE CASES ---\n");
   }
+#if RVV_BENCH_ENABLE_MULTICORE && HTHREAD_TRACE
+  hthread_trace_reset();
+#endif
   for (int i = 0; i < RVV_BENCH_NUM_SQUARE_CASES; ++i) {
     bench_run_case(&RVV_BENCH_SQUARE_CASES[i]);
   }
@@ -54,6 +60,10 @@ static void run_suite_for_frequency(uint64_t frequency_hz) {
     printf("\n=== RVV MATMUL BENCHMARKS DONE @ %llu Hz ===\n",
            (unsigned long long)frequency_hz);
   }
+#if RVV_BENCH_ENABLE_MULTICORE && HTHREAD_TRACE
+  /* Binary scheduler trace; decode with scripts/trace/hthread_trace_to_chrome.py */
+  hthread_trace_dump(frequency_hz);
+#endif
 }
 
 void app_init(void) {
@@ -0,0 +1,41 @@
+/*
+ * bench_config.h - Configuration for the vec-nn softmax benchmarks.
+*/
+
+#ifndef SOFTMAX_BMARK_BENCH_CONFIG_H
+#define SOFTMAX_BMARK_BENCH_CONFIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef SOFTMAX_BENCH_TARGET_FREQUENCY_HZ
+#define SOFTMAX_BENCH_TARGET_FREQUENCY_HZ 50000000ULL
+#endif
+
+// How many repetitions per row length
+#ifndef SOFTMAX_BENCH_RUNS
+#define SOFTMAX_BENCH_RUNS 8
+#endif
+
+// Largest row: the 1000-class ImageNet classifier (cls_1000); attention rows go up to 512
+#ifndef SOFTMAX_BENCH_MAX_SIZE
+#define SOFTMAX_BENCH_MAX_SIZE 1000
+#endif
+
+// Quantization of the int8 path: logits in ~[-8, 8), probabilities in [0, 1)
+#ifndef SOFTMAX_BENCH_INPUT_SCALE
+#define SOFTMAX_BENCH_INPUT_SCALE 0.0625f
+#endif
+
+typedef struct {
+  const char *name;
+  size_t size;
+} SoftmaxSizeCase;
+
+static inline uint64_t rdcycle64(void) {
+  uint64_t x;
+  asm volatile("rdcycle %0" : "=r"(x));
+  return x;
+}
+
+#endif // SOFTMAX_BMARK_BENCH_CONFIG_H
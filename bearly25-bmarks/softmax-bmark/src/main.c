@@ -0,0 +1,154 @@
+/*
+ * main.c - vec-nn softmax benchmarks over BorAI attention rows and classifier heads.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "bench_config.h"
+#include "chip_config.h"
+#include "layers.h"
+#include "simple_setup.h"
+
+uint64_t target_frequency = SOFTMAX_BENCH_TARGET_FREQUENCY_HZ;
+
+static const SoftmaxSizeCase SOFTMAX_CASES[] = {
+  {"attn_16", 16},
+  {"attn_64", 64},
+  {"attn_128", 128},
+  {"attn_256", 256},
+  {"attn_512", 512},
+  {"cls_10", 10},
+  {"cls_12", 12},
+  {"cls_1000", 1000},
+};
+
+#define SOFTMAX_NUM_CASES (int)(sizeof(SOFTMAX_CASES) / sizeof(SOFTMAX_CASES[0]))
+
+static float input_f32[SOFTMAX_BENCH_MAX_SIZE];
+static float output_f32[SOFTMAX_BENCH_MAX_SIZE];
+static float ref_f32[SOFTMAX_BENCH_MAX_SIZE];
+static int8_t input_i8[SOFTMAX_BENCH_MAX_SIZE];
+static int8_t output_i8[SOFTMAX_BENCH_MAX_SIZE];
+static softmax_int8_lut_t lut;
+
+typedef struct {
+  uint64_t sum;
+  uint64_t best;
+} bench_stats_t;
+
+static void softmax_ref(const float *x, float *y, size_t size) {
+  float max_val = x[0];
+  for (size_t i = 1; i < size; i++) {
+    if (x[i] > max_val) max_val = x[i];
+  }
+  float sum = 0.0f;
+  for (size_t i = 0; i < size; i++) {
+    y[i] = expf(x[i] - max_val);
+    sum += y[i];
+  }
+  for (size_t i = 0; i < size; i++) {
+    y[i] /= sum;
+  }
+}
+
+static void fill_inputs(size_t size) {
+  uint32_t state = 0x12345678u ^ (uint32_t)size;
+  for (size_t i = 0; i < size; i++) {
+    state = state * 1664525u + 1013904223u;
+    int8_t q = (int8_t)(state >> 24);
+    input_i8[i] = q;
+    input_f32[i] = (float)q * SOFTMAX_BENCH_INPUT_SCALE;
+  }
+}
+
+static float max_abs_err_f32(size_t size) {
+  float err = 0.0f;
+  for (size_t i = 0; i < size; i++) {
+    float d = fabsf(output_f32[i] - ref_f32[i]);
+    if (d > err) err = d;
+  }
+  return err;
+}
+
+static float max_abs_err_i8(size_t size, quantization_params_t qp) {
+  float err = 0.0f;
+  for (size_t i = 0; i < size; i++) {
+    float p = (float)(output_i8[i] - qp.zero_point) * qp.scale;
+    float d = fabsf(p - ref_f32[i]);
+    if (d > err) err = d;
+  }
+  return err;
+}
+
+static void print_stats(const char *kernel, const bench_stats_t *st, size_t size, float err) {
+  uint64_t avg = st->sum / SOFTMAX_BENCH_RUNS;
+  printf("    %-10s best=%llu avg=%llu cyc/elem=%llu max_err=%d.%06d\n",
+         kernel,
+         (unsigned long long)st->best,
+         (unsigned long long)avg,
+         (unsigned long long)(st->best / size),
+         (int)err, (int)((err - (int)err) * 1000000.0f));
+}
+
+#define BENCH_TIME(stats, call)                     \
+  do {                                              \
+    (stats).sum = 0;                                \
+    (stats).best = UINT64_MAX;                      \
+    for (int r = 0; r < SOFTMAX_BENCH_RUNS; ++r) {  \
+      uint64_t t0 = rdcycle64();                    \
+      call;                                         \
+      uint64_t t1 = rdcycle64();                    \
+      (stats).sum += t1 - t0;                       \
+      if (t1 - t0 < (stats).best) (stats).best = t1 - t0; \
+    }                                               \
+  } while (0)
+
+static void bench_run_case(const SoftmaxSizeCase *cs) {
+  const size_t n = cs->size;
+  const quantization_params_t out_qp = {1.0f / 256.0f, -128};
+  bench_stats_t st;
+
+  printf("  [%s] size=%u\n", cs->name, (unsigned)n);
+  fill_inputs(n);
+
+  BENCH_TIME(st, softmax_ref(input_f32, ref_f32, n));
+  print_stats("scalar", &st, n, 0.0f);
+
+  // Classifier-style call used by the tests: one inner position, n channels
+  BENCH_TIME(st, softmax_vec(input_f32, output_f32, n, 1));
+  print_stats("vec_chan", &st, n, max_abs_err_f32(n));
+
+  BENCH_TIME(st, softmax_row_f32(input_f32, output_f32, n));
+  print_stats("vec_row", &st, n, max_abs_err_f32(n));
+
+  BENCH_TIME(st, softmax_int8(input_i8, output_i8, 1, n, &lut, out_qp));
+  print_stats("int8_lut", &st, n, max_abs_err_i8(n, out_qp));
+}
+
+void app_init(void) {
+  init_test(target_frequency);
+}
+
+void app_main(void) {
+  printf("=== VEC-NN SOFTMAX BENCH @ %llu Hz ===\n",
+         (unsigned long long)target_frequency);
+  printf("  runs=%d input_scale=1/%d\n",
+         SOFTMAX_BENCH_RUNS, (int)(1.0f / SOFTMAX_BENCH_INPUT_SCALE));
+
+  uint64_t t0 = rdcycle64();
+  softmax_int8_lut_init(&lut, SOFTMAX_BENCH_INPUT_SCALE);
+  printf("  int8 LUT build: %llu cycles\n", (unsigned long long)(rdcycle64() - t0));
+
+  for (int i = 0; i < SOFTMAX_NUM_CASES; ++i) {
+    bench_run_case(&SOFTMAX_CASES[i]);
+  }
+
+  printf("=== VEC-NN SOFTMAX BENCH DONE ===\n");
+}
+
+int main(void) {
+  app_init();
+  app_main();
+  return 0;
+}
@@ -41,12 +41,13 @@
 #endif
 
 // Optional memory placement hooks (disabled by default for portability).
-// When enabled, tiny hot buffers can be staged in scratchpad/TCM.
+// When enabled, tiny hot buffers are staged in scratchpad/TCM with region_alloc() (hal_region.h), next
+// to whatever else the program placed there; a buffer that does not fit stays in DRAM.
 #ifndef TINYSPEECH_MC_USE_SCRATCHPAD_FC
 #define TINYSPEECH_MC_USE_SCRATCHPAD_FC 0
 #endif
 
-// 1: map hot shared fixed-path int8 buffers into scratchpad (64KB region)
+// 1: map hot shared fixed-path int8 buffers into scratchpad
 //    pad2, pad3, gap3(hart0/shared), and w2_pack16.
 #ifndef TINYSPEECH_MC_USE_SCRATCHPAD_SHARED
 #define TINYSPEECH_MC_USE_SCRATCHPAD_SHARED 0
@@ -58,50 +59,4 @@
 #define TINYSPEECH_MC_USE_TCM_PRIVATE 0
 #endif
 
-#ifndef TINYSPEECH_MC_SCRATCHPAD_BYTES
-#define TINYSPEECH_MC_SCRATCHPAD_BYTES (64u * 1024u)
-#endif
-
-#ifndef TINYSPEECH_MC_TCM_BYTES
-#define TINYSPEECH_MC_TCM_BYTES (8u * 1024u)
-#endif
-
-// Scratchpad layout offsets for fixed-path hot buffers.
-#ifndef TINYSPEECH_MC_SCRATCH_OFFSET_PAD2
-#define TINYSPEECH_MC_SCRATCH_OFFSET_PAD2 0u
-#endif
-
-#ifndef TINYSPEECH_MC_SCRATCH_OFFSET_PAD3
-#define TINYSPEECH_MC_SCRATCH_OFFSET_PAD3 12288u
-#endif
-
-#ifndef TINYSPEECH_MC_SCRATCH_OFFSET_GAP3
-#define TINYSPEECH_MC_SCRATCH_OFFSET_GAP3 18432u
-#endif
-
-#ifndef TINYSPEECH_MC_SCRATCH_OFFSET_W2PACK16
-#define TINYSPEECH_MC_SCRATCH_OFFSET_W2PACK16 20480u
-#endif
-
-// Core-local TCM layout offsets for tiny private buffers.
-#ifndef TINYSPEECH_MC_CORE1_TCM_OFFSET_GAP3_PRIV
-#define TINYSPEECH_MC_CORE1_TCM_OFFSET_GAP3_PRIV 0u
-#endif
-
-#ifndef TINYSPEECH_MC_CORE0_TCM_OFFSET_FC
-#define TINYSPEECH_MC_CORE0_TCM_OFFSET_FC 0u
-#endif
-
-#ifndef TINYSPEECH_MC_SCRATCHPAD_BASE
-#define TINYSPEECH_MC_SCRATCHPAD_BASE 0x08000000UL
-#endif
-
-#ifndef TINYSPEECH_MC_CORE0_TCM_BASE
-#define TINYSPEECH_MC_CORE0_TCM_BASE 0x08010000UL
-#endif
-
-#ifndef TINYSPEECH_MC_CORE1_TCM_BASE
-#define TINYSPEECH_MC_CORE1_TCM_BASE 0x08012000UL
-#endif
-
 #endif
@@ -284,6 +284,9 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
 #endif
 
     printf("=== Bearly25 TinySpeech-MC @ %llu Hz ===\n", (unsigned long long)frequency_hz);
+#if HTHREAD_TRACE
+    hthread_trace_reset();
+#endif
     printf("  mode: multicore inference benchmark (2 cores)\n");
 #if TINYSPEECH_INT8_PIPELINE
     printf("  kernel mode: fixed-shape INT8 conv/gap/fc\n");
@@ -605,6 +608,11 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
                (unsigned long)st_model_total.max);
     }
 
+#if HTHREAD_TRACE
+    // Binary scheduler trace; decode with scripts/trace/hthread_trace_to_chrome.py
+    hthread_trace_dump(frequency_hz);
+#endif
+
     return (fail == 0) ? 0 : 1;
 }
 
@@ -1,5 +1,6 @@
 #include "tinyspeech_int8.h"
 #include "bench_config.h"
+#include "hal_region.h"
 
 #include <limits.h>
 #include <math.h>
@@ -53,37 +54,10 @@
 #define TS_W2PACK16_BYTES (TS_L2_OC * TS_L2_IC * TS_K * 2)
 #define TS_FC_BYTES (TS_FC_OUT * TS_FC_IN)
 
-#if TINYSPEECH_MC_USE_SCRATCHPAD_SHARED
-#if ((TINYSPEECH_MC_SCRATCH_OFFSET_PAD2 + TS_PAD2_BYTES) > TINYSPEECH_MC_SCRATCHPAD_BYTES)
-#error "scratchpad layout overflow: PAD2"
-#endif
-#if ((TINYSPEECH_MC_SCRATCH_OFFSET_PAD3 + TS_PAD3_BYTES) > TINYSPEECH_MC_SCRATCHPAD_BYTES)
-#error "scratchpad layout overflow: PAD3"
-#endif
-#if ((TINYSPEECH_MC_SCRATCH_OFFSET_GAP3 + TS_GAP3_BYTES) > TINYSPEECH_MC_SCRATCHPAD_BYTES)
-#error "scratchpad layout overflow: GAP3"
-#endif
-#if ((TINYSPEECH_MC_SCRATCH_OFFSET_W2PACK16 + TS_W2PACK16_BYTES) > TINYSPEECH_MC_SCRATCHPAD_BYTES)
-#error "scratchpad layout overflow: W2PACK16"
-#endif
-#endif
-
-#if TINYSPEECH_MC_USE_TCM_PRIVATE
-#if ((TINYSPEECH_MC_CORE1_TCM_OFFSET_GAP3_PRIV + TS_GAP3_BYTES) > TINYSPEECH_MC_TCM_BYTES)
-#error "core1 TCM layout overflow: GAP3 private"
-#endif
-#if ((TINYSPEECH_MC_CORE0_TCM_OFFSET_FC + TS_FC_BYTES) > TINYSPEECH_MC_TCM_BYTES)
-#error "core0 TCM layout overflow: FC"
-#endif
-#endif
-
 static int8_t g_w1_q[TS_L1_OC * TS_L1_IC * TS_K] __attribute__((aligned(64)));
 static int8_t g_w2_q[TS_L2_OC * TS_L2_IC * TS_K] __attribute__((aligned(64)));
 static int8_t g_w3_q[TS_L3_OC * TS_L3_IC * TS_K] __attribute__((aligned(64)));
 static int8_t g_wfc_q[TS_FC_OUT * TS_FC_IN] __attribute__((aligned(64)));
-#if TINYSPEECH_MC_USE_SCRATCHPAD_FC
-static int8_t g_wfc_scratch[TS_FC_OUT * TS_FC_IN] __attribute__((aligned(64)));
-#endif
 static const int8_t *g_wfc_active = g_wfc_q;
 static int8_t g_w1_pack[TS_L1_OC * TS_L1_IC * TS_K] __attribute__((aligned(64)));
 static int8_t g_w2_pack[TS_L2_OC * TS_L2_IC * TS_K] __attribute__((aligned(64)));
@@ -140,28 +114,27 @@ static inline uint64_t rdcycle64_int8(void) {
     return x;
 }
 
-static inline void tinyspeech_int8_bind_hot_buffers(void) {
-    g_w2_pack16_active = g_w2_pack16;
-    g_pad2_active = g_pad2;
-    g_pad3_active = g_pad3;
-    g_gap3_acc_shared = g_gap3_acc;
-    g_gap3_acc_h1_private = g_gap3_acc;
+// Moves a hot buffer into an SRAM region (hal_region.h) on the first prepare; later prepares keep
+// that placement, and a buffer that does not fit stays in DRAM.
+static inline void *tinyspeech_int8_place(void *current, void *dram, region_id_t region, size_t bytes) {
+    if (current != dram) {
+        return current;
+    }
+    void *p = region_alloc(region, bytes, 64);
+    return (p != NULL) ? p : dram;
+}
 
+static inline void tinyspeech_int8_bind_hot_buffers(void) {
 #if TINYSPEECH_MC_USE_SCRATCHPAD_SHARED
-    {
-        uintptr_t sb = (uintptr_t)TINYSPEECH_MC_SCRATCHPAD_BASE;
-        g_pad2_active = (int8_t *)(sb + (uintptr_t)TINYSPEECH_MC_SCRATCH_OFFSET_PAD2);
-        g_pad3_active = (int8_t *)(sb + (uintptr_t)TINYSPEECH_MC_SCRATCH_OFFSET_PAD3);
-        g_gap3_acc_shared = (int32_t *)(sb + (uintptr_t)TINYSPEECH_MC_SCRATCH_OFFSET_GAP3);
-        g_w2_pack16_active = (const int16_t *)(sb + (uintptr_t)TINYSPEECH_MC_SCRATCH_OFFSET_W2PACK16);
-    }
+    g_pad2_active = tinyspeech_int8_place(g_pad2_active, g_pad2, REGION_SCRATCHPAD, TS_PAD2_BYTES);
+    g_pad3_active = tinyspeech_int8_place(g_pad3_active, g_pad3, REGION_SCRATCHPAD, TS_PAD3_BYTES);
+    g_gap3_acc_shared = tinyspeech_int8_place(g_gap3_acc_shared, g_gap3_acc, REGION_SCRATCHPAD, TS_GAP3_BYTES);
+    g_w2_pack16_active = tinyspeech_int8_place((void *)g_w2_pack16_active, g_w2_pack16,
+                                               REGION_SCRATCHPAD, TS_W2PACK16_BYTES);
 #endif
 
 #if TINYSPEECH_MC_USE_TCM_PRIVATE
-    {
-        uintptr_t c1 = (uintptr_t)TINYSPEECH_MC_CORE1_TCM_BASE;
-        g_gap3_acc_h1_private = (int32_t *)(c1 + (uintptr_t)TINYSPEECH_MC_CORE1_TCM_OFFSET_GAP3_PRIV);
-    }
+    g_gap3_acc_h1_private = tinyspeech_int8_place(g_gap3_acc_h1_private, g_gap3_acc, REGION_TCM1, TS_GAP3_BYTES);
 #endif
 }
 
@@ -2083,17 +2056,13 @@ int tinyspeech_int8_prepare(const Tensor *conv1_w,
     g_w3_scale = quantize_weights_symmetric(conv3_w->f_data, conv3_w->size, g_w3_q);
     g_wfc_scale = quantize_weights_symmetric(fc_w->f_data, fc_w->size, g_wfc_q);
 #if TINYSPEECH_MC_USE_TCM_PRIVATE
-    {
-        int8_t *fc_tcm = (int8_t *)(uintptr_t)(TINYSPEECH_MC_CORE0_TCM_BASE + TINYSPEECH_MC_CORE0_TCM_OFFSET_FC);
-        memcpy(fc_tcm, g_wfc_q, sizeof(g_wfc_q));
-        g_wfc_active = fc_tcm;
-    }
+    g_wfc_active = tinyspeech_int8_place((void *)g_wfc_active, g_wfc_q, REGION_TCM0, TS_FC_BYTES);
 #elif TINYSPEECH_MC_USE_SCRATCHPAD_FC
-    memcpy(g_wfc_scratch, g_wfc_q, sizeof(g_wfc_q));
-    g_wfc_active = g_wfc_scratch;
-#else
-    g_wfc_active = g_wfc_q;
+    g_wfc_active = tinyspeech_int8_place((void *)g_wfc_active, g_wfc_q, REGION_SCRATCHPAD, TS_FC_BYTES);
 #endif
+    if (g_wfc_active != g_wfc_q) {
+        memcpy((void *)g_wfc_active, g_wfc_q, sizeof(g_wfc_q));
+    }
     pack_w_oc_to_k_major(g_w1_q, g_w1_pack, TS_L1_OC, TS_L1_IC);
     pack_w_oc_to_k_major(g_w2_q, g_w2_pack, TS_L2_OC, TS_L2_IC);
     pack_w_oc_to_k_major(g_w3_q, g_w3_pack, TS_L3_OC, TS_L3_IC);
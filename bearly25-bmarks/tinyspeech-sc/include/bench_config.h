@@ -27,4 +27,48 @@
   350000000ULL
 #endif
 
+// 1: pin the int8 pipeline's per-inference activations (act1/act2/pad3/gap3/act3, ~16 KB) into
+//    the MBUS scratchpad instead of DRAM .bss (see hal_region.h). The scratchpad is not zeroed at
+//    boot; every stage writes these buffers in full (pad borders included) before reading them.
+//    0 keeps them in DRAM for an A/B run.
+#ifndef TINYSPEECH_SC_PIN_SCRATCHPAD
+#define TINYSPEECH_SC_PIN_SCRATCHPAD 1
+#endif
+
+// 1: print which memory region each int8 buffer lives in after runtime prep
+#ifndef TINYSPEECH_SC_PLACEMENT_REPORT
+#define TINYSPEECH_SC_PLACEMENT_REPORT 1
+#endif
+
+// 1: record the int8 stages as prof.h regions and print a per-region CSV after the cycle summary;
+//    0 compiles the regions out
+#ifndef TINYSPEECH_SC_PROF
+#define TINYSPEECH_SC_PROF 0
+#endif
+
+// PMU events counted next to cycles/instret when TINYSPEECH_SC_PROF=1 (at most four, see prof.h)
+#ifndef TINYSPEECH_SC_PROF_EVENTS
+#define TINYSPEECH_SC_PROF_EVENTS PROF_EVENTS_MISSES
+#endif
+
+// 1: at init, move glossy's buffered console (TERMINAL_UART_BUFFERED) onto UART0's PLIC source
+//    (hal_plic.h), so the per-case log lines drain from the TXWM interrupt while the next case runs
+//    instead of stalling the loop for ~9 ms each at 115200 baud. Compare the "Wall summary" line of
+//    a build with and without it. CMake sets it for UART0 builds with TERMINAL_UART_BUFFERED=ON.
+#ifndef TINYSPEECH_SC_CONSOLE_IRQ
+#define TINYSPEECH_SC_CONSOLE_IRQ 0
+#endif
+
+// 1: record the per-case result and progress lines with BINLOG (lib/binlog) and print them with one
+//    binlog_drain() after the timed loop, so the loop never waits on the console. Decode the capture
+//    with scripts/trace/decode_binlog.py --elf tinyspeech-sc.elf --log <console>. Set by the CMake
+//    option of the same name, which also links binlog.
+#ifndef TINYSPEECH_SC_BINLOG
+#define TINYSPEECH_SC_BINLOG 0
+#endif
+
+#if !TINYSPEECH_SC_PROF && !defined(PROF_DISABLE)
+#define PROF_DISABLE
+#endif
+
 #endif
@@ -8,6 +8,8 @@ int tinyspeech_int8_prepare(const Tensor *conv1_w,
                             const Tensor *conv3_w,
                             const Tensor *fc_w);
 int tinyspeech_int8_is_ready(void);
+// Registers the int8 pipeline's buffers with region_track() for region_report().
+void tinyspeech_int8_track_buffers(void);
 void tinyspeech_int8_calib_reset(void);
 int tinyspeech_int8_calib_finalize(const Tensor *conv1_bias,
                                    const Tensor *conv2_bias,
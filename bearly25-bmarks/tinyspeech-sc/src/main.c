@@ -5,6 +5,15 @@
 #include "tinyspeech_model.h"
 #include "tinyspeech_inputs.h"
 #include "tinyspeech_reference.h"
+#include "tinyspeech_int8.h"
+#include "hal_region.h"
+#include "prof.h"
+#if TINYSPEECH_SC_CONSOLE_IRQ
+#include "hal_plic.h"
+#endif
+#if TINYSPEECH_SC_BINLOG
+#include "binlog.h"
+#endif
 
 #if (TINYSPEECH_TEST_NUM_CASES != TINYSPEECH_EXPECTED_NUM_CASES)
 #error "tinyspeech_inputs.h mismatch: unexpected case count"
@@ -18,6 +27,10 @@
 #error "tinyspeech_reference.h mismatch: unexpected case count/stage count"
 #endif
 
+#if TINYSPEECH_SC_BINLOG && (TINYSPEECH_NUM_CLASSES != 6)
+#error "TINYSPEECH_SC_BINLOG: the per-case output record assumes 6 classes"
+#endif
+
 #ifndef TINYSPEECH_REF_CHECK_STAGE_SUM
 #define TINYSPEECH_REF_CHECK_STAGE_SUM 1
 #endif
@@ -32,12 +45,6 @@ static const char *k_labels[TINYSPEECH_NUM_CLASSES] = {
 
 uint64_t target_frequency = TINYSPEECH_SC_TARGET_FREQUENCY_HZ;
 
-static inline uint64_t rdcycle64(void) {
-    uint64_t x;
-    __asm__ volatile("rdcycle %0" : "=r"(x));
-    return x;
-}
-
 static Tensor make_input_tensor(const int8_t *flat_data) {
     u_int8_t shape[4] = {1, 1, TINYSPEECH_TEST_INPUT_H, TINYSPEECH_TEST_INPUT_W};
     Tensor t = create_tensor(shape, 4);
@@ -241,8 +248,21 @@ static void print_debug_trace(void) {
 }
 #endif
 
+static int g_console_irq;
+
 void app_init(void) {
     init_test(target_frequency);
+#if TINYSPEECH_SC_CONSOLE_IRQ
+    printf("console: buffered, routing UART0 (PLIC source %u) to the TX ring\n", (unsigned)UART0_IRQ_ID);
+    g_console_irq = (platform_uart_irq_enable(&uart_console, UART0_IRQ_ID) == 0);
+    if (!g_console_irq) {
+        printf("console: no free PLIC handler slot, staying polled\n");
+    }
+#endif
+#if TINYSPEECH_INT8_PIPELINE && TINYSPEECH_SC_PLACEMENT_REPORT
+    // Once: the buffers don't move, and the PLL sweep reports them again at every frequency.
+    tinyspeech_int8_track_buffers();
+#endif
 }
 
 typedef struct {
@@ -358,6 +378,17 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
     int calib_ok = tinyspeech_int8_calibration_end();
     printf("  calibration: %s\n", calib_ok ? "done" : "failed (falling back to dynamic int8)");
     fflush(stdout);
+#if TINYSPEECH_SC_PLACEMENT_REPORT
+    printf("  placement:\n");
+    region_report();
+    fflush(stdout);
+#endif
+#endif
+
+#if TINYSPEECH_SC_PROF
+    // Programs the PMU and drops whatever calibration recorded; only the timed cases are reported.
+    static const prof_event_t prof_events[] = { TINYSPEECH_SC_PROF_EVENTS };
+    prof_init(prof_events, PROF_COUNT(prof_events));
 #endif
 
     uint32_t pass = 0;
@@ -383,16 +414,25 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
     cycle_stat_init(&st_softmax);
     cycle_stat_init(&st_model_total);
 
+#if TINYSPEECH_SC_BINLOG
+    binlog_reset();
+#endif
+    // Wall clock of the whole case loop, logging included: what the console mode changes.
+    uint64_t wall0 = prof_cycles();
     for (uint32_t tc = 0; tc < TINYSPEECH_TEST_NUM_CASES; tc++) {
         const tinyspeech_test_input_case_t *c = &g_tinyspeech_test_inputs[tc];
 
 #if !TINYSPEECH_VERBOSE_CASE_LOGS
 #if (TINYSPEECH_PROGRESS_EVERY > 0)
         if ((tc % TINYSPEECH_PROGRESS_EVERY) == 0) {
+#if TINYSPEECH_SC_BINLOG
+            BINLOG("  progress: case %lu/%d\n", (unsigned long)(tc + 1), TINYSPEECH_TEST_NUM_CASES);
+#else
             printf("  progress: case %lu/%d\n",
                    (unsigned long)(tc + 1),
                    TINYSPEECH_TEST_NUM_CASES);
             fflush(stdout);
+#endif
         }
 #endif
 #endif
@@ -402,9 +442,11 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
             print_input_preview(c->data);
         }
 
-        uint64_t c0 = rdcycle64();
+        PROF_BEGIN("inference");
+        uint64_t c0 = prof_cycles();
         Tensor probs = tinyspeech_run_inference(&input);
-        uint64_t c1 = rdcycle64();
+        uint64_t c1 = prof_cycles();
+        PROF_END();
         free_tensor(&input);
         const tinyspeech_cycle_profile_t *prof = tinyspeech_last_cycle_profile();
         uint64_t cycles = c1 - c0;
@@ -479,6 +521,24 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
                     ? k_labels[pred]
                     : "<oor>";
 
+#if TINYSPEECH_SC_BINLOG
+            // BINLOG takes at most eight arguments: the status goes into the format string.
+            if (case_pass) {
+                BINLOG("[CASE %lu] %s exp=%s pred=%s %s=%.6f sum=%.6f cycles=%lu status=PASS\n",
+                       (unsigned long)tc, c->name, exp_str, pred_str, score_label, max_prob, sum,
+                       (unsigned long)cycles);
+            } else {
+                BINLOG("[CASE %lu] %s exp=%s pred=%s %s=%.6f sum=%.6f cycles=%lu status=FAIL\n",
+                       (unsigned long)tc, c->name, exp_str, pred_str, score_label, max_prob, sum,
+                       (unsigned long)cycles);
+            }
+
+            if (TINYSPEECH_PRINT_CASE_PROBS) {
+                BINLOG("    output = %.6f %.6f %.6f %.6f %.6f %.6f\n",
+                       probs.f_data[0], probs.f_data[1], probs.f_data[2],
+                       probs.f_data[3], probs.f_data[4], probs.f_data[5]);
+            }
+#else
             printf("[CASE %lu] %s exp=%s pred=%s %s=%.6f sum=%.6f cycles=%lu status=%s\n",
                    (unsigned long)tc,
                    c->name,
@@ -497,6 +557,7 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
                 }
                 printf("\n");
             }
+#endif
         }
 
         if (TINYSPEECH_VERBOSE_CASE_LOGS) {
@@ -526,6 +587,23 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
 
         free_tensor(&probs);
     }
+    fflush(stdout);
+#if TINYSPEECH_SC_CONSOLE_IRQ
+    // Count the ring's tail too, so both modes are timed until every case line has left.
+    uart_buffered_flush(&uart_console);
+#endif
+    uint64_t wall_cycles = prof_cycles() - wall0;
+#if TINYSPEECH_SC_BINLOG
+    // Outside the wall clock: this is the console time the loop no longer pays.
+    size_t binlog_records = binlog_drain();
+    uint32_t binlog_lost = 0;
+    for (uint32_t hart = 0; hart < BINLOG_MAX_HARTS; hart++) {
+        binlog_lost += binlog_dropped(hart);
+    }
+    printf("binlog: %lu records drained, %lu dropped (decode with scripts/trace/decode_binlog.py)\n",
+           (unsigned long)binlog_records,
+           (unsigned long)binlog_lost);
+#endif
 
     printf("TinySpeech summary: pass=%lu fail=%lu\n",
            (unsigned long)pass,
@@ -540,6 +618,11 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
            (unsigned long)ref_summary.logit_fail,
            (unsigned long)ref_summary.stage_fail,
            (unsigned long)ref_summary.missing_ref);
+    printf("Wall summary: cases=%d loop=%llu cycles (%llu per case) console=%s\n",
+           TINYSPEECH_TEST_NUM_CASES,
+           (unsigned long long)wall_cycles,
+           (unsigned long long)(wall_cycles / (uint64_t)(TINYSPEECH_TEST_NUM_CASES > 0 ? TINYSPEECH_TEST_NUM_CASES : 1)),
+           TINYSPEECH_SC_BINLOG ? "binlog" : (g_console_irq ? "irq" : "polled"));
     if (TINYSPEECH_TEST_NUM_CASES > 0) {
         unsigned long avg_cycles = (unsigned long)(cycles_sum / (uint64_t)TINYSPEECH_TEST_NUM_CASES);
         printf("Cycle summary: min=%lu avg=%lu max=%lu\n",
@@ -578,6 +661,11 @@ static int run_suite_for_frequency(uint64_t frequency_hz) {
                (unsigned long)st_model_total.max);
     }
 
+#if TINYSPEECH_SC_PROF
+    printf("Region profile:\n");
+    prof_report_csv();
+#endif
+
     return (fail == 0) ? 0 : 1;
 }
 
@@ -602,7 +690,7 @@ int main(void) {
     }
 
     target_frequency = k_pll_sweep_freqs_hz[0];
-    init_test(target_frequency);
+    app_init();
     status |= run_suite_for_frequency(target_frequency);
 
     for (size_t i = 1; i < num_freqs; ++i) {
@@ -1,5 +1,9 @@
 #include "tinyspeech_int8.h"
 
+#include "bench_config.h"
+#include "hal_region.h"
+#include "prof.h"
+
 #include <limits.h>
 #include <math.h>
 #include <stddef.h>
@@ -39,6 +43,13 @@
 #define TS_POOL_AREA 4
 #define TS_GAP_AREA (TS_L3_OH * TS_L3_OW)
 
+// Activations rewritten on every inference; small enough to pin into the scratchpad.
+#if TINYSPEECH_SC_PIN_SCRATCHPAD
+#define TS_HOT_DATA REGION_SCRATCHPAD_DATA
+#else
+#define TS_HOT_DATA
+#endif
+
 static int8_t g_w1_q[TS_L1_OC * TS_L1_IC * TS_K] __attribute__((aligned(64)));
 static int8_t g_w2_q[TS_L2_OC * TS_L2_IC * TS_K] __attribute__((aligned(64)));
 static int8_t g_w3_q[TS_L3_OC * TS_L3_IC * TS_K] __attribute__((aligned(64)));
@@ -71,28 +82,22 @@ static int8_t g_in0[TS_IN_H * TS_IN_W] __attribute__((aligned(64)));
 static int8_t g_pad1[(TS_IN_H + 2) * (TS_IN_W + 2)] __attribute__((aligned(64)));
 static int32_t g_conv1_acc[TS_L1_OC * TS_L1_OH * TS_L1_OW] __attribute__((aligned(64)));
 static int32_t g_pool1_acc[TS_L1_OC * TS_L1_PH * TS_L1_PW] __attribute__((aligned(64)));
-static int8_t g_act1[TS_L1_OC * TS_L1_PH * TS_L1_PW] __attribute__((aligned(64)));
+static int8_t g_act1[TS_L1_OC * TS_L1_PH * TS_L1_PW] __attribute__((aligned(64))) TS_HOT_DATA;
 
 static int8_t g_pad2[TS_L2_IC * (TS_L2_OH + 2) * (TS_L2_OW + 2)] __attribute__((aligned(64)));
 static int32_t g_conv2_acc[TS_L2_OC * TS_L2_OH * TS_L2_OW] __attribute__((aligned(64)));
 static int32_t g_pool2_acc[TS_L2_OC * TS_L2_PH * TS_L2_PW] __attribute__((aligned(64)));
-static int8_t g_act2[TS_L2_OC * TS_L2_PH * TS_L2_PW] __attribute__((aligned(64)));
+static int8_t g_act2[TS_L2_OC * TS_L2_PH * TS_L2_PW] __attribute__((aligned(64))) TS_HOT_DATA;
 
-static int8_t g_pad3[TS_L3_IC * (TS_L3_OH + 2) * (TS_L3_OW + 2)] __attribute__((aligned(64)));
-static int32_t g_gap3_acc[TS_L3_OC] __attribute__((aligned(64)));
-static int8_t g_act3[TS_FC_IN] __attribute__((aligned(64)));
+static int8_t g_pad3[TS_L3_IC * (TS_L3_OH + 2) * (TS_L3_OW + 2)] __attribute__((aligned(64))) TS_HOT_DATA;
+static int32_t g_gap3_acc[TS_L3_OC] __attribute__((aligned(64))) TS_HOT_DATA;
+static int8_t g_act3[TS_FC_IN] __attribute__((aligned(64))) TS_HOT_DATA;
 static int32_t g_conv3_acc[TS_L3_OC * TS_L3_OH * TS_L3_OW] __attribute__((aligned(64)));
 
 static int32_t g_bias1_q[TS_L1_OC] __attribute__((aligned(64)));
 static int32_t g_bias2_q[TS_L2_OC] __attribute__((aligned(64)));
 static int32_t g_bias3_q[TS_L3_OC] __attribute__((aligned(64)));
 
-static inline uint64_t rdcycle64_int8(void) {
-    uint64_t x;
-    __asm__ volatile("rdcycle %0" : "=r"(x));
-    return x;
-}
-
 static inline int8_t clamp_i8(int32_t x) {
     if (x > 127) {
         return 127;
@@ -2025,6 +2030,26 @@ int tinyspeech_int8_prepare(const Tensor *conv1_w,
     return 1;
 }
 
+void tinyspeech_int8_track_buffers(void) {
+    region_track("g_w1_pack16", g_w1_pack16, sizeof(g_w1_pack16));
+    region_track("g_w2_pack16", g_w2_pack16, sizeof(g_w2_pack16));
+    region_track("g_w3_pack16", g_w3_pack16, sizeof(g_w3_pack16));
+    region_track("g_wfc_q", g_wfc_q, sizeof(g_wfc_q));
+    region_track("g_in0", g_in0, sizeof(g_in0));
+    region_track("g_pad1", g_pad1, sizeof(g_pad1));
+    region_track("g_conv1_acc", g_conv1_acc, sizeof(g_conv1_acc));
+    region_track("g_pool1_acc", g_pool1_acc, sizeof(g_pool1_acc));
+    region_track("g_act1", g_act1, sizeof(g_act1));
+    region_track("g_pad2", g_pad2, sizeof(g_pad2));
+    region_track("g_conv2_acc", g_conv2_acc, sizeof(g_conv2_acc));
+    region_track("g_pool2_acc", g_pool2_acc, sizeof(g_pool2_acc));
+    region_track("g_act2", g_act2, sizeof(g_act2));
+    region_track("g_pad3", g_pad3, sizeof(g_pad3));
+    region_track("g_conv3_acc", g_conv3_acc, sizeof(g_conv3_acc));
+    region_track("g_gap3_acc", g_gap3_acc, sizeof(g_gap3_acc));
+    region_track("g_act3", g_act3, sizeof(g_act3));
+}
+
 int tinyspeech_int8_is_ready(void) {
     return g_prepared;
 }
@@ -2117,7 +2142,8 @@ static Tensor tinyspeech_run_inference_int8_dynamic(const Tensor *input,
         return logits;
     }
 
-    uint64_t t0 = rdcycle64_int8();
+    PROF_BEGIN("input_cast");
+    uint64_t t0 = prof_cycles();
     if (input->data != NULL) {
         memcpy(g_in0, input->data, (size_t)TS_IN_H * TS_IN_W * sizeof(int8_t));
     } else if (input->f_data != NULL) {
@@ -2127,8 +2153,9 @@ static Tensor tinyspeech_run_inference_int8_dynamic(const Tensor *input,
     } else {
         memset(g_in0, 0, (size_t)TS_IN_H * TS_IN_W * sizeof(int8_t));
     }
-    uint64_t t1 = rdcycle64_int8();
+    uint64_t t1 = prof_cycles();
     profile->input_cast = t1 - t0;
+    PROF_END();
 
     const float s0 = 1.0f;
 #if defined(__riscv_vector)
@@ -2144,7 +2171,8 @@ static Tensor tinyspeech_run_inference_int8_dynamic(const Tensor *input,
     const int16_t *w3_conv16 = NULL;
 #endif
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("conv1_pool1");
+    t0 = prof_cycles();
     make_bias_q(conv1_bias, s0, g_w1_scale, g_bias1_q, TS_L1_OC);
     pad_input_1ch(g_in0, TS_IN_H, TS_IN_W, g_pad1, TS_IN_H + 2, TS_IN_W + 2);
     float s1 = 1.0f;
@@ -2162,10 +2190,12 @@ static Tensor tinyspeech_run_inference_int8_dynamic(const Tensor *input,
                            TS_L1_PH, TS_L1_PW, s0, g_w1_scale, g_act1, &max1);
     calib_track_max(1, max1);
 #endif
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->conv1_pool1 = t1 - t0;
+    PROF_END();
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("conv2_pool2");
+    t0 = prof_cycles();
     make_bias_q(conv2_bias, s1, g_w2_scale, g_bias2_q, TS_L2_OC);
 #if !defined(__riscv_vector)
     pad_input_c(g_act1, TS_L2_IC, TS_L2_OH, TS_L2_OW, g_pad2, TS_L2_OH + 2, TS_L2_OW + 2);
@@ -2185,10 +2215,12 @@ static Tensor tinyspeech_run_inference_int8_dynamic(const Tensor *input,
                            TS_L2_PH, TS_L2_PW, s1, g_w2_scale, g_act2, &max2);
     calib_track_max(2, max2);
 #endif
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->conv2_pool2 = t1 - t0;
+    PROF_END();
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("conv3_gap");
+    t0 = prof_cycles();
     make_bias_q(conv3_bias, s2, g_w3_scale, g_bias3_q, TS_L3_OC);
     float s3 = 1.0f;
 #if defined(__riscv_vector)
@@ -2213,13 +2245,16 @@ static Tensor tinyspeech_run_inference_int8_dynamic(const Tensor *input,
     s3 = conv_relu_gap_to_i8(g_act2, s2, w3_conv8, w3_conv16, g_w3_scale, g_bias3_q, g_act3, &max3);
     calib_track_max(3, max3);
 #endif
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->conv3_gap = t1 - t0;
+    PROF_END();
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("fc_logits");
+    t0 = prof_cycles();
     fc_logits_i8(g_act3, s3 * g_wfc_scale, logits.f_data);
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->fc_logits = t1 - t0;
+    PROF_END();
     profile->softmax = 0;
 
     return logits;
@@ -2242,7 +2277,8 @@ static Tensor tinyspeech_run_inference_int8_fixed(const Tensor *input,
         return logits;
     }
 
-    uint64_t t0 = rdcycle64_int8();
+    PROF_BEGIN("input_cast");
+    uint64_t t0 = prof_cycles();
     if (input->data != NULL) {
         memcpy(g_in0, input->data, (size_t)TS_IN_H * TS_IN_W * sizeof(int8_t));
     } else if (input->f_data != NULL) {
@@ -2252,8 +2288,9 @@ static Tensor tinyspeech_run_inference_int8_fixed(const Tensor *input,
     } else {
         memset(g_in0, 0, (size_t)TS_IN_H * TS_IN_W * sizeof(int8_t));
     }
-    uint64_t t1 = rdcycle64_int8();
+    uint64_t t1 = prof_cycles();
     profile->input_cast = t1 - t0;
+    PROF_END();
 
 #if defined(__riscv_vector)
     const int16_t *w1_conv16 = g_w1_pack16;
@@ -2268,7 +2305,8 @@ static Tensor tinyspeech_run_inference_int8_fixed(const Tensor *input,
     const int16_t *w3_conv16 = NULL;
 #endif
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("conv1_pool1");
+    t0 = prof_cycles();
     pad_input_1ch(g_in0, TS_IN_H, TS_IN_W, g_pad1, TS_IN_H + 2, TS_IN_W + 2);
 #if defined(__riscv_vector)
     conv3x3_pool2x2_requant_relu_to_padded_1c_rvv(g_pad1, TS_IN_W + 2, w1_conv16, g_bias1_q,
@@ -2280,10 +2318,12 @@ static Tensor tinyspeech_run_inference_int8_fixed(const Tensor *input,
                             TS_L1_PH, TS_L1_PW, g_mul1_q31, g_act1);
     pad_input_c(g_act1, TS_L2_IC, TS_L2_OH, TS_L2_OW, g_pad2, TS_L2_OH + 2, TS_L2_OW + 2);
 #endif
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->conv1_pool1 = t1 - t0;
+    PROF_END();
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("conv2_pool2");
+    t0 = prof_cycles();
 #if defined(__riscv_vector)
 #if TINYSPEECH_INT8_RVV_UKERNELS
     conv3x3_pool2x2_requant_relu_to_padded_hwc_c_rvv_uk48x24(g_pad2, w2_conv16, g_bias2_q,
@@ -2299,10 +2339,12 @@ static Tensor tinyspeech_run_inference_int8_fixed(const Tensor *input,
                             TS_L2_PH, TS_L2_PW, g_mul2_q31, g_act2);
     pad_input_c(g_act2, TS_L3_IC, TS_L3_OH, TS_L3_OW, g_pad3, TS_L3_OH + 2, TS_L3_OW + 2);
 #endif
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->conv2_pool2 = t1 - t0;
+    PROF_END();
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("conv3_gap");
+    t0 = prof_cycles();
 #if defined(__riscv_vector)
 #if TINYSPEECH_INT8_RVV_UKERNELS
     conv3x3_relu_gap_acc_hwc_padded_c_rvv_uk96x48(g_pad3, w3_conv16, g_bias3_q, g_gap3_acc);
@@ -2330,13 +2372,16 @@ static Tensor tinyspeech_run_inference_int8_fixed(const Tensor *input,
         g_act3[oc] = requant_u7_from_acc(avg_acc, g_mul3_q31);
     }
 #endif
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->conv3_gap = t1 - t0;
+    PROF_END();
 
-    t0 = rdcycle64_int8();
+    PROF_BEGIN("fc_logits");
+    t0 = prof_cycles();
     fc_logits_i8(g_act3, g_s3_fixed * g_wfc_scale, logits.f_data);
-    t1 = rdcycle64_int8();
+    t1 = prof_cycles();
     profile->fc_logits = t1 - t0;
+    PROF_END();
     profile->softmax = 0;
 
     return logits;
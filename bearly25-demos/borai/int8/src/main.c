@@ -773,7 +773,7 @@ static float* forward_mc(Transformer* transformer, int token, int pos, int harti
                     att[t] = score / sqrtf(head_size);
                 }
 #ifdef VEC_SOFTMAX
-                softmax_vec(att, att, 1, (size_t)(pos + 1));
+                softmax_row_f32(att, att, (size_t)(pos + 1));
 #else
                 softmax(att, pos + 1);
 #endif
@@ -1014,7 +1014,7 @@ float* forward(Transformer* transformer, int token, int pos) {
 
             // softmax the scores to get attention weights, from 0..pos inclusively
 #ifdef VEC_SOFTMAX
-            softmax_vec(att, att, 1, (size_t)(pos + 1));
+            softmax_row_f32(att, att, (size_t)(pos + 1));
 #else
             softmax(att, pos + 1);
 #endif
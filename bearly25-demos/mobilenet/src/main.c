@@ -7,6 +7,7 @@
  */
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -15,6 +16,14 @@
 #include "layers.h"
 #include "compare.h"
 
+/* Fused inverted residual blocks; vec-nn/test/inverted_residual_test checks
+   them byte for byte against the unfused path below (-DMOBILENET_FUSED_IR=0). */
+#ifndef MOBILENET_FUSED_IR
+#define MOBILENET_FUSED_IR 1
+#endif
+
+#include "graph.h"
+
 /* -------------------------------------------------------------------------- */
 /* Helpers                                                                    */
 /* -------------------------------------------------------------------------- */
@@ -58,15 +67,31 @@ void print_int32_matrix(int32_t *arr, size_t rows, size_t cols)
     }
 }
 
+/* MOBILENET_FUSED_IR: run each inverted residual block as one fused
+   row-strip operator (inverted_residual_int8) instead of four full-tensor
+   passes. Either way all activations live in one planned arena (see
+   mobilenet_arena()). */
+#if MOBILENET_FUSED_IR
+/* Only block inputs/outputs are materialized; the expanded tensors live in
+   ir_scratch one strip at a time. */
+#define MAX_INT8_BUFFER (32 * 112 * 112) /* largest feature map */
+#ifndef MOBILENET_IR_SCRATCH_BYTES
+#define MOBILENET_IR_SCRATCH_BYTES (64 * 1024)
+#endif
+static int8_t ir_scratch[MOBILENET_IR_SCRATCH_BYTES] __attribute__((aligned(64)));
+#else
 #define MAX_INT8_BUFFER (96 * 112 * 112) /* largest feature map */
+#endif
 #define MAX_CHANNELS    1280
 
 static float relu_tmp[MAX_INT8_BUFFER];
 
 /* Dequant int8 -> float with given rq, apply ReLU6, re-quant to int8. 
-   NOTE: we *do not* change scale – we reuse the same requantization_params_t. */
+   NOTE: we *do not* change scale – we reuse the same requantization_params_t.
+   output may be input (the planner usually folds ReLU6 in place). */
 static void relu6_apply_int8(
-    int8_t *tensor,
+    const int8_t *input,
+    int8_t *output,
     size_t channels,
     size_t rows,
     size_t cols,
@@ -83,19 +108,63 @@ static void relu6_apply_int8(
         const float s =
             (rq_source && rq_source->scale) ? rq_source->scale[c] : 1.0f;
         for (size_t i = 0; i < rows * cols; ++i, ++idx) {
-            relu_tmp[idx] = ((float)tensor[idx] - (float)zp) * s;
+            relu_tmp[idx] = ((float)input[idx] - (float)zp) * s;
         }
     }
 
     /* relu6_int8 is assumed to:
        - clamp relu_tmp in [0, 6]
        - requantize back to int8 using the same rq (per-channel scales). */
-    relu6_int8(channels, rows * cols, relu_tmp, tensor,
+    relu6_int8(channels, rows * cols, relu_tmp, output,
                rq_source ? *rq_source
                          : (requantization_params_t){ .scale = NULL, .zero_point = 0 });
 }
 
-/* Thin wrapper around existing 1x1 conv kernel. */
+/* Pointwise weights repacked for the packed GEMM by mobilenet_pack_weights(),
+   looked up by their source blob. */
+#define MAX_PW_LAYERS 40
+#ifndef MOBILENET_PW_SCRATCH_BYTES
+#define MOBILENET_PW_SCRATCH_BYTES (64 * 1024)
+#endif
+
+typedef struct {
+    const uint8_t *src;
+    vecnn_packed_weights_int8_t packed;
+} pw_packed_t;
+
+static pw_packed_t pw_packed[MAX_PW_LAYERS];
+static size_t n_pw_packed;
+static int8_t pw_scratch[MOBILENET_PW_SCRATCH_BYTES] __attribute__((aligned(64)));
+
+static const vecnn_packed_weights_int8_t *pw_find_packed(const uint8_t *weights)
+{
+    for (size_t i = 0; i < n_pw_packed; ++i) {
+        if (pw_packed[i].src == weights) return &pw_packed[i].packed;
+    }
+    return NULL;
+}
+
+static void pw_pack(
+    const uint8_t *weights,
+    size_t Cin, size_t Cout,
+    const requantization_params_t *rq)
+{
+    if (!weights || !rq || !rq->scale || pw_find_packed(weights)) return;
+    if (n_pw_packed == MAX_PW_LAYERS) return;
+
+    void *buf = malloc(conv_1x1_int8_packed_size(Cin, Cout));
+    if (!buf) {
+        printf("WARN: no memory to pack %ux%u pointwise weights\n",
+               (unsigned)Cin, (unsigned)Cout);
+        return;
+    }
+    pw_packed_t *e = &pw_packed[n_pw_packed++];
+    e->src = weights;
+    conv_1x1_int8_pack(&e->packed, buf, Cin, Cout, weights, rq->scale);
+}
+
+/* 1x1 conv on the packed weights when mobilenet_pack_weights() packed them,
+   on the original blob otherwise. */
 static void pointwise_conv1x1_int8(
     size_t H, size_t W,
     size_t Cin, size_t Cout,
@@ -104,6 +173,19 @@ static void pointwise_conv1x1_int8(
     int8_t *output,
     const requantization_params_t *rq)
 {
+    const vecnn_packed_weights_int8_t *packed = pw_find_packed(weights);
+    if (packed) {
+        conv_1x1_int8_packed(
+            H, W,
+            input,
+            packed,
+            output,
+            /* relu */ 0,
+            rq->zero_point,
+            pw_scratch, sizeof(pw_scratch));
+        return;
+    }
+
     conv_1x1_int8(
         H, W,
         Cin, Cout,
@@ -134,14 +216,22 @@ typedef struct {
     const requantization_params_t *rq_pw;     /* also used for residual_add */
 } block_desc_t;
 
+/* Arena buffers of one block (see mobilenet_arena()). The fused path only
+   uses out; the unfused one writes every stage, each ReLU6 and the residual
+   add into the tensor the planner gave it (often in place). */
+typedef struct {
+    int8_t *expand, *expand6;   /* NULL without expansion */
+    int8_t *dw, *dw6;
+    int8_t *project, *project6;
+    int8_t *out;                /* project6, or the residual sum */
+} block_bufs_t;
+
 /* One block = [optional PW-expand] -> DW -> PW-proj (+ optional residual). */
 static void run_block(
     const block_desc_t *cfg,
     size_t in_h, size_t in_w, size_t in_ch,
     int8_t *input,
-    int8_t *buf0,
-    int8_t *buf1,
-    int8_t **out,
+    const block_bufs_t *bufs,
     size_t *out_h,
     size_t *out_w,
     size_t *out_ch)
@@ -150,6 +240,35 @@ static void run_block(
     const int has_expand = (cfg->expand > 1);
     printf("has expand: %d \n", has_expand);
 
+#if MOBILENET_FUSED_IR
+    /* Same stages and activations as the unfused path below. */
+    const requantization_params_t rq_none = { .scale = NULL, .zero_point = 0 };
+    const inverted_residual_params_t ir = {
+        .in_ch = in_ch, .hidden_ch = hidden_ch, .out_ch = cfg->out_ch,
+        .stride = cfg->stride,
+        .residual = cfg->use_residual && cfg->stride == 1 && in_ch == cfg->out_ch,
+        .w_expand = has_expand ? (const void *)cfg->w_expand : NULL,
+        .w_dw = (const void *)cfg->w_dw,
+        .w_project = (const void *)cfg->w_pw,
+        .pk_expand = has_expand ? pw_find_packed(cfg->w_expand) : NULL,
+        .pk_project = pw_find_packed(cfg->w_pw),
+        .rq_expand = cfg->rq_expand ? *cfg->rq_expand : rq_none,
+        .rq_dw = cfg->rq_dw ? *cfg->rq_dw : rq_none,
+        .rq_project = cfg->rq_pw ? *cfg->rq_pw : rq_none,
+        .act_expand = VECNN_ACT_RELU6,
+        .act_dw = VECNN_ACT_RELU6,
+        .act_project = VECNN_ACT_RELU6,
+    };
+    size_t strip_rows = inverted_residual_int8_strip_rows(&ir, in_h, in_w, sizeof(ir_scratch));
+
+    inverted_residual_int8(&ir, in_h, in_w, input, bufs->out, ir_scratch, strip_rows);
+
+    *out_h  = (in_h + cfg->stride - 1) / cfg->stride;
+    *out_w  = (in_w + cfg->stride - 1) / cfg->stride;
+    *out_ch = cfg->out_ch;
+    return;
+#endif
+
     /* 1) Expansion 1x1 (optional), output scale = rq_expand */
     int8_t *after_expand = input;
     if (has_expand) {
@@ -157,10 +276,10 @@ static void run_block(
             in_h, in_w,
             in_ch, hidden_ch,
             cfg->w_expand,
-            input, buf0,
+            input, bufs->expand,
             cfg->rq_expand);
-        relu6_apply_int8(buf0, hidden_ch, in_h, in_w, cfg->rq_expand);
-        after_expand = buf0;
+        relu6_apply_int8(bufs->expand, bufs->expand6, hidden_ch, in_h, in_w, cfg->rq_expand);
+        after_expand = bufs->expand6;
     }
 
     /* 2) Depthwise 3x3 stride {1,2} with SAME padding, output scale = rq_dw */
@@ -174,13 +293,13 @@ static void run_block(
         /* padding = SAME */ 1,
         (const void *)cfg->w_dw,
         after_expand,
-        buf1,
+        bufs->dw,
         /* relu */ 0,
         cfg->rq_dw ? *cfg->rq_dw
                    : (requantization_params_t){ .scale = NULL, .zero_point = 0 });
-    relu6_apply_int8(buf1, hidden_ch, dw_out_h, dw_out_w, cfg->rq_dw);
+    relu6_apply_int8(bufs->dw, bufs->dw6, hidden_ch, dw_out_h, dw_out_w, cfg->rq_dw);
 
-    print_int8_matrix(buf1, dw_out_h, dw_out_w);
+    print_int8_matrix(bufs->dw6, dw_out_h, dw_out_w);
     // print_int8_matrix(buf1 + dw_out_h * dw_out_w, dw_out_h, dw_out_w);
     // print_int8_matrix(buf1 + 2*dw_out_h * dw_out_w, dw_out_h, dw_out_w);
     // print_int8_matrix(buf1 + 3*dw_out_h * dw_out_w, dw_out_h, dw_out_w);
@@ -192,14 +311,14 @@ static void run_block(
         dw_out_h, dw_out_w,
         hidden_ch, cfg->out_ch,
         cfg->w_pw,
-        buf1, buf0,
+        bufs->dw6, bufs->project,
         cfg->rq_pw);
 
-    print_int8_matrix(buf0, dw_out_h, dw_out_w);
+    print_int8_matrix(bufs->project, dw_out_h, dw_out_w);
     // print_int8_matrix(buf0 + 1*dw_out_h*dw_out_w, dw_out_h, dw_out_w);
     // print_int8_matrix(buf0 + 2*dw_out_h*dw_out_w, dw_out_h, dw_out_w);
     
-    relu6_apply_int8(buf0, cfg->out_ch, dw_out_h, dw_out_w, cfg->rq_pw);
+    relu6_apply_int8(bufs->project, bufs->project6, cfg->out_ch, dw_out_h, dw_out_w, cfg->rq_pw);
 
     /* 4) Residual add (if used)
            We keep the SAME activation scale as cfg->rq_pw. */
@@ -208,13 +327,12 @@ static void run_block(
             dw_out_h, dw_out_w,
             cfg->out_ch,
             input,      /* skip-connection (already int8 at previous layer's scale) */
-            buf0,       /* block output */
-            buf0,       /* in-place */
+            bufs->project6, /* block output */
+            bufs->out,
             cfg->rq_pw ? *cfg->rq_pw
                        : (requantization_params_t){ .scale = NULL, .zero_point = 0 });
     }
 
-    *out    = buf0;
     *out_h  = dw_out_h;
     *out_w  = dw_out_w;
     *out_ch = cfg->out_ch;
@@ -250,13 +368,317 @@ void avgpool_global_7x7_int8(
     }
 }
 
+/* -------------------------------------------------------------------------- */
+/* Inverted residual stack                                                    */
+/* Each block uses per-layer rq_*: expand, dw, pw                             */
+/* -------------------------------------------------------------------------- */
+static const block_desc_t blocks[] = {
+    /* t=1, 32->16, stride=1, no residual (first block) */
+    {1, 16, 1, 0,
+     /* w_expand */ NULL,
+     /* w_dw     */ blocks_0_0_0_wb_q,
+     /* w_pw     */ blocks_0_1_0_wb_q,
+     /* rq_expand */ NULL,
+     /* rq_dw     */ &rq_blocks_0_0_0,
+     /* rq_pw     */ &rq_blocks_0_1_0},
+
+    /* t=6, 16->24, stride=2, no residual */
+    {6, 24, 2, 0,
+     blocks_1_0_0_wb_q,
+     blocks_1_1_0_wb_q,
+     blocks_1_2_0_wb_q,
+     &rq_blocks_1_0_0,
+     &rq_blocks_1_1_0,
+     &rq_blocks_1_2_0},
+
+    /* t=6, 24->24, stride=1, residual */
+    {6, 24, 1, 1,
+     blocks_2_0_0_wb_q,
+     blocks_2_1_0_wb_q,
+     blocks_2_2_0_wb_q,
+     &rq_blocks_2_0_0,
+     &rq_blocks_2_1_0,
+     &rq_blocks_2_2_0},
+
+    /* t=6, 24->32, stride=2, no residual */
+    {6, 32, 2, 0,
+     blocks_3_0_0_wb_q,
+     blocks_3_1_0_wb_q,
+     blocks_3_2_0_wb_q,
+     &rq_blocks_3_0_0,
+     &rq_blocks_3_1_0,
+     &rq_blocks_3_2_0},
+
+    /* t=6, 32->32, stride=1, residual */
+    {6, 32, 1, 1,
+     blocks_4_0_0_wb_q,
+     blocks_4_1_0_wb_q,
+     blocks_4_2_0_wb_q,
+     &rq_blocks_4_0_0,
+     &rq_blocks_4_1_0,
+     &rq_blocks_4_2_0},
+
+    {6, 32, 1, 1,
+     blocks_5_0_0_wb_q,
+     blocks_5_1_0_wb_q,
+     blocks_5_2_0_wb_q,
+     &rq_blocks_5_0_0,
+     &rq_blocks_5_1_0,
+     &rq_blocks_5_2_0},
+
+    {6, 64, 2, 0,
+     blocks_6_0_0_wb_q,
+     blocks_6_1_0_wb_q,
+     blocks_6_2_0_wb_q,
+     &rq_blocks_6_0_0,
+     &rq_blocks_6_1_0,
+     &rq_blocks_6_2_0},
+
+    {6, 64, 1, 1,
+     blocks_7_0_0_wb_q,
+     blocks_7_1_0_wb_q,
+     blocks_7_2_0_wb_q,
+     &rq_blocks_7_0_0,
+     &rq_blocks_7_1_0,
+     &rq_blocks_7_2_0},
+
+    {6, 64, 1, 1,
+     blocks_8_0_0_wb_q,
+     blocks_8_1_0_wb_q,
+     blocks_8_2_0_wb_q,
+     &rq_blocks_8_0_0,
+     &rq_blocks_8_1_0,
+     &rq_blocks_8_2_0},
+
+    {6, 64, 1, 1,
+     blocks_9_0_0_wb_q,
+     blocks_9_1_0_wb_q,
+     blocks_9_2_0_wb_q,
+     &rq_blocks_9_0_0,
+     &rq_blocks_9_1_0,
+     &rq_blocks_9_2_0},
+
+    {6, 96, 1, 0,
+     blocks_10_0_0_wb_q,
+     blocks_10_1_0_wb_q,
+     blocks_10_2_0_wb_q,
+     &rq_blocks_10_0_0,
+     &rq_blocks_10_1_0,
+     &rq_blocks_10_2_0},
+
+    {6, 96, 1, 1,
+     blocks_11_0_0_wb_q,
+     blocks_11_1_0_wb_q,
+     blocks_11_2_0_wb_q,
+     &rq_blocks_11_0_0,
+     &rq_blocks_11_1_0,
+     &rq_blocks_11_2_0},
+
+    {6, 96, 1, 1,
+     blocks_12_0_0_wb_q,
+     blocks_12_1_0_wb_q,
+     blocks_12_2_0_wb_q,
+     &rq_blocks_12_0_0,
+     &rq_blocks_12_1_0,
+     &rq_blocks_12_2_0},
+
+    {6, 160, 2, 0,
+     blocks_13_0_0_wb_q,
+     blocks_13_1_0_wb_q,
+     blocks_13_2_0_wb_q,
+     &rq_blocks_13_0_0,
+     &rq_blocks_13_1_0,
+     &rq_blocks_13_2_0},
+
+    {6, 160, 1, 1,
+     blocks_14_0_0_wb_q,
+     blocks_14_1_0_wb_q,
+     blocks_14_2_0_wb_q,
+     &rq_blocks_14_0_0,
+     &rq_blocks_14_1_0,
+     &rq_blocks_14_2_0},
+
+    {6, 160, 1, 1,
+     blocks_15_0_0_wb_q,
+     blocks_15_1_0_wb_q,
+     blocks_15_2_0_wb_q,
+     &rq_blocks_15_0_0,
+     &rq_blocks_15_1_0,
+     &rq_blocks_15_2_0},
+
+    {6, 320, 1, 0,
+     blocks_16_0_0_wb_q,
+     blocks_16_1_0_wb_q,
+     blocks_16_2_0_wb_q,
+     &rq_blocks_16_0_0,
+     &rq_blocks_16_1_0,
+     &rq_blocks_16_2_0},
+};
+
+#define N_BLOCKS (sizeof(blocks) / sizeof(blocks[0]))
+
+/* Repack every pointwise layer once, before the first forward pass. */
+static void mobilenet_pack_weights(void)
+{
+    size_t ch = 32;
+
+    pw_pack(stem_1_0_wb_q, 3, 32, &rq_stem_1_0);
+    for (size_t i = 0; i < N_BLOCKS; ++i) {
+        const size_t hidden = (blocks[i].expand == 0 ? ch : ch * blocks[i].expand);
+        if (blocks[i].expand > 1) {
+            pw_pack(blocks[i].w_expand, ch, hidden, blocks[i].rq_expand);
+        }
+        pw_pack(blocks[i].w_pw, hidden, blocks[i].out_ch, blocks[i].rq_pw);
+        ch = blocks[i].out_ch;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Activation arena                                                           */
+/* -------------------------------------------------------------------------- */
+/* Tensor ids of the stem; the block tensors follow (see mb_blocks). */
+enum {
+    T_INPUT_F32,
+    T_INPUT_Q,
+    T_STEM_DW,
+    T_STEM_DW6,
+    T_STEM_PW,
+    T_STEM_PW6,
+    T_BLOCK0,
+};
+/* Unfused blocks have up to 7 tensors and ops, fused ones 1. */
+#define N_TENSORS (T_BLOCK0 + 7 * N_BLOCKS)
+#define N_OPS     (5 + 7 * N_BLOCKS)
+
+/* Tensor ids of one block, -1 when the block has no such stage. */
+typedef struct {
+    int expand, expand6;
+    int dw, dw6;
+    int project, project6;
+    int out;
+} block_tensors_t;
+
+static vecnn_tensor_t mb_tensors[N_TENSORS];
+static vecnn_op_t mb_ops[N_OPS];
+static vecnn_graph_t mb_graph;
+static block_tensors_t mb_blocks[N_BLOCKS];
+
+#define ARENA_PTR(arena, id) ((int8_t *)vecnn_graph_tensor(&mb_graph, (arena), (int)(id)))
+
+/* Add block i reading tensor x (ch x h x w) to the graph. */
+static int mobilenet_add_block(vecnn_graph_t *g, size_t i, int x,
+                               size_t ch, size_t h, size_t w)
+{
+    const block_desc_t *cfg = &blocks[i];
+    block_tensors_t *t = &mb_blocks[i];
+    const size_t hidden = (cfg->expand == 0 ? ch : ch * cfg->expand);
+    const size_t oh = (h + cfg->stride - 1) / cfg->stride;
+    const size_t ow = (w + cfg->stride - 1) / cfg->stride;
+    const uint32_t out_flags = (i + 1 == N_BLOCKS) ? VECNN_TENSOR_OUTPUT : 0;
+
+    t->expand = t->expand6 = t->dw = t->dw6 = t->project = t->project6 = -1;
+
+#if MOBILENET_FUSED_IR
+    (void)hidden;
+    t->out = vecnn_graph_add_tensor(g, "block", cfg->out_ch, oh, ow, 1, out_flags);
+    vecnn_graph_add_op(g, VECNN_OP_INVERTED_RESIDUAL, "block", x, -1, t->out);
+#else
+    int dw_in = x;
+    if (cfg->expand > 1) {
+        t->expand = vecnn_graph_add_tensor(g, "expand", hidden, h, w, 1, 0);
+        t->expand6 = vecnn_graph_add_tensor(g, "expand6", hidden, h, w, 1, 0);
+        vecnn_graph_add_op(g, VECNN_OP_CONV1X1, "expand", x, -1, t->expand);
+        vecnn_graph_add_op(g, VECNN_OP_RELU6, "expand6", t->expand, -1, t->expand6);
+        dw_in = t->expand6;
+    }
+    t->dw = vecnn_graph_add_tensor(g, "dw", hidden, oh, ow, 1, 0);
+    t->dw6 = vecnn_graph_add_tensor(g, "dw6", hidden, oh, ow, 1, 0);
+    vecnn_graph_add_op(g, VECNN_OP_DWCONV3X3, "dw", dw_in, -1, t->dw);
+    vecnn_graph_add_op(g, VECNN_OP_RELU6, "dw6", t->dw, -1, t->dw6);
+
+    const int residual = cfg->use_residual && cfg->stride == 1 && ch == cfg->out_ch;
+    t->project = vecnn_graph_add_tensor(g, "project", cfg->out_ch, oh, ow, 1, 0);
+    t->project6 = vecnn_graph_add_tensor(g, "project6", cfg->out_ch, oh, ow, 1,
+                                         residual ? 0 : out_flags);
+    vecnn_graph_add_op(g, VECNN_OP_CONV1X1, "project", t->dw6, -1, t->project);
+    vecnn_graph_add_op(g, VECNN_OP_RELU6, "project6", t->project, -1, t->project6);
+    t->out = t->project6;
+    if (residual) {
+        t->out = vecnn_graph_add_tensor(g, "residual", cfg->out_ch, oh, ow, 1, out_flags);
+        vecnn_graph_add_op(g, VECNN_OP_RESIDUAL_ADD, "residual", t->project6, x, t->out);
+    }
+#endif
+    return t->out;
+}
+
+/* Describe the forward pass (fused or unfused blocks), plan it once and
+   allocate a single arena of the planned size for all activations. */
+static int8_t *mobilenet_arena(void)
+{
+    static int8_t *arena = NULL;
+    vecnn_graph_t *g = &mb_graph;
+    size_t h = 224, w = 224, ch = 3;
+
+    if (arena) return arena;
+
+    vecnn_graph_init(g, mb_tensors, N_TENSORS, mb_ops, N_OPS);
+
+    vecnn_graph_add_tensor(g, "input_f32", ch, h, w, sizeof(float),
+                           VECNN_TENSOR_INPUT | VECNN_TENSOR_EXTERNAL);
+    vecnn_graph_add_tensor(g, "input_q", ch, h, w, 1, 0);
+    h = (h + 2 - 3) / 2 + 1;
+    w = (w + 2 - 3) / 2 + 1;
+    vecnn_graph_add_tensor(g, "stem_dw", ch, h, w, 1, 0);
+    vecnn_graph_add_tensor(g, "stem_dw_relu6", ch, h, w, 1, 0);
+    vecnn_graph_add_tensor(g, "stem_pw", 32, h, w, 1, 0);
+    vecnn_graph_add_tensor(g, "stem_pw_relu6", 32, h, w, 1, 0);
+
+    vecnn_graph_add_op(g, VECNN_OP_QUANT, "quant", T_INPUT_F32, -1, T_INPUT_Q);
+    vecnn_graph_add_op(g, VECNN_OP_DWCONV3X3, "stem.0", T_INPUT_Q, -1, T_STEM_DW);
+    vecnn_graph_add_op(g, VECNN_OP_RELU6, "stem.0.relu6", T_STEM_DW, -1, T_STEM_DW6);
+    vecnn_graph_add_op(g, VECNN_OP_CONV1X1, "stem.1", T_STEM_DW6, -1, T_STEM_PW);
+    vecnn_graph_add_op(g, VECNN_OP_RELU6, "stem.1.relu6", T_STEM_PW, -1, T_STEM_PW6);
+
+    int x = T_STEM_PW6;
+    ch = 32;
+    for (size_t i = 0; i < N_BLOCKS; ++i) {
+        x = mobilenet_add_block(g, i, x, ch, h, w);
+        h = (h + blocks[i].stride - 1) / blocks[i].stride;
+        w = (w + blocks[i].stride - 1) / blocks[i].stride;
+        ch = blocks[i].out_ch;
+    }
+
+    if (vecnn_graph_plan(g) != 0) {
+        printf("ERROR: arena plan failed\n");
+        return NULL;
+    }
+    vecnn_graph_report(g);
+
+    arena = (int8_t *)malloc(g->arena_bytes);
+    if (!arena) {
+        printf("ERROR: arena allocation (%u bytes) failed\n", (unsigned)g->arena_bytes);
+    }
+    return arena;
+}
+
+/* Arena pointer of tensor id, NULL for an absent stage. */
+static int8_t *arena_ptr_or_null(int8_t *arena, int id)
+{
+    return id < 0 ? NULL : ARENA_PTR(arena, id);
+}
+
 /* -------------------------------------------------------------------------- */
 /* Forward pass                                                               */
 /* -------------------------------------------------------------------------- */
 void mobilenet_forward(const float *input_f32, float *logits_f32)
 {
-    static int8_t buf0[MAX_INT8_BUFFER];
-    static int8_t buf1[MAX_INT8_BUFFER];
+    int8_t *arena = mobilenet_arena();
+    if (!arena) return;
+    int8_t *input_q = ARENA_PTR(arena, T_INPUT_Q);
+    int8_t *stem_dw = ARENA_PTR(arena, T_STEM_DW);
+    int8_t *stem_dw6 = ARENA_PTR(arena, T_STEM_DW6);
+    int8_t *stem_pw = ARENA_PTR(arena, T_STEM_PW);
+    int8_t *stem_pw6 = ARENA_PTR(arena, T_STEM_PW6);
     static int8_t pooled[1280];
     static int8_t logits_q[10];
 
@@ -266,7 +688,7 @@ void mobilenet_forward(const float *input_f32, float *logits_f32)
     quant_f32(
         BATCHES * ch * h * w,
         (float *)input_f32,
-        buf0,
+        input_q,
         qp_input);
 
     // print_int8_matrix(buf0 + 2*h*w, h, w);
@@ -285,12 +707,12 @@ void mobilenet_forward(const float *input_f32, float *logits_f32)
         /* stride */ 2,
         /* padding */ 1,
         (const void *)stem_0_0_wb_q,
-        buf0,
-        buf1,
+        input_q,
+        stem_dw,
         /* relu */ 0,
         rq_stem_0_0);
-    compare(COMPARE0, buf1, COMPARE0_LEN);
-    relu6_apply_int8(buf1, ch, stem_h, stem_w, &rq_stem_0_0);
+    compare(COMPARE0, stem_dw, COMPARE0_LEN);
+    relu6_apply_int8(stem_dw, stem_dw6, ch, stem_h, stem_w, &rq_stem_0_0);
 
     // print_int8_matrix(buf1, h/2, w/2);
     // print_int8_matrix(buf1 + h*w/4, h/2, w/2);
@@ -301,10 +723,10 @@ void mobilenet_forward(const float *input_f32, float *logits_f32)
         stem_h, stem_w,
         ch, 32,
         stem_1_0_wb_q,
-        buf1, buf0,
+        stem_dw6, stem_pw,
         &rq_stem_1_0);
-    compare(COMPARE1, buf0, COMPARE1_LEN);
-    relu6_apply_int8(buf0, 32, stem_h, stem_w, &rq_stem_1_0);
+    compare(COMPARE1, stem_pw, COMPARE1_LEN);
+    relu6_apply_int8(stem_pw, stem_pw6, 32, stem_h, stem_w, &rq_stem_1_0);
 
     // print_int8_matrix(buf0, stem_h, stem_w);
     // print_int8_matrix(buf0 + stem_h * stem_w, stem_h, stem_w);
@@ -321,158 +743,25 @@ void mobilenet_forward(const float *input_f32, float *logits_f32)
     /* Inverted residual stack                                            */
     /* Each block uses per-layer rq_*: expand, dw, pw                     */
     /* ------------------------------------------------------------------ */
-    static const block_desc_t blocks[] = {
-        /* t=1, 32->16, stride=1, no residual (first block) */
-        {1, 16, 1, 0,
-         /* w_expand */ NULL,
-         /* w_dw     */ blocks_0_0_0_wb_q,
-         /* w_pw     */ blocks_0_1_0_wb_q,
-         /* rq_expand */ NULL,
-         /* rq_dw     */ &rq_blocks_0_0_0,
-         /* rq_pw     */ &rq_blocks_0_1_0},
-
-        /* t=6, 16->24, stride=2, no residual */
-        {6, 24, 2, 0,
-         blocks_1_0_0_wb_q,
-         blocks_1_1_0_wb_q,
-         blocks_1_2_0_wb_q,
-         &rq_blocks_1_0_0,
-         &rq_blocks_1_1_0,
-         &rq_blocks_1_2_0},
-
-        /* t=6, 24->24, stride=1, residual */
-        {6, 24, 1, 1,
-         blocks_2_0_0_wb_q,
-         blocks_2_1_0_wb_q,
-         blocks_2_2_0_wb_q,
-         &rq_blocks_2_0_0,
-         &rq_blocks_2_1_0,
-         &rq_blocks_2_2_0},
-
-        /* t=6, 24->32, stride=2, no residual */
-        {6, 32, 2, 0,
-         blocks_3_0_0_wb_q,
-         blocks_3_1_0_wb_q,
-         blocks_3_2_0_wb_q,
-         &rq_blocks_3_0_0,
-         &rq_blocks_3_1_0,
-         &rq_blocks_3_2_0},
-
-        /* t=6, 32->32, stride=1, residual */
-        {6, 32, 1, 1,
-         blocks_4_0_0_wb_q,
-         blocks_4_1_0_wb_q,
-         blocks_4_2_0_wb_q,
-         &rq_blocks_4_0_0,
-         &rq_blocks_4_1_0,
-         &rq_blocks_4_2_0},
-
-        {6, 32, 1, 1,
-         blocks_5_0_0_wb_q,
-         blocks_5_1_0_wb_q,
-         blocks_5_2_0_wb_q,
-         &rq_blocks_5_0_0,
-         &rq_blocks_5_1_0,
-         &rq_blocks_5_2_0},
-
-        {6, 64, 2, 0,
-         blocks_6_0_0_wb_q,
-         blocks_6_1_0_wb_q,
-         blocks_6_2_0_wb_q,
-         &rq_blocks_6_0_0,
-         &rq_blocks_6_1_0,
-         &rq_blocks_6_2_0},
-
-        {6, 64, 1, 1,
-         blocks_7_0_0_wb_q,
-         blocks_7_1_0_wb_q,
-         blocks_7_2_0_wb_q,
-         &rq_blocks_7_0_0,
-         &rq_blocks_7_1_0,
-         &rq_blocks_7_2_0},
-
-        {6, 64, 1, 1,
-         blocks_8_0_0_wb_q,
-         blocks_8_1_0_wb_q,
-         blocks_8_2_0_wb_q,
-         &rq_blocks_8_0_0,
-         &rq_blocks_8_1_0,
-         &rq_blocks_8_2_0},
-
-        {6, 64, 1, 1,
-         blocks_9_0_0_wb_q,
-         blocks_9_1_0_wb_q,
-         blocks_9_2_0_wb_q,
-         &rq_blocks_9_0_0,
-         &rq_blocks_9_1_0,
-         &rq_blocks_9_2_0},
-
-        {6, 96, 1, 0,
-         blocks_10_0_0_wb_q,
-         blocks_10_1_0_wb_q,
-         blocks_10_2_0_wb_q,
-         &rq_blocks_10_0_0,
-         &rq_blocks_10_1_0,
-         &rq_blocks_10_2_0},
-
-        {6, 96, 1, 1,
-         blocks_11_0_0_wb_q,
-         blocks_11_1_0_wb_q,
-         blocks_11_2_0_wb_q,
-         &rq_blocks_11_0_0,
-         &rq_blocks_11_1_0,
-         &rq_blocks_11_2_0},
-
-        {6, 96, 1, 1,
-         blocks_12_0_0_wb_q,
-         blocks_12_1_0_wb_q,
-         blocks_12_2_0_wb_q,
-         &rq_blocks_12_0_0,
-         &rq_blocks_12_1_0,
-         &rq_blocks_12_2_0},
-
-        {6, 160, 2, 0,
-         blocks_13_0_0_wb_q,
-         blocks_13_1_0_wb_q,
-         blocks_13_2_0_wb_q,
-         &rq_blocks_13_0_0,
-         &rq_blocks_13_1_0,
-         &rq_blocks_13_2_0},
-
-        {6, 160, 1, 1,
-         blocks_14_0_0_wb_q,
-         blocks_14_1_0_wb_q,
-         blocks_14_2_0_wb_q,
-         &rq_blocks_14_0_0,
-         &rq_blocks_14_1_0,
-         &rq_blocks_14_2_0},
-
-        {6, 160, 1, 1,
-         blocks_15_0_0_wb_q,
-         blocks_15_1_0_wb_q,
-         blocks_15_2_0_wb_q,
-         &rq_blocks_15_0_0,
-         &rq_blocks_15_1_0,
-         &rq_blocks_15_2_0},
-
-        {6, 320, 1, 0,
-         blocks_16_0_0_wb_q,
-         blocks_16_1_0_wb_q,
-         blocks_16_2_0_wb_q,
-         &rq_blocks_16_0_0,
-         &rq_blocks_16_1_0,
-         &rq_blocks_16_2_0},
-    };
 
-    int8_t *cur = buf0;
-    for (size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
-        int8_t *out = NULL;
+    int8_t *cur = stem_pw6;
+    for (size_t i = 0; i < N_BLOCKS; ++i) {
+        const block_tensors_t *t = &mb_blocks[i];
+        const block_bufs_t bufs = {
+            .expand   = arena_ptr_or_null(arena, t->expand),
+            .expand6  = arena_ptr_or_null(arena, t->expand6),
+            .dw       = arena_ptr_or_null(arena, t->dw),
+            .dw6      = arena_ptr_or_null(arena, t->dw6),
+            .project  = arena_ptr_or_null(arena, t->project),
+            .project6 = arena_ptr_or_null(arena, t->project6),
+            .out      = ARENA_PTR(arena, t->out),
+        };
+        int8_t *out = bufs.out;
+
         run_block(&blocks[i],
                   h, w, ch,
                   cur,
-                  buf0,
-                  buf1,
-                  &out,
+                  &bufs,
                   &h, &w, &ch);
         if (i < 5) {
             printf("i: %d\n", i);
@@ -534,6 +823,8 @@ int main(void)
 
     printf("Loaded Sample\n");
 
+    mobilenet_pack_weights();
+
     mobilenet_forward(input_f32, logits_f32);
 
     printf("Completed Forward Pass\n");
@@ -23,6 +23,9 @@ void test_dispatch_capacity_stress(void);
 void test_barrier_repeated_stress(void);
 void test_mixed_mode_stress(void);
 void test_api_edge_cases(void);
+void test_parallel_for_coverage(void);
+void test_group_join_isolation(void);
+void test_idle_sleep_wake(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,139 @@
+/*
+ * test_parallel.c - parallel_for and task-group tests for thread-lib.
+ */
+#include "tests.h"
+#include "hthread.h"
+#include "riscv.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// ----------------------
+// Test: parallel_for covers every index exactly once
+// ----------------------
+
+#define PFOR_N 1000u
+
+static volatile uint8_t pfor_hits[PFOR_N];
+static volatile uint32_t pfor_chunks_per_hart[N_HARTS];
+static volatile uint32_t pfor_bad_chunks = 0;
+
+static void pfor_body(size_t begin, size_t end, void *ctx) {
+    size_t grain = (size_t)(uintptr_t)ctx;
+    uint32_t mhartid = (uint32_t)READ_CSR("mhartid");
+
+    if (end - begin > grain || begin >= end) {
+        __sync_fetch_and_add(&pfor_bad_chunks, 1);
+    }
+    for (size_t i = begin; i < end; i++) {
+        pfor_hits[i]++;
+    }
+    // Make each chunk long enough for the other harts to steal.
+    for (volatile uint32_t d = 0; d < 2000u; d++) {
+        asm volatile("nop");
+    }
+    if (mhartid < N_HARTS) {
+        __sync_fetch_and_add(&pfor_chunks_per_hart[mhartid], 1);
+    }
+}
+
+void test_parallel_for_coverage(void) {
+    printf("\n[TEST] parallel_for index coverage...\n");
+
+    const size_t grains[] = {1u, 7u, 64u, 0u};
+    int pass = 1;
+
+    for (uint32_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        for (uint32_t i = 0; i < PFOR_N; i++) {
+            pfor_hits[i] = 0;
+        }
+        for (uint32_t h = 0; h < N_HARTS; h++) {
+            pfor_chunks_per_hart[h] = 0;
+        }
+        pfor_bad_chunks = 0;
+
+        size_t grain = grains[g];
+        size_t limit = grain ? grain : PFOR_N;
+        hthread_parallel_for(0, PFOR_N, grain, pfor_body, (void *)(uintptr_t)limit);
+
+        uint32_t wrong = 0;
+        for (uint32_t i = 0; i < PFOR_N; i++) {
+            if (pfor_hits[i] != 1u) {
+                wrong++;
+            }
+        }
+        if (wrong != 0 || pfor_bad_chunks != 0) {
+            pass = 0;
+            printf("[FAIL] parallel_for grain=%u: %u index(es) not hit once, %u bad chunk(s)\n",
+                   (uint32_t)grain, wrong, pfor_bad_chunks);
+        }
+
+        printf("[INFO] grain=%u chunks per hart:", (uint32_t)grain);
+        for (uint32_t h = 0; h < N_HARTS; h++) {
+            printf(" %u", pfor_chunks_per_hart[h]);
+        }
+        printf("\n");
+    }
+
+    if (pass) {
+        printf("[PASS] parallel_for_coverage: every index processed exactly once.\n");
+    }
+}
+
+// ----------------------
+// Test: group wait only joins its own children
+// ----------------------
+
+static volatile uint32_t group_children_done = 0;
+static volatile uint32_t group_blocker_release = 0;
+static volatile uint32_t group_blocker_done = 0;
+
+static void group_child_task(void *arg) {
+    (void)arg;
+    __sync_fetch_and_add(&group_children_done, 1);
+}
+
+// Pinned to hart1 and held open until the group has been joined.
+static void group_blocker_task(void *arg) {
+    (void)arg;
+    uint64_t spin = 0;
+    while (group_blocker_release == 0u && spin < 50000000ull) {
+        asm volatile("nop");
+        spin++;
+    }
+    group_blocker_done = 1;
+}
+
+void test_group_join_isolation(void) {
+    printf("\n[TEST] task group joins only its own children...\n");
+
+    group_children_done = 0;
+    group_blocker_release = 0;
+    group_blocker_done = 0;
+
+    hthread_issue(1, group_blocker_task, NULL);
+
+    const uint32_t N = 32;
+    hthread_group_t group;
+    hthread_group_init(&group);
+    for (uint32_t i = 0; i < N; i++) {
+        hthread_group_spawn(&group, group_child_task, NULL);
+    }
+    hthread_group_wait(&group);
+
+    int pass = 1;
+    if (group_children_done != N) {
+        pass = 0;
+        printf("[FAIL] group_join: %u/%u children done after wait\n", group_children_done, N);
+    }
+    if (group_blocker_done != 0u) {
+        pass = 0;
+        printf("[FAIL] group_join: wait also waited for unrelated hart1 work\n");
+    }
+
+    group_blocker_release = 1;
+    hthread_join(1);
+
+    if (pass) {
+        printf("[PASS] group_join_isolation: group wait ignored unrelated tasks.\n");
+    }
+}
@@ -1,3 +1,106 @@
 /*
- * test_sleep.c - Placeholder for future sleep/idle behavior tests.
+ * test_sleep.c - Idle sleep/wake behavior tests for thread-lib.
  */
+#include "tests.h"
+#include "hthread.h"
+#include "riscv.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define SLEEP_WAIT_POLLS 2000000u
+
+static volatile uint32_t sleep_task_hart = 0xFFFFFFFFu;
+
+static void sleep_probe_task(void *arg) {
+    (void)arg;
+    sleep_task_hart = (uint32_t)READ_CSR("mhartid");
+}
+
+#define SLEEP_BARRIER_ROUNDS 8u
+
+static void sleep_barrier_task(void *arg) {
+    (void)arg;
+    for (uint32_t r = 0; r < SLEEP_BARRIER_ROUNDS; r++) {
+        hthread_barrier();
+    }
+}
+
+// Poll until hart `h` has gone to sleep at least `count` times.
+static int wait_for_sleeps(uint32_t h, uint32_t count) {
+    hthread_idle_stats_t st;
+    for (uint32_t i = 0; i < SLEEP_WAIT_POLLS; i++) {
+        hthread_idle_stats(h, &st);
+        if (st.sleeps >= count) {
+            return 1;
+        }
+        asm volatile("nop");
+    }
+    return 0;
+}
+
+// ----------------------
+// Test: an idle hart parks in wfi and an issued task wakes it
+// ----------------------
+
+void test_idle_sleep_wake(void) {
+    printf("\n[TEST] idle sleep and MSIP wake-up...\n");
+
+    if (N_HARTS < 2) {
+        printf("[SKIP] idle_sleep_wake: needs at least 2 harts.\n");
+        return;
+    }
+
+    int pass = 1;
+    hthread_idle_stats_t st;
+
+    hthread_set_idle_policy(16u, 16u);
+    hthread_idle_stats_reset();
+
+    if (!wait_for_sleeps(1, 1)) {
+        pass = 0;
+        printf("[FAIL] hart1 never entered wfi with an empty queue.\n");
+    }
+
+    sleep_task_hart = 0xFFFFFFFFu;
+    hthread_issue(1, sleep_probe_task, 0);
+    hthread_join(1);
+
+    if (sleep_task_hart != 1u) {
+        pass = 0;
+        printf("[FAIL] issued task ran on hart %u, expected hart 1.\n", sleep_task_hart);
+    }
+
+    // Hart0 arrives late at every barrier, so the others exhaust their tiny
+    // spin budget and must be woken by the last arrival.
+    for (uint32_t h = 1; h < N_HARTS; h++) {
+        hthread_issue(h, sleep_barrier_task, 0);
+    }
+    for (uint32_t r = 0; r < SLEEP_BARRIER_ROUNDS; r++) {
+        for (volatile uint32_t d = 0; d < 20000u; d++) {
+            asm volatile("nop");
+        }
+        hthread_barrier();
+    }
+    for (uint32_t h = 1; h < N_HARTS; h++) {
+        hthread_join(h);
+    }
+
+    hthread_idle_stats(1, &st);
+    printf("[INFO] hart1: sleeps=%u wakeups=%u idle=%llu sleep=%llu cycles\n",
+           st.sleeps, st.wakeups,
+           (unsigned long long)st.idle_cycles, (unsigned long long)st.sleep_cycles);
+    if (st.wakeups != 0u) {
+        printf("[INFO] hart1 wake latency: avg=%llu max=%llu cycles\n",
+               (unsigned long long)(st.wake_latency_total / st.wakeups),
+               (unsigned long long)st.wake_latency_max);
+    } else {
+        pass = 0;
+        printf("[FAIL] hart1 slept but no wake-up was recorded.\n");
+    }
+
+    hthread_set_idle_policy(HTHREAD_IDLE_SPIN_BUDGET, HTHREAD_BARRIER_SPIN_BUDGET);
+
+    if (pass) {
+        printf("[PASS] idle_sleep_wake: hart1 slept when idle and woke for new work.\n");
+    }
+}
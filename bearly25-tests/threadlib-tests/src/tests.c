@@ -21,9 +21,12 @@ void run_all_tests(void) {
         test_join_completion_semantics();
         test_dispatch_capacity_stress();
         test_mixed_mode_stress();
+        test_group_join_isolation();
+        test_idle_sleep_wake();
     } else {
         printf("\n[SKIP] multicore stress tests: work-stealing check did not pass.\n");
     }
+    test_parallel_for_coverage();
     test_api_edge_cases();
 
     printf("\n[INFO] All tests completed.\n");
@@ -2,8 +2,17 @@
 #include "pll.h"
 #include "gpio.h"
 #include "chip_config.h"
+#include "hthread.h"
 #include <stdbool.h>
 
+#ifndef BMARK_PROF
+#define BMARK_PROF 0
+#endif
+
+#if BMARK_PROF
+#include "prof.h"
+#endif
+
 #define BMARK_GPIO_PIN GPIO_PIN_1
 
 long chip_freq;
@@ -45,7 +54,7 @@ test_info init_test(UART_Type *UARTx) {
     uart_init(debug_uart, &UART_init_config);
 
     // Wake up all the secondary HARTs
-    for (int i = 1; i < 4; i++) {
+    for (int i = 1; i < N_HARTS; i++) {
       CLINT->MSIP[i] = 1;
     }
     first_iteration = false;
@@ -113,6 +122,10 @@ test_info init_test(UART_Type *UARTx) {
 }
 
 void start_roi() {
+#if BMARK_PROF
+  // Outside the GPIO-marked ROI, so the host-timed window never includes the region bookkeeping.
+  PROF_BEGIN("roi");
+#endif
   char start_char = 7;
   uart_transmit(debug_uart, &start_char, 1, 0);
   gpio_write_pin(GPIOC, BMARK_GPIO_PIN, 0);
@@ -122,6 +135,9 @@ void end_roi() {
   gpio_write_pin(GPIOC, BMARK_GPIO_PIN, 1);
   char end_char = 23;
   uart_transmit(debug_uart, &end_char, 1, 0);
+#if BMARK_PROF
+  PROF_END();
+#endif
 }
 
 void xmit_payload_packet(void* data, size_t size) {
@@ -8,6 +8,8 @@
 #include "c2c_shm.h"
 #include "c2c_turnsync.h"
 #include "kws_stream_proto.h"
+#define KWS_STREAM_RING_LOG(...) KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] " __VA_ARGS__)
+#include "kws_stream_ring.h"
 
 #if KWS_BEARLY_ROLLING_DEBUG_INPUT_COMPARE || KWS_BEARLY_ROLLING_USE_GOLDEN_INPUT || KWS_BEARLY_ROLLING_CALIBRATE_FULL
 #include "tinyspeech_inputs.h" /* g_tinyspeech_test_inputs[]: the exact int8 MFCC maps Spike ran on */
@@ -163,6 +165,8 @@ static uint8_t g_input_compared; /* print the DSP-vs-reference input diff only o
 #endif
 
 static uint32_t g_last_consumed;
+static int32_t  g_rx_expected_label;  /* expected_label of the case in g_case */
+static int32_t  g_rx_ref_case_index;  /* ref_case_index of the case in g_case */
 static uint32_t g_last_pred_class;
 static uint32_t g_last_pred_score_q;
 static float    g_last_pred_score;   /* winning raw logit (softmax off) — used by the confidence gate */
@@ -180,25 +184,88 @@ static inline uint64_t rdcycle64(void) {
   return x;
 }
 
-/* Remote-write our ack (+ result) into the DSP spad; ack_index is written before the turn flip. */
-static void send_ack(uint32_t idx) {
+/* Stage our result words for the DSP spad; the caller stages ack_index itself. */
+static void send_ack(c2c_tx_t *tx) {
   uint64_t rx_cycle = rdcycle64();
+  volatile uint32_t *rx_cycle_words = (volatile uint32_t *)&g_dsp->bml_rx_cycle;
 
-  c2c_remote_write_u32(&g_dsp->bml_pred_class, g_last_pred_class);
-  c2c_remote_write_u32(&g_dsp->bml_pred_score_q, g_last_pred_score_q);
-  c2c_remote_write_block(&g_dsp->bml_rx_cycle, &rx_cycle, sizeof(rx_cycle));
-  c2c_remote_write_u32(&g_dsp->ack_index, idx);
+  c2c_tx_stage_u32(tx, &g_dsp->bml_pred_class, g_last_pred_class);
+  c2c_tx_stage_u32(tx, &g_dsp->bml_pred_score_q, g_last_pred_score_q);
+  c2c_tx_stage_u32(tx, &rx_cycle_words[0], (uint32_t)rx_cycle);
+  c2c_tx_stage_u32(tx, &rx_cycle_words[1], (uint32_t)(rx_cycle >> 32));
 }
 
-/* Hand the turn back to DSP: write our ack/result, then flip the turn register (peer spad = commit,
- * then our own spad = "not ours"), then wake DSP. */
+#if !KWS_STREAM_USE_RING
+/* Hand the turn back to DSP: ack/result words and the turn register go out as one transaction
+ * (turn is the commit word, so DSP sees it only after the ack), then our own spad = "not ours",
+ * then wake DSP. */
 static void handoff_to_dsp(uint32_t ack_idx) {
-  send_ack(ack_idx);
-  c2c_remote_write_u32(&g_dsp->turn, C2C_TURN_DSP); /* commit: DSP's turn, in DSP's spad */
+  c2c_tx_t tx;
+
+  c2c_tx_begin(&tx);
+  send_ack(&tx);
+  c2c_tx_stage_u32(&tx, &g_dsp->ack_index, ack_idx); /* lands before the turn flip */
+  c2c_tx_stage_commit(&tx, &g_dsp->turn, C2C_TURN_DSP); /* commit: DSP's turn, in DSP's spad */
+  c2c_tx_commit(&tx);
   c2c_local_write_u32(&g_bml->turn, C2C_TURN_DSP);  /* our own spad: no longer our turn */
   c2c_wake_peer();
 }
 
+/* Turn mode: wait for our turn AND a NEW case (case_index advanced), then verify it into g_case.
+ * A duplicate grant (turn==BML but case_index already consumed) means our previous ack was lost ->
+ * re-ack WITHOUT re-inferring, so DSP's self-heal re-grant is absorbed idempotently. */
+static uint32_t turn_receive_case(void) {
+  for (;;) {
+    uint32_t idx = 0u;
+    uint32_t checksum;
+
+    for (;;) {
+      uint32_t turn;
+      c2c_invalidate_range(g_bml, KWS_STREAM_CONTROL_CLEAR_BYTES); /* turn + case_index */
+      turn = g_bml->turn;
+      idx = g_bml->case_index;
+      if (turn == C2C_TURN_BML) {
+        if (idx > g_last_consumed) {
+          break; /* genuinely new case -> verify it below */
+        }
+        /* Duplicate grant (a lost ack). Re-hand-back so DSP advances; do not re-infer. */
+        KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] dup grant case_index=%u (last_consumed=%u); re-acking\n",
+                               (unsigned)idx, (unsigned)g_last_consumed);
+        handoff_to_dsp(g_last_consumed);
+      }
+      c2c_sleep_until_tick(); /* wake on DSP's grant MSIP or the periodic timer */
+    }
+
+    checksum = g_bml->payload_checksum;
+    if (c2c_local_read_block_verify(g_case, g_bml->case_payload, KWS_CASE_PAYLOAD_BYTES, checksum)) {
+      g_rx_expected_label = (int32_t)g_bml->expected_label;
+      g_rx_ref_case_index = (int32_t)g_bml->ref_case_index;
+      return idx;
+    }
+    /* Torn read after retries (rare). Re-ack last so DSP re-grants; static payload re-reads clean. */
+    KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] verify FAILED case_index=%u checksum=0x%08lx; re-acking last=%u\n",
+                           (unsigned)idx, (unsigned long)checksum, (unsigned)g_last_consumed);
+    handoff_to_dsp(g_last_consumed);
+  }
+}
+
+#else
+/* Ring mode (kws_stream_proto.h, state machine in kws_stream_ring.h): cases arrive in slot
+ * (n-1)%SLOTS of our own spad; DSP keeps producing while we infer, so there is no turn to hand
+ * back, only an ack (with our result words) that frees a slot. */
+static kws_stream_ring_consumer_t g_ring;
+
+/* Receive the next verified case into g_case, with its slot's header telemetry. */
+static uint32_t ring_receive_case(void) {
+  uint32_t idx = kws_stream_ring_receive(&g_ring, g_case);
+  kws_stream_ring_slot_t *slot = &g_ring.ring->slot[kws_stream_ring_slot_of(idx)];
+
+  g_rx_expected_label = (int32_t)slot->expected_label;
+  g_rx_ref_case_index = (int32_t)slot->ref_case_index;
+  return idx;
+}
+#endif
+
 static void run_inference(uint32_t case_index) {
   uint8_t shape[4] = {1, 1, KWS_MFCC_DIM, KWS_FRAMES_PER_CASE};
   Tensor input;
@@ -364,6 +431,12 @@ void app_main(void) {
    * which also removes the stale-SRAM / boot-order hazard. */
   c2c_local_write_u32(&g_bml->turn, C2C_TURN_DSP);
   c2c_local_write_u32(&g_bml->case_index, 0u);
+#if KWS_STREAM_USE_RING
+  kws_stream_ring_consumer_init(&g_ring,
+                                (kws_stream_ring_bml_spad_t *)(uintptr_t)KWS_STREAM_BML_SPAD_BASE,
+                                g_dsp, send_ack);
+  kws_stream_ring_boot_clear(&g_ring);
+#endif
   KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] DEBUG cleared own 0xD control (turn=DSP, case_index=0)\n");
 
   /* Arm MSIP + timer wake before any wfi. */
@@ -373,40 +446,16 @@ void app_main(void) {
    * spad until it sees this. */
   KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] DEBUG grace done; announcing bml_ready -> DSP spad\n");
   c2c_remote_write_u32(&g_dsp->bml_ready, KWS_STREAM_READY_MAGIC);
-  KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] DEBUG bml_ready announced; entering turn-taking loop\n");
+  KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] DEBUG bml_ready announced; entering consumer loop\n");
 
-  /* Turn-taking consumer loop. Wait for our turn AND a NEW case (case_index advanced). A duplicate
-   * grant (turn==BML but case_index already consumed) means our previous ack was lost -> re-ack
-   * WITHOUT re-inferring, so DSP's self-heal re-grant is absorbed idempotently. */
+  /* Consumer loop: receive the next verified case into g_case (ring slot or turn grant), infer,
+   * then ack it (ring: frees the slot; turn: hands the turn back). */
   while (1) {
-    uint32_t idx = 0u;
-    uint32_t checksum;
-
-    for (;;) {
-      uint32_t turn;
-      c2c_full_flush();
-      turn = g_bml->turn;
-      idx = g_bml->case_index;
-      if (turn == C2C_TURN_BML) {
-        if (idx > g_last_consumed) {
-          break; /* genuinely new case -> process it below */
-        }
-        /* Duplicate grant (a lost ack). Re-hand-back so DSP advances; do not re-infer. */
-        KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] dup grant case_index=%u (last_consumed=%u); re-acking\n",
-                               (unsigned)idx, (unsigned)g_last_consumed);
-        handoff_to_dsp(g_last_consumed);
-      }
-      c2c_sleep_until_tick(); /* wake on DSP's grant MSIP or the periodic timer */
-    }
-
-    checksum = g_bml->payload_checksum;
-    if (!c2c_local_read_block_verify(g_case, g_bml->case_payload, KWS_CASE_PAYLOAD_BYTES, checksum)) {
-      /* Torn read after retries (rare). Re-ack last so DSP re-grants; static payload re-reads clean. */
-      KWS_BEARLY_ROLLING_LOG("[bearly-kws-stream] verify FAILED case_index=%u checksum=0x%08lx; re-acking last=%u\n",
-                             (unsigned)idx, (unsigned long)checksum, (unsigned)g_last_consumed);
-      handoff_to_dsp(g_last_consumed);
-      continue;
-    }
+#if KWS_STREAM_USE_RING
+    uint32_t idx = ring_receive_case();
+#else
+    uint32_t idx = turn_receive_case();
+#endif
 
 #if KWS_BEARLY_ROLLING_DEBUG_INPUT_COMPARE
     /* Per case: compare the received (DSP-computed) MFCC map against its MATCHING reference feature
@@ -415,7 +464,7 @@ void app_main(void) {
      * (window/hop, mel bank, log, DCT, quant recipe) diverging from the reference extractor. Falls
      * back to REF_CASE_INDEX if DSP sent no valid index (e.g. an older producer). */
     {
-      int32_t rci = (int32_t)g_bml->ref_case_index;
+      int32_t rci = g_rx_ref_case_index;
       if ((rci < 0) || (rci >= (int32_t)TINYSPEECH_TEST_NUM_CASES)) {
         rci = (int32_t)KWS_BEARLY_ROLLING_REF_CASE_INDEX;
       }
@@ -476,10 +525,10 @@ void app_main(void) {
     g_last_consumed = idx;
 
 #if KWS_BEARLY_ROLLING_CHECK_EXPECTED
-    /* Score pred vs the ground-truth label DSP tagged this case with (resident in our spad, written
-     * before the turn commit). expected_label < 0 = unknown -> logged but not counted. */
+    /* Score pred vs the ground-truth label DSP tagged this case with (copied out of our spad with
+     * the verified case). expected_label < 0 = unknown -> logged but not counted. */
     {
-      int32_t expected = (int32_t)g_bml->expected_label;
+      int32_t expected = g_rx_expected_label;
       int32_t pred = (int32_t)g_last_pred_class;
       /* Confidence gate: with softmax off the score is the top raw logit; a low value means the
        * window didn't look like any keyword (noise/non-speech). Below the floor we announce "(no
@@ -536,7 +585,11 @@ void app_main(void) {
     }
 #endif
 
+#if KWS_STREAM_USE_RING
+    kws_stream_ring_ack(&g_ring, idx);
+#else
     handoff_to_dsp(idx);
+#endif
   }
 }
 
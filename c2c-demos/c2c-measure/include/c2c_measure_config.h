@@ -43,6 +43,15 @@
 #define C2C_MEASURE_CACHE_FLUSH_TRIALS 64u
 #endif
 
+/* Range sizes for the c2c_shm flush/invalidate bench: one turn register, one payload block. */
+#ifndef C2C_MEASURE_RANGE_SMALL_BYTES
+#define C2C_MEASURE_RANGE_SMALL_BYTES 4u
+#endif
+
+#ifndef C2C_MEASURE_RANGE_LARGE_BYTES
+#define C2C_MEASURE_RANGE_LARGE_BYTES 1024u
+#endif
+
 #ifndef C2C_MEASURE_OVERHEAD_TRIALS
 #define C2C_MEASURE_OVERHEAD_TRIALS 64u
 #endif
@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include "c2c_measure_config.h"
+#include "c2c_shm.h"
 #include "simple_setup.h"
 
 #endif /* C2C_MEASURE_MAIN_H */
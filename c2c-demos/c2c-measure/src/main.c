@@ -255,6 +255,61 @@ static void run_cache_flush_bench(void) {
   C2C_MEASURE_LOG("\n");
 }
 
+typedef void (*shm_range_fn_t)(volatile const void *addr, uint32_t bytes);
+
+/* c2c_shm range coherence vs the full walk it replaces on every handoff. Each trial first dirties
+ * the range so the flush has real write-backs to do. */
+static void run_shm_range_bench(const char *name, shm_range_fn_t fn, uint32_t bytes) {
+  volatile uint32_t *vals = g_vals;
+  cycle_stats_t stats;
+
+  stats_reset(&stats);
+  for (uint32_t trial = 0; trial < C2C_MEASURE_CACHE_FLUSH_TRIALS; ++trial) {
+    uint64_t saved_mstatus;
+    uint64_t t0;
+    uint64_t t1;
+
+    for (uint32_t w = 0; w < (bytes >> 2); ++w) {
+      vals[w] = trial ^ w;
+    }
+    saved_mstatus = disable_irqs();
+    fence_rw();
+    t0 = rdcycle64();
+    if (fn != NULL) {
+      fn(vals, bytes);
+    } else {
+      c2c_full_flush();
+    }
+    fence_rw();
+    t1 = rdcycle64();
+    restore_irqs(saved_mstatus);
+    stats_add(&stats, subtract_measurement_overhead(t1 - t0));
+  }
+
+  C2C_MEASURE_LOG("[c2c-measure] shm_%s bytes=%u trials=%u best=%llu avg=%llu worst=%llu\n",
+                  name, (unsigned)bytes,
+                  (unsigned)C2C_MEASURE_CACHE_FLUSH_TRIALS,
+                  (unsigned long long)stats.best,
+                  (unsigned long long)stats_avg(&stats, C2C_MEASURE_CACHE_FLUSH_TRIALS),
+                  (unsigned long long)stats.worst);
+}
+
+static void run_shm_coherence_bench(void) {
+  C2C_MEASURE_LOG("[c2c-measure] c2c_shm zicbom=%u set_evict=%u l1=%ux%u l2=%ux%u set_touches=%u\n",
+                  (unsigned)C2C_SHM_USE_ZICBOM,
+                  (unsigned)C2C_SHM_SET_EVICT,
+                  (unsigned)C2C_SHM_L1_SETS,
+                  (unsigned)C2C_SHM_L1_WAYS,
+                  (unsigned)C2C_SHM_L2_SETS,
+                  (unsigned)C2C_SHM_L2_WAYS,
+                  (unsigned)C2C_SHM_EVICT_SET_TOUCHES);
+  run_shm_range_bench("full_flush", NULL, C2C_MEASURE_RANGE_SMALL_BYTES);
+  run_shm_range_bench("flush_range", c2c_flush_range, C2C_MEASURE_RANGE_SMALL_BYTES);
+  run_shm_range_bench("inval_range", c2c_invalidate_range, C2C_MEASURE_RANGE_SMALL_BYTES);
+  run_shm_range_bench("flush_range", c2c_flush_range, C2C_MEASURE_RANGE_LARGE_BYTES);
+  run_shm_range_bench("inval_range", c2c_invalidate_range, C2C_MEASURE_RANGE_LARGE_BYTES);
+}
+
 static void run_ptr_read_bench(void) {
   cycle_stats_t stats;
 
@@ -332,6 +387,7 @@ void app_main(void) {
   build_pointer_ring();
 
   run_cache_flush_bench();
+  run_shm_coherence_bench();
   run_ptr_read_bench();
   run_ptr_write_bench();
 
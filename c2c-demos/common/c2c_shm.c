@@ -8,11 +8,40 @@ _Static_assert((C2C_SHM_EVICT_BYTES % C2C_SHM_CACHE_LINE_BYTES) == 0u,
                "C2C_SHM_EVICT_BYTES must be a multiple of cache line size.");
 _Static_assert((C2C_SHM_WRITE_REPEATS >= 1u), "C2C_SHM_WRITE_REPEATS must be >= 1.");
 _Static_assert((C2C_SHM_READ_RETRIES >= 1u), "C2C_SHM_READ_RETRIES must be >= 1.");
+_Static_assert((C2C_SHM_TX_BLOCK_REPEATS >= 1u), "C2C_SHM_TX_BLOCK_REPEATS must be >= 1.");
 
-static uint8_t g_c2c_evict[C2C_SHM_EVICT_BYTES] __attribute__((aligned(0x8000)));
+#if C2C_SHM_SET_EVICT
+/* Bytes between two addresses that index the same L1 / L2 set. */
+#define C2C_SHM_L1_STRIDE (C2C_SHM_L1_SETS * C2C_SHM_CACHE_LINE_BYTES)
+#define C2C_SHM_L2_STRIDE (C2C_SHM_L2_SETS * C2C_SHM_CACHE_LINE_BYTES)
+#define C2C_SHM_SET_EVICT_BYTES (C2C_SHM_EVICT_SET_TOUCHES * C2C_SHM_L2_STRIDE)
+
+_Static_assert((C2C_SHM_L1_SETS & (C2C_SHM_L1_SETS - 1u)) == 0u,
+               "C2C_SHM_L1_SETS must be a power of two.");
+_Static_assert((C2C_SHM_L2_SETS & (C2C_SHM_L2_SETS - 1u)) == 0u,
+               "C2C_SHM_L2_SETS must be a power of two.");
+_Static_assert((C2C_SHM_L2_STRIDE % C2C_SHM_L1_STRIDE) == 0u,
+               "C2C_SHM_L2_SETS must be a multiple of C2C_SHM_L1_SETS so L2 set lines share the L1 "
+               "set.");
+_Static_assert((C2C_SHM_L2_STRIDE <= 0x8000u),
+               "C2C_SHM_L2_SETS * C2C_SHM_CACHE_LINE_BYTES must not exceed the 32 KB alignment "
+               "of g_c2c_evict.");
+_Static_assert((C2C_SHM_EVICT_SET_TOUCHES > C2C_SHM_L2_WAYS + C2C_SHM_L1_WAYS),
+               "C2C_SHM_EVICT_SET_TOUCHES must exceed the L1 + L2 associativity.");
+
+#define C2C_SHM_EVICT_BUF_BYTES \
+  (C2C_SHM_SET_EVICT_BYTES > C2C_SHM_EVICT_BYTES ? C2C_SHM_SET_EVICT_BYTES : C2C_SHM_EVICT_BYTES)
+#else
+#define C2C_SHM_EVICT_BUF_BYTES C2C_SHM_EVICT_BYTES
+#endif
+
+#ifndef C2C_SHM_HOST_SIM
+static uint8_t g_c2c_evict[C2C_SHM_EVICT_BUF_BYTES] __attribute__((aligned(0x8000)));
 static volatile uint8_t g_c2c_evict_sink;
 
-void c2c_full_flush(void) {
+/* Read+write every line of the evict buffer C2C_SHM_EVICT_PASSES times. The writes leave the
+ * buffer dirty, so each pass also forces the previous pass's victims (and ours) to write back. */
+static void c2c_evict_walk(void) {
   volatile uint8_t *buf = (volatile uint8_t *)g_c2c_evict;
   volatile uint8_t sink = g_c2c_evict_sink;
 
@@ -25,45 +54,147 @@ void c2c_full_flush(void) {
   }
 
   g_c2c_evict_sink = sink;
+}
+#endif
+
+void c2c_full_flush(void) {
+#ifdef C2C_SHM_HOST_SIM
+  c2c_sim_coherence(NULL, C2C_SHM_EVICT_BYTES * C2C_SHM_EVICT_PASSES);
+#else
+  c2c_evict_walk();
+#endif
+  c2c_fence_rw();
+}
+
+#if defined(C2C_SHM_HOST_SIM)
+/* The simulated link charges coherence by line; it has no cache to evict. */
+#elif C2C_SHM_USE_ZICBOM
+/* cbo.flush / cbo.inval: MISC-MEM, funct3 = 2, rd = x0, imm selects the op. Emitted with .insn
+ * so toolchains without Zicbom in -march still assemble them. */
+static inline void c2c_cbo_flush(uintptr_t line) {
+  __asm__ volatile(".insn i 0x0F, 2, x0, %0, 2" :: "r"(line) : "memory");
+}
+
+static inline void c2c_cbo_inval(uintptr_t line) {
+  __asm__ volatile(".insn i 0x0F, 2, x0, %0, 0" :: "r"(line) : "memory");
+}
+#elif C2C_SHM_SET_EVICT
+/* Read+write C2C_SHM_EVICT_SET_TOUCHES distinct evict-buffer lines that share `line`'s L2 set
+ * (and therefore its L1 set). The first misses push a dirty target from the L1 into the L2, the
+ * rest replace L2 ways until it is written back to the spad; the L2 is inclusive, so that also
+ * drops any L1 copy. */
+static void c2c_evict_set(uintptr_t line) {
+  volatile uint8_t *buf = (volatile uint8_t *)g_c2c_evict + (line & (C2C_SHM_L2_STRIDE - 1u));
+  uint8_t sink = g_c2c_evict_sink;
+
+  for (uint32_t t = 0; t < (uint32_t)C2C_SHM_EVICT_SET_TOUCHES; ++t) {
+    sink ^= buf[t * C2C_SHM_L2_STRIDE];
+    buf[t * C2C_SHM_L2_STRIDE] = (uint8_t)(sink + (uint8_t)t);
+  }
+  g_c2c_evict_sink = sink;
+}
+
+/* Consecutive lines index consecutive L2 slots, so the first min(lines, L2_SETS) lines of the
+ * range cover every set it touches. */
+static void c2c_evict_range(volatile const void *addr, uint32_t bytes) {
+  uintptr_t first = (uintptr_t)addr & ~(uintptr_t)(C2C_SHM_CACHE_LINE_BYTES - 1u);
+  uintptr_t end = (uintptr_t)addr + bytes;
+  uint32_t lines = (uint32_t)((end - first + C2C_SHM_CACHE_LINE_BYTES - 1u) / C2C_SHM_CACHE_LINE_BYTES);
+
+  if (lines > C2C_SHM_L2_SETS) {
+    lines = C2C_SHM_L2_SETS;
+  }
+  for (uint32_t l = 0; l < lines; ++l) {
+    c2c_evict_set(first + (uintptr_t)l * C2C_SHM_CACHE_LINE_BYTES);
+  }
+}
+#else
+/* C2C_SHM_SET_EVICT=0: the range goes out with everything else. */
+static void c2c_evict_range(volatile const void *addr, uint32_t bytes) {
+  (void)addr;
+  (void)bytes;
+  c2c_evict_walk();
+}
+#endif
+
+void c2c_flush_range(volatile const void *addr, uint32_t bytes) {
+  if (bytes == 0u) {
+    return;
+  }
+  c2c_fence_rw();
+#if defined(C2C_SHM_HOST_SIM)
+  c2c_sim_coherence(addr, bytes);
+#elif C2C_SHM_USE_ZICBOM
+  uintptr_t end = (uintptr_t)addr + bytes;
+  for (uintptr_t line = (uintptr_t)addr & ~(uintptr_t)(C2C_SHM_CACHE_LINE_BYTES - 1u); line < end;
+       line += C2C_SHM_CACHE_LINE_BYTES) {
+    c2c_cbo_flush(line);
+  }
+#else
+  c2c_evict_range(addr, bytes);
+#endif
+  c2c_fence_rw();
+}
+
+void c2c_invalidate_range(volatile const void *addr, uint32_t bytes) {
+  if (bytes == 0u) {
+    return;
+  }
+  c2c_fence_rw();
+#if defined(C2C_SHM_HOST_SIM)
+  c2c_sim_coherence(addr, bytes);
+#elif C2C_SHM_USE_ZICBOM
+  uintptr_t end = (uintptr_t)addr + bytes;
+  for (uintptr_t line = (uintptr_t)addr & ~(uintptr_t)(C2C_SHM_CACHE_LINE_BYTES - 1u); line < end;
+       line += C2C_SHM_CACHE_LINE_BYTES) {
+    c2c_cbo_inval(line);
+  }
+#else
+  c2c_evict_range(addr, bytes);
+#endif
   c2c_fence_rw();
 }
 
 void c2c_remote_write_u32(volatile uint32_t *addr, uint32_t val) {
   for (uint32_t r = 0; r < C2C_SHM_WRITE_REPEATS; ++r) {
-    *addr = val;
+    C2C_SHM_STORE32(addr, val);
     c2c_fence_rw();
   }
-  c2c_full_flush();
+  c2c_flush_range(addr, sizeof(*addr));
 }
 
 /* Spads are 32-bit-access-only: byte/half stores can trap or hang. Callers pass a 4-aligned dst
  * and a 4-byte-multiple length; we always write whole 32-bit words. `src` may be unaligned, so we
  * assemble each word from bytes (little-endian, matching the RISC-V cores on both sides). */
-void c2c_remote_write_block(volatile void *dst, const void *src, uint32_t bytes) {
+static void c2c_write_words(volatile void *dst, const void *src, uint32_t words) {
   volatile uint32_t *d = (volatile uint32_t *)dst;
   const uint8_t *s = (const uint8_t *)src;
+
+  for (uint32_t w = 0; w < words; ++w) {
+    const uint8_t *b = &s[w << 2];
+    uint32_t val = (uint32_t)b[0] | ((uint32_t)b[1] << 8) |
+                   ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    C2C_SHM_STORE32(&d[w], val);
+  }
+}
+
+void c2c_remote_write_block(volatile void *dst, const void *src, uint32_t bytes) {
   uint32_t words = bytes >> 2;
 
   for (uint32_t r = 0; r < C2C_SHM_WRITE_REPEATS; ++r) {
-    for (uint32_t w = 0; w < words; ++w) {
-      const uint8_t *b = &s[w << 2];
-      uint32_t val = (uint32_t)b[0] | ((uint32_t)b[1] << 8) |
-                     ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
-      d[w] = val;
-    }
+    c2c_write_words(dst, src, words);
     c2c_fence_rw();
   }
-  c2c_full_flush();
+  c2c_flush_range(dst, words << 2);
 }
 
 void c2c_local_write_u32(volatile uint32_t *addr, uint32_t val) {
-  *addr = val;
-  c2c_fence_rw();
-  c2c_full_flush();
+  C2C_SHM_STORE32(addr, val);
+  c2c_flush_range(addr, sizeof(*addr));
 }
 
 uint32_t c2c_local_read_u32(volatile const uint32_t *addr) {
-  c2c_full_flush();
+  c2c_invalidate_range(addr, sizeof(*addr));
   return *addr;
 }
 
@@ -87,6 +218,101 @@ uint32_t c2c_local_read_u32_stable(volatile const uint32_t *addr, int *stable) {
   return prev;
 }
 
+void c2c_tx_begin(c2c_tx_t *tx) {
+  tx->n_words = 0u;
+  tx->n_blocks = 0u;
+  tx->commit_addr = NULL;
+  tx->commit_val = 0u;
+  tx->overflow = 0;
+}
+
+/* Kept sorted by address (insertion) so commit can emit the burst in one ascending sweep. */
+void c2c_tx_stage_u32(c2c_tx_t *tx, volatile uint32_t *addr, uint32_t val) {
+  uint32_t i = tx->n_words;
+
+  for (uint32_t k = 0; k < tx->n_words; ++k) {
+    if (tx->word_addr[k] == addr) {
+      tx->word_val[k] = val;
+      return;
+    }
+  }
+  if (tx->n_words >= C2C_SHM_TX_MAX_WORDS) {
+    tx->overflow = 1;
+    return;
+  }
+  while ((i > 0u) && ((uintptr_t)tx->word_addr[i - 1u] > (uintptr_t)addr)) {
+    tx->word_addr[i] = tx->word_addr[i - 1u];
+    tx->word_val[i] = tx->word_val[i - 1u];
+    --i;
+  }
+  tx->word_addr[i] = addr;
+  tx->word_val[i] = val;
+  tx->n_words++;
+}
+
+void c2c_tx_stage_block(c2c_tx_t *tx, volatile void *dst, const void *src, uint32_t bytes) {
+  if (tx->n_blocks >= C2C_SHM_TX_MAX_BLOCKS) {
+    tx->overflow = 1;
+    return;
+  }
+  tx->blocks[tx->n_blocks].dst = dst;
+  tx->blocks[tx->n_blocks].src = src;
+  tx->blocks[tx->n_blocks].bytes = bytes & ~3u;
+  tx->n_blocks++;
+}
+
+void c2c_tx_stage_commit(c2c_tx_t *tx, volatile uint32_t *addr, uint32_t val) {
+  tx->commit_addr = addr;
+  tx->commit_val = val;
+}
+
+int c2c_tx_commit(c2c_tx_t *tx) {
+  uintptr_t last_line = 1u; /* never a line address */
+
+  if (tx->overflow) {
+    return 0;
+  }
+
+  for (uint32_t r = 0; r < C2C_SHM_TX_BLOCK_REPEATS; ++r) {
+    for (uint32_t b = 0; b < tx->n_blocks; ++b) {
+      c2c_write_words(tx->blocks[b].dst, tx->blocks[b].src, tx->blocks[b].bytes >> 2);
+    }
+    c2c_fence_rw();
+  }
+  for (uint32_t r = 0; r < C2C_SHM_WRITE_REPEATS; ++r) {
+    for (uint32_t w = 0; w < tx->n_words; ++w) {
+      C2C_SHM_STORE32(tx->word_addr[w], tx->word_val[w]);
+    }
+    c2c_fence_rw();
+  }
+
+#if !defined(C2C_SHM_HOST_SIM) && !C2C_SHM_USE_ZICBOM && !C2C_SHM_SET_EVICT
+  /* Every range flush is a full walk here, so walk once for the whole transaction. */
+  (void)last_line;
+  if ((tx->n_blocks != 0u) || (tx->n_words != 0u)) {
+    c2c_full_flush();
+  }
+#else
+  /* Single flush pass: each block once, then each distinct header line once (the words are
+   * sorted, so equal lines are adjacent). */
+  for (uint32_t b = 0; b < tx->n_blocks; ++b) {
+    c2c_flush_range(tx->blocks[b].dst, tx->blocks[b].bytes);
+  }
+  for (uint32_t w = 0; w < tx->n_words; ++w) {
+    uintptr_t line = (uintptr_t)tx->word_addr[w] & ~(uintptr_t)(C2C_SHM_CACHE_LINE_BYTES - 1u);
+    if (line != last_line) {
+      c2c_flush_range((volatile const void *)line, C2C_SHM_CACHE_LINE_BYTES);
+      last_line = line;
+    }
+  }
+#endif
+
+  if (tx->commit_addr != NULL) {
+    c2c_remote_write_u32(tx->commit_addr, tx->commit_val);
+  }
+  return 1;
+}
+
 uint32_t c2c_checksum(const void *buf, uint32_t bytes) {
   const uint8_t *b = (const uint8_t *)buf;
   uint32_t acc = 0x811C9DC5u; /* FNV-1a offset basis */
@@ -107,7 +333,7 @@ int c2c_local_read_block_verify(void *dst, volatile const void *src, uint32_t by
   uint32_t words = bytes >> 2;
 
   for (uint32_t r = 0; r < C2C_SHM_READ_RETRIES; ++r) {
-    c2c_full_flush();
+    c2c_invalidate_range(src, bytes);
     for (uint32_t w = 0; w < words; ++w) {
       uint32_t val = s[w];
       uint8_t *b = &d[w << 2];
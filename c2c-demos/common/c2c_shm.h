@@ -9,13 +9,20 @@
  *   - A chip may READ only its OWN adjacent spad; it may WRITE to BOTH.
  *   - Cross-link (remote) writes are UNSTABLE: repeat them a few times so they stick.
  *   - Coherence is not automatic: before reading your own spad (which the remote wrote
- *     behind your cache) you must FULL-FLUSH the cache first.
+ *     behind your cache) the lines you read must be invalidated, and your own writes must be
+ *     written back before the peer can see them.
  *
  * This module centralizes those rules so every demo uses one implementation. The API is
  * split by access class:
  *   - c2c_remote_write_*  : write into the OTHER chip's spad, repeated C2C_WRITE_REPEATS times.
  *   - c2c_local_write_u32 : write into your OWN spad once (e.g. clearing your own flag).
- *   - c2c_local_read_*    : read your OWN spad, flushing first.
+ *   - c2c_local_read_*    : read your OWN spad, invalidating the lines read first.
+ *
+ * Coherence is range-based: c2c_flush_range / c2c_invalidate_range touch only the lines that
+ * cover the target bytes. With Zicbom (C2C_SHM_USE_ZICBOM) these are cbo.flush / cbo.inval per
+ * line; otherwise each target line is pushed out of the L1 and the L2 by touching
+ * C2C_SHM_EVICT_SET_TOUCHES evict-buffer lines that index the same set. c2c_full_flush remains
+ * for whole-cache handoffs.
  */
 
 #include <stdint.h>
@@ -43,6 +50,55 @@ extern "C" {
 #define C2C_SHM_EVICT_PASSES 3u
 #endif
 
+/* Use Zicbom cache-block ops for range flush/invalidate. Defaults on when the toolchain was told
+ * the core has Zicbom (-march=..._zicbom); force with -DC2C_SHM_USE_ZICBOM=1 if the core has it
+ * but the -march string does not (the ops are emitted with .insn, so no assembler support needed). */
+#ifndef C2C_SHM_USE_ZICBOM
+#if defined(__riscv_zicbom)
+#define C2C_SHM_USE_ZICBOM 1
+#else
+#define C2C_SHM_USE_ZICBOM 0
+#endif
+#endif
+
+/* Without Zicbom, range flush/invalidate evict by set (C2C_SHM_SET_EVICT, default on): for each
+ * line of the range they read+write C2C_SHM_EVICT_SET_TOUCHES evict-buffer lines that index the
+ * same L2 set. The L2 set stride is a multiple of the L1 one, so those lines share the L1 set too
+ * and the target leaves both levels. Set C2C_SHM_SET_EVICT=0 to fall back to the full read+write
+ * walk of C2C_SHM_EVICT_BYTES (x C2C_SHM_EVICT_PASSES) on a hierarchy the geometry below does not
+ * describe. */
+#ifndef C2C_SHM_SET_EVICT
+#define C2C_SHM_SET_EVICT 1
+#endif
+
+/* Set-eviction geometry. A line at address A lives in L2 slot (A / LINE) % L2_SETS, so
+ * evict-buffer lines at the same offset modulo L2_SETS*LINE compete with it. Defaults are the
+ * Bearly25 hierarchy (bearly25-bmarks/memory-latency): L1 D$ 64 sets x 2 ways, L2 2 banks x 256
+ * sets x 8 ways interleaved on addr[6], i.e. 512 consecutive line slots. */
+#ifndef C2C_SHM_L1_SETS
+#define C2C_SHM_L1_SETS 64u
+#endif
+
+#ifndef C2C_SHM_L1_WAYS
+#define C2C_SHM_L1_WAYS 2u
+#endif
+
+#ifndef C2C_SHM_L2_SETS
+#define C2C_SHM_L2_SETS 512u
+#endif
+
+#ifndef C2C_SHM_L2_WAYS
+#define C2C_SHM_L2_WAYS 8u
+#endif
+
+/* Distinct same-set lines touched per target line. L2 replacement is pseudo-random, so a line
+ * survives N misses in a W-way set with p = (1 - 1/W)^N. 2 x ways is more misses per set than
+ * the 3-pass full walk produces (it has only 8 distinct lines per set; its later passes mostly
+ * hit). The evict buffer grows to TOUCHES x L2_SETS x LINE bytes (512 KB by default). */
+#ifndef C2C_SHM_EVICT_SET_TOUCHES
+#define C2C_SHM_EVICT_SET_TOUCHES (2u * C2C_SHM_L2_WAYS)
+#endif
+
 /* How many times to repeat a remote (cross-link) write so it takes. Tune on silicon. */
 #ifndef C2C_SHM_WRITE_REPEATS
 #define C2C_SHM_WRITE_REPEATS 4u
@@ -53,6 +109,23 @@ extern "C" {
 #define C2C_SHM_READ_RETRIES 8u
 #endif
 
+/* Transaction capacity: scalar header words and payload blocks staged per c2c_tx_t. */
+#ifndef C2C_SHM_TX_MAX_WORDS
+#define C2C_SHM_TX_MAX_WORDS 16u
+#endif
+
+#ifndef C2C_SHM_TX_MAX_BLOCKS
+#define C2C_SHM_TX_MAX_BLOCKS 4u
+#endif
+
+/* Payload passes per transaction commit. Blocks are checksummed by the receiver, which NAKs a torn
+ * payload, so one pass is the default; header words and the commit word (which nothing can
+ * verify) keep C2C_SHM_WRITE_REPEATS. Callers relying on this must re-write the payload when they
+ * answer a NAK — re-committing the header alone re-sends the same torn bytes. */
+#ifndef C2C_SHM_TX_BLOCK_REPEATS
+#define C2C_SHM_TX_BLOCK_REPEATS 1u
+#endif
+
 /* Canonical scratchpad bases (informational; callers pass explicit addresses). */
 #ifndef C2C_SHM_DSP_SPAD_BASE
 #define C2C_SHM_DSP_SPAD_BASE 0xC0000000UL /* adjacent to DSP; DSP reads, BML remote-writes */
@@ -61,34 +134,97 @@ extern "C" {
 #define C2C_SHM_BML_SPAD_BASE 0xD0000000UL /* adjacent to BML; BML reads, DSP remote-writes */
 #endif
 
+/* ---- Host simulation port ----------------------------------------------------------------- */
+
+/* Built with C2C_SHM_HOST_SIM (c2c-demos/host-sim), every spad store and coherence op goes through
+ * the simulated lossy link in c2c_link_sim.h instead of straight to memory. */
+#ifdef C2C_SHM_HOST_SIM
+#include "c2c_link_sim.h"
+#define C2C_SHM_STORE32(addr, val) c2c_sim_store32((addr), (val))
+#else
+#define C2C_SHM_STORE32(addr, val) (*(addr) = (val))
+#endif
+
 /* ---- Primitives ------------------------------------------------------------------------- */
 
 static inline void c2c_fence_rw(void) {
+#ifdef C2C_SHM_HOST_SIM
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
   __asm__ volatile("fence rw, rw" ::: "memory");
+#endif
 }
 
 /* Force the entire cache out by walking the internal evict buffer, then fence. */
 void c2c_full_flush(void);
 
-/* Remote (cross-link) writes: repeated C2C_SHM_WRITE_REPEATS times, then a full flush. */
+/* Write back (and drop) every cache line overlapping [addr, addr + bytes), then fence. */
+void c2c_flush_range(volatile const void *addr, uint32_t bytes);
+
+/* Drop every cache line overlapping [addr, addr + bytes) so the next read goes to the spad. Under
+ * Zicbom dirty data in those lines is discarded: flush your own writes to them first (the
+ * c2c_local_write_* / c2c_remote_write_* helpers already do). */
+void c2c_invalidate_range(volatile const void *addr, uint32_t bytes);
+
+/* Remote (cross-link) writes: repeated C2C_SHM_WRITE_REPEATS times, then a range flush. */
 void c2c_remote_write_u32(volatile uint32_t *addr, uint32_t val);
 void c2c_remote_write_block(volatile void *dst, const void *src, uint32_t bytes);
 
-/* Local write into your own spad (single write) + flush so it reaches spad memory. */
+/* Local write into your own spad (single write) + range flush so it reaches spad memory. */
 void c2c_local_write_u32(volatile uint32_t *addr, uint32_t val);
 
-/* Local reads of your own spad: full-flush first so you see what the remote wrote. */
+/* Local reads of your own spad: invalidate first so you see what the remote wrote. */
 uint32_t c2c_local_read_u32(volatile const uint32_t *addr);
 
-/* Flush+read repeatedly until two fresh reads agree (bounded by C2C_SHM_READ_RETRIES).
+/* Invalidate+read repeatedly until two fresh reads agree (bounded by C2C_SHM_READ_RETRIES).
  * *stable is set to 1 if agreement was reached, 0 if it gave up (last value returned). */
 uint32_t c2c_local_read_u32_stable(volatile const uint32_t *addr, int *stable);
 
+/* ---- Remote-write transactions ---------------------------------------------------------- */
+
+/*
+ * Batched cross-link publish: stage header words, payload blocks and one commit word, then
+ * c2c_tx_commit writes them as
+ *   1. every block, C2C_SHM_TX_BLOCK_REPEATS passes;
+ *   2. all header words as one burst in address order (so words sharing a line go out back to
+ *      back), C2C_SHM_WRITE_REPEATS passes;
+ *   3. one flush pass over the blocks and the header lines (a single c2c_full_flush when range
+ *      flushes fall back to the full walk);
+ *   4. the commit word, C2C_SHM_WRITE_REPEATS times, and a flush of its line.
+ * The commit word is thus never visible before the data it publishes. Staging a word twice keeps
+ * the last value. Staging beyond capacity marks the transaction failed and commit writes nothing.
+ */
+typedef struct {
+  volatile void *dst;
+  const void *src;
+  uint32_t bytes;
+} c2c_tx_block_t;
+
+typedef struct {
+  volatile uint32_t *word_addr[C2C_SHM_TX_MAX_WORDS];
+  uint32_t word_val[C2C_SHM_TX_MAX_WORDS];
+  uint32_t n_words;
+  c2c_tx_block_t blocks[C2C_SHM_TX_MAX_BLOCKS];
+  uint32_t n_blocks;
+  volatile uint32_t *commit_addr;
+  uint32_t commit_val;
+  int overflow;
+} c2c_tx_t;
+
+void c2c_tx_begin(c2c_tx_t *tx);
+void c2c_tx_stage_u32(c2c_tx_t *tx, volatile uint32_t *addr, uint32_t val);
+/* Same contract as c2c_remote_write_block: 4-aligned dst, 4-byte-multiple length. `src` must stay
+ * valid until c2c_tx_commit returns. */
+void c2c_tx_stage_block(c2c_tx_t *tx, volatile void *dst, const void *src, uint32_t bytes);
+void c2c_tx_stage_commit(c2c_tx_t *tx, volatile uint32_t *addr, uint32_t val);
+/* Returns 1 once written, 0 if the transaction overflowed (nothing written). */
+int c2c_tx_commit(c2c_tx_t *tx);
+
 /* Simple checksum over a byte buffer (order-sensitive). */
 uint32_t c2c_checksum(const void *buf, uint32_t bytes);
 
 /* Copy `bytes` from your own spad into `dst`, verifying against expect_checksum.
- * Retries (flush+recopy) up to C2C_SHM_READ_RETRIES. Returns 1 on match, 0 on give-up. */
+ * Retries (invalidate+recopy) up to C2C_SHM_READ_RETRIES. Returns 1 on match, 0 on give-up. */
 int c2c_local_read_block_verify(void *dst, volatile const void *src, uint32_t bytes,
                                 uint32_t expect_checksum);
 
@@ -20,19 +20,27 @@
  * the local MSIP address. CLINT layout relative to CLINT_BASE: MSIP @ +0x0000, mtimecmp @ +0x4000,
  * mtime @ +0xBFF8. MTIME_FREQ = 50 kHz (20 us/tick).
  *
- * Built on c2c_shm (c2c_full_flush / c2c_remote_write_u32 / c2c_local_read_u32 / c2c_fence_rw), so
+ * Built on c2c_shm (c2c_flush_range / c2c_remote_write_u32 / c2c_local_read_u32 / c2c_fence_rw), so
  * it shares the one flush implementation and the repeat/flush write discipline.
  */
 
 #include <stdint.h>
 
+#ifndef C2C_SHM_HOST_SIM
 #include "chip_config.h"   /* CLINT_BASE */
+#endif
 #include "c2c_shm.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Host simulation (c2c-demos/host-sim): each simulated chip's CLINT lives in c2c_link_sim. */
+#ifdef C2C_SHM_HOST_SIM
+#define C2C_OWN_MSIP_ADDR  ((uintptr_t)c2c_sim_own_msip())
+#define C2C_PEER_MSIP_ADDR ((uintptr_t)c2c_sim_peer_msip())
+#endif
+
 /* Own CLINT MSIP (hart 0, CLINT offset 0). */
 #ifndef C2C_OWN_MSIP_ADDR
 #define C2C_OWN_MSIP_ADDR ((uintptr_t)CLINT_BASE + 0x0000U)
@@ -59,27 +67,36 @@ extern "C" {
 #define C2C_TURN_BML 1u
 
 static inline uint64_t c2c_mtime(void) {
+#ifdef C2C_SHM_HOST_SIM
+  return c2c_sim_mtime();
+#else
   return *(volatile uint64_t *)(uintptr_t)(C2C_MTIME_ADDR);
+#endif
 }
 
 static inline void c2c_set_mtimecmp(uint64_t v) {
+#ifdef C2C_SHM_HOST_SIM
+  c2c_sim_set_mtimecmp(v);
+#else
   *(volatile uint64_t *)(uintptr_t)(C2C_MTIMECMP_ADDR) = v;
+#endif
   c2c_fence_rw();
 }
 
 /* Arm BOTH wake sources: MSIE (fast peer wake) and MTIE (periodic safety net), with mstatus.MIE
  * cleared so neither traps — wfi resumes and we poll. Call once, after boot, before the wait loop. */
 static inline void c2c_arm_wake(void) {
+#ifndef C2C_SHM_HOST_SIM
   __asm__ volatile("csrc mstatus, %0" :: "r"(1UL << 3) : "memory");            /* mstatus.MIE = 0 */
   __asm__ volatile("csrs mie, %0" :: "r"((1UL << 3) | (1UL << 7)) : "memory"); /* MSIE + MTIE   */
+#endif
 }
 
-/* Clear our own CLINT MSIP (idempotent) + full flush. */
+/* Clear our own CLINT MSIP (idempotent) + flush its line. */
 static inline void c2c_clear_own_msip(void) {
   volatile uint32_t *m = (volatile uint32_t *)(uintptr_t)(C2C_OWN_MSIP_ADDR);
   *m = 0u;
-  c2c_fence_rw();
-  c2c_full_flush();
+  c2c_flush_range(m, sizeof(*m));
 }
 
 /* Wake the peer: cross-link write of 1 to its CLINT MSIP (repeated via c2c_shm to defeat drops). */
@@ -92,12 +109,16 @@ static inline void c2c_wake_peer(void) {
  * MSIP after waking so a stale pending bit can't spin us. */
 static inline void c2c_sleep_until_tick(void) {
   c2c_set_mtimecmp(c2c_mtime() + (uint64_t)C2C_POLL_INTERVAL_TICKS);
+#ifdef C2C_SHM_HOST_SIM
+  c2c_sim_wfi();
+#else
   __asm__ volatile("wfi");
+#endif
   c2c_clear_own_msip();
 }
 
 /* Block (timer-paced wfi) until the turn register in our OWN spad equals my_turn. Each wake (MSIP
- * or timer) flushes and re-reads the register; if it is not yet ours we sleep again. */
+ * or timer) invalidates and re-reads the register; if it is not yet ours we sleep again. */
 static inline void c2c_await_turn(volatile const uint32_t *own_turn, uint32_t my_turn) {
   while (c2c_local_read_u32(own_turn) != my_turn) {
     c2c_sleep_until_tick();
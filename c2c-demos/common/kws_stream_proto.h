@@ -24,7 +24,20 @@
  * `case_index` is monotonic and `payload_checksum` guards a torn payload; both are written before
  * the turn register (the commit), so when the peer sees its turn the data is already resident.
  *
- * All accesses go through c2c_shm.h helpers (repeat remote writes; flush-first local reads).
+ * RING MODE (KWS_STREAM_USE_RING, default): the turn register serializes DSP MFCC production and
+ * BML inference. The ring instead gives the BML spad KWS_STREAM_RING_SLOTS payload slots after
+ * its control block. Each side owns one index and writes it into the peer's spad:
+ *   - prod_index (BML spad, DSP writes): cases published so far; case n lives in slot (n-1)%SLOTS.
+ *   - ack_index  (DSP spad, BML writes): cases consumed so far (the same field as turn mode).
+ * DSP may publish case n once n - ack_index <= SLOTS, so it computes case i+1 while BML infers
+ * case i. A slot is published as one c2c_tx_t (payload + slot header, prod_index as the commit
+ * word). A slot whose checksum fails on BML is NAKed via nak_index/nak_seq in the DSP spad and
+ * republished. Wakes and liveness are unchanged: c2c_wake_peer after every publish/ack and the
+ * c2c_turnsync timer tick on both sides; a DSP waiting on a full ring re-sends prod_index on
+ * each idle tick.
+ *
+ * All accesses go through c2c_shm.h helpers (repeat remote writes; flush-first local reads). Each
+ * handoff is one c2c_tx_t transaction whose commit word is the peer turn register.
  */
 
 #include <stdint.h>
@@ -36,7 +49,26 @@
 extern "C" {
 #endif
 
+/* Ring (default) or strict turn-taking. Both chips must be built with the same setting. */
+#ifndef KWS_STREAM_USE_RING
+#define KWS_STREAM_USE_RING 1
+#endif
+
+/* Payload slots in the BML spad (ring mode). 2 = double buffering. */
+#ifndef KWS_STREAM_RING_SLOTS
+#define KWS_STREAM_RING_SLOTS 2u
+#endif
+
+/* Usable bytes per scratchpad. */
+#ifndef KWS_STREAM_SPAD_BYTES
+#define KWS_STREAM_SPAD_BYTES 16384u
+#endif
+
+#if KWS_STREAM_USE_RING
+#define KWS_STREAM_PROTO_VERSION 4u   /* 4: multi-slot ring (3: turn-register sync) */
+#else
 #define KWS_STREAM_PROTO_VERSION 3u   /* 3: turn-register sync (was 2: rx_ready/epoch handshake) */
+#endif
 
 /* Local scratchpad bases (used for LOCAL reads / local turn writes). */
 #ifndef KWS_STREAM_DSP_SPAD_BASE
@@ -91,9 +123,40 @@ typedef struct __attribute__((packed)) {
   volatile uint32_t reserved0;        /* 0x14  pad (align bml_rx_cycle) */
   volatile uint64_t bml_rx_cycle;     /* 0x18  rdcycle at ack */
   volatile uint32_t turn;             /* 0x20  C2C_TURN_*: whose turn it is (the commit) */
-  volatile uint32_t reserved1[7];     /* 0x24..0x3F */
+  volatile uint32_t nak_index;        /* 0x24  ring: case whose slot failed BML's checksum */
+  volatile uint32_t nak_seq;          /* 0x28  ring: ++ per NAK, so a repeated NAK is seen */
+  volatile uint32_t reserved1[5];     /* 0x2C..0x3F */
 } kws_stream_dsp_spad_t;
 
+/* Ring slot: one header line, then the payload, padded to whole cache lines so slots never share
+ * a line (a flush/invalidate of one slot cannot touch its neighbour). */
+#define KWS_STREAM_RING_SLOT_BYTES (0x40u + ((KWS_CASE_PAYLOAD_BYTES + 0x3Fu) & ~0x3Fu))
+
+typedef struct __attribute__((packed)) {
+  volatile uint32_t case_index;       /* 0x00  case carried by this slot (0 = never filled) */
+  volatile uint32_t payload_checksum; /* 0x04  c2c_checksum over case_payload */
+  volatile int32_t  expected_label;   /* 0x08  ground-truth class (-1 = unknown) */
+  volatile int32_t  ref_case_index;   /* 0x0C  matching tinyspeech_inputs.h index (-1 = none) */
+  volatile uint64_t dsp_tx_cycle;     /* 0x10  rdcycle at publish */
+  volatile uint32_t reserved[10];     /* 0x18..0x3F */
+  volatile int8_t   case_payload[KWS_STREAM_RING_SLOT_BYTES - 0x40u]; /* 0x40 */
+} kws_stream_ring_slot_t;
+
+/* BML-adjacent spad in ring mode: control block with prod_index, then the slots. */
+typedef struct __attribute__((packed)) {
+  volatile uint32_t magic;            /* 0x00  KWS_STREAM_MAGIC_BML */
+  volatile uint32_t version;          /* 0x04  KWS_STREAM_PROTO_VERSION */
+  volatile uint32_t payload_bytes;    /* 0x08  = KWS_CASE_PAYLOAD_BYTES */
+  volatile uint32_t slots;            /* 0x0C  = KWS_STREAM_RING_SLOTS */
+  volatile uint32_t prod_index;       /* 0x10  cases published by DSP (the commit) */
+  volatile uint32_t reserved0[11];    /* 0x14..0x3F */
+  kws_stream_ring_slot_t slot[KWS_STREAM_RING_SLOTS]; /* 0x40 */
+} kws_stream_ring_bml_spad_t;
+
+static inline uint32_t kws_stream_ring_slot_of(uint32_t case_index) {
+  return (case_index - 1u) % KWS_STREAM_RING_SLOTS;
+}
+
 _Static_assert(sizeof(kws_stream_bml_spad_t) == (0x40u + KWS_CASE_PAYLOAD_BYTES),
                "kws_stream_bml_spad_t layout drifted from documented offsets.");
 _Static_assert(offsetof(kws_stream_bml_spad_t, case_payload) == 0x40u,
@@ -112,8 +175,19 @@ _Static_assert(offsetof(kws_stream_dsp_spad_t, bml_ready) == 0x10u,
                "bml_ready must sit at offset 0x10.");
 _Static_assert(offsetof(kws_stream_dsp_spad_t, turn) == 0x20u,
                "dsp turn register must sit at offset 0x20.");
+_Static_assert(offsetof(kws_stream_dsp_spad_t, nak_index) == 0x24u,
+               "nak_index must sit at offset 0x24.");
 _Static_assert(sizeof(kws_stream_dsp_spad_t) == 0x40u,
                "kws_stream_dsp_spad_t control block must stay 0x40 bytes.");
+_Static_assert(KWS_STREAM_RING_SLOTS >= 1u, "KWS_STREAM_RING_SLOTS must be >= 1.");
+_Static_assert((sizeof(kws_stream_ring_slot_t) % 0x40u) == 0u,
+               "ring slots must be whole cache lines.");
+_Static_assert(offsetof(kws_stream_ring_bml_spad_t, prod_index) == 0x10u,
+               "prod_index must sit at offset 0x10.");
+_Static_assert(offsetof(kws_stream_ring_bml_spad_t, slot) == 0x40u,
+               "ring slots must start at offset 0x40.");
+_Static_assert(sizeof(kws_stream_ring_bml_spad_t) <= KWS_STREAM_SPAD_BYTES,
+               "KWS_STREAM_RING_SLOTS slots do not fit in the BML scratchpad.");
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,292 @@
+#ifndef C2C_KWS_STREAM_RING_H
+#define C2C_KWS_STREAM_RING_H
+
+/*
+ * kws_stream_ring — the ring-mode (KWS_STREAM_USE_RING) state machines of the KWS stream protocol.
+ *
+ * One implementation of each side of kws_stream_proto.h's ring, shared by the demos
+ * (dsp-kws-rolling is the producer, bearly-kws-rolling the consumer) and by the host bench in
+ * c2c-demos/host-sim, so the bench measures the code that runs on silicon:
+ *
+ *   producer (DSP): keeps a local copy of every in-flight slot, publishes case n into slot
+ *     (n-1)%SLOTS as one c2c_tx_t with prod_index as the commit word, waits for a free slot, and
+ *     republishes a slot in full when BML NAKs it. A wait that sees an idle tick with the ring still
+ *     full re-commits prod_index and wakes BML (heals a dropped commit or wake toward BML).
+ *   consumer (BML): waits for case last_consumed+1, verifies the slot header and payload checksum
+ *     into a local buffer, NAKs a torn slot, and acks each consumed case (ack_index is the commit
+ *     word). Any wake that finds nothing new re-sends the last ack: it goes out once and DSP
+ *     cannot tell a lost ack from a slow BML, so only BML can heal it.
+ *
+ * Header-only like c2c_turnsync.h, so each includer's log hook applies. Define KWS_STREAM_RING_LOG
+ * before including to see the recovery events. Waits give up early when the optional `stop` flag
+ * becomes nonzero (the bench's watchdog); the demos leave it NULL.
+ */
+
+#include <stdint.h>
+
+#include "c2c_shm.h"
+#include "c2c_turnsync.h"
+#include "kws_stream_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef KWS_STREAM_RING_LOG
+#define KWS_STREAM_RING_LOG(...) do { } while (0)
+#endif
+
+/* ---- Producer (DSP) ---------------------------------------------------------------------- */
+
+typedef struct {
+  kws_stream_ring_bml_spad_t *ring;   /* BML spad, cross-link address (remote writes only) */
+  kws_stream_dsp_spad_t *dsp;         /* own spad (local reads) */
+  uint64_t (*clock)(void);            /* stamps dsp_tx_cycle; NULL = 0 */
+  volatile const int *stop;           /* optional: waits return once *stop != 0 */
+  /* Local copy of every in-flight slot, so a NAKed case can be republished after the producer
+   * moved on. */
+  int8_t   case_copy[KWS_STREAM_RING_SLOTS][KWS_CASE_PAYLOAD_BYTES];
+  uint32_t checksum[KWS_STREAM_RING_SLOTS];
+  int32_t  expected_label[KWS_STREAM_RING_SLOTS];
+  int32_t  ref_case_index[KWS_STREAM_RING_SLOTS];
+  uint32_t prod;                      /* cases published (the prod_index we last committed) */
+  uint32_t ack;                       /* last ack_index seen */
+  uint32_t nak_seq;                   /* last nak_seq served */
+  uint32_t republishes;               /* slots republished on a NAK */
+  uint32_t recommits;                 /* prod_index re-commits on an idle tick */
+  uint32_t stale_recommits;           /* the same, on an MSIP that brought no ack */
+} kws_stream_ring_producer_t;
+
+static inline int kws_stream_ring_stopped(volatile const int *stop) {
+  return (stop != NULL) && (*stop != 0);
+}
+
+static inline void kws_stream_ring_producer_init(kws_stream_ring_producer_t *p,
+                                                 kws_stream_ring_bml_spad_t *ring,
+                                                 kws_stream_dsp_spad_t *dsp,
+                                                 uint64_t (*clock)(void)) {
+  p->ring = ring;
+  p->dsp = dsp;
+  p->clock = clock;
+  p->stop = NULL;
+  p->prod = 0u;
+  p->ack = 0u;
+  p->nak_seq = 0u;
+  p->republishes = 0u;
+  p->recommits = 0u;
+  p->stale_recommits = 0u;
+}
+
+/* Identity (magic/version/payload_bytes/slots) into BML's spad. Cross-link write: only after the
+ * boot barrier. */
+static inline void kws_stream_ring_publish_identity(kws_stream_ring_producer_t *p) {
+  c2c_tx_t tx;
+
+  c2c_tx_begin(&tx);
+  c2c_tx_stage_u32(&tx, &p->ring->magic, KWS_STREAM_MAGIC_BML);
+  c2c_tx_stage_u32(&tx, &p->ring->version, KWS_STREAM_PROTO_VERSION);
+  c2c_tx_stage_u32(&tx, &p->ring->payload_bytes, (uint32_t)KWS_CASE_PAYLOAD_BYTES);
+  c2c_tx_stage_u32(&tx, &p->ring->slots, (uint32_t)KWS_STREAM_RING_SLOTS);
+  c2c_tx_commit(&tx);
+}
+
+/* Publish case idx from its slot's local copy: payload (if full) + slot header, with prod_index as
+ * the commit word. A republish of an older case re-commits the current prod_index. */
+static inline void kws_stream_ring_publish_slot(kws_stream_ring_producer_t *p, uint32_t idx,
+                                                int full) {
+  uint32_t s = kws_stream_ring_slot_of(idx);
+  kws_stream_ring_slot_t *slot = &p->ring->slot[s];
+  uint64_t tx_cycle = (p->clock != NULL) ? p->clock() : 0u;
+  volatile uint32_t *tx_cycle_words = (volatile uint32_t *)&slot->dsp_tx_cycle;
+  c2c_tx_t tx;
+
+  c2c_tx_begin(&tx);
+  if (full) {
+    c2c_tx_stage_block(&tx, slot->case_payload, p->case_copy[s], KWS_CASE_PAYLOAD_BYTES);
+  }
+  c2c_tx_stage_u32(&tx, &slot->payload_checksum, p->checksum[s]);
+  c2c_tx_stage_u32(&tx, (volatile uint32_t *)&slot->expected_label, (uint32_t)p->expected_label[s]);
+  c2c_tx_stage_u32(&tx, (volatile uint32_t *)&slot->ref_case_index, (uint32_t)p->ref_case_index[s]);
+  c2c_tx_stage_u32(&tx, &tx_cycle_words[0], (uint32_t)tx_cycle);
+  c2c_tx_stage_u32(&tx, &tx_cycle_words[1], (uint32_t)(tx_cycle >> 32));
+  c2c_tx_stage_u32(&tx, &slot->case_index, idx);
+  c2c_tx_stage_commit(&tx, &p->ring->prod_index, p->prod);
+  c2c_tx_commit(&tx);
+  c2c_wake_peer();
+}
+
+/* Refresh ack_index from our own spad (logging newly acked cases) and serve a new NAK by
+ * republishing the full slot. Returns the current ack_index. */
+static inline uint32_t kws_stream_ring_poll(kws_stream_ring_producer_t *p) {
+  uint32_t ack;
+  uint32_t nak_seq;
+  uint32_t nak;
+
+  c2c_invalidate_range(p->dsp, sizeof(*p->dsp));
+  ack = p->dsp->ack_index;
+  nak_seq = p->dsp->nak_seq;
+  nak = p->dsp->nak_index;
+
+  if (ack > p->ack) {
+    KWS_STREAM_RING_LOG("case_index=%u acked; pred=%u score_q=%u (published=%u)\n",
+                        (unsigned)ack, (unsigned)p->dsp->bml_pred_class,
+                        (unsigned)p->dsp->bml_pred_score_q, (unsigned)p->prod);
+    p->ack = ack;
+  }
+  if (nak_seq != p->nak_seq) {
+    p->nak_seq = nak_seq;
+    if ((nak > ack) && (nak <= p->prod)) {
+      KWS_STREAM_RING_LOG("NAK case_index=%u -> republish slot %u\n",
+                          (unsigned)nak, (unsigned)kws_stream_ring_slot_of(nak));
+      p->republishes++;
+      kws_stream_ring_publish_slot(p, nak, /*full=*/1);
+    }
+  }
+  return ack;
+}
+
+/* Block until ack_index >= target. On an idle tick without it, re-commit prod_index and wake BML;
+ * an MSIP that brought no ack (a NAK's wake, a duplicate re-ack) only re-polls. */
+static inline void kws_stream_ring_wait_ack(kws_stream_ring_producer_t *p, uint32_t target) {
+  while (!kws_stream_ring_stopped(p->stop) && (kws_stream_ring_poll(p) < target)) {
+    uint64_t tick_due = c2c_mtime() + (uint64_t)C2C_POLL_INTERVAL_TICKS;
+
+    c2c_sleep_until_tick(); /* wake on BML's ack MSIP or the periodic timer */
+    if (kws_stream_ring_poll(p) >= target) {
+      break;
+    }
+    if (c2c_mtime() < tick_due) {
+      p->stale_recommits++;
+      continue;
+    }
+    KWS_STREAM_RING_LOG("ring full, waiting for ack_index=%u (have %u); re-commit [self-heal]\n",
+                        (unsigned)target, (unsigned)p->ack);
+    p->recommits++;
+    c2c_remote_write_u32(&p->ring->prod_index, p->prod);
+    c2c_wake_peer();
+  }
+}
+
+/* Take case idx's slot: wait until idx - ack_index <= SLOTS, copy the case into the slot's local
+ * copy and publish it (full = payload too; 0 = header only, for a payload already resident). */
+static inline void kws_stream_ring_publish(kws_stream_ring_producer_t *p, uint32_t idx,
+                                           const int8_t *payload, uint32_t checksum,
+                                           int32_t expected_label, int32_t ref_case_index,
+                                           int full) {
+  uint32_t s = kws_stream_ring_slot_of(idx);
+
+  if (idx > KWS_STREAM_RING_SLOTS) {
+    kws_stream_ring_wait_ack(p, idx - KWS_STREAM_RING_SLOTS);
+  } else {
+    (void)kws_stream_ring_poll(p);
+  }
+  for (uint32_t i = 0; i < (uint32_t)KWS_CASE_PAYLOAD_BYTES; ++i) {
+    p->case_copy[s][i] = payload[i];
+  }
+  p->checksum[s] = checksum;
+  p->expected_label[s] = expected_label;
+  p->ref_case_index[s] = ref_case_index;
+  p->prod = idx;
+  kws_stream_ring_publish_slot(p, idx, full);
+}
+
+/* ---- Consumer (BML) ---------------------------------------------------------------------- */
+
+typedef struct {
+  kws_stream_ring_bml_spad_t *ring;   /* own spad (local reads) */
+  kws_stream_dsp_spad_t *dsp;         /* DSP spad, cross-link address (remote writes only) */
+  void (*stage_result)(c2c_tx_t *tx); /* result words sent with every ack; NULL = none */
+  volatile const int *stop;           /* optional: receive returns 0 once *stop != 0 */
+  uint32_t last_consumed;             /* last case acked */
+  uint32_t nak_seq;                   /* last nak_seq sent */
+  uint32_t reacks;                    /* last ack re-sent on a wake with nothing new */
+  uint32_t naks;                      /* slots NAKed (header mismatch or checksum give-up) */
+} kws_stream_ring_consumer_t;
+
+static inline void kws_stream_ring_consumer_init(kws_stream_ring_consumer_t *c,
+                                                 kws_stream_ring_bml_spad_t *ring,
+                                                 kws_stream_dsp_spad_t *dsp,
+                                                 void (*stage_result)(c2c_tx_t *tx)) {
+  c->ring = ring;
+  c->dsp = dsp;
+  c->stage_result = stage_result;
+  c->stop = NULL;
+  c->last_consumed = 0u;
+  c->nak_seq = 0u;
+  c->reacks = 0u;
+  c->naks = 0u;
+}
+
+/* Local boot-clear of the ring control block and slot headers, before announcing readiness. */
+static inline void kws_stream_ring_boot_clear(kws_stream_ring_consumer_t *c) {
+  c2c_local_write_u32(&c->ring->prod_index, 0u);
+  for (uint32_t s = 0; s < KWS_STREAM_RING_SLOTS; ++s) {
+    c2c_local_write_u32(&c->ring->slot[s].case_index, 0u);
+  }
+}
+
+/* Ack case idx: result words, then ack_index as the commit word (frees its slot), then wake DSP in
+ * case it is waiting on a full ring. */
+static inline void kws_stream_ring_ack(kws_stream_ring_consumer_t *c, uint32_t idx) {
+  c2c_tx_t tx;
+
+  c2c_tx_begin(&tx);
+  if (c->stage_result != NULL) {
+    c->stage_result(&tx);
+  }
+  c2c_tx_stage_commit(&tx, &c->dsp->ack_index, idx);
+  c2c_tx_commit(&tx);
+  c2c_wake_peer();
+  c->last_consumed = idx;
+}
+
+/* NAK case idx: DSP republishes its slot from its local copy. nak_seq is the commit word so a
+ * second NAK of the same case is still a change DSP can see. */
+static inline void kws_stream_ring_nak(kws_stream_ring_consumer_t *c, uint32_t idx) {
+  c2c_tx_t tx;
+
+  c2c_tx_begin(&tx);
+  c2c_tx_stage_u32(&tx, &c->dsp->nak_index, idx);
+  c2c_tx_stage_commit(&tx, &c->dsp->nak_seq, ++c->nak_seq);
+  c2c_tx_commit(&tx);
+  c2c_wake_peer();
+  c->naks++;
+}
+
+/* Block until case last_consumed+1 is published, then verify its payload into dst
+ * (KWS_CASE_PAYLOAD_BYTES) and return its index; the slot header (expected_label, ...) stays
+ * readable in the spad until the case is acked. A slot whose header does not carry the expected
+ * case, or whose payload fails the checksum, is NAKed; the periodic tick re-NAKs until DSP's
+ * republish lands. Returns 0 only if `stop` was raised. */
+static inline uint32_t kws_stream_ring_receive(kws_stream_ring_consumer_t *c, int8_t *dst) {
+  uint32_t idx = c->last_consumed + 1u;
+  kws_stream_ring_slot_t *slot = &c->ring->slot[kws_stream_ring_slot_of(idx)];
+
+  for (int woke = 0; !kws_stream_ring_stopped(c->stop); woke = 1) {
+    if (c2c_local_read_u32(&c->ring->prod_index) < idx) {
+      if (woke && (c->last_consumed != 0u)) {
+        c->reacks++;
+        kws_stream_ring_ack(c, c->last_consumed);
+      }
+    } else {
+      c2c_invalidate_range(slot, 0x40u); /* slot header line */
+      if ((slot->case_index == idx) &&
+          c2c_local_read_block_verify(dst, slot->case_payload, KWS_CASE_PAYLOAD_BYTES,
+                                      slot->payload_checksum)) {
+        return idx;
+      }
+      KWS_STREAM_RING_LOG("ring slot %u verify FAILED case_index=%u (slot has %u); NAK\n",
+                          (unsigned)kws_stream_ring_slot_of(idx), (unsigned)idx,
+                          (unsigned)slot->case_index);
+      kws_stream_ring_nak(c, idx);
+    }
+    c2c_sleep_until_tick(); /* wake on DSP's publish MSIP or the periodic timer */
+  }
+  return 0u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* C2C_KWS_STREAM_RING_H */
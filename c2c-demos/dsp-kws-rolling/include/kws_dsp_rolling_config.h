@@ -75,6 +75,17 @@
 #define KWS_DSP_ROLLING_USE_THREADLIB 0
 #endif
 
+/* 1 (default) = compute each case with the streaming MFCC context (mfcc-lib mfcc_stream.h): every
+ * frame is read in place from the stream's history, with the coefficient-major matrix built
+ * directly, instead of copying a 1024-sample window per frame. Features differ from the per-frame
+ * path only by rounding (no absmax normalization round trip). An embedded clip is pushed whole per
+ * case. In mic mode the stream stays alive across cases: the capture reads a DMA-fed I2S ring
+ * (hal_i2s_stream.h) and pushes only the audio that arrived since the previous case, so each hop is
+ * analyzed once. 0 = the per-frame driver path (multi-core with thread-lib). */
+#ifndef KWS_DSP_ROLLING_MFCC_STREAM
+#define KWS_DSP_ROLLING_MFCC_STREAM 1
+#endif
+
 /* Multi-testcase mode (plan 003 axis B). 0 (default) = the original single embedded yes_test_005
  * waveform, streamed repeatedly (static payload). 1 = round-robin over the generated waveform set
  * in kws_dsp_signals.h (a few recordings per keyword), computing a fresh MFCC case per recording
@@ -202,6 +213,17 @@
 #define KWS_DSP_ROLLING_MIC_FULLSCALE 8388608.0f /* 2^23 */
 #endif
 
+/* Stream mode (KWS_DSP_ROLLING_MFCC_STREAM) has no per-window mean to subtract; DC is tracked by a
+ * one-pole high-pass, dc += ALPHA * (x - dc). 1e-3 = ~2.5 Hz corner at 16 kHz. */
+#ifndef KWS_DSP_ROLLING_MIC_DC_ALPHA
+#define KWS_DSP_ROLLING_MIC_DC_ALPHA 1.0e-3f
+#endif
+/* Stream mode without the VAD gate: new samples per case (16000 = back-to-back 1 s windows; less
+ * overlaps consecutive cases, reusing the frames already analyzed). */
+#ifndef KWS_DSP_ROLLING_MIC_STRIDE_SAMPLES
+#define KWS_DSP_ROLLING_MIC_STRIDE_SAMPLES KWS_DSP_ROLLING_MIC_NUM_SAMPLES
+#endif
+
 /* --- Voice-activity gate (plan 001 §7). Monitor short-frame AC energy; when it crosses
  * KWS_DSP_ROLLING_VAD_THRESHOLD, capture the case starting from a short pre-roll before the onset so
  * the word's attack isn't clipped, then fill a full 1 s window. Set KWS_DSP_ROLLING_VAD_ENABLE=0 to
@@ -15,15 +15,28 @@
 #include "c2c_shm.h"
 #include "c2c_turnsync.h"
 #include "kws_stream_proto.h"
+#define KWS_STREAM_RING_LOG(...) KWS_DSP_ROLLING_LOG("[dsp-kws-stream] " __VA_ARGS__)
+#include "kws_stream_ring.h"
+#if KWS_DSP_ROLLING_MFCC_STREAM
+#include "mfcc_stream.h"
+#endif
 
 #if KWS_DSP_ROLLING_USE_MIC
 #include "rocketcore.h"
 #include "hal_mmio.h"
 #include "hal_i2s.h"
+#if KWS_DSP_ROLLING_MFCC_STREAM
+#include "hal_i2s_stream.h"
+#endif
 
+#if KWS_DSP_ROLLING_MFCC_STREAM
+/* Live audio goes straight into the MFCC stream (mic_capture_case), one VAD frame at a time. */
+static float32_t g_mic_frame[KWS_DSP_ROLLING_VAD_FRAME_SAMPLES];
+#else
 /* One live-audio window (raw 24-bit samples scaled to float ~[-1,1], DC removed). Reused as the
  * "signal" buffer for every case, so all the downstream MFCC code is unchanged. */
 static float32_t g_mic_audio[KWS_DSP_ROLLING_MIC_NUM_SAMPLES];
+#endif
 
 /* Mic config: RX + internal clock generator on, 32-bit, DAC off. Mirrors the proven dsp-i2s-test
  * i2s_params_mic. clkdiv is a placeholder; set_I2S_sample_freq() overrides it for exactly 16 kHz at
@@ -44,9 +57,11 @@ static i2s_params_t g_i2s_params_mic = {
 };
 
 #if KWS_DSP_ROLLING_VAD_ENABLE
+#if !KWS_DSP_ROLLING_MFCC_STREAM
 /* Pre-roll ring of the most-recent monitoring samples (scaled float), so the window can start
- * shortly BEFORE the detected onset. */
+ * shortly BEFORE the detected onset. (Stream mode: the MFCC history already holds the pre-roll.) */
 static float32_t g_vad_ring[KWS_DSP_ROLLING_VAD_PREROLL_SAMPLES];
+#endif
 _Static_assert((KWS_DSP_ROLLING_VAD_FRAME_SAMPLES % 2u) == 0u, "VAD frame must be even (I2S reads pairs).");
 _Static_assert((KWS_DSP_ROLLING_VAD_PREROLL_SAMPLES % KWS_DSP_ROLLING_VAD_FRAME_SAMPLES) == 0u,
                "VAD pre-roll must be a whole number of frames.");
@@ -58,6 +73,7 @@ _Static_assert(KWS_DSP_ROLLING_VAD_PREROLL_SAMPLES < KWS_DSP_ROLLING_MIC_NUM_SAM
 /* One signal source per streamed case. In single mode this is the embedded yes_test_005 waveform;
  * in multi mode we index the generated table. Every case labels the payload with a ground-truth
  * class so BML can score pred-vs-expected. */
+#if !(KWS_DSP_ROLLING_USE_MIC && KWS_DSP_ROLLING_MFCC_STREAM)
 static const float *signal_samples(uint32_t s) {
 #if KWS_DSP_ROLLING_USE_MIC
   (void)s;
@@ -69,6 +85,8 @@ static const float *signal_samples(uint32_t s) {
   return g_kws_dsp_yes005_signal;
 #endif
 }
+#endif
+#if !KWS_DSP_ROLLING_MFCC_STREAM
 static uint32_t signal_num_samples(uint32_t s) {
 #if KWS_DSP_ROLLING_USE_MIC
   (void)s;
@@ -81,6 +99,7 @@ static uint32_t signal_num_samples(uint32_t s) {
   return KWS_DSP_YES005_NUM_SAMPLES;
 #endif
 }
+#endif
 static int32_t signal_label(uint32_t s) {
 #if KWS_DSP_ROLLING_USE_MIC
   (void)s;
@@ -162,7 +181,17 @@ static kws_stream_bml_spad_t *const g_bml =
     (kws_stream_bml_spad_t *)(uintptr_t)KWS_STREAM_BML_SPAD_PEER;   /* peer, cross-link writes */
 
 static mfcc_driver_t g_mfcc;
+#if KWS_DSP_ROLLING_MFCC_STREAM
+/* Samples that produce exactly FRAMES_PER_CASE frames at the signal hop. */
+#define KWS_DSP_ROLLING_CASE_SAMPLES \
+  ((((uint32_t)KWS_DSP_ROLLING_FRAMES_PER_CASE - 1u) * KWS_DSP_ROLLING_SIGNAL_HOP_SAMPLES) + MFCC_DRIVER_FFT_LEN)
+/* Lives across cases: reset at init and, for embedded clips, per clip; in mic mode never again. */
+static mfcc_stream_t g_mfcc_stream;
+static uint64_t g_stream_frames_mark;  /* g_mfcc_stream.frames/cycles at the previous case */
+static uint64_t g_stream_cycles_mark;
+#else
 static float32_t g_input_window[MFCC_DRIVER_FFT_LEN];
+#endif
 static int8_t g_case[KWS_CASE_PAYLOAD_BYTES];
 static float32_t g_case_f32[KWS_CASE_PAYLOAD_BYTES]; /* full float MFCC map before quantization */
 static uint32_t g_mfcc_fail_local;
@@ -179,6 +208,7 @@ static inline uint64_t rdcycle64(void) {
   return x;
 }
 
+#if !KWS_DSP_ROLLING_MFCC_STREAM
 static void load_signal_window(uint32_t sig_idx, uint8_t frame_idx, float32_t *dst) {
   const float *samples = signal_samples(sig_idx);
   const uint32_t len = signal_num_samples(sig_idx);
@@ -189,6 +219,7 @@ static void load_signal_window(uint32_t sig_idx, uint8_t frame_idx, float32_t *d
     dst[n] = (idx < len) ? samples[idx] : 0.0f;
   }
 }
+#endif
 
 static int8_t clip_i8(int32_t qi) {
   if (qi > 127) {
@@ -205,6 +236,7 @@ static int8_t quantize_mfcc_fixed(float32_t x) {
   return clip_i8((int32_t)lrintf(qf));
 }
 
+#if !KWS_DSP_ROLLING_MFCC_STREAM
 /* Fill mfcc_f32_out with KWS_MFCC_DIM float coefficients for one frame (no quantization — the whole
  * case is quantized together so per-case normalization can match the reference recipe). */
 static mfcc_driver_status_t compute_one_mfcc_frame(uint32_t sig_idx,
@@ -245,18 +277,43 @@ static mfcc_driver_status_t compute_one_mfcc_frame(uint32_t sig_idx,
   *mfcc_cycles_out = mfcc_cycles;
   return MFCC_DRIVER_OK;
 }
+#endif
 
 /* Compute a full 94-frame case for signal sig_idx into g_case (coeff-major). All frames' float
  * MFCCs are buffered first so the whole case can be quantized together — this lets the default
  * per-case normalization match the reference recipe (q = clip(round(x * 127/max|x|))). */
 static void compute_full_case(uint32_t sig_idx) {
   uint64_t total_mfcc_cycles = 0u;
+  uint32_t mfcc_frames = (uint32_t)KWS_DSP_ROLLING_FRAMES_PER_CASE; /* frames analyzed for this case */
   float32_t case_amax = 0.0f;
 
   g_case_expected_label = signal_label(sig_idx);
   g_case_ref_index = signal_ref_index(sig_idx);
   g_mfcc_fail_local = 0u;
 
+#if KWS_DSP_ROLLING_MFCC_STREAM
+  /* The stream's rolling matrix is already coefficient-major {H=12, W=94}; take it whole. In mic
+   * mode mic_capture_case has pushed only the audio that arrived since the previous case into the
+   * live stream, so only those hops were analyzed. An embedded clip is a separate recording: its
+   * frames start from an empty history. */
+#if !KWS_DSP_ROLLING_USE_MIC
+  mfcc_stream_reset(&g_mfcc_stream);
+  g_stream_frames_mark = 0u;
+  g_stream_cycles_mark = 0u;
+  (void)mfcc_stream_push(&g_mfcc_stream, signal_samples(sig_idx), KWS_DSP_ROLLING_CASE_SAMPLES);
+#endif
+  memcpy(g_case_f32, mfcc_stream_features(&g_mfcc_stream), sizeof(g_case_f32));
+  for (uint32_t i = 0; i < (uint32_t)KWS_CASE_PAYLOAD_BYTES; ++i) {
+    float32_t a = (g_case_f32[i] < 0.0f) ? -g_case_f32[i] : g_case_f32[i];
+    if (a > case_amax) {
+      case_amax = a;
+    }
+  }
+  total_mfcc_cycles = g_mfcc_stream.cycles - g_stream_cycles_mark;
+  mfcc_frames = (uint32_t)(g_mfcc_stream.frames - g_stream_frames_mark);
+  g_stream_cycles_mark = g_mfcc_stream.cycles;
+  g_stream_frames_mark = g_mfcc_stream.frames;
+#else
   for (uint8_t frame_idx = 0; frame_idx < (uint8_t)KWS_DSP_ROLLING_FRAMES_PER_CASE; ++frame_idx) {
     float32_t mfcc_f32[KWS_MFCC_DIM];
     uint64_t mfcc_cycles = 0u;
@@ -275,6 +332,7 @@ static void compute_full_case(uint32_t sig_idx) {
     }
     total_mfcc_cycles += mfcc_cycles;
   }
+#endif
 
   /* Quantize the whole map. */
 #if KWS_DSP_ROLLING_MFCC_NORMALIZE
@@ -290,16 +348,17 @@ static void compute_full_case(uint32_t sig_idx) {
 
   g_case_checksum = c2c_checksum(g_case, KWS_CASE_PAYLOAD_BYTES);
 
-  KWS_DSP_ROLLING_LOG("[dsp-kws-stream] case computed sig=%u name=%s expected=%ld ref=%ld frames=%u amax=%d/1000 checksum=0x%08lx avg_mfcc_cycles/frame=%llu fails=%u\n",
+  KWS_DSP_ROLLING_LOG("[dsp-kws-stream] case computed sig=%u name=%s expected=%ld ref=%ld frames=%u analyzed=%u amax=%d/1000 checksum=0x%08lx avg_mfcc_cycles/frame=%llu fails=%u\n",
                       (unsigned)sig_idx, signal_name(sig_idx),
                       (long)g_case_expected_label, (long)g_case_ref_index,
-                      (unsigned)KWS_DSP_ROLLING_FRAMES_PER_CASE,
+                      (unsigned)KWS_DSP_ROLLING_FRAMES_PER_CASE, (unsigned)mfcc_frames,
                       (int)lrintf(case_amax * 1000.0f),
                       (unsigned long)g_case_checksum,
-                      (unsigned long long)(total_mfcc_cycles / KWS_DSP_ROLLING_FRAMES_PER_CASE),
+                      (unsigned long long)(mfcc_frames ? (total_mfcc_cycles / mfcc_frames) : 0u),
                       (unsigned)g_mfcc_fail_local);
 }
 
+#if !KWS_STREAM_USE_RING
 /* Identity (magic/version/payload_bytes) into BML's spad. Cross-link write -> app_main only. */
 static void publish_identity(void) {
   c2c_remote_write_u32(&g_bml->magic, KWS_STREAM_MAGIC_BML);
@@ -307,38 +366,97 @@ static void publish_identity(void) {
   c2c_remote_write_u32(&g_bml->payload_bytes, (uint32_t)KWS_CASE_PAYLOAD_BYTES);
 }
 
-/* Full publish: whole payload + checksum + tx_cycle, then case_index (written before the turn). */
-static void publish_case_full(uint32_t idx) {
+/* Full publish: whole payload + checksum + tx_cycle + case_index, staged into one transaction. */
+static void publish_case_full(c2c_tx_t *tx, uint32_t idx) {
   uint64_t tx_cycle = rdcycle64();
-
-  c2c_remote_write_block(g_bml->case_payload, g_case, KWS_CASE_PAYLOAD_BYTES);
-  c2c_remote_write_u32(&g_bml->payload_checksum, g_case_checksum);
-  c2c_remote_write_u32((volatile uint32_t *)&g_bml->expected_label, (uint32_t)g_case_expected_label);
-  c2c_remote_write_u32((volatile uint32_t *)&g_bml->ref_case_index, (uint32_t)g_case_ref_index);
-  c2c_remote_write_block(&g_bml->dsp_tx_cycle, &tx_cycle, sizeof(tx_cycle));
-  c2c_remote_write_u32(&g_bml->case_index, idx);
+  volatile uint32_t *tx_cycle_words = (volatile uint32_t *)&g_bml->dsp_tx_cycle;
+
+  c2c_tx_stage_block(tx, g_bml->case_payload, g_case, KWS_CASE_PAYLOAD_BYTES);
+  c2c_tx_stage_u32(tx, &g_bml->payload_checksum, g_case_checksum);
+  c2c_tx_stage_u32(tx, (volatile uint32_t *)&g_bml->expected_label, (uint32_t)g_case_expected_label);
+  c2c_tx_stage_u32(tx, (volatile uint32_t *)&g_bml->ref_case_index, (uint32_t)g_case_ref_index);
+  c2c_tx_stage_u32(tx, &tx_cycle_words[0], (uint32_t)tx_cycle);
+  c2c_tx_stage_u32(tx, &tx_cycle_words[1], (uint32_t)(tx_cycle >> 32));
+  c2c_tx_stage_u32(tx, &g_bml->case_index, idx);
 }
 
 /* Static-payload fast path: payload+checksum already resident in BML's spad; just bump case_index
  * to re-trigger inference on the same data. Turn-taking serializes access, so even a full publish
  * every round is now safe — this is purely a throughput optimization. */
-static void publish_case_recommit(uint32_t idx) {
-  c2c_remote_write_u32(&g_bml->case_index, idx);
+static void publish_case_recommit(c2c_tx_t *tx, uint32_t idx) {
+  c2c_tx_stage_u32(tx, &g_bml->case_index, idx);
 }
 
-/* Hand the turn to BML: publish the case data, then flip the turn register (peer spad = commit,
- * so data is resident before BML sees its turn; then our own spad = "not ours"), then wake BML. */
+/* Hand the turn to BML: publish the case data with the turn register as the transaction's commit
+ * word (peer spad, written only after the data is flushed), then our own spad = "not ours", then
+ * wake BML. A torn payload fails BML's checksum and comes back as a re-ack; the re-grant that
+ * follows re-publishes the payload in full. */
 static void handoff_to_bml(uint32_t idx, int full) {
+  c2c_tx_t tx;
+
+  c2c_tx_begin(&tx);
   if (full) {
-    publish_case_full(idx);
+    publish_case_full(&tx, idx);
   } else {
-    publish_case_recommit(idx);
+    publish_case_recommit(&tx, idx);
   }
-  c2c_remote_write_u32(&g_bml->turn, C2C_TURN_BML); /* commit: BML's turn, in BML's spad */
+  c2c_tx_stage_commit(&tx, &g_bml->turn, C2C_TURN_BML); /* commit: BML's turn, in BML's spad */
+  c2c_tx_commit(&tx);
   c2c_local_write_u32(&g_dsp->turn, C2C_TURN_BML);  /* our own spad: no longer our turn */
   c2c_wake_peer();
   g_case_index = idx;
 }
+#else
+/* Ring mode (kws_stream_proto.h, state machine in kws_stream_ring.h): case n goes to slot
+ * (n-1)%SLOTS of BML's spad, and DSP only waits when every slot holds a case BML has not acked
+ * yet. */
+static kws_stream_ring_producer_t g_ring;
+
+static uint64_t ring_clock(void) {
+  return rdcycle64();
+}
+
+#if KWS_DSP_ROLLING_USE_MIC
+static void mic_capture_case(void);
+#endif
+
+/* Producer loop: compute case idx while BML infers earlier ones, wait for a free slot, publish. */
+static void __attribute__((noreturn)) ring_run(void) {
+  for (uint32_t idx = 1u;; ++idx) {
+    uint32_t s = kws_stream_ring_slot_of(idx);
+    /* Static payload: every slot gets the payload once, later rounds rewrite only the header. */
+    int full = KWS_DSP_ROLLING_FULL_PUBLISH || (idx <= KWS_STREAM_RING_SLOTS);
+
+    if (idx > 1u) {
+#if KWS_DSP_ROLLING_INTER_CASE_QUIET_CYCLES && !KWS_DSP_ROLLING_USE_MIC
+      uint64_t q0 = rdcycle64();
+      while ((rdcycle64() - q0) < (uint64_t)KWS_DSP_ROLLING_INTER_CASE_QUIET_CYCLES) {
+        __asm__ volatile("nop");
+      }
+#endif
+#if KWS_DSP_ROLLING_USE_MIC
+      mic_capture_case();
+      compute_full_case(0u);
+#elif KWS_DSP_ROLLING_MULTI_SIGNAL
+      compute_full_case(signal_for_case(idx));
+#endif
+    }
+
+    KWS_DSP_ROLLING_LOG("[dsp-kws-stream] publishing case_index=%u -> slot %u (%s)\n",
+                        (unsigned)idx, (unsigned)s, full ? "full payload" : "header only");
+    kws_stream_ring_publish(&g_ring, idx, g_case, g_case_checksum, g_case_expected_label,
+                            g_case_ref_index, full);
+    g_case_index = idx;
+
+#if KWS_DSP_ROLLING_PUBLISH_ONCE
+    KWS_DSP_ROLLING_LOG("[dsp-kws-stream] PUBLISH_ONCE: done; entering wfi (link idle)\n");
+    while (1) {
+      __asm__ volatile("wfi");
+    }
+#endif
+  }
+}
+#endif /* KWS_STREAM_USE_RING */
 
 /* Boot barrier: poll our LOCAL 0xC for bml_ready. No cross-link writes until we see it (a write
  * into a still-booting BML kills it). */
@@ -369,15 +487,157 @@ static inline int32_t mic_extract_sample(uint32_t slot) {
   return ((int32_t)slot) >> KWS_DSP_ROLLING_MIC_SAMPLE_SHIFT;
 }
 
+#if KWS_DSP_ROLLING_MFCC_STREAM
+/* DMA-fed capture ring: the mic keeps streaming into it while the CPU runs MFCC or services the
+ * link, and reads below never stall on the FIFO. Views are one pair wide (window = hop = 2). */
+#define KWS_DSP_ROLLING_MIC_RING_PERIOD   KWS_DSP_ROLLING_VAD_FRAME_SAMPLES
+#define KWS_DSP_ROLLING_MIC_RING_CAPACITY (16u * KWS_DSP_ROLLING_MIC_RING_PERIOD)
+static uint32_t g_mic_ring[I2S_STREAM_BUFFER_WORDS(KWS_DSP_ROLLING_MIC_RING_CAPACITY, 2u)]
+    __attribute__((aligned(8)));
+static i2s_stream_t g_mic_stream;
+
+static void mic_stream_start(void) {
+  const i2s_stream_config_t cfg = {
+      .channel     = KWS_DSP_ROLLING_MIC_CHANNEL,
+      .side        = I2S_LEFT,
+      .dir         = I2S_STREAM_RX,
+      .mode        = I2S_STREAM_DMA,
+      .dma_channel = DMA_CORE_CHANNEL_COUNT,
+      .buffer      = g_mic_ring,
+      .capacity    = KWS_DSP_ROLLING_MIC_RING_CAPACITY,
+      .period      = KWS_DSP_ROLLING_MIC_RING_PERIOD,
+      .window      = 2u,
+      .hop         = 2u,
+      .watermark   = 0u,
+  };
+  if ((i2s_stream_init(&g_mic_stream, &cfg) != 0) || (i2s_stream_start(&g_mic_stream) != 0)) {
+    KWS_DSP_ROLLING_LOG("[dsp-kws-stream] mic: I2S stream start failed\n");
+    while (1) {
+      __asm__ volatile("wfi");
+    }
+  }
+}
+#endif
+
 /* Pop one 64-bit RX block from the mic (LEFT) = two consecutive time samples, scaled to float
  * ~[-1,1]. Mirrors the proven dsp-i2s-test read model; the mic's internal clkgen free-runs, so a
  * blind read blocks until a sample is available. */
 static inline void mic_read_pair(float32_t *s0, float32_t *s1) {
+#if KWS_DSP_ROLLING_MFCC_STREAM
+  i2s_frame_t f;
+  while (!i2s_stream_frame_acquire(&g_mic_stream, &f)) {
+    i2s_stream_poll(&g_mic_stream);
+  }
+  uint64_t v = (uint64_t)f.samples[0] | ((uint64_t)f.samples[1] << 32);
+  i2s_stream_frame_release(&g_mic_stream);
+#else
   uint64_t v = read_I2S_rx(KWS_DSP_ROLLING_MIC_CHANNEL, I2S_LEFT);
+#endif
   *s0 = (float32_t)mic_extract_sample((uint32_t)(v & 0xFFFFFFFFu)) * (1.0f / KWS_DSP_ROLLING_MIC_FULLSCALE);
   *s1 = (float32_t)mic_extract_sample((uint32_t)(v >> 32)) * (1.0f / KWS_DSP_ROLLING_MIC_FULLSCALE);
 }
 
+#if KWS_DSP_ROLLING_MFCC_STREAM
+/* DC tracker (one-pole high-pass) and per-case level stats of the audio pushed into the stream. */
+static float32_t g_mic_dc;
+static bool g_mic_dc_valid;
+
+typedef struct {
+  float32_t vmin;
+  float32_t vmax;
+  float32_t abssum;
+  uint32_t n;
+} mic_stats_t;
+
+static inline float32_t mic_remove_dc(float32_t x, mic_stats_t *st) {
+  if (!g_mic_dc_valid) {
+    g_mic_dc = x;
+    g_mic_dc_valid = true;
+  }
+  g_mic_dc += (float32_t)KWS_DSP_ROLLING_MIC_DC_ALPHA * (x - g_mic_dc);
+  x -= g_mic_dc;
+  if (x < st->vmin) st->vmin = x;
+  if (x > st->vmax) st->vmax = x;
+  st->abssum += (x < 0.0f) ? -x : x;
+  st->n++;
+  return x;
+}
+
+/* Read one VAD frame from the mic ring, push it into the MFCC stream (analyzing any hop it
+ * completes) and return its AC energy, the same gate measure as the windowed capture. */
+static float32_t mic_push_frame(mic_stats_t *st) {
+  const uint32_t FR = KWS_DSP_ROLLING_VAD_FRAME_SAMPLES;
+  float32_t sum = 0.0f;
+  float32_t sumsq = 0.0f;
+
+  for (uint32_t i = 0; i < FR; i += 2u) {
+    float32_t a, b;
+    mic_read_pair(&a, &b);
+    a = mic_remove_dc(a, st);
+    b = mic_remove_dc(b, st);
+    g_mic_frame[i] = a;
+    g_mic_frame[i + 1u] = b;
+    sum += a + b;
+    sumsq += (a * a) + (b * b);
+  }
+  (void)mfcc_stream_push(&g_mfcc_stream, g_mic_frame, FR);
+
+  float32_t mean = sum / (float32_t)FR;
+  float32_t energy = (sumsq / (float32_t)FR) - (mean * mean);
+  return (energy < 0.0f) ? 0.0f : energy;
+}
+
+/* Advance the live MFCC stream to the next case. The mic is never flushed and the stream never
+ * reset: only audio that arrived since the previous case is pushed, so each hop is analyzed once
+ * and the 94-frame matrix rolls forward. With the VAD gate the stream keeps running while
+ * listening; after an onset it is fed MIC_NUM_SAMPLES - PREROLL more samples, which leaves the
+ * pre-roll and the onset at the start of the matrix as in the windowed capture. Without it each
+ * case advances by KWS_DSP_ROLLING_MIC_STRIDE_SAMPLES. */
+static void mic_capture_case(void) {
+  const uint32_t FR = KWS_DSP_ROLLING_VAD_FRAME_SAMPLES;
+  mic_stats_t st = {1.0f, -1.0f, 0.0f, 0u};
+  uint32_t remaining;
+
+#if KWS_DSP_ROLLING_VAD_ENABLE
+  uint32_t frame_ctr = 0u;
+
+  KWS_DSP_ROLLING_LOG("[dsp-kws-stream] mic: listening (VAD thresh=%d/1e6; speak now)...\n",
+                      (int)lrintf((float32_t)KWS_DSP_ROLLING_VAD_THRESHOLD * 1.0e6f));
+
+  for (;;) {
+    float32_t energy = mic_push_frame(&st);
+
+#if KWS_DSP_ROLLING_VAD_LOG_EVERY
+    if ((frame_ctr % KWS_DSP_ROLLING_VAD_LOG_EVERY) == 0u) {
+      KWS_DSP_ROLLING_LOG("[dsp-kws-stream] mic: vad frame=%u energy=%d/1e6\n",
+                          (unsigned)frame_ctr, (int)lrintf(energy * 1.0e6f));
+    }
+#endif
+    frame_ctr++;
+
+    if (energy >= (float32_t)KWS_DSP_ROLLING_VAD_THRESHOLD) {
+      KWS_DSP_ROLLING_LOG("[dsp-kws-stream] mic: onset frame=%u energy=%d/1e6 -> capturing\n",
+                          (unsigned)frame_ctr, (int)lrintf(energy * 1.0e6f));
+      break;
+    }
+  }
+  remaining = KWS_DSP_ROLLING_MIC_NUM_SAMPLES - KWS_DSP_ROLLING_VAD_PREROLL_SAMPLES;
+#else
+  remaining = KWS_DSP_ROLLING_MIC_STRIDE_SAMPLES;
+#endif
+
+  /* The first case also waits for a full matrix (no leading zero columns). */
+  while ((remaining > 0u) || !mfcc_stream_full(&g_mfcc_stream)) {
+    (void)mic_push_frame(&st);
+    remaining = (remaining > FR) ? (remaining - FR) : 0u;
+  }
+
+  KWS_DSP_ROLLING_LOG("[dsp-kws-stream] mic: pushed %u samples dc=%d/1e6 min=%d/1e6 max=%d/1e6 absmean=%d/1e6 overruns=%u\n",
+                      (unsigned)st.n, (int)lrintf(g_mic_dc * 1.0e6f), (int)lrintf(st.vmin * 1.0e6f),
+                      (int)lrintf(st.vmax * 1.0e6f), (int)lrintf((st.abssum / (float32_t)st.n) * 1.0e6f),
+                      (unsigned)g_mic_stream.overruns);
+}
+#else
 /* Capture one ~1 s window of live mic audio into g_mic_audio (scaled float, DC removed) — the same
  * shape as an embedded waveform, so all the downstream MFCC code is unchanged. With the VAD gate
  * enabled, monitors short-frame AC energy and starts capturing only once a speech onset crosses the
@@ -471,6 +731,7 @@ static void mic_capture_case(void) {
                       (unsigned)N, (int)lrintf(dc * 1.0e6f), (int)lrintf(vmin * 1.0e6f),
                       (int)lrintf(vmax * 1.0e6f), (int)lrintf(absmean * 1.0e6f));
 }
+#endif /* KWS_DSP_ROLLING_MFCC_STREAM */
 #endif /* KWS_DSP_ROLLING_USE_MIC */
 
 void app_init(void) {
@@ -492,6 +753,15 @@ void app_init(void) {
       __asm__ volatile("wfi");
     }
   }
+#if KWS_DSP_ROLLING_MFCC_STREAM
+  if (mfcc_stream_init(&g_mfcc_stream, &g_mfcc, KWS_DSP_ROLLING_SIGNAL_HOP_SAMPLES,
+                       KWS_DSP_ROLLING_FRAMES_PER_CASE) != MFCC_DRIVER_OK) {
+    KWS_DSP_ROLLING_LOG("[dsp-kws-stream] MFCC stream init failed\n");
+    while (1) {
+      __asm__ volatile("wfi");
+    }
+  }
+#endif
 
 #if KWS_DSP_ROLLING_USE_MIC
   /* Configure the I2S mic (channel 0, per the validated pinout) and clock it at exactly 16 kHz for
@@ -504,6 +774,9 @@ void app_init(void) {
                       KWS_DSP_ROLLING_MIC_CHANNEL, (unsigned)KWS_DSP_ROLLING_MIC_SAMPLE_RATE_HZ,
                       (unsigned)KWS_DSP_ROLLING_MIC_BITDEPTH,
                       (unsigned)reg_read16(I2S_CONFIG(KWS_DSP_ROLLING_MIC_CHANNEL)));
+#if KWS_DSP_ROLLING_MFCC_STREAM
+  mic_stream_start();
+#endif
 #endif
 
   KWS_DSP_ROLLING_LOG("[dsp-kws-stream] init own_spad=0x%08lx peer_spad=0x%09llx payload_bytes=%u signals=%u mode=%s\n",
@@ -525,6 +798,10 @@ void app_main(void) {
   /* Local boot-clear of our OWN 0xC control block: turn = BML (not ours until we grant it after
    * the first publish), and clear the stale barrier flag. Local writes — safe. */
   c2c_local_write_u32(&g_dsp->turn, C2C_TURN_BML);
+#if KWS_STREAM_USE_RING
+  c2c_local_write_u32(&g_dsp->ack_index, 0u);
+  c2c_local_write_u32(&g_dsp->nak_seq, 0u);
+#endif
 
   /* Boot barrier: do NOT write BML's spad until BML says it has booted. */
   KWS_DSP_ROLLING_LOG("[dsp-kws-stream] waiting for BML boot barrier before touching peer spad\n");
@@ -539,6 +816,17 @@ void app_main(void) {
   compute_full_case(0u);
 #endif
 
+#if KWS_STREAM_USE_RING
+  /* Ring: identity first, then the producer loop publishes case 1 (already computed) into slot 0
+   * and keeps going while BML works through the ring. */
+  kws_stream_ring_producer_init(&g_ring,
+                                (kws_stream_ring_bml_spad_t *)(uintptr_t)KWS_STREAM_BML_SPAD_PEER,
+                                g_dsp, ring_clock);
+  kws_stream_ring_publish_identity(&g_ring);
+  KWS_DSP_ROLLING_LOG("[dsp-kws-stream] ring mode slots=%u; entering producer loop\n",
+                      (unsigned)KWS_STREAM_RING_SLOTS);
+  ring_run();
+#else
   /* DSP is the initiator: publish case 1 and hand the first turn to BML (no await — nobody grants
    * DSP the first turn). Identity is folded into this first quiet window. */
   publish_identity();
@@ -548,26 +836,40 @@ void app_main(void) {
   uint32_t n = 1u; /* the case currently granted to BML (== g_case_index) */
 
   while (1) {
-    /* Wait until BML has acked case n. On any idle TIMER tick with no ack, RE-GRANT n: this
-     * self-heals a dropped grant, a dropped return-ack, or a dropped wake in either direction.
-     * Re-grants are idempotent — BML ignores a duplicate (case_index <= its last_consumed), so
-     * there is never a double inference. Steady state (ack arrives via MSIP before the ~50ms tick)
-     * fires no re-grant, so link traffic is unchanged. */
+    /* Wait until BML has acked case n. BML answers a torn payload (checksum miss) by handing the
+     * turn back with ack_index still n-1: that NAK is re-granted at once, without waiting for a
+     * tick, and whether or not BML's wake reached us. An idle TIMER tick with no ack also RE-GRANTS
+     * n: this self-heals a dropped grant, a dropped return-ack, or a dropped wake in either
+     * direction. An MSIP that brings neither (the NAK's own wake, after we already answered it)
+     * just goes back to sleep. Re-grants are idempotent — BML ignores a duplicate (case_index <=
+     * its last_consumed), so there is never a double inference. A re-grant always re-publishes the
+     * full payload: a bare recommit would hand BML the same torn bytes again. Steady state (ack
+     * arrives via MSIP before the ~50ms tick) fires no re-grant, so link traffic is unchanged. */
     for (;;) {
+      uint64_t tick_due;
+
       if (c2c_local_read_u32(&g_dsp->ack_index) >= n) {
         break;
       }
+      if (c2c_local_read_u32(&g_dsp->turn) == C2C_TURN_DSP) {
+        KWS_DSP_ROLLING_LOG("[dsp-kws-stream] NAK case_index=%u (ack_index=%u) -> re-grant\n",
+                            (unsigned)n, (unsigned)g_dsp->ack_index);
+        handoff_to_bml(n, /*full=*/1);
+        continue;
+      }
+      tick_due = c2c_mtime() + (uint64_t)C2C_POLL_INTERVAL_TICKS;
       c2c_sleep_until_tick(); /* wake on BML's ack MSIP or the periodic timer */
-      if (c2c_local_read_u32(&g_dsp->ack_index) >= n) {
-        break;
+      if ((c2c_mtime() < tick_due) || (c2c_local_read_u32(&g_dsp->ack_index) >= n) ||
+          (c2c_local_read_u32(&g_dsp->turn) == C2C_TURN_DSP)) {
+        continue;
       }
       KWS_DSP_ROLLING_LOG("[dsp-kws-stream] re-grant case_index=%u (ack_index=%u) [self-heal]\n",
                           (unsigned)n, (unsigned)g_dsp->ack_index);
-      handoff_to_bml(n, KWS_DSP_ROLLING_FULL_PUBLISH);
+      handoff_to_bml(n, /*full=*/1);
     }
 
     /* Acked -> read result telemetry. */
-    c2c_full_flush();
+    c2c_invalidate_range(g_dsp, sizeof(*g_dsp));
     KWS_DSP_ROLLING_LOG("[dsp-kws-stream] case_index=%u acked; pred=%u score_q=%u -> next\n",
                         (unsigned)n, (unsigned)g_dsp->bml_pred_class,
                         (unsigned)g_dsp->bml_pred_score_q);
@@ -606,6 +908,7 @@ void app_main(void) {
     }
 #endif
   }
+#endif /* KWS_STREAM_USE_RING */
 }
 
 int main(void) {
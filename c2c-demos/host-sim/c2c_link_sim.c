@@ -0,0 +1,180 @@
+/*
+ * c2c_link_sim.c - Host-side lossy model of the SP25 C2C link (see c2c_link_sim.h).
+ */
+
+#define _GNU_SOURCE
+#include "c2c_link_sim.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t  wake;
+  volatile uint32_t msip;
+  uint64_t mtimecmp;
+  uint64_t rng;
+  c2c_sim_stats_t stats;
+} __attribute__((aligned(64))) sim_chip_t;
+
+static uint8_t g_spad[C2C_SIM_CHIPS][C2C_SIM_SPAD_BYTES] __attribute__((aligned(64)));
+static sim_chip_t g_chip[C2C_SIM_CHIPS];
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static c2c_sim_config_t g_cfg;
+static uint64_t g_t0_ns;
+static __thread int t_chip = C2C_SIM_DSP;
+
+uint64_t c2c_sim_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Busy-wait: models a stalled core, so it must not yield the way a sleep would. */
+static void sim_spin_ns(uint64_t ns) {
+  if (ns == 0) return;
+  uint64_t end = c2c_sim_now_ns() + ns;
+  while (c2c_sim_now_ns() < end) {
+  }
+}
+
+/* xorshift64*, one stream per chip so the two threads never share state. */
+static int sim_drop(sim_chip_t *c, double p) {
+  if (p <= 0.0) return 0;
+  c->rng ^= c->rng >> 12;
+  c->rng ^= c->rng << 25;
+  c->rng ^= c->rng >> 27;
+  uint64_t r = c->rng * 0x2545F4914F6CDD1Dull;
+  return (double)(r >> 11) * (1.0 / 9007199254740992.0) < p;
+}
+
+static int sim_in_spad(int chip, volatile const void *addr) {
+  uintptr_t a = (uintptr_t)addr;
+  uintptr_t base = (uintptr_t)g_spad[chip];
+  return a >= base && a < base + C2C_SIM_SPAD_BYTES;
+}
+
+/* wfi deadlines are mtime-based, so the condvars wait on CLOCK_MONOTONIC. */
+static void sim_init_once(void) {
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  for (int i = 0; i < C2C_SIM_CHIPS; ++i) {
+    pthread_mutex_init(&g_chip[i].lock, NULL);
+    pthread_cond_init(&g_chip[i].wake, &attr);
+  }
+  pthread_condattr_destroy(&attr);
+}
+
+void c2c_sim_init(const c2c_sim_config_t *cfg) {
+  pthread_once(&g_once, sim_init_once);
+  g_cfg = *cfg;
+  if (g_cfg.tick_ns == 0) g_cfg.tick_ns = 20000u;
+  memset(g_spad, 0, sizeof(g_spad));
+  for (int i = 0; i < C2C_SIM_CHIPS; ++i) {
+    sim_chip_t *c = &g_chip[i];
+    pthread_mutex_lock(&c->lock);
+    c->msip = 0;
+    c->mtimecmp = UINT64_MAX;
+    c->rng = (cfg->seed ? cfg->seed : 0x9E3779B97F4A7C15ull) + 0x1000193ull * (uint64_t)(i + 1);
+    memset(&c->stats, 0, sizeof(c->stats));
+    pthread_mutex_unlock(&c->lock);
+  }
+  g_t0_ns = c2c_sim_now_ns();
+}
+
+void c2c_sim_bind_chip(int chip) {
+  t_chip = chip;
+}
+
+volatile void *c2c_sim_spad(int chip) {
+  return g_spad[chip];
+}
+
+void c2c_sim_get_stats(int chip, c2c_sim_stats_t *out) {
+  *out = g_chip[chip].stats;
+}
+
+static void sim_raise_msip(int chip) {
+  sim_chip_t *c = &g_chip[chip];
+  pthread_mutex_lock(&c->lock);
+  c->msip = 1u;
+  pthread_cond_broadcast(&c->wake);
+  pthread_mutex_unlock(&c->lock);
+}
+
+void c2c_sim_kick(int chip) {
+  sim_raise_msip(chip);
+}
+
+void c2c_sim_store32(volatile uint32_t *addr, uint32_t val) {
+  const int peer = t_chip ^ 1;
+  sim_chip_t *self = &g_chip[t_chip];
+
+  if (addr == &g_chip[peer].msip) {
+    self->stats.msip_writes++;
+    sim_spin_ns(g_cfg.store_ns);
+    if (sim_drop(self, g_cfg.msip_drop)) {
+      self->stats.dropped_msips++;
+      return;
+    }
+    if (val) sim_raise_msip(peer);
+    else __atomic_store_n(addr, val, __ATOMIC_RELEASE);
+    return;
+  }
+  if (sim_in_spad(peer, addr)) {
+    self->stats.remote_stores++;
+    sim_spin_ns(g_cfg.store_ns);
+    if (sim_drop(self, g_cfg.write_drop)) {
+      self->stats.dropped_stores++;
+      return;
+    }
+  }
+  __atomic_store_n(addr, val, __ATOMIC_RELEASE);
+}
+
+void c2c_sim_coherence(volatile const void *addr, uint32_t bytes) {
+  (void)addr;
+  uint32_t lines = (bytes + 63u) / 64u + 1u;
+  g_chip[t_chip].stats.coherence_lines += lines;
+  sim_spin_ns((uint64_t)lines * g_cfg.line_ns);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+volatile uint32_t *c2c_sim_own_msip(void) {
+  return &g_chip[t_chip].msip;
+}
+
+volatile uint32_t *c2c_sim_peer_msip(void) {
+  return &g_chip[t_chip ^ 1].msip;
+}
+
+uint64_t c2c_sim_mtime(void) {
+  return (c2c_sim_now_ns() - g_t0_ns) / g_cfg.tick_ns;
+}
+
+void c2c_sim_set_mtimecmp(uint64_t v) {
+  sim_chip_t *c = &g_chip[t_chip];
+  pthread_mutex_lock(&c->lock);
+  c->mtimecmp = v;
+  pthread_mutex_unlock(&c->lock);
+}
+
+/* Park until our MSIP is set or mtime reaches mtimecmp (interrupts masked, as on silicon). */
+void c2c_sim_wfi(void) {
+  sim_chip_t *c = &g_chip[t_chip];
+  pthread_mutex_lock(&c->lock);
+  c->stats.wfi_calls++;
+  while (!__atomic_load_n(&c->msip, __ATOMIC_ACQUIRE)) {
+    uint64_t now = c2c_sim_mtime();
+    if (now >= c->mtimecmp) {
+      c->stats.wfi_timeouts++;
+      break;
+    }
+    uint64_t deadline = g_t0_ns + c->mtimecmp * (uint64_t)g_cfg.tick_ns;
+    struct timespec ts = {(time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull)};
+    pthread_cond_timedwait(&c->wake, &c->lock, &ts);
+  }
+  pthread_mutex_unlock(&c->lock);
+}
@@ -0,0 +1,72 @@
+#ifndef C2C_LINK_SIM_H
+#define C2C_LINK_SIM_H
+
+/*
+ * c2c_link_sim — host-side model of the SP25 C2C link for c2c_shm / c2c_turnsync.
+ *
+ * Two simulated chips (pthreads) each own one scratchpad and one CLINT MSIP word. Building
+ * c2c_shm.c and c2c_turnsync.h with -DC2C_SHM_HOST_SIM routes their stores, coherence ops, mtime
+ * and wfi through the hooks below, so the unmodified protocol code runs against:
+ *   - a lossy cross-link: each store into the PEER's spad is dropped with probability write_drop,
+ *     each peer-MSIP write with probability msip_drop;
+ *   - access latency: store_ns per cross-link store, line_ns per cache line flushed/invalidated;
+ *   - a CLINT timer ticking every tick_ns, so C2C_POLL_INTERVAL_TICKS keeps its meaning.
+ * Local stores (own spad, own MSIP) always land. There is no cache: coherence ops only cost time.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef C2C_SIM_SPAD_BYTES
+#define C2C_SIM_SPAD_BYTES 16384u
+#endif
+
+enum { C2C_SIM_DSP = 0, C2C_SIM_BML = 1, C2C_SIM_CHIPS = 2 };
+
+typedef struct {
+  double   write_drop;  /* P(one cross-link spad store is lost) */
+  double   msip_drop;   /* P(one cross-link MSIP write is lost) */
+  uint32_t store_ns;    /* cost of one cross-link store */
+  uint32_t line_ns;     /* cost per cache line flushed or invalidated */
+  uint32_t tick_ns;     /* mtime tick (silicon: 20000 ns = 50 kHz) */
+  uint64_t seed;
+} c2c_sim_config_t;
+
+typedef struct {
+  uint64_t remote_stores;
+  uint64_t dropped_stores;
+  uint64_t msip_writes;
+  uint64_t dropped_msips;
+  uint64_t coherence_lines;
+  uint64_t wfi_calls;
+  uint64_t wfi_timeouts;  /* wfi left on the timer, not an MSIP */
+} c2c_sim_stats_t;
+
+/* Reset both chips (spads zeroed, MSIPs clear, stats cleared, mtime restarted). */
+void c2c_sim_init(const c2c_sim_config_t *cfg);
+/* Make the calling thread chip `chip` for every hook below. */
+void c2c_sim_bind_chip(int chip);
+/* Base of `chip`'s scratchpad (C2C_SIM_SPAD_BYTES, 64-byte aligned). */
+volatile void *c2c_sim_spad(int chip);
+void c2c_sim_get_stats(int chip, c2c_sim_stats_t *out);
+uint64_t c2c_sim_now_ns(void);
+/* Harness-only wake that bypasses the lossy link (used to stop a parked chip). */
+void c2c_sim_kick(int chip);
+
+/* Port hooks (C2C_SHM_HOST_SIM). */
+void c2c_sim_store32(volatile uint32_t *addr, uint32_t val);
+void c2c_sim_coherence(volatile const void *addr, uint32_t bytes);
+volatile uint32_t *c2c_sim_own_msip(void);
+volatile uint32_t *c2c_sim_peer_msip(void);
+uint64_t c2c_sim_mtime(void);
+void c2c_sim_set_mtimecmp(uint64_t v);
+void c2c_sim_wfi(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* C2C_LINK_SIM_H */
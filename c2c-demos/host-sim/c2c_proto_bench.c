@@ -0,0 +1,478 @@
+/*
+ * c2c_proto_bench.c - Host-side throughput/latency bench for the C2C KWS stream protocols.
+ *
+ * Runs c2c_shm.c and c2c_turnsync.h, built with -DC2C_SHM_HOST_SIM, over the lossy link model in
+ * c2c_link_sim.c. One pthread plays the DSP (producer) and one the BML (consumer). The turn loops
+ * mirror dsp-kws-rolling / bearly-kws-rolling on the kws_stream_proto.h layouts; the ring runs the
+ * demos' own state machines from kws_stream_ring.h:
+ *   turn-words  strict turn-taking, every field a separate c2c_remote_write_* (pre-c2c_tx_t)
+ *   turn-tx     strict turn-taking, one c2c_tx_t per handoff (KWS_STREAM_USE_RING=0 demos)
+ *   ring        KWS_STREAM_RING_SLOTS-slot ring with ack/NAK (KWS_STREAM_USE_RING=1 demos)
+ * Produce/consume work is a busy-wait standing in for MFCC and inference. The boot barrier and
+ * identity words are skipped: both simulated chips start with zeroed spads.
+ *
+ * For each protocol it reports delivered cases/s, payload throughput, handoff latency (producer
+ * publish start -> consumer holds a verified payload) p50/p99/max, and the recovery counters.
+ * Link tunables (C2C_SHM_WRITE_REPEATS, C2C_SHM_READ_RETRIES, C2C_POLL_INTERVAL_TICKS, ...) are
+ * compile-time, as on silicon: pass them through DEFS.
+ *
+ * Usage:
+ *   make -C c2c-demos/host-sim run ARGS="-p all -n 200 -w 0.01 -m 0.05"
+ *   make -C c2c-demos/host-sim run DEFS="-DC2C_SHM_WRITE_REPEATS=2 -DC2C_POLL_INTERVAL_TICKS=500"
+ *   ./c2c_proto_bench [-p turn-words|turn-tx|ring|all] [-n cases] [-w write_drop] [-m msip_drop]
+ *                     [-s store_ns] [-l line_ns] [-t tick_ns] [-P produce_us] [-C consume_us]
+ *                     [-S seed] [-T timeout_ms]
+ *
+ * A run that has not delivered every case within timeout_ms of wall time is stopped and reported
+ * as HUNG; the bench then exits nonzero.
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "c2c_link_sim.h"
+#include "c2c_shm.h"
+#include "c2c_turnsync.h"
+#include "kws_stream_proto.h"
+#include "kws_stream_ring.h"
+
+_Static_assert(sizeof(kws_stream_ring_bml_spad_t) <= C2C_SIM_SPAD_BYTES,
+               "ring layout does not fit the simulated scratchpad.");
+
+typedef enum { PROTO_TURN_WORDS, PROTO_TURN_TX, PROTO_RING, PROTO_COUNT } proto_id_t;
+
+static const char *const PROTO_NAMES[PROTO_COUNT] = {"turn-words", "turn-tx", "ring"};
+
+typedef struct {
+  proto_id_t proto;
+  uint32_t cases;
+  uint32_t produce_us;
+  uint32_t consume_us;
+  uint32_t timeout_ms;
+  c2c_sim_config_t link;
+} bench_config_t;
+
+/* Per-run state. Each counter is written by exactly one chip thread; main reads after join. */
+typedef struct {
+  const bench_config_t *cfg;
+  uint64_t *pub_ns;           /* [case] first publish of the case (DSP) */
+  uint64_t *rx_ns;            /* [case] verified payload in hand (BML) */
+  volatile int stop;          /* DSP saw the final ack (or the watchdog fired): both chips leave */
+  volatile int hung;          /* watchdog fired before DSP saw the final ack */
+  uint32_t regrants;          /* DSP: turn re-grants / ring re-commits on an idle timer tick */
+  uint32_t stale_regrants;    /* DSP: ring wakes on an MSIP that carried no ack (no re-commit) */
+  uint32_t nak_regrants;      /* DSP: turn re-grants answering a NAK (turn back, no ack) */
+  uint32_t republishes;       /* DSP: ring slots republished on a NAK */
+  uint32_t reacks;            /* BML: duplicate grants re-acked */
+  uint32_t verify_fails;      /* BML: checksum give-ups (re-ack / NAK) */
+  uint32_t corrupt;           /* BML: verified payload that differs from what DSP produced */
+} bench_run_t;
+
+static bench_run_t g_run;
+
+static kws_stream_dsp_spad_t *dsp_spad(void) {
+  return (kws_stream_dsp_spad_t *)c2c_sim_spad(C2C_SIM_DSP);
+}
+
+static kws_stream_bml_spad_t *bml_spad(void) {
+  return (kws_stream_bml_spad_t *)c2c_sim_spad(C2C_SIM_BML);
+}
+
+static kws_stream_ring_bml_spad_t *ring_spad(void) {
+  return (kws_stream_ring_bml_spad_t *)c2c_sim_spad(C2C_SIM_BML);
+}
+
+static void busy_us(uint32_t us) {
+  uint64_t end = c2c_sim_now_ns() + (uint64_t)us * 1000u;
+  while (c2c_sim_now_ns() < end) {
+  }
+}
+
+/* c2c_sleep_until_tick, reporting whether the wake was the timer (1) or an MSIP (0). */
+static int sleep_until_tick_timed_out(void) {
+  c2c_sim_stats_t before;
+  c2c_sim_stats_t after;
+
+  c2c_sim_get_stats(C2C_SIM_DSP, &before);
+  c2c_sleep_until_tick();
+  c2c_sim_get_stats(C2C_SIM_DSP, &after);
+  return after.wfi_timeouts != before.wfi_timeouts;
+}
+
+/* Deterministic per-case payload, so the consumer can tell a false checksum match. */
+static void make_payload(uint32_t idx, int8_t *buf) {
+  uint32_t state = 0x6B5753u ^ (idx * 2654435761u);
+  for (uint32_t i = 0; i < (uint32_t)KWS_CASE_PAYLOAD_BYTES; ++i) {
+    state = state * 1664525u + 1013904223u;
+    buf[i] = (int8_t)(state >> 24);
+  }
+}
+
+static void check_payload(uint32_t idx, const int8_t *got) {
+  int8_t want[KWS_CASE_PAYLOAD_BYTES];
+  make_payload(idx, want);
+  if (memcmp(want, got, KWS_CASE_PAYLOAD_BYTES) != 0) {
+    g_run.corrupt++;
+  }
+}
+
+static void mark_published(uint32_t idx) {
+  if (g_run.pub_ns[idx] == 0) {
+    g_run.pub_ns[idx] = c2c_sim_now_ns();
+  }
+}
+
+/* ---- Turn-taking (KWS_STREAM_USE_RING=0) ------------------------------------------------ */
+
+static int8_t g_turn_case[KWS_CASE_PAYLOAD_BYTES];
+
+static void turn_handoff_to_bml(uint32_t idx, int use_tx) {
+  kws_stream_bml_spad_t *bml = bml_spad();
+  kws_stream_dsp_spad_t *dsp = dsp_spad();
+  uint32_t checksum = c2c_checksum(g_turn_case, KWS_CASE_PAYLOAD_BYTES);
+
+  if (use_tx) {
+    c2c_tx_t tx;
+    c2c_tx_begin(&tx);
+    c2c_tx_stage_block(&tx, bml->case_payload, g_turn_case, KWS_CASE_PAYLOAD_BYTES);
+    c2c_tx_stage_u32(&tx, &bml->payload_checksum, checksum);
+    c2c_tx_stage_u32(&tx, &bml->case_index, idx);
+    c2c_tx_stage_commit(&tx, &bml->turn, C2C_TURN_BML);
+    c2c_tx_commit(&tx);
+  } else {
+    c2c_remote_write_block(bml->case_payload, g_turn_case, KWS_CASE_PAYLOAD_BYTES);
+    c2c_remote_write_u32(&bml->payload_checksum, checksum);
+    c2c_remote_write_u32(&bml->case_index, idx);
+    c2c_remote_write_u32(&bml->turn, C2C_TURN_BML);
+  }
+  c2c_local_write_u32(&dsp->turn, C2C_TURN_BML);
+  c2c_wake_peer();
+}
+
+static void turn_handoff_to_dsp(uint32_t ack_idx, int use_tx) {
+  kws_stream_bml_spad_t *bml = bml_spad();
+  kws_stream_dsp_spad_t *dsp = dsp_spad();
+
+  if (use_tx) {
+    c2c_tx_t tx;
+    c2c_tx_begin(&tx);
+    c2c_tx_stage_u32(&tx, &dsp->ack_index, ack_idx);
+    c2c_tx_stage_commit(&tx, &dsp->turn, C2C_TURN_DSP);
+    c2c_tx_commit(&tx);
+  } else {
+    c2c_remote_write_u32(&dsp->ack_index, ack_idx);
+    c2c_remote_write_u32(&dsp->turn, C2C_TURN_DSP);
+  }
+  c2c_local_write_u32(&bml->turn, C2C_TURN_DSP);
+  c2c_wake_peer();
+}
+
+static void turn_producer(int use_tx) {
+  kws_stream_dsp_spad_t *dsp = dsp_spad();
+
+  for (uint32_t n = 1; n <= g_run.cfg->cases && !g_run.stop; ++n) {
+    busy_us(g_run.cfg->produce_us);
+    make_payload(n, g_turn_case);
+    mark_published(n);
+    turn_handoff_to_bml(n, use_tx);
+
+    /* Same wait as dsp-kws-rolling: a NAK (turn handed back without the ack) re-grants case n at
+     * once, an idle tick without the ack re-grants it as self-heal, any other MSIP is slept off. */
+    while (!g_run.stop) {
+      if (c2c_local_read_u32(&dsp->ack_index) >= n) {
+        break;
+      }
+      if (c2c_local_read_u32(&dsp->turn) == C2C_TURN_DSP) {
+        g_run.nak_regrants++;
+        turn_handoff_to_bml(n, use_tx);
+        continue;
+      }
+      if (!sleep_until_tick_timed_out() || (c2c_local_read_u32(&dsp->ack_index) >= n) ||
+          (c2c_local_read_u32(&dsp->turn) == C2C_TURN_DSP)) {
+        continue;
+      }
+      g_run.regrants++;
+      turn_handoff_to_bml(n, use_tx);
+    }
+  }
+}
+
+static void turn_consumer(int use_tx) {
+  kws_stream_bml_spad_t *bml = bml_spad();
+  int8_t rx[KWS_CASE_PAYLOAD_BYTES];
+  uint32_t last = 0;
+
+  while (!g_run.stop) {
+    uint32_t idx = 0;
+    uint32_t turn;
+
+    c2c_invalidate_range(bml, KWS_STREAM_CONTROL_CLEAR_BYTES);
+    turn = bml->turn;
+    idx = bml->case_index;
+    if (turn != C2C_TURN_BML) {
+      c2c_sleep_until_tick();
+      continue;
+    }
+    if (idx <= last) {
+      g_run.reacks++;
+      turn_handoff_to_dsp(last, use_tx);
+      c2c_sleep_until_tick();
+      continue;
+    }
+    if (!c2c_local_read_block_verify(rx, bml->case_payload, KWS_CASE_PAYLOAD_BYTES,
+                                     bml->payload_checksum)) {
+      g_run.verify_fails++;
+      turn_handoff_to_dsp(last, use_tx);
+      c2c_sleep_until_tick();
+      continue;
+    }
+    g_run.rx_ns[idx] = c2c_sim_now_ns();
+    check_payload(idx, rx);
+    busy_us(g_run.cfg->consume_us);
+    last = idx;
+    turn_handoff_to_dsp(last, use_tx);
+  }
+}
+
+/* ---- Ring (KWS_STREAM_USE_RING=1) ------------------------------------------------------- */
+
+/* The shared state machines from kws_stream_ring.h, exactly as the demos run them. */
+static kws_stream_ring_producer_t g_ring_tx;
+static kws_stream_ring_consumer_t g_ring_rx;
+
+static void ring_producer(void) {
+  kws_stream_ring_producer_init(&g_ring_tx, ring_spad(), dsp_spad(), NULL);
+  g_ring_tx.stop = &g_run.stop;
+  for (uint32_t idx = 1; idx <= g_run.cfg->cases && !g_run.stop; ++idx) {
+    int8_t next[KWS_CASE_PAYLOAD_BYTES];
+
+    busy_us(g_run.cfg->produce_us);
+    make_payload(idx, next);
+    if (idx > KWS_STREAM_RING_SLOTS) {
+      kws_stream_ring_wait_ack(&g_ring_tx, idx - KWS_STREAM_RING_SLOTS); /* latency starts after */
+    }
+    mark_published(idx);
+    kws_stream_ring_publish(&g_ring_tx, idx, next, c2c_checksum(next, KWS_CASE_PAYLOAD_BYTES),
+                            -1, -1, /*full=*/1);
+  }
+  kws_stream_ring_wait_ack(&g_ring_tx, g_run.cfg->cases);
+  g_run.regrants += g_ring_tx.recommits;
+  g_run.stale_regrants += g_ring_tx.stale_recommits;
+  g_run.republishes += g_ring_tx.republishes;
+}
+
+static void ring_consumer(void) {
+  int8_t rx[KWS_CASE_PAYLOAD_BYTES];
+
+  kws_stream_ring_consumer_init(&g_ring_rx, ring_spad(), dsp_spad(), NULL);
+  g_ring_rx.stop = &g_run.stop;
+  for (;;) {
+    uint32_t idx = kws_stream_ring_receive(&g_ring_rx, rx);
+    if (idx == 0u) {
+      break;
+    }
+    g_run.rx_ns[idx] = c2c_sim_now_ns();
+    check_payload(idx, rx);
+    busy_us(g_run.cfg->consume_us);
+    kws_stream_ring_ack(&g_ring_rx, idx);
+  }
+  g_run.reacks += g_ring_rx.reacks;
+  g_run.verify_fails += g_ring_rx.naks;
+}
+
+/* ---- Driver ----------------------------------------------------------------------------- */
+
+static void *dsp_thread(void *arg) {
+  (void)arg;
+  c2c_sim_bind_chip(C2C_SIM_DSP);
+  c2c_arm_wake();
+  switch (g_run.cfg->proto) {
+    case PROTO_TURN_WORDS: turn_producer(0); break;
+    case PROTO_TURN_TX:    turn_producer(1); break;
+    default:               ring_producer();  break;
+  }
+  g_run.stop = 1;
+  c2c_sim_kick(C2C_SIM_BML);
+  return NULL;
+}
+
+static void *bml_thread(void *arg) {
+  (void)arg;
+  c2c_sim_bind_chip(C2C_SIM_BML);
+  c2c_arm_wake();
+  switch (g_run.cfg->proto) {
+    case PROTO_TURN_WORDS: turn_consumer(0); break;
+    case PROTO_TURN_TX:    turn_consumer(1); break;
+    default:               ring_consumer();  break;
+  }
+  return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* Join the DSP thread, or stop both chips once cfg->timeout_ms of wall time has passed. */
+static void join_or_stop(pthread_t dsp, const bench_config_t *cfg) {
+  struct timespec deadline;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += (time_t)(cfg->timeout_ms / 1000u);
+  deadline.tv_nsec += (long)(cfg->timeout_ms % 1000u) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  if (pthread_timedjoin_np(dsp, NULL, &deadline) == 0) {
+    return;
+  }
+  g_run.hung = 1;
+  g_run.stop = 1;
+  c2c_sim_kick(C2C_SIM_DSP);
+  c2c_sim_kick(C2C_SIM_BML);
+  pthread_join(dsp, NULL);
+}
+
+/* Returns 0 when every case was delivered, 1 when the run hung. */
+static int run_proto(const bench_config_t *cfg) {
+  const uint32_t n = cfg->cases;
+  pthread_t dsp, bml;
+  c2c_sim_stats_t st[C2C_SIM_CHIPS];
+  uint64_t *lat = calloc(n, sizeof(*lat));
+  uint32_t got = 0;
+
+  memset(&g_run, 0, sizeof(g_run));
+  g_run.cfg = cfg;
+  g_run.pub_ns = calloc(n + 1u, sizeof(uint64_t));
+  g_run.rx_ns = calloc(n + 1u, sizeof(uint64_t));
+  if (!lat || !g_run.pub_ns || !g_run.rx_ns) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+
+  c2c_sim_init(&cfg->link);
+  uint64_t t0 = c2c_sim_now_ns();
+  pthread_create(&bml, NULL, bml_thread, NULL);
+  pthread_create(&dsp, NULL, dsp_thread, NULL);
+  join_or_stop(dsp, cfg);
+  pthread_join(bml, NULL);
+  double secs = (double)(c2c_sim_now_ns() - t0) * 1e-9;
+
+  for (uint32_t i = 1; i <= n; ++i) {
+    if (g_run.rx_ns[i] && g_run.pub_ns[i]) {
+      lat[got++] = g_run.rx_ns[i] - g_run.pub_ns[i];
+    }
+  }
+  qsort(lat, got, sizeof(*lat), cmp_u64);
+  c2c_sim_get_stats(C2C_SIM_DSP, &st[C2C_SIM_DSP]);
+  c2c_sim_get_stats(C2C_SIM_BML, &st[C2C_SIM_BML]);
+
+  printf("%-10s cases=%u/%u time=%.3fs cases/s=%.1f payload=%.1fKB/s\n",
+         PROTO_NAMES[cfg->proto], got, n, secs, (double)got / secs,
+         (double)got * KWS_CASE_PAYLOAD_BYTES / secs / 1024.0);
+  if (got) {
+    printf("           handoff_us p50=%.1f p99=%.1f max=%.1f\n",
+           (double)lat[got / 2u] * 1e-3, (double)lat[(got * 99u) / 100u] * 1e-3,
+           (double)lat[got - 1u] * 1e-3);
+  }
+  if (g_run.hung) {
+    printf("           HUNG: no final ack within %ums; stopped with %u/%u cases delivered\n",
+           cfg->timeout_ms, got, n);
+  }
+  printf("           regrants=%u stale_msip_regrants=%u nak_regrants=%u republishes=%u reacks=%u "
+         "verify_fails=%u corrupt=%u\n",
+         g_run.regrants, g_run.stale_regrants, g_run.nak_regrants, g_run.republishes, g_run.reacks,
+         g_run.verify_fails, g_run.corrupt);
+  for (int c = 0; c < C2C_SIM_CHIPS; ++c) {
+    printf("           %s: stores=%llu dropped=%llu msip=%llu/%llu lost wfi=%llu timer_wakes=%llu\n",
+           c == C2C_SIM_DSP ? "dsp" : "bml",
+           (unsigned long long)st[c].remote_stores, (unsigned long long)st[c].dropped_stores,
+           (unsigned long long)st[c].dropped_msips, (unsigned long long)st[c].msip_writes,
+           (unsigned long long)st[c].wfi_calls, (unsigned long long)st[c].wfi_timeouts);
+  }
+
+  free(lat);
+  free(g_run.pub_ns);
+  free(g_run.rx_ns);
+  return g_run.hung;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [-p turn-words|turn-tx|ring|all] [-n cases] [-w write_drop] [-m msip_drop]\n"
+          "          [-s store_ns] [-l line_ns] [-t tick_ns] [-P produce_us] [-C consume_us]\n"
+          "          [-S seed] [-T timeout_ms]\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  bench_config_t cfg = {
+    .proto = PROTO_COUNT, /* all */
+    .cases = 200,
+    .produce_us = 2000,
+    .consume_us = 3000,
+    .timeout_ms = 30000,
+    .link = {.write_drop = 0.01, .msip_drop = 0.05, .store_ns = 50, .line_ns = 20,
+             .tick_ns = 20000, .seed = 1},
+  };
+  int opt;
+
+  while ((opt = getopt(argc, argv, "p:n:w:m:s:l:t:P:C:S:T:h")) != -1) {
+    switch (opt) {
+      case 'p':
+        cfg.proto = PROTO_COUNT;
+        if (strcmp(optarg, "all") != 0) {
+          int p = 0;
+          while (p < PROTO_COUNT && strcmp(optarg, PROTO_NAMES[p]) != 0) ++p;
+          if (p == PROTO_COUNT) {
+            usage(argv[0]);
+            return 2;
+          }
+          cfg.proto = (proto_id_t)p;
+        }
+        break;
+      case 'n': cfg.cases = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'w': cfg.link.write_drop = strtod(optarg, NULL); break;
+      case 'm': cfg.link.msip_drop = strtod(optarg, NULL); break;
+      case 's': cfg.link.store_ns = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'l': cfg.link.line_ns = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 't': cfg.link.tick_ns = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'P': cfg.produce_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'C': cfg.consume_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'S': cfg.link.seed = strtoull(optarg, NULL, 0); break;
+      case 'T': cfg.timeout_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+      default:
+        usage(argv[0]);
+        return opt == 'h' ? 0 : 2;
+    }
+  }
+  if (cfg.cases == 0 || cfg.link.tick_ns == 0 || cfg.timeout_ms == 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  printf("c2c_proto_bench: payload=%uB cases=%u produce=%uus consume=%uus\n",
+         (unsigned)KWS_CASE_PAYLOAD_BYTES, cfg.cases, cfg.produce_us, cfg.consume_us);
+  printf("  link: write_drop=%.4f msip_drop=%.4f store=%uns line=%uns tick=%uns seed=%llu\n",
+         cfg.link.write_drop, cfg.link.msip_drop, cfg.link.store_ns, cfg.link.line_ns,
+         cfg.link.tick_ns, (unsigned long long)cfg.link.seed);
+  printf("  tunables: WRITE_REPEATS=%u READ_RETRIES=%u POLL_INTERVAL_TICKS=%llu RING_SLOTS=%u\n",
+         (unsigned)C2C_SHM_WRITE_REPEATS, (unsigned)C2C_SHM_READ_RETRIES,
+         (unsigned long long)C2C_POLL_INTERVAL_TICKS, (unsigned)KWS_STREAM_RING_SLOTS);
+
+  int hung = 0;
+  for (int p = 0; p < PROTO_COUNT; ++p) {
+    if (cfg.proto != PROTO_COUNT && cfg.proto != (proto_id_t)p) continue;
+    bench_config_t one = cfg;
+    one.proto = (proto_id_t)p;
+    hung |= run_proto(&one);
+  }
+  return hung ? 1 : 0;
+}
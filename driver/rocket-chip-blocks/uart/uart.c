@@ -58,3 +58,210 @@ Status uart_transmit(UART_Type *UARTx, const uint8_t *data, uint16_t size, uint3
   }
   return OK;
 }
+
+
+/* ================ Buffered (interrupt-driven) mode ================ */
+
+#define UART_TX_BUFFER_MASK                     (UART_TX_BUFFER_SIZE - 1U)
+#define UART_RX_BUFFER_MASK                     (UART_RX_BUFFER_SIZE - 1U)
+
+#if (UART_TX_BUFFER_SIZE & UART_TX_BUFFER_MASK) || (UART_RX_BUFFER_SIZE & UART_RX_BUFFER_MASK)
+#error "UART_TX_BUFFER_SIZE and UART_RX_BUFFER_SIZE must be powers of two"
+#endif
+
+static inline uintptr_t uart_irq_save(void) {
+  uintptr_t mstatus;
+  asm volatile("csrrci %0, mstatus, 8" : "=r"(mstatus) :: "memory");
+  return mstatus & 8U;
+}
+
+static inline void uart_irq_restore(uintptr_t mie) {
+  if (mie) {
+    asm volatile("csrsi mstatus, 8" ::: "memory");
+  }
+}
+
+/* Masks interrupts on this hart first, so the handler can never spin on a lock its own hart holds. */
+static inline uintptr_t uart_tx_lock(UART_BufferedType *huart) {
+  uintptr_t mie = uart_irq_save();
+  while (__atomic_exchange_n(&huart->tx_lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+  }
+  return mie;
+}
+
+static inline void uart_tx_unlock(UART_BufferedType *huart, uintptr_t mie) {
+  __atomic_store_n(&huart->tx_lock, 0U, __ATOMIC_RELEASE);
+  uart_irq_restore(mie);
+}
+
+/* Moves queued bytes into the TX FIFO until it is full. Called with tx_lock held. */
+static void uart_buffered_fill_tx(UART_BufferedType *huart) {
+  uint32_t tail = huart->tx_tail;
+
+  while (tail != huart->tx_head) {
+    if (READ_BITS(huart->UARTx->TXDATA, UART_TXDATA_FULL_MSK)) {
+      break;
+    }
+    huart->UARTx->TXDATA = huart->tx_buffer[tail & UART_TX_BUFFER_MASK];
+    tail += 1;
+  }
+  huart->tx_tail = tail;
+
+  if (huart->use_interrupts) {
+    if (tail != huart->tx_head) {
+      SET_BITS(huart->UARTx->IE, UART_IE_TXWM_MSK);
+    } else {
+      CLEAR_BITS(huart->UARTx->IE, UART_IE_TXWM_MSK);
+    }
+  }
+}
+
+/* Moves received bytes into the RX ring. Only one context may call this at a time: the interrupt
+ * handler when interrupts are used, uart_buffered_receive otherwise. */
+static void uart_buffered_drain_rx(UART_BufferedType *huart) {
+  uint32_t head = huart->rx_head;
+  uint32_t rx_data_status;
+
+  while (1) {
+    rx_data_status = huart->UARTx->RXDATA;
+    if (READ_BITS(rx_data_status, UART_RXDATA_EMPTY_MSK)) {
+      break;
+    }
+    if (head - huart->rx_tail < UART_RX_BUFFER_SIZE) {
+      huart->rx_buffer[head & UART_RX_BUFFER_MASK] = READ_BITS(rx_data_status, UART_RXDATA_DATA_MSK);
+      head += 1;
+    }
+    else {
+      huart->rx_dropped += 1;
+    }
+  }
+  __atomic_store_n(&huart->rx_head, head, __ATOMIC_RELEASE);
+}
+
+/* Programs the watermarks for use_interrupts; TXWM itself follows the ring in uart_buffered_fill_tx. */
+static void uart_buffered_config_irqs(UART_BufferedType *huart) {
+  UART_Type *UARTx = huart->UARTx;
+
+  uart_disable_tx_interrupt(UARTx);
+  if (huart->use_interrupts) {
+    // refill when the FIFO is half empty; TXWM itself is enabled only while the ring holds data
+    CLEAR_BITS(UARTx->TXCTRL, UART_TXCTRL_TXCNT_MSK);
+    SET_BITS(UARTx->TXCTRL, (UART_FIFO_DEPTH / 2U) << UART_TXCTRL_TXCNT_POS);
+    // RXWM pends as soon as one byte is waiting
+    uart_enable_rx_interrupt(UARTx, 0);
+  }
+  else {
+    uart_disable_rx_interrupt(UARTx);
+  }
+}
+
+void uart_buffered_init(UART_BufferedType *huart, UART_Type *UARTx, uint8_t use_interrupts) {
+  huart->UARTx = UARTx;
+  huart->use_interrupts = use_interrupts;
+  huart->tx_lock = 0;
+  huart->tx_head = 0;
+  huart->tx_tail = 0;
+  huart->rx_head = 0;
+  huart->rx_tail = 0;
+  huart->tx_dropped = 0;
+  huart->rx_dropped = 0;
+
+  uart_buffered_config_irqs(huart);
+}
+
+void uart_buffered_init_once(UART_BufferedType *huart, UART_Type *UARTx, uint8_t use_interrupts) {
+  uint32_t state = 0U;
+
+  if (__atomic_load_n(&huart->init_state, __ATOMIC_ACQUIRE) == 2U) {
+    return;
+  }
+  if (__atomic_compare_exchange_n(&huart->init_state, &state, 1U, 0,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    uart_buffered_init(huart, UARTx, use_interrupts);
+    __atomic_store_n(&huart->init_state, 2U, __ATOMIC_RELEASE);
+    return;
+  }
+  // another hart got here first: wait until its rings are usable
+  while (__atomic_load_n(&huart->init_state, __ATOMIC_ACQUIRE) != 2U) {
+  }
+}
+
+void uart_buffered_set_interrupts(UART_BufferedType *huart, uint8_t use_interrupts) {
+  uintptr_t mie = uart_tx_lock(huart);
+
+  huart->use_interrupts = use_interrupts;
+  uart_buffered_config_irqs(huart);
+  uart_buffered_fill_tx(huart);
+  uart_tx_unlock(huart, mie);
+}
+
+uint16_t uart_buffered_transmit(UART_BufferedType *huart, const uint8_t *data, uint16_t size, uint8_t block) {
+  uint16_t queued = 0;
+
+  while (queued < size) {
+    uintptr_t mie = uart_tx_lock(huart);
+    uint32_t head = huart->tx_head;
+    uint32_t space = UART_TX_BUFFER_SIZE - (head - huart->tx_tail);
+    uint32_t n = size - queued;
+
+    if (n > space) {
+      n = space;
+    }
+    for (uint32_t i = 0; i < n; i += 1) {
+      huart->tx_buffer[(head + i) & UART_TX_BUFFER_MASK] = data[queued + i];
+    }
+    huart->tx_head = head + n;
+    queued += n;
+    uart_buffered_fill_tx(huart);
+    uart_tx_unlock(huart, mie);
+
+    if (queued < size && !block) {
+      huart->tx_dropped += size - queued;
+      break;
+    }
+  }
+  return queued;
+}
+
+uint16_t uart_buffered_receive(UART_BufferedType *huart, uint8_t *data, uint16_t size) {
+  uint32_t tail = huart->rx_tail;
+  uint16_t count = 0;
+
+  if (!huart->use_interrupts) {
+    uart_buffered_drain_rx(huart);
+  }
+  while (count < size && tail != __atomic_load_n(&huart->rx_head, __ATOMIC_ACQUIRE)) {
+    data[count] = huart->rx_buffer[tail & UART_RX_BUFFER_MASK];
+    tail += 1;
+    count += 1;
+  }
+  __atomic_store_n(&huart->rx_tail, tail, __ATOMIC_RELEASE);
+  return count;
+}
+
+void uart_buffered_flush(UART_BufferedType *huart) {
+  while (__atomic_load_n(&huart->tx_tail, __ATOMIC_ACQUIRE) != huart->tx_head) {
+    uintptr_t mie = uart_tx_lock(huart);
+    uart_buffered_fill_tx(huart);
+    uart_tx_unlock(huart, mie);
+  }
+}
+
+void uart_buffered_irq_handler(UART_BufferedType *huart) {
+  uint32_t pending = huart->UARTx->IP;
+
+  if (READ_BITS(pending, UART_IP_RXWM_MSK)) {
+    uart_buffered_drain_rx(huart);
+  }
+  // If another hart is queueing it will fill the FIFO itself; TXWM stays pending otherwise.
+  if (READ_BITS(pending, UART_IP_TXWM_MSK) &&
+      __atomic_exchange_n(&huart->tx_lock, 1U, __ATOMIC_ACQUIRE) == 0U) {
+    uart_buffered_fill_tx(huart);
+    __atomic_store_n(&huart->tx_lock, 0U, __ATOMIC_RELEASE);
+  }
+}
+
+void uart_buffered_irq_dispatch(uint32_t irq_id, void *arg) {
+  (void)irq_id;
+  uart_buffered_irq_handler((UART_BufferedType *)arg);
+}
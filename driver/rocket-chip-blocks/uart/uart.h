@@ -104,6 +104,100 @@ Status uart_receive(UART_Type *UARTx, uint8_t *data, uint16_t size, uint32_t tim
 Status uart_transmit(UART_Type *UARTx, const uint8_t *data, uint16_t size, uint32_t timeout);
 
 
+/* ================ Buffered (interrupt-driven) mode ================ */
+/*
+ * Software TX/RX rings in front of the 8-entry hardware FIFOs, so a caller never waits for the
+ * line: uart_buffered_transmit copies into the TX ring and returns, and the ring is drained into
+ * the FIFO by the TXWM interrupt (enabled only while the ring holds data). RXWM moves received
+ * bytes into the RX ring.
+ *
+ * The driver does not know the UART's PLIC source: route it to uart_buffered_irq_handler from the
+ * platform's external interrupt dispatch (on dsp25, platform_external_irq_register with
+ * uart_buffered_irq_dispatch), then call uart_buffered_set_interrupts. Without interrupts
+ * (use_interrupts = 0, or before the PLIC is set up) the rings are serviced only from
+ * transmit/receive calls and uart_buffered_flush, so a caller that must see its bytes leave
+ * (glossy's _write) flushes before returning.
+ */
+
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE                     4096U   /* power of two */
+#endif
+
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE                     256U    /* power of two */
+#endif
+
+typedef struct {
+  UART_Type *UARTx;
+  uint8_t use_interrupts;
+  volatile uint32_t init_state;                 /** uart_buffered_init_once: 0 none, 1 running, 2 done */
+  volatile uint32_t tx_lock;                    /** serializes producers (several harts may print) */
+  volatile uint32_t tx_head;                    /** bytes queued */
+  volatile uint32_t tx_tail;                    /** bytes handed to the FIFO */
+  volatile uint32_t rx_head;                    /** bytes received */
+  volatile uint32_t rx_tail;                    /** bytes read by the application */
+  volatile uint32_t tx_dropped;                 /** bytes discarded by uart_buffered_transmit */
+  volatile uint32_t rx_dropped;                 /** bytes lost to a full RX ring */
+  uint8_t tx_buffer[UART_TX_BUFFER_SIZE];
+  uint8_t rx_buffer[UART_RX_BUFFER_SIZE];
+} UART_BufferedType;
+
+/**
+ * @brief Binds the rings to an initialized UART (see uart_init).
+ *
+ * With use_interrupts set, RXWM is enabled immediately and TXWM whenever the TX ring is not empty.
+ * The caller still routes the UART's PLIC source to uart_buffered_irq_handler.
+ */
+void uart_buffered_init(UART_BufferedType *huart, UART_Type *UARTx, uint8_t use_interrupts);
+
+/**
+ * @brief uart_buffered_init for a zero-initialized instance shared by several harts.
+ *
+ * The first caller initializes; concurrent callers wait until it is done; later calls return at once.
+ */
+void uart_buffered_init_once(UART_BufferedType *huart, UART_Type *UARTx, uint8_t use_interrupts);
+
+/**
+ * @brief Switches a live instance between polled and interrupt-driven servicing without losing
+ *        queued bytes. Enable only after the UART's PLIC source reaches uart_buffered_irq_handler.
+ */
+void uart_buffered_set_interrupts(UART_BufferedType *huart, uint8_t use_interrupts);
+
+/**
+ * @brief Queues up to size bytes for transmission without waiting for the line.
+ *
+ * @param block if set, waits for ring space when the ring is full (output is never lost);
+ *              otherwise the bytes that do not fit are dropped and counted in tx_dropped.
+ * @return uint16_t number of bytes queued
+ */
+uint16_t uart_buffered_transmit(UART_BufferedType *huart, const uint8_t *data, uint16_t size, uint8_t block);
+
+/**
+ * @brief Copies up to size already received bytes out of the RX ring. Never waits.
+ *
+ * @return uint16_t number of bytes copied
+ */
+uint16_t uart_buffered_receive(UART_BufferedType *huart, uint8_t *data, uint16_t size);
+
+/**
+ * @brief Waits until every queued byte has been handed to the hardware FIFO.
+ */
+void uart_buffered_flush(UART_BufferedType *huart);
+
+/**
+ * @brief Services both rings. Call from the external interrupt handler for this UART's source.
+ */
+void uart_buffered_irq_handler(UART_BufferedType *huart);
+
+/**
+ * @brief uart_buffered_irq_handler with arg as the instance, for (irq_id, arg) dispatch tables.
+ */
+void uart_buffered_irq_dispatch(uint32_t irq_id, void *arg);
+
+/* Console instance used by glossy's _write/_read when built with TERMINAL_UART_BUFFERED. */
+extern UART_BufferedType uart_console;
+
+
 #ifdef __cplusplus
 }
 #endif
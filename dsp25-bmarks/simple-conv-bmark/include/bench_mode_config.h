@@ -15,6 +15,7 @@
 #define SIMPLE_CONV_RUN_RVV_SINGLE_CORE_RTL_STYLE 1
 #define SIMPLE_CONV_RUN_RVV_MULTI_CORE_REFERENCE  0
 #define SIMPLE_CONV_RUN_ACCELERATOR_DMA  0
+#define SIMPLE_CONV_RUN_ACCELERATOR_DMA_STREAM 1
 
 /*
  * Steady-state MMIO mode:
@@ -34,6 +35,14 @@
 #define SIMPLE_CONV_RTL_STYLE_PRELOAD_PACKETS 8
 #define SIMPLE_CONV_RTL_STYLE_ALLOW_UNSAFE_PRELOAD 0
 
+/*
+ * DMA streaming mode (conv_dma_stream_*):
+ * - the input is streamed in chunks of this many elements (even, >= 8)
+ * - the CPU runs a fixed background work loop between polls; the loop count
+ *   gives the cycles the CPU had free while the accelerator was streaming
+ */
+#define SIMPLE_CONV_DMA_STREAM_CHUNK_LENGTH 64
+
 /* Backward compatibility for older code paths */
 #define SIMPLE_CONV_RUN_RVV_REFERENCE SIMPLE_CONV_RUN_RVV_MULTI_CORE_REFERENCE
 
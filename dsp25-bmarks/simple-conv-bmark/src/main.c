@@ -10,6 +10,7 @@
  *   6) dma_full_correct
  *   7) mmio_rtl_style (START->N-output drain timing)
  *   8) rvv_sc_rtl_style (same transform as rtl_style)
+ *   9) dma_stream (chunked conv_dma_stream_*, reports CPU occupancy)
  *
  * Correctness checks are outside the timed region.
  */
@@ -57,6 +58,10 @@
 #error "SIMPLE_CONV_INPUT_LENGTH must be even (2 FP32 per 64b packet)"
 #endif
 
+#if (SIMPLE_CONV_DMA_STREAM_CHUNK_LENGTH % 2) != 0 || SIMPLE_CONV_DMA_STREAM_CHUNK_LENGTH < 8
+#error "SIMPLE_CONV_DMA_STREAM_CHUNK_LENGTH must be even and >= KERNEL_LEN"
+#endif
+
 #if SIMPLE_CONV_RTL_STYLE_PRELOAD_PACKETS < 1
 #error "SIMPLE_CONV_RTL_STYLE_PRELOAD_PACKETS must be >= 1"
 #endif
@@ -129,6 +134,16 @@ static bool g_rvv_mc_ready = false;
 static uint32_t g_dma_base_id = 0x1000u;
 static bool g_mmio_preconfigured_ready = false;
 
+#define STREAM_CHUNK_LEN     ((uint32_t)SIMPLE_CONV_DMA_STREAM_CHUNK_LENGTH)
+#define STREAM_WORK_SPINS    16u
+#define STREAM_CAL_ITERS     1024u
+
+static conv_dma_stream_t g_stream;
+static volatile uint32_t g_stream_work_sink;
+static uint64_t g_stream_free_iters;
+static uint64_t g_stream_cycles;
+static uint64_t g_stream_work_cycles_x1024;  // cycles per STREAM_CAL_ITERS background iterations
+
 static inline float bits_to_f32(uint32_t x) {
   union {
     uint32_t u;
@@ -542,6 +557,53 @@ static bool run_dma_full_correct_once(void) {
   return !status_has_error(get_register_status());
 }
 
+// Stand-in for application work done between stream polls.
+static void stream_background_work(void) {
+  for (uint32_t i = 0u; i < STREAM_WORK_SPINS; i++) {
+    g_stream_work_sink += i;
+  }
+}
+
+static void prepare_dma_stream_mode(void) {
+  uint64_t t0 = read_cycles();
+  for (uint32_t i = 0u; i < STREAM_CAL_ITERS; i++) {
+    stream_background_work();
+  }
+  g_stream_work_cycles_x1024 = read_cycles() - t0;
+}
+
+static bool run_dma_stream_once(void) {
+  uint64_t free_iters = 0u;
+  uint64_t t0 = read_cycles();
+
+  if (conv_dma_stream_start(&g_stream, g_input_bits, INPUT_LEN, g_kernel_bits, KERNEL_LEN,
+                            g_hw_out_bits, STREAM_CHUNK_LEN) != 0) {
+    return false;
+  }
+  while (!conv_dma_stream_poll(&g_stream)) {
+    stream_background_work();
+    free_iters++;
+  }
+
+  g_stream_cycles = read_cycles() - t0;
+  g_stream_free_iters = free_iters;
+  return !status_has_error(g_stream.status);
+}
+
+// CPU occupancy of the last dma_stream run: cycles not spent in background work, over the run.
+static void print_stream_occupancy(void) {
+  uint64_t free_cycles = (g_stream_free_iters * g_stream_work_cycles_x1024) / STREAM_CAL_ITERS;
+  uint64_t busy_cycles = (free_cycles < g_stream_cycles) ? (g_stream_cycles - free_cycles) : 0u;
+  uint64_t busy_permille = (g_stream_cycles == 0u) ? 0u : (busy_cycles * 1000u) / g_stream_cycles;
+
+  printf("stream_chunks: %u (chunk_len=%u)\n", (unsigned)g_stream.num_chunks, STREAM_CHUNK_LEN);
+  printf("stream_last_run_cycles: %" PRIu64 "\n", g_stream_cycles);
+  printf("cpu_free_cycles_est: %" PRIu64 "\n", free_cycles);
+  printf("cpu_occupancy: %" PRIu64 ".%" PRIu64 "%% (mmio modes: 100%%)\n",
+         busy_permille / 10u,
+         busy_permille % 10u);
+}
+
 static bool float_mismatch(float got, float ref) {
   float diff = absf_local(got - ref);
   float tol = 1e-4f * (absf_local(ref) + 1.0f);
@@ -998,10 +1060,27 @@ int main(void) {
   }
 #endif
 
+#if SIMPLE_CONV_RUN_ACCELERATOR_DMA_STREAM
+  {
+    bench_result_t dma_stream = benchmark_mode(
+        "dma_stream",
+        run_dma_stream_once,
+        mismatches_mmio_or_dma,
+        prepare_dma_stream_mode,
+        true,
+        WARMUP_RUNS,
+        TIMED_RUNS,
+        1u);
+    print_result(&dma_stream);
+    print_stream_occupancy();
+  }
+#endif
+
 #if !(SIMPLE_CONV_RUN_ACCELERATOR_MMIO || SIMPLE_CONV_RUN_ACCELERATOR_MMIO_STEADY_STATE || \
       SIMPLE_CONV_RUN_ACCELERATOR_MMIO_RTL_STYLE || SIMPLE_CONV_RUN_SCALAR_REFERENCE || \
       SIMPLE_CONV_RUN_RVV_SINGLE_CORE_REFERENCE || SIMPLE_CONV_RUN_RVV_SINGLE_CORE_RTL_STYLE || \
-      SIMPLE_CONV_RUN_RVV_MULTI_CORE_REFERENCE || SIMPLE_CONV_RUN_ACCELERATOR_DMA)
+      SIMPLE_CONV_RUN_RVV_MULTI_CORE_REFERENCE || SIMPLE_CONV_RUN_ACCELERATOR_DMA || \
+      SIMPLE_CONV_RUN_ACCELERATOR_DMA_STREAM)
   printf("note: all benchmark modes are disabled in bench_mode_config.h\n");
 #endif
 
@@ -72,7 +72,7 @@ extern "C" {
 /* Exported functions prototypes ---------------------------------------------*/
 /* USER CODE BEGIN EFP */
 void convrev_init();
-void convrev_main();
+int convrev_main();
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
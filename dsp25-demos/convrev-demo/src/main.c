@@ -23,8 +23,10 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 
+#include "chip_config.h"
 #include "hal_i2s.h"
 #include "hal_conv.h"
+#include "hal_conv_long.h"
 
 /* USER CODE END Includes */
 
@@ -47,17 +49,23 @@
 // --- Hardware & Buffer Config ---
 #define SAMPLE_RATE       44100
 #define I2S_CHANNEL_NUM   0
-#define CHUNK_SIZE        128  // Frames processed per loop
-#define KERNEL_LEN        16   // Hardware Limit
-#define IN_DILATION       1
+#define CHUNK_SIZE        128  // Frames processed per loop (one conv_long block)
 
 // --- Reverb Settings ---
-// How many 16-sample blocks to use. 
-// 64 blocks * 16 samples = 1024 samples total tail.
-#define IR_PARTITIONS     64 
-
-// Accumulation Buffer Size
-#define ACCUM_BUFFER_LEN  ((IR_PARTITIONS * KERNEL_LEN) + CHUNK_SIZE + 64)
+// Impulse response length in samples. hal_conv_long splits it into 16-tap
+// segments for the accelerator: 2048 taps = ~46 ms tail at 44.1 kHz.
+#define IR_LEN            CONV_LONG_MAX_TAPS
+
+// --- Real-time budget ---
+// A chunk lasts CHUNK_SIZE / SAMPLE_RATE (~2.9 ms at 44.1 kHz). Processing one chunk (convolution
+// plus sample conversion) must finish inside that, or the I2S FIFOs underrun. Any chunk over
+// budget stops the demo with a failure, so a too-long IR_LEN cannot pass silently.
+#define CONVREV_BUDGET_CYCLES ((uint64_t)SYS_CLK_FREQ * CHUNK_SIZE / SAMPLE_RATE)
+
+// --- Profiling ---
+// Chunks between cycle-count summaries (0 = never). One summary line takes ~5 ms at 115200 baud,
+// longer than a chunk, so each report costs one I2S underrun: keep it rare.
+#define CONVREV_REPORT_EVERY 1024
 /* USER CODE END PD */
 
 
@@ -69,24 +77,27 @@
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
 // --- Buffers ---
-// The Impulse Response sliced into small blocks for the hardware
-uint32_t ir_partitions[IR_PARTITIONS][KERNEL_LEN];
-
-// Ring-like buffer for summing up future echoes
-float    accum_buffer[ACCUM_BUFFER_LEN];
+// The Impulse Response and the partitioned-convolution state built from it
+float       ir[IR_LEN];
+conv_long_t reverb;
 
 // Audio I/O Buffers
 uint64_t i2s_rx_buffer[CHUNK_SIZE];
 float    input_float[CHUNK_SIZE];
-uint32_t hw_result_buffer[CHUNK_SIZE + KERNEL_LEN]; 
+float    output_float[CHUNK_SIZE];
 uint64_t i2s_tx_buffer[CHUNK_SIZE];
+
+// per-chunk processing cycles since the last summary
+uint64_t chunk_cycles_sum;
+uint64_t chunk_cycles_max;
+uint32_t chunk_count;
 /* USER CODE END PV */
 
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
-void init_ir_partitions(void);
-void process_audio_chunk(void);
+void init_ir(void);
+int  process_audio_chunk(void);
 void float_to_i2s(float* in_data, uint64_t* out_data, int length);
 void i2s_to_float(uint64_t* in_data, float* out_data, int length);
 /* USER CODE END PFP */
@@ -107,106 +118,106 @@ void convrev_init() {
     i2s_params.bitdepth_rx = 32;
     config_I2S(I2S_CHANNEL_NUM, &i2s_params);
 
-    // 2. Clear Accumulation Buffer
-    memset(accum_buffer, 0, ACCUM_BUFFER_LEN * sizeof(float));
-
-    // 3. Prepare the Impulse Response (Partitioning)
-    init_ir_partitions();
+    // 2. Prepare the Impulse Response and partition it for the accelerator
+    init_ir();
+    if (conv_long_init(&reverb, ir, IR_LEN, CHUNK_SIZE) != 0) {
+        printf("conv_long_init failed\n");
+    }
 
-    printf("System Ready. Mode: %s\n", USE_IMPORTED_IR ? "Imported IR" : "Synthetic IR");
+    printf("System Ready. Mode: %s, %d taps, budget %llu cycles per %d-frame chunk\n",
+           USE_IMPORTED_IR ? "Imported IR" : "Synthetic IR", (int)IR_LEN,
+           (unsigned long long)CONVREV_BUDGET_CYCLES, CHUNK_SIZE);
 }
 
-void convrev_main() {
-    process_audio_chunk();
+int convrev_main() {
+    return process_audio_chunk();
 }
 
 /**
- * @brief Logic to load OR generate IR and slice it into 16-sample partitions.
+ * @brief Logic to load OR generate the IR.
  */
-void init_ir_partitions(void) {
-    printf("Partitioning Impulse Response...\n");
+void init_ir(void) {
+    printf("Loading Impulse Response (%d taps)...\n", (int)IR_LEN);
     
     unsigned long seed = 12345;
-    int total_ir_len = IR_PARTITIONS * KERNEL_LEN;
-
-    for (int p = 0; p < IR_PARTITIONS; p++) {
-        for (int k = 0; k < KERNEL_LEN; k++) {
-            
-            // Current global index in the imaginary long IR array
-            int global_idx = (p * KERNEL_LEN) + k;
-            float sample_val = 0.0f;
-
-            // --- OPTION A: Load from Header File ---
-            #if USE_IMPORTED_IR
-                if (global_idx < IR_DATA_LEN) {
-                    sample_val = IR_DATA[global_idx];
-                } else {
-                    sample_val = 0.0f; // Zero-pad if IR_DATA is shorter than partitions
-                }
-            
-            // --- OPTION B: Generate Synthetic IR ---
-            #else
-                // White noise generation
-                seed = (1103515245 * seed + 12345) % 2147483648;
-                float noise = ((float)seed / 1073741824.0f) - 1.0f;
-
-                // Exponential decay
-                float decay = expf( -4.0f * (float)global_idx / (float)total_ir_len );
-                sample_val = noise * decay * 0.2f; 
-            #endif
-
-            // Store as uint32 representation for the hardware driver
-            ir_partitions[p][k] = *((uint32_t*)&sample_val);
-        }
+    int total_ir_len = IR_LEN;
+
+    for (int global_idx = 0; global_idx < total_ir_len; global_idx++) {
+        float sample_val = 0.0f;
+
+        // --- OPTION A: Load from Header File ---
+        #if USE_IMPORTED_IR
+            if (global_idx < IR_DATA_LEN) {
+                sample_val = IR_DATA[global_idx];
+            } else {
+                sample_val = 0.0f; // Zero-pad if IR_DATA is shorter than IR_LEN
+            }
+        
+        // --- OPTION B: Generate Synthetic IR ---
+        #else
+            // White noise generation
+            seed = (1103515245 * seed + 12345) % 2147483648;
+            float noise = ((float)seed / 1073741824.0f) - 1.0f;
+
+            // Exponential decay
+            float decay = expf( -4.0f * (float)global_idx / (float)total_ir_len );
+            sample_val = noise * decay * 0.2f; 
+        #endif
+
+        ir[global_idx] = sample_val;
     }
 }
 
 /**
- * @brief Main Audio Processing Loop (Partitioned Convolution)
+ * @brief Main Audio Processing Loop (Partitioned Convolution, see hal_conv_long.h)
+ * @retval 0 while the chunk met its real-time budget, -1 on an underrun
  */
-void process_audio_chunk() {
+int process_audio_chunk() {
     // 1. Read Audio
     for (int i = 0; i < CHUNK_SIZE; i++) {
         i2s_rx_buffer[i] = read_I2S_rx(I2S_CHANNEL_NUM, I2S_LEFT);
     }
+    uint64_t t0 = READ_CSR("mcycle");
     i2s_to_float(i2s_rx_buffer, input_float, CHUNK_SIZE);
 
-    // 2. Perform Partitioned Convolution
-    for (int p = 0; p < IR_PARTITIONS; p++) {
-        int time_offset = p * KERNEL_LEN;
-
-        // Call Hardware Driver
-        perform_convolution_1D(
-            (uint32_t*)input_float, 
-            CHUNK_SIZE, 
-            ir_partitions[p], 
-            KERNEL_LEN, 
-            hw_result_buffer, 
-            IN_DILATION
-        );
-
-        // Accumulate (Overlap-Add)
-        int result_len = CHUNK_SIZE + KERNEL_LEN - 1;
-        for (int i = 0; i < result_len; i++) {
-            if ((time_offset + i) < ACCUM_BUFFER_LEN) {
-                float val = *((float*)&hw_result_buffer[i]);
-                accum_buffer[time_offset + i] += val;
-            }
-        }
-    }
+    // 2. Perform Partitioned Convolution (accelerator, or RVV when it is busy)
+    conv_long_process(&reverb, input_float, output_float, CHUNK_SIZE);
 
-    // 3. Output Audio (Input + Reverb Tail)
-    float_to_i2s(accum_buffer, i2s_tx_buffer, CHUNK_SIZE);
+    // 3. Output Audio (Reverb)
+    float_to_i2s(output_float, i2s_tx_buffer, CHUNK_SIZE);
+    uint64_t cycles = READ_CSR("mcycle") - t0;
 
     for (int i = 0; i < CHUNK_SIZE; i++) {
         write_I2S_tx(I2S_CHANNEL_NUM, I2S_LEFT, i2s_tx_buffer[i]);
         write_I2S_tx(I2S_CHANNEL_NUM, I2S_RIGHT, i2s_tx_buffer[i]);
     }
 
-    // 4. Shift Accumulator for next frame
-    int remaining = ACCUM_BUFFER_LEN - CHUNK_SIZE;
-    memmove(&accum_buffer[0], &accum_buffer[CHUNK_SIZE], remaining * sizeof(float));
-    memset(&accum_buffer[remaining], 0, CHUNK_SIZE * sizeof(float));
+    // 4. Budget: the chunk was processed in cycles; the stream needs it in CONVREV_BUDGET_CYCLES
+    if (cycles > CONVREV_BUDGET_CYCLES) {
+        printf("FAIL: underrun, chunk %u took %llu cycles > budget %llu (%d taps)\n",
+               (unsigned)chunk_count, (unsigned long long)cycles,
+               (unsigned long long)CONVREV_BUDGET_CYCLES, (int)IR_LEN);
+        return -1;
+    }
+
+#if CONVREV_REPORT_EVERY
+    // 5. Profile: accumulate here, print off the per-chunk path
+    chunk_cycles_sum += cycles;
+    if (cycles > chunk_cycles_max) chunk_cycles_max = cycles;
+    if (++chunk_count == CONVREV_REPORT_EVERY) {
+        printf("%u chunks: avg %llu max %llu of %llu budget cycles (max %llu%%, accel blocks=%u, fallback blocks=%u)\n",
+               (unsigned)chunk_count, (unsigned long long)(chunk_cycles_sum / chunk_count),
+               (unsigned long long)chunk_cycles_max, (unsigned long long)CONVREV_BUDGET_CYCLES,
+               (unsigned long long)(chunk_cycles_max * 100 / CONVREV_BUDGET_CYCLES),
+               reverb.accel_blocks, reverb.fallback_blocks);
+        chunk_cycles_sum = 0;
+        chunk_cycles_max = 0;
+        chunk_count = 0;
+    }
+#else
+    chunk_count++;
+#endif
+    return 0;
 }
 
 // --- Helpers ---
@@ -250,8 +261,9 @@ int main(int argc, char **argv) {
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1) {
-    convrev_main();
-    return 0;
+    if (convrev_main() != 0) {
+      return 1;
+    }
   }
   /* USER CODE END WHILE */
 }
@@ -0,0 +1,163 @@
+/*
+ * dma-i2s-stream
+ *
+ * Captures the I2S mic (channel 0, left, 16 kHz) into a DMA-serviced ring and
+ * walks it with overlapping frame views (window 1024, hop 160, the MFCC
+ * framing), doing background work between frames. Checks that:
+ *   - every frame index advances by exactly one hop
+ *   - consecutive views agree on their overlap, including views that cross
+ *     the ring's wrap point (mirror consistency)
+ *   - no overruns and no DMA errors occurred
+ * and reports how much of the time the CPU was free.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hal_i2s.h"
+#include "hal_i2s_stream.h"
+#include "simple_setup.h"
+
+#define TEST_NAME "dma-i2s-stream"
+uint64_t target_frequency = 150000000UL;
+
+#define MIC_CHANNEL   0
+#define SAMPLE_RATE   16000U
+#define WINDOW        1024U
+#define HOP           160U
+#define PERIOD        320U
+#define CAPACITY      (8U * PERIOD)
+#define NUM_FRAMES    200U
+
+static uint32_t g_ring[I2S_STREAM_BUFFER_WORDS(CAPACITY, WINDOW)] __attribute__((aligned(8)));
+static uint32_t g_prev[WINDOW];
+static i2s_stream_t g_stream;
+
+static i2s_params_t g_mic_params = {
+  .tx_en         = 0,
+  .rx_en         = 0,   // enabled by i2s_stream_start
+  .bitdepth_tx   = I2S_BITDEPTH_32,
+  .bitdepth_rx   = I2S_BITDEPTH_32,
+  .clkgen        = 1,
+  .dacen         = 0,
+  .ws_len        = 3,
+  .clkdiv        = 8,
+  .tx_fp         = 0,
+  .rx_fp         = 0,
+  .tx_force_left = 0,
+  .rx_force_left = 0,
+};
+
+static volatile uint32_t g_sink;
+
+static void background_work(void) {
+  uint32_t acc = g_sink;
+  for (uint32_t i = 0; i < 64U; ++i) {
+    acc = acc * 1664525U + 1013904223U;
+  }
+  g_sink = acc;
+}
+
+int main(int argc, char **argv) {
+  i2s_stream_config_t cfg = {
+    .channel     = MIC_CHANNEL,
+    .side        = I2S_LEFT,
+    .dir         = I2S_STREAM_RX,
+    .mode        = I2S_STREAM_DMA,
+    .dma_channel = DMA_CORE_CHANNEL_COUNT,   // first peripheral channel
+    .buffer      = g_ring,
+    .capacity    = CAPACITY,
+    .period      = PERIOD,
+    .window      = WINDOW,
+    .hop         = HOP,
+    .watermark   = 0,
+  };
+  uint64_t expect_index = 0U;
+  uint64_t free_iters = 0U;
+  uint64_t busy_iters = 0U;
+  uint32_t frames = 0U;
+  uint32_t wraps = 0U;
+  int fail = 0;
+
+  (void)argc;
+  (void)argv;
+
+  init_test(target_frequency);
+  printf("[%s] start\n\n", TEST_NAME);
+
+  config_I2S(MIC_CHANNEL, &g_mic_params);
+  set_I2S_sample_freq(MIC_CHANNEL, target_frequency, SAMPLE_RATE, 32);
+
+  if (i2s_stream_init(&g_stream, &cfg) != 0 || i2s_stream_start(&g_stream) != 0) {
+    printf("[%s] FAIL (stream setup)\n", TEST_NAME);
+    return 1;
+  }
+
+  while (frames < NUM_FRAMES) {
+    i2s_frame_t frame;
+
+    i2s_stream_poll(&g_stream);
+    if (!i2s_stream_frame_acquire(&g_stream, &frame)) {
+      background_work();
+      free_iters++;
+      continue;
+    }
+    busy_iters++;
+
+    if (frame.index != expect_index || frame.length != WINDOW) {
+      printf("[%s] frame %u: index %llu length %u, expected %llu %u\n", TEST_NAME,
+             (unsigned)frames, (unsigned long long)frame.index, (unsigned)frame.length,
+             (unsigned long long)expect_index, (unsigned)WINDOW);
+      fail = 1;
+      break;
+    }
+    if ((frame.index % CAPACITY) + WINDOW > CAPACITY) {
+      wraps++;
+    }
+    if (frames > 0U) {
+      for (uint32_t i = 0; i < WINDOW - HOP; ++i) {
+        if (frame.samples[i] != g_prev[HOP + i]) {
+          printf("[%s] frame %u: overlap mismatch at %u: 0x%08x != 0x%08x\n", TEST_NAME,
+                 (unsigned)frames, (unsigned)i, (unsigned)frame.samples[i],
+                 (unsigned)g_prev[HOP + i]);
+          fail = 1;
+          break;
+        }
+      }
+    }
+    for (uint32_t i = 0; i < WINDOW; ++i) {
+      g_prev[i] = frame.samples[i];
+    }
+
+    i2s_stream_frame_release(&g_stream);
+    expect_index += HOP;
+    frames++;
+    if (fail) {
+      break;
+    }
+  }
+
+  i2s_stream_stop(&g_stream);
+
+  printf("  frames: %u (wrapped views: %u)\n", (unsigned)frames, (unsigned)wraps);
+  printf("  overruns: %u  dma_errors: %u\n", (unsigned)g_stream.overruns,
+         (unsigned)g_stream.dma_errors);
+  printf("  cpu free: %llu permille of loop iterations\n",
+         (unsigned long long)((free_iters * 1000U) / (free_iters + busy_iters)));
+
+  if (fail || wraps == 0U || g_stream.overruns != 0U || g_stream.dma_errors != 0U) {
+    printf("\n[%s] FAIL\n", TEST_NAME);
+    return 1;
+  }
+
+  printf("\n[%s] PASS\n", TEST_NAME);
+  return 0;
+}
+
+void __attribute__((weak, noreturn)) __main(void) {
+  while (1) {
+    asm volatile("wfi");
+  }
+}
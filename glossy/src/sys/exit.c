@@ -2,6 +2,12 @@
 #include "chip_config.h"
 
 __attribute__((weak, noreturn)) void _exit(int code) {
+  #if defined(TERMINAL_DEVICE_UART0) && defined(TERMINAL_UART_BUFFERED)
+    if (uart_console.UARTx != NULL) {
+      uart_buffered_flush(&uart_console);
+    }
+  #endif
+
   #if defined(TERMINAL_DEVICE_HTIF)
     *(HTIF->fromhost) = 0;
     *(HTIF->tohost) = (code << 1) | 0x1;
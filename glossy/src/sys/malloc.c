@@ -0,0 +1,438 @@
+/**
+ * @file malloc.c
+ * @brief Per-hart heap arenas in place of newlib's malloc.
+ *
+ * newlib's malloc keeps one global free list on top of a single break and is not safe to call from
+ * two harts at once. Here each hart gets its own arena, a fixed slice of the heap reserved by the
+ * linker script ([__heap_arenas_start, __heap_end), __heap_harts slices):
+ *  - requests up to MALLOC_MAX_SLAB_SIZE bytes are rounded to a power-of-two size class and served
+ *    from the hart's own free lists, which are refilled by carving slabs out of the arena. The owning
+ *    hart is the only one that touches them, so this path takes no lock.
+ *  - a block freed by another hart is pushed onto the owner's remote-free stack (one atomic CAS) and
+ *    taken back in bulk the next time the owner runs out of blocks of some class.
+ *  - larger requests, harts without an arena and arenas that are full fall back to the shared pool,
+ *    a first-fit free list under a spinlock that grows with _sbrk over [__end, __heap_arenas_start).
+ *
+ * Linker scripts without __heap_arenas_start (no per-hart arenas) run everything through the pool.
+ * Like before, malloc must not be called from interrupt handlers.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <reent.h>
+
+#include "riscv.h"
+
+#define likely(x)   __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+
+#define MALLOC_MAX_HARTS        8U
+#define MALLOC_ALIGN            16U
+#define MALLOC_MIN_SHIFT        4U
+#define MALLOC_NUM_CLASSES      8U      /* 16 B .. 2 KiB */
+#define MALLOC_MAX_SLAB_SIZE    (1UL << (MALLOC_MIN_SHIFT + MALLOC_NUM_CLASSES - 1U))
+#define MALLOC_SLAB_BYTES       4096U   /* carved per refill of a size class */
+
+#define MALLOC_KIND_SLAB        0x534c4142U
+#define MALLOC_KIND_POOL        0x504f4f4cU
+#define MALLOC_KIND_ALIGNED     0x414c4e44U
+#define MALLOC_NO_OWNER         0xFFFFU
+
+typedef struct {
+  uint32_t kind;
+  uint16_t owner;       /** hart whose arena the block came from (slab blocks) */
+  uint16_t cls;         /** size class (slab blocks) */
+  size_t size;          /** payload bytes (pool blocks), offset to the real block (aligned views) */
+} __attribute__((aligned(MALLOC_ALIGN))) malloc_header_t;
+
+typedef struct malloc_node {
+  struct malloc_node *next;
+} malloc_node_t;
+
+typedef struct {
+  char *brk;                                  /** next uncarved byte of the arena */
+  char *limit;                                /** end of the arena, NULL until first use */
+  malloc_node_t *free[MALLOC_NUM_CLASSES];    /** owner-only free lists */
+  malloc_node_t *remote;                      /** blocks freed by other harts, pushed atomically */
+} __attribute__((aligned(64))) malloc_arena_t;
+
+typedef struct {
+  uint32_t lock;
+  malloc_header_t *free;                      /** address-ordered free blocks */
+} malloc_pool_t;
+
+extern void *_sbrk(ptrdiff_t incr);
+
+/* Set by the linker script; absent (0) when it reserves no per-hart arenas. */
+extern char __heap_arenas_start[] __attribute__((weak));
+extern char __heap_harts[] __attribute__((weak));
+extern char __heap_end[];
+
+static malloc_arena_t malloc_arenas[MALLOC_MAX_HARTS];
+static malloc_pool_t malloc_pool;
+
+static inline malloc_header_t *malloc_header(void *ptr) {
+  return (malloc_header_t *)ptr - 1;
+}
+
+static inline size_t malloc_class_size(uint32_t cls) {
+  return (size_t)1U << (cls + MALLOC_MIN_SHIFT);
+}
+
+static inline uint32_t malloc_size_class(size_t size) {
+  if (size <= MALLOC_ALIGN) {
+    return 0U;
+  }
+  return (uint32_t)(sizeof(unsigned long) * 8U - __builtin_clzl(size - 1U)) - MALLOC_MIN_SHIFT;
+}
+
+static void malloc_pool_lock(void) {
+  while (__atomic_exchange_n(&malloc_pool.lock, 1U, __ATOMIC_ACQUIRE)) {
+    while (__atomic_load_n(&malloc_pool.lock, __ATOMIC_RELAXED));
+  }
+}
+
+static void malloc_pool_unlock(void) {
+  __atomic_store_n(&malloc_pool.lock, 0U, __ATOMIC_RELEASE);
+}
+
+/* Free pool blocks link through the first word of their payload. */
+#define MALLOC_POOL_NEXT(block) (*(malloc_header_t **)((block) + 1))
+
+static void *malloc_pool_alloc(size_t size) {
+  malloc_header_t **link;
+  malloc_header_t *block;
+
+  if (unlikely(size > (size_t)PTRDIFF_MAX - sizeof(malloc_header_t) - MALLOC_ALIGN)) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  size = (size + MALLOC_ALIGN - 1U) & ~(size_t)(MALLOC_ALIGN - 1U);
+  if (size == 0U) {
+    size = MALLOC_ALIGN;
+  }
+
+  malloc_pool_lock();
+  for (link = &malloc_pool.free; (block = *link) != NULL; link = &MALLOC_POOL_NEXT(block)) {
+    if (block->size < size) {
+      continue;
+    }
+    if (block->size >= size + sizeof(malloc_header_t) + MALLOC_ALIGN) {
+      /* Split; the tail takes the block's place on the free list. */
+      malloc_header_t *rest = (malloc_header_t *)((char *)(block + 1) + size);
+      rest->kind = MALLOC_KIND_POOL;
+      rest->owner = MALLOC_NO_OWNER;
+      rest->size = block->size - size - sizeof(malloc_header_t);
+      MALLOC_POOL_NEXT(rest) = MALLOC_POOL_NEXT(block);
+      *link = rest;
+      block->size = size;
+    } else {
+      *link = MALLOC_POOL_NEXT(block);
+    }
+    malloc_pool_unlock();
+    return block + 1;
+  }
+
+  block = _sbrk((ptrdiff_t)(sizeof(malloc_header_t) + size));
+  malloc_pool_unlock();
+  if (unlikely(block == (void *)(-1))) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  block->kind = MALLOC_KIND_POOL;
+  block->owner = MALLOC_NO_OWNER;
+  block->size = size;
+  return block + 1;
+}
+
+static inline char *malloc_pool_block_end(malloc_header_t *block) {
+  return (char *)(block + 1) + block->size;
+}
+
+static void malloc_pool_free(malloc_header_t *block) {
+  malloc_header_t *prev = NULL;
+  malloc_header_t *next;
+
+  malloc_pool_lock();
+  next = malloc_pool.free;
+  while (next != NULL && next < block) {
+    prev = next;
+    next = MALLOC_POOL_NEXT(next);
+  }
+
+  if (next != NULL && malloc_pool_block_end(block) == (char *)next) {
+    block->size += sizeof(malloc_header_t) + next->size;
+    next = MALLOC_POOL_NEXT(next);
+  }
+  MALLOC_POOL_NEXT(block) = next;
+
+  if (prev == NULL) {
+    malloc_pool.free = block;
+  } else if (malloc_pool_block_end(prev) == (char *)block) {
+    prev->size += sizeof(malloc_header_t) + block->size;
+    MALLOC_POOL_NEXT(prev) = next;
+  } else {
+    MALLOC_POOL_NEXT(prev) = block;
+  }
+  malloc_pool_unlock();
+}
+
+static malloc_arena_t *malloc_arena(uint32_t hart) {
+  malloc_arena_t *arena;
+  size_t harts = (size_t)(uintptr_t)__heap_harts;
+  size_t span;
+
+  if (hart >= MALLOC_MAX_HARTS) {
+    return NULL;
+  }
+  arena = &malloc_arenas[hart];
+  if (likely(arena->limit != NULL)) {
+    return arena;
+  }
+  if (__heap_arenas_start == NULL || hart >= harts) {
+    return NULL;
+  }
+  span = ((size_t)(__heap_end - __heap_arenas_start) / harts) & ~(size_t)(MALLOC_ALIGN - 1U);
+  arena->brk = __heap_arenas_start + (size_t)hart * span;
+  arena->limit = arena->brk + span;
+  return arena;
+}
+
+/* Moves blocks other harts freed back onto the owner's lists. */
+static void malloc_arena_reclaim(malloc_arena_t *arena) {
+  malloc_node_t *node = __atomic_exchange_n(&arena->remote, NULL, __ATOMIC_ACQUIRE);
+
+  while (node != NULL) {
+    malloc_node_t *next = node->next;
+    uint32_t cls = malloc_header(node)->cls;
+    node->next = arena->free[cls];
+    arena->free[cls] = node;
+    node = next;
+  }
+}
+
+/* Carves up to MALLOC_SLAB_BYTES worth of class-sized blocks onto the class's free list. */
+static int malloc_arena_refill(malloc_arena_t *arena, uint32_t hart, uint32_t cls) {
+  const size_t stride = sizeof(malloc_header_t) + malloc_class_size(cls);
+  size_t count = (size_t)(arena->limit - arena->brk) / stride;
+
+  if (count > MALLOC_SLAB_BYTES / stride) {
+    count = MALLOC_SLAB_BYTES / stride;
+  }
+  for (size_t i = 0; i < count; i += 1) {
+    malloc_header_t *block = (malloc_header_t *)arena->brk;
+    malloc_node_t *node = (malloc_node_t *)(block + 1);
+
+    block->kind = MALLOC_KIND_SLAB;
+    block->owner = (uint16_t)hart;
+    block->cls = (uint16_t)cls;
+    block->size = 0U;
+    node->next = arena->free[cls];
+    arena->free[cls] = node;
+    arena->brk += stride;
+  }
+  return count > 0U;
+}
+
+static void *malloc_arena_alloc(malloc_arena_t *arena, uint32_t hart, size_t size) {
+  const uint32_t cls = malloc_size_class(size);
+  malloc_node_t *node = arena->free[cls];
+
+  if (unlikely(node == NULL)) {
+    if (__atomic_load_n(&arena->remote, __ATOMIC_RELAXED) != NULL) {
+      malloc_arena_reclaim(arena);
+    }
+    if (arena->free[cls] == NULL && !malloc_arena_refill(arena, hart, cls)) {
+      return NULL;
+    }
+    node = arena->free[cls];
+  }
+  arena->free[cls] = node->next;
+  return node;
+}
+
+static void *malloc_alloc(size_t size) {
+  const uint32_t hart = (uint32_t)READ_CSR("mhartid");
+
+  if (likely(size <= MALLOC_MAX_SLAB_SIZE)) {
+    malloc_arena_t *arena = malloc_arena(hart);
+    if (likely(arena != NULL)) {
+      void *ptr = malloc_arena_alloc(arena, hart, size);
+      if (likely(ptr != NULL)) {
+        return ptr;
+      }
+    }
+  }
+  return malloc_pool_alloc(size);
+}
+
+static void malloc_release(void *ptr) {
+  malloc_header_t *block;
+
+  if (ptr == NULL) {
+    return;
+  }
+  block = malloc_header(ptr);
+
+  if (block->kind == MALLOC_KIND_SLAB) {
+    malloc_arena_t *owner = &malloc_arenas[block->owner];
+    malloc_node_t *node = ptr;
+
+    if (likely(block->owner == (uint32_t)READ_CSR("mhartid"))) {
+      node->next = owner->free[block->cls];
+      owner->free[block->cls] = node;
+    } else {
+      node->next = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+      while (!__atomic_compare_exchange_n(&owner->remote, &node->next, node, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+  } else if (block->kind == MALLOC_KIND_ALIGNED) {
+    malloc_release((char *)ptr - block->size);
+  } else {
+    malloc_pool_free(block);
+  }
+}
+
+static size_t malloc_usable(void *ptr) {
+  malloc_header_t *block = malloc_header(ptr);
+
+  if (block->kind == MALLOC_KIND_SLAB) {
+    return malloc_class_size(block->cls);
+  }
+  if (block->kind == MALLOC_KIND_ALIGNED) {
+    return malloc_usable((char *)ptr - block->size) - block->size;
+  }
+  return block->size;
+}
+
+static void *malloc_aligned(size_t align, size_t size) {
+  char *base;
+  char *ptr;
+  malloc_header_t *view;
+
+  if (align == 0U || (align & (align - 1U)) != 0U) {
+    errno = EINVAL;
+    return NULL;
+  }
+  if (align <= MALLOC_ALIGN) {
+    return malloc_alloc(size);
+  }
+  if (size > SIZE_MAX - align) {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  base = malloc_alloc(size + align);
+  if (base == NULL) {
+    return NULL;
+  }
+  ptr = (char *)(((uintptr_t)base + align - 1U) & ~(uintptr_t)(align - 1U));
+  if (ptr == base) {
+    return base;
+  }
+  /* base and ptr are both 16-byte aligned, so the view header fits in the gap. */
+  view = malloc_header(ptr);
+  view->kind = MALLOC_KIND_ALIGNED;
+  view->owner = MALLOC_NO_OWNER;
+  view->cls = 0U;
+  view->size = (size_t)(ptr - base);
+  return ptr;
+}
+
+static void *malloc_resize(void *ptr, size_t size) {
+  void *moved;
+  size_t usable;
+
+  if (ptr == NULL) {
+    return malloc_alloc(size);
+  }
+  if (size == 0U) {
+    malloc_release(ptr);
+    return NULL;
+  }
+  usable = malloc_usable(ptr);
+  if (size <= usable) {
+    return ptr;
+  }
+  moved = malloc_alloc(size);
+  if (moved != NULL) {
+    memcpy(moved, ptr, usable);
+    malloc_release(ptr);
+  }
+  return moved;
+}
+
+static void *malloc_zeroed(size_t count, size_t size) {
+  void *ptr;
+
+  if (size != 0U && count > SIZE_MAX / size) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  ptr = malloc_alloc(count * size);
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void *malloc(size_t size) {
+  return malloc_alloc(size);
+}
+
+void free(void *ptr) {
+  malloc_release(ptr);
+}
+
+void *calloc(size_t count, size_t size) {
+  return malloc_zeroed(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  return malloc_resize(ptr, size);
+}
+
+void *memalign(size_t align, size_t size) {
+  return malloc_aligned(align, size);
+}
+
+void *aligned_alloc(size_t align, size_t size) {
+  return malloc_aligned(align, size);
+}
+
+size_t malloc_usable_size(void *ptr) {
+  return (ptr != NULL) ? malloc_usable(ptr) : 0U;
+}
+
+/* Reentrant entry points used inside newlib (stdio buffers and the like). */
+void *_malloc_r(struct _reent *r, size_t size) {
+  (void)r;
+  return malloc_alloc(size);
+}
+
+void _free_r(struct _reent *r, void *ptr) {
+  (void)r;
+  malloc_release(ptr);
+}
+
+void *_calloc_r(struct _reent *r, size_t count, size_t size) {
+  (void)r;
+  return malloc_zeroed(count, size);
+}
+
+void *_realloc_r(struct _reent *r, void *ptr, size_t size) {
+  (void)r;
+  return malloc_resize(ptr, size);
+}
+
+void *_memalign_r(struct _reent *r, size_t align, size_t size) {
+  (void)r;
+  return malloc_aligned(align, size);
+}
+
+size_t _malloc_usable_size_r(struct _reent *r, void *ptr) {
+  (void)r;
+  return malloc_usable_size(ptr);
+}
@@ -2,6 +2,23 @@
 #include <unistd.h>
 #include <sys/types.h>
 
+#include "chip_config.h"
+
 __attribute__((weak)) ssize_t _read(int file, void *ptr, size_t len) {
-  return -1;
+  #if defined(TERMINAL_DEVICE_UART0) && defined(TERMINAL_UART_BUFFERED)
+    // wait for at least one byte, then return whatever the RX ring holds
+    uint16_t chunk = (len > 0xFFFFU) ? 0xFFFFU : (uint16_t)len;
+    uint16_t n = 0;
+    (void)file;
+    if (len == 0) {
+      return 0;
+    }
+    uart_buffered_init_once(&uart_console, UART0, 0);
+    while (n == 0) {
+      n = uart_buffered_receive(&uart_console, (uint8_t *)ptr, chunk);
+    }
+    return n;
+  #else
+    return -1;
+  #endif
 }
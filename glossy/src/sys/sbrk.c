@@ -9,16 +9,25 @@ static char *curbrk = __end;
 
 __attribute__((weak)) void *_sbrk(ptrdiff_t incr) {
   extern char __heap_end[];
+#ifdef GLOSSY_HEAP_ARENAS
+  /* The per-hart malloc arenas sit above the break (see malloc.c). */
+  extern char __heap_arenas_start[] __attribute__((weak));
+  char *limit = (__heap_arenas_start != NULL) ? __heap_arenas_start : __heap_end;
+#else
+  /* newlib's malloc: the linker scripts reserve no arenas (__heap_harts = 0) without the option. */
+  char *limit = __heap_end;
+#endif
   char *newbrk;
   char *oldbrk;
 
-  oldbrk = curbrk;
-  newbrk = oldbrk + incr;
-  if (unlikely((newbrk < __end) || (newbrk >= __heap_end))) {
-    errno = ENOMEM;
-    return (void *)(-1);
-  }
+  oldbrk = __atomic_load_n(&curbrk, __ATOMIC_RELAXED);
+  do {
+    newbrk = oldbrk + incr;
+    if (unlikely((newbrk < __end) || (newbrk >= limit))) {
+      errno = ENOMEM;
+      return (void *)(-1);
+    }
+  } while (!__atomic_compare_exchange_n(&curbrk, &oldbrk, newbrk, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-  curbrk = newbrk;
   return oldbrk;
 }
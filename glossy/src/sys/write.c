@@ -4,11 +4,40 @@
 
 #include "chip_config.h"
 
+#if defined(TERMINAL_DEVICE_UART0) && defined(TERMINAL_UART_BUFFERED)
+UART_BufferedType uart_console;
+
+/* Polled until the application routes UART0's PLIC source to uart_buffered_irq_handler and calls
+ * uart_buffered_set_interrupts(&uart_console, 1) (see uart.h). Safe to race from several harts. */
+static void console_init(void) {
+  uart_buffered_init_once(&uart_console, UART0, 0);
+}
+
+#if defined(TERMINAL_UART_NONBLOCKING)
+#define CONSOLE_BLOCK 0
+#else
+#define CONSOLE_BLOCK 1
+#endif
+#endif
+
 
 __attribute__((weak)) ssize_t _write(int fd, const void *ptr, size_t len) {
   #if defined(TERMINAL_DEVICE_HTIF)
     htif_syscall(fd, (uintptr_t)ptr, len, FESVR_write);
     return len;
+  #elif defined(TERMINAL_DEVICE_UART0) && defined(TERMINAL_UART_BUFFERED)
+    // queue; with TERMINAL_UART_NONBLOCKING what does not fit in the ring is dropped
+    console_init();
+    for (size_t done = 0; done < len; ) {
+      uint16_t chunk = (len - done > 0xFFFFU) ? 0xFFFFU : (uint16_t)(len - done);
+      uart_buffered_transmit(&uart_console, (const uint8_t *)ptr + done, chunk, CONSOLE_BLOCK);
+      done += chunk;
+    }
+    // nothing else drains a polled ring: a message printed before a final wfi would never leave
+    if (!uart_console.use_interrupts) {
+      uart_buffered_flush(&uart_console);
+    }
+    return len;
   #elif defined(TERMINAL_DEVICE_UART0)
     uart_transmit(UART0, (uint8_t *)ptr, len, 100);
     return len;
@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include "riscv.h"
+#include "chip_config.h"
 
 
 /* ==== Exception Handlers ==== */
@@ -58,7 +59,12 @@ __attribute__((weak)) void supervisor_software_interrupt_callback() {}
 
 __attribute__((weak)) void hypervisor_software_interrupt_callback() {}
 
-__attribute__((weak)) void machine_software_interrupt_callback() {}
+__attribute__((weak)) void machine_software_interrupt_callback() {
+  #if defined(CLINT)
+    // MSIP is level-triggered: acknowledge it, or the trap re-enters as soon as it returns
+    CLINT->MSIP[READ_CSR("mhartid")] = 0;
+  #endif
+}
 
 __attribute__((weak)) void user_timer_interrupt_callback() {}
 
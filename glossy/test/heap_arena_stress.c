@@ -0,0 +1,361 @@
+/*
+ * heap_arena_stress.c - Host-side stress test for the glossy per-hart heap arenas.
+ *
+ * Builds src/sys/malloc.c and sbrk.c unmodified against pthreads, with one
+ * thread per simulated hart (READ_CSR("mhartid") reads a thread-local id),
+ * and hammers them with a random mix of malloc/calloc/realloc/memalign/
+ * aligned_alloc/free. Harts 0..harts-1 own arenas; two extra threads play
+ * a hart past __heap_harts and one past MALLOC_MAX_HARTS, so both fall back
+ * to the shared pool. Blocks are handed to other harts through per-hart
+ * mailboxes, so frees also go through the owner's remote-free stack. The
+ * races only show up under `make tsan` on a single-core host. It checks:
+ *
+ *  - every block is aligned, at least as large as asked for, zeroed when it
+ *    comes from calloc, and keeps its fill pattern until it is freed (no two
+ *    live blocks overlap); realloc keeps the old contents.
+ *  - small requests from a hart with an arena are always served from that
+ *    arena (the live set fits, so a miss means blocks leaked out of it).
+ *  - once everything is freed, the pool has coalesced back into one block:
+ *    a request for the whole break is served in place without growing it.
+ *
+ * Usage: heap_arena_stress [harts] [ops]
+ */
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEAP_HARTS        4u                    /* __heap_harts */
+#define HEAP_POOL_BYTES   (16u << 20)           /* [__end, __heap_arenas_start) */
+#define HEAP_ARENA_BYTES  (2u << 20)            /* per hart */
+#define MALLOC_MAX_HARTS  8u                    /* matches malloc.c */
+#define MALLOC_MAX_SLAB   2048u                 /* largest arena size class */
+#define MALLOC_HEADER     16u
+
+#define SLOTS             64u                   /* live blocks per hart */
+#define MAX_THREADS       (HEAP_HARTS + 2u)
+#define MAILBOX_SLOTS     16u                   /* per hart */
+#define MAX_SIZE          16384u
+
+/* The linker-script symbols malloc.c and sbrk.c expect, laid out like dsp25.ld does. */
+#define STR_(x) #x
+#define STR(x)  STR_(x)
+__asm__(".globl __heap_harts\n"
+        ".set __heap_harts, " STR(HEAP_HARTS) "\n"
+        ".section .bss\n"
+        ".balign 64\n"
+        ".globl __end\n"
+        "__end:\n"
+        ".space " STR(HEAP_POOL_BYTES) "\n"
+        ".globl __heap_arenas_start\n"
+        "__heap_arenas_start:\n"
+        ".space " STR(HEAP_HARTS) " * " STR(HEAP_ARENA_BYTES) "\n"
+        ".globl __heap_end\n"
+        "__heap_end:\n"
+        ".previous\n");
+
+extern char __end[];
+extern char __heap_arenas_start[];
+
+void *glossy_malloc(size_t size);
+void glossy_free(void *ptr);
+void *glossy_calloc(size_t count, size_t size);
+void *glossy_realloc(void *ptr, size_t size);
+void *glossy_memalign(size_t align, size_t size);
+void *glossy_aligned_alloc(size_t align, size_t size);
+size_t glossy_malloc_usable_size(void *ptr);
+void *glossy_sbrk(ptrdiff_t incr);
+
+__thread unsigned long test_hart_id;
+
+typedef struct {
+    uint8_t *ptr;
+    size_t size;
+    uint32_t tag;
+} block_t;
+
+/* Blocks in the mailbox start with their size and tag so any hart can check and free them. */
+typedef struct {
+    uint64_t size;
+    uint64_t tag;
+} mail_header_t;
+
+static uint8_t *g_mailbox[MAX_THREADS][MAILBOX_SLOTS];
+static uint32_t g_hart_ids[MAX_THREADS];
+static uint32_t g_threads;
+static pthread_barrier_t g_start;
+static uint32_t g_ops;
+static uint32_t g_errors;
+static uint64_t g_remote_frees;
+static uint64_t g_pool_allocs;
+
+#define FAIL(...)                                     \
+    do {                                              \
+        __atomic_fetch_add(&g_errors, 1u, __ATOMIC_RELAXED); \
+        fprintf(stderr, "[FAIL] " __VA_ARGS__);       \
+    } while (0)
+
+static uint32_t rnd(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return (uint32_t)(x >> 32);
+}
+
+static uint8_t pattern(uint32_t tag, size_t i) {
+    return (uint8_t)(tag * 131u + (uint32_t)i * 7u + (tag >> 8));
+}
+
+static void fill(uint8_t *p, size_t from, size_t size, uint32_t tag) {
+    for (size_t i = from; i < size; i++) {
+        p[i] = pattern(tag, i);
+    }
+}
+
+static int check(const uint8_t *p, size_t from, size_t size, uint32_t tag) {
+    for (size_t i = from; i < size; i++) {
+        if (p[i] != pattern(tag, i)) {
+            FAIL("hart %lu: block %p tag %u corrupt at byte %zu of %zu\n",
+                 test_hart_id, (const void *)p, tag, i, size);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static size_t pick_size(uint64_t *state) {
+    uint32_t r = rnd(state) % 100u;
+
+    if (r < 5u) {
+        return 0u;
+    }
+    if (r < 75u) {
+        return 1u + rnd(state) % MALLOC_MAX_SLAB;
+    }
+    return MALLOC_MAX_SLAB + 1u + rnd(state) % (MAX_SIZE - MALLOC_MAX_SLAB);
+}
+
+static int in_arena(const void *p, uint32_t hart) {
+    if (hart >= HEAP_HARTS) {
+        return 0;
+    }
+    const uint8_t *lo = (const uint8_t *)__heap_arenas_start + (size_t)hart * HEAP_ARENA_BYTES;
+    return (const uint8_t *)p >= lo && (const uint8_t *)p < lo + HEAP_ARENA_BYTES;
+}
+
+static void free_mail(uint8_t *p) {
+    mail_header_t hdr;
+
+    memcpy(&hdr, p, sizeof(hdr));
+    check(p, sizeof(hdr), (size_t)hdr.size, (uint32_t)hdr.tag);
+    for (uint32_t h = 0; h < HEAP_HARTS; h++) {
+        if (h != test_hart_id && in_arena(p, h)) {
+            __atomic_fetch_add(&g_remote_frees, 1u, __ATOMIC_RELAXED);
+        }
+    }
+    glossy_free(p);
+}
+
+static void take_mail(uint32_t self, uint32_t slot) {
+    uint8_t *p = __atomic_exchange_n(&g_mailbox[self][slot], NULL, __ATOMIC_ACQ_REL);
+
+    if (p != NULL) {
+        free_mail(p);
+    }
+}
+
+static void alloc_block(block_t *b, uint32_t hart, uint32_t tag, uint64_t *state) {
+    const uint32_t kind = rnd(state) % 8u;
+    size_t size = pick_size(state);
+    size_t align = 16u;
+    uint8_t *p;
+
+    if (kind < 5u) {
+        p = glossy_malloc(size);
+    } else if (kind == 5u) {
+        p = glossy_calloc(1u + size / 8u, 8u);
+        size = (1u + size / 8u) * 8u;
+        if (p != NULL) {
+            for (size_t i = 0; i < size; i++) {
+                if (p[i] != 0u) {
+                    FAIL("hart %u: calloc block %p not zeroed at byte %zu\n", hart, (void *)p, i);
+                    break;
+                }
+            }
+        }
+    } else if (kind == 6u) {
+        align = (size_t)32u << (rnd(state) % 8u);
+        p = glossy_memalign(align, size);
+    } else {
+        align = 64u;
+        p = glossy_aligned_alloc(align, size);
+    }
+
+    if (p == NULL) {
+        FAIL("hart %u: allocation of %zu bytes (align %zu) failed\n", hart, size, align);
+        b->ptr = NULL;
+        return;
+    }
+    if (((uintptr_t)p & (align - 1u)) != 0u) {
+        FAIL("hart %u: block %p not %zu-byte aligned\n", hart, (void *)p, align);
+    }
+    if (glossy_malloc_usable_size(p) < size) {
+        FAIL("hart %u: block %p usable %zu < %zu\n", hart, (void *)p,
+             glossy_malloc_usable_size(p), size);
+    }
+    if (!in_arena(p, hart)) {
+        __atomic_fetch_add(&g_pool_allocs, 1u, __ATOMIC_RELAXED);
+        if (hart < HEAP_HARTS && kind <= 5u && size <= MALLOC_MAX_SLAB) {
+            FAIL("hart %u: %zu-byte block %p served outside its arena\n", hart, size, (void *)p);
+        }
+    }
+    fill(p, 0u, size, tag);
+    b->ptr = p;
+    b->size = size;
+    b->tag = tag;
+}
+
+static void *hart_main(void *arg) {
+    const uint32_t self = (uint32_t)(uintptr_t)arg;
+    const uint32_t hart = g_hart_ids[self];
+    uint64_t state = 0x9e3779b97f4a7c15ull * (hart + 1u);
+    block_t blocks[SLOTS];
+    uint32_t tag = hart << 24;
+
+    test_hart_id = hart;
+    memset(blocks, 0, sizeof(blocks));
+    pthread_barrier_wait(&g_start);
+
+    for (uint32_t op = 0; op < g_ops; op++) {
+        block_t *b = &blocks[rnd(&state) % SLOTS];
+
+        take_mail(self, rnd(&state) % MAILBOX_SLOTS);
+
+        if (b->ptr == NULL) {
+            alloc_block(b, hart, ++tag, &state);
+            continue;
+        }
+        if (!check(b->ptr, 0u, b->size, b->tag)) {
+            b->ptr = NULL;      /* leave the corrupt block alone */
+            continue;
+        }
+
+        switch (rnd(&state) % 4u) {
+        case 0:
+        case 1:
+            glossy_free(b->ptr);
+            b->ptr = NULL;
+            break;
+        case 2: {
+            size_t size = pick_size(&state);
+            size_t keep = (size < b->size) ? size : b->size;
+            uint8_t *p = glossy_realloc(b->ptr, size);
+
+            if (size == 0u) {
+                b->ptr = NULL;
+                break;
+            }
+            if (p == NULL) {
+                FAIL("hart %u: realloc to %zu bytes failed\n", hart, size);
+                glossy_free(b->ptr);
+                b->ptr = NULL;
+                break;
+            }
+            check(p, 0u, keep, b->tag);
+            b->ptr = p;
+            b->size = size;
+            b->tag = ++tag;
+            fill(p, 0u, size, b->tag);
+            break;
+        }
+        default:
+            if (b->size >= sizeof(mail_header_t)) {
+                /* Hand the block to another hart; it gets freed there. */
+                const uint32_t to = (self + 1u + rnd(&state) % (g_threads - 1u)) % g_threads;
+                mail_header_t h = { .size = b->size, .tag = b->tag };
+                uint8_t *expected = NULL;
+
+                memcpy(b->ptr, &h, sizeof(h));
+                if (!__atomic_compare_exchange_n(&g_mailbox[to][rnd(&state) % MAILBOX_SLOTS],
+                                                 &expected, b->ptr, 0, __ATOMIC_ACQ_REL,
+                                                 __ATOMIC_RELAXED)) {
+                    glossy_free(b->ptr);
+                }
+                b->ptr = NULL;
+            } else {
+                glossy_free(b->ptr);
+                b->ptr = NULL;
+            }
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < SLOTS; i++) {
+        if (blocks[i].ptr != NULL && check(blocks[i].ptr, 0u, blocks[i].size, blocks[i].tag)) {
+            glossy_free(blocks[i].ptr);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    uint32_t harts = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : HEAP_HARTS;
+    g_ops = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 200000u;
+    /* Arena harts, then one past __heap_harts and one past MALLOC_MAX_HARTS (pool only). */
+    pthread_t tid[MAX_THREADS];
+    char *brk;
+
+    if (harts == 0u || harts > HEAP_HARTS) {
+        fprintf(stderr, "harts must be in [1, %u]\n", HEAP_HARTS);
+        return 2;
+    }
+    for (uint32_t h = 0; h < harts; h++) {
+        g_hart_ids[g_threads++] = h;
+    }
+    g_hart_ids[g_threads++] = HEAP_HARTS;
+    g_hart_ids[g_threads++] = MALLOC_MAX_HARTS + 1u;
+
+    printf("heap arena stress: %u arena harts + 2 pool-only harts, %u ops each\n", harts, g_ops);
+    pthread_barrier_init(&g_start, NULL, g_threads);
+    for (uint32_t t = 0; t < g_threads; t++) {
+        pthread_create(&tid[t], NULL, hart_main, (void *)(uintptr_t)t);
+    }
+    for (uint32_t t = 0; t < g_threads; t++) {
+        pthread_join(tid[t], NULL);
+    }
+    pthread_barrier_destroy(&g_start);
+
+    /* The main thread drains the mailbox as hart 0. */
+    test_hart_id = 0;
+    for (uint32_t t = 0; t < g_threads; t++) {
+        for (uint32_t slot = 0; slot < MAILBOX_SLOTS; slot++) {
+            take_mail(t, slot);
+        }
+    }
+
+    /* Everything is free again: the pool must be a single block spanning the whole break. */
+    brk = glossy_sbrk(0);
+    if ((size_t)(brk - __end) > MALLOC_HEADER + MALLOC_MAX_SLAB) {
+        size_t span = (size_t)(brk - __end) - MALLOC_HEADER;
+        void *p = glossy_malloc(span);
+
+        if (p != __end + MALLOC_HEADER || glossy_sbrk(0) != brk) {
+            FAIL("pool did not coalesce: %zu-byte request got %p (pool starts at %p), break %p -> %p\n",
+                 span, p, (void *)__end, (void *)brk, glossy_sbrk(0));
+        }
+        glossy_free(p);
+    }
+
+    if (g_errors != 0u) {
+        printf("[FAIL] %u violation(s)\n", g_errors);
+        return 1;
+    }
+    printf("[PASS] %u harts x %u ops: %llu remote frees, %llu pool allocations, pool %zu KiB\n",
+           g_threads, g_ops, (unsigned long long)g_remote_frees,
+           (unsigned long long)g_pool_allocs, (size_t)(brk - __end) >> 10);
+    return 0;
+}
@@ -0,0 +1,7 @@
+/* Host stand-in for newlib's reent.h; malloc.c only passes the pointer through. */
+#ifndef GLOSSY_TEST_REENT_H
+#define GLOSSY_TEST_REENT_H
+
+struct _reent;
+
+#endif
@@ -0,0 +1,9 @@
+/* Host stand-in for riscv.h: each test thread plays one hart and READ_CSR("mhartid") returns its id. */
+#ifndef GLOSSY_TEST_RISCV_H
+#define GLOSSY_TEST_RISCV_H
+
+extern __thread unsigned long test_hart_id;
+
+#define READ_CSR(REG) (test_hart_id)
+
+#endif
@@ -0,0 +1,76 @@
+#include "binlog.h"
+
+#include <unistd.h>
+
+#define BINLOG_LINE_BYTES       48U
+
+binlog_ring_t binlog_rings[BINLOG_MAX_HARTS];
+
+typedef struct {
+  char text[4U + (2U * BINLOG_LINE_BYTES) + 1U];
+  uint32_t bytes;
+} binlog_line_t;
+
+static void binlog_line_flush(binlog_line_t *line) {
+  if (line->bytes == 0U) {
+    return;
+  }
+  line->text[4U + (2U * line->bytes)] = '\n';
+  write(STDOUT_FILENO, line->text, 4U + (2U * line->bytes) + 1U);
+  line->bytes = 0U;
+}
+
+static void binlog_line_put(binlog_line_t *line, uint64_t value, uint32_t size) {
+  static const char hex[] = "0123456789abcdef";
+
+  for (uint32_t i = 0; i < size; i += 1) {
+    const uint8_t b = (uint8_t)(value >> (8U * i));
+    if (line->bytes == BINLOG_LINE_BYTES) {
+      binlog_line_flush(line);
+    }
+    line->text[4U + (2U * line->bytes)] = hex[b >> 4];
+    line->text[4U + (2U * line->bytes) + 1U] = hex[b & 0xFU];
+    line->bytes += 1U;
+  }
+}
+
+size_t binlog_drain(void) {
+  binlog_line_t line = { .text = "@BL ", .bytes = 0U };
+  size_t records = 0U;
+
+  for (uint32_t hart = 0; hart < BINLOG_MAX_HARTS; hart += 1) {
+    binlog_ring_t *ring = &binlog_rings[hart];
+    const uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = ring->tail;
+
+    while (tail != head) {
+      const uint64_t word0 = ring->words[tail & (BINLOG_RING_WORDS - 1U)];
+      const uint32_t nargs = (uint32_t)(word0 >> 56);
+
+      binlog_line_put(&line, hart, 1U);
+      binlog_line_put(&line, nargs, 1U);
+      binlog_line_put(&line, word0 & ((1ULL << 56) - 1U), 8U);
+      for (uint32_t i = 1; i < 2U + nargs; i += 1) {
+        binlog_line_put(&line, ring->words[(tail + i) & (BINLOG_RING_WORDS - 1U)], 8U);
+      }
+      tail += 2U + nargs;
+      records += 1U;
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+  }
+
+  binlog_line_flush(&line);
+  return records;
+}
+
+void binlog_reset(void) {
+  for (uint32_t hart = 0; hart < BINLOG_MAX_HARTS; hart += 1) {
+    __atomic_store_n(&binlog_rings[hart].tail, __atomic_load_n(&binlog_rings[hart].head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+    binlog_rings[hart].dropped = 0U;
+  }
+}
+
+uint32_t binlog_dropped(uint32_t hart) {
+  return (hart < BINLOG_MAX_HARTS) ? binlog_rings[hart].dropped : 0U;
+}
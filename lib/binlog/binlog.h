@@ -0,0 +1,170 @@
+/**
+ * @file binlog.h
+ * @brief Per-hart binary logging with host-side formatting.
+ *
+ * BINLOG(fmt, ...) is a printf replacement for hot paths. Nothing is formatted on the chip: the call
+ * site stores the address of its format string (placed in .rodata.binlog), an mcycle timestamp and
+ * up to BINLOG_MAX_ARGS raw 64-bit arguments into the calling hart's ring. Each hart only ever writes
+ * its own ring, so harts log concurrently without a lock; a full ring drops the record and counts it.
+ *
+ * binlog_drain() (one hart at a time) moves the rings out through _write, i.e. over whatever console
+ * glossy is built for (UART or HTIF), as lines of the form
+ *
+ *   @BL <hex bytes>
+ *
+ * which survive being interleaved with ordinary printf output. scripts/trace/decode_binlog.py takes
+ * the captured console log and the program's ELF, looks the format strings up in the ELF and prints
+ * the text. Argument rules, since the host only sees the format string:
+ *  - integers, characters and pointers are recorded as 64-bit values (%d, %u, %x, %ld, %llu, %p, %c)
+ *  - float and double are recorded as double bits (%f, %e, %g)
+ *  - %s only works for strings that live in the ELF (string literals, const tables)
+ *
+ * Stream format (little endian), one record after another:
+ *   u8 hart, u8 nargs, u64 format address, u64 mcycle, nargs x u64 argument
+ */
+
+#ifndef __BINLOG_H
+#define __BINLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef BINLOG_MAX_HARTS
+#define BINLOG_MAX_HARTS        4U
+#endif
+
+#ifndef BINLOG_RING_WORDS
+#define BINLOG_RING_WORDS       4096U   /* 64-bit words per hart, power of two */
+#endif
+
+#define BINLOG_MAX_ARGS         8U
+
+/* Hart index and timestamp of a record; override to log mtime or to build for the host. */
+#ifndef BINLOG_HART_ID
+#define BINLOG_HART_ID()        binlog_read_mhartid()
+#endif
+#ifndef BINLOG_TIMESTAMP
+#define BINLOG_TIMESTAMP()      binlog_read_mcycle()
+#endif
+
+typedef struct {
+  volatile uint64_t head;         /** words written by the owning hart */
+  volatile uint64_t tail;         /** words consumed by binlog_drain */
+  volatile uint32_t dropped;      /** records lost to a full ring */
+  uint64_t words[BINLOG_RING_WORDS];
+} __attribute__((aligned(64))) binlog_ring_t;   /* rings of different harts never share a line */
+
+static inline uint64_t binlog_read_mhartid(void) {
+  uint64_t x;
+  asm volatile("csrr %0, mhartid" : "=r"(x));
+  return x;
+}
+
+static inline uint64_t binlog_read_mcycle(void) {
+  uint64_t x;
+  asm volatile("csrr %0, mcycle" : "=r"(x));
+  return x;
+}
+
+static inline uint64_t binlog_from_u64(uint64_t x) {
+  return x;
+}
+
+static inline uint64_t binlog_from_f64(double x) {
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+/* Arithmetic arguments pass through unchanged; anything else is a pointer and goes through
+ * uintptr_t, so typed pointers (int *, struct foo *) convert without -Wint-conversion. */
+#define BINLOG_ARG_VALUE(x) _Generic((x),                                                     \
+    float: (x), double: (x), _Bool: (x), char: (x), signed char: (x), unsigned char: (x),     \
+    short: (x), unsigned short: (x), int: (x), unsigned int: (x), long: (x),                  \
+    unsigned long: (x), long long: (x), unsigned long long: (x),                              \
+    default: (uintptr_t)(x))
+
+#define BINLOG_ARG(x) _Generic((x),                                                           \
+    float: binlog_from_f64, double: binlog_from_f64,                                          \
+    default: binlog_from_u64)(BINLOG_ARG_VALUE(x))
+
+#define BINLOG_NARGS(...)       BINLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define BINLOG_CAT(a, b)        BINLOG_CAT_(a, b)
+#define BINLOG_CAT_(a, b)       a##b
+
+#define BINLOG_MAP0()
+#define BINLOG_MAP1(a)          BINLOG_ARG(a)
+#define BINLOG_MAP2(a, ...)     BINLOG_ARG(a), BINLOG_MAP1(__VA_ARGS__)
+#define BINLOG_MAP3(a, ...)     BINLOG_ARG(a), BINLOG_MAP2(__VA_ARGS__)
+#define BINLOG_MAP4(a, ...)     BINLOG_ARG(a), BINLOG_MAP3(__VA_ARGS__)
+#define BINLOG_MAP5(a, ...)     BINLOG_ARG(a), BINLOG_MAP4(__VA_ARGS__)
+#define BINLOG_MAP6(a, ...)     BINLOG_ARG(a), BINLOG_MAP5(__VA_ARGS__)
+#define BINLOG_MAP7(a, ...)     BINLOG_ARG(a), BINLOG_MAP6(__VA_ARGS__)
+#define BINLOG_MAP8(a, ...)     BINLOG_ARG(a), BINLOG_MAP7(__VA_ARGS__)
+
+/**
+ * @brief Records one log line. fmt must be a string literal; at most BINLOG_MAX_ARGS arguments.
+ */
+#define BINLOG(fmt, ...) do {                                                                  \
+    static const char binlog_fmt_[] __attribute__((section(".rodata.binlog"))) = fmt;        \
+    const uint64_t binlog_args_[] = {                                                         \
+      0U, BINLOG_CAT(BINLOG_MAP, BINLOG_NARGS(__VA_ARGS__))(__VA_ARGS__) };                   \
+    binlog_record(binlog_fmt_, BINLOG_NARGS(__VA_ARGS__), &binlog_args_[1]);                  \
+  } while (0)
+
+extern binlog_ring_t binlog_rings[BINLOG_MAX_HARTS];
+
+/**
+ * @brief Appends a record to the calling hart's ring. Use BINLOG instead of calling this directly.
+ */
+static inline void binlog_record(const char *fmt, uint32_t nargs, const uint64_t *args) {
+  const uint64_t hart = BINLOG_HART_ID();
+  binlog_ring_t *ring;
+  uint64_t head;
+
+  if (hart >= BINLOG_MAX_HARTS) {
+    return;
+  }
+  ring = &binlog_rings[hart];
+  head = ring->head;
+  if (head + 2U + nargs - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > BINLOG_RING_WORDS) {
+    ring->dropped += 1;
+    return;
+  }
+
+  ring->words[head & (BINLOG_RING_WORDS - 1U)] = ((uint64_t)nargs << 56) | (uint64_t)(uintptr_t)fmt;
+  ring->words[(head + 1U) & (BINLOG_RING_WORDS - 1U)] = BINLOG_TIMESTAMP();
+  for (uint32_t i = 0; i < nargs; i += 1) {
+    ring->words[(head + 2U + i) & (BINLOG_RING_WORDS - 1U)] = args[i];
+  }
+  __atomic_store_n(&ring->head, head + 2U + nargs, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Writes every pending record of every hart to the console. Only one hart may drain at a time;
+ *        the others keep logging meanwhile.
+ * @return size_t number of records written
+ */
+size_t binlog_drain(void);
+
+/**
+ * @brief Discards pending records and clears the drop counters.
+ */
+void binlog_reset(void);
+
+/**
+ * @brief Records dropped by hart's ring since the last reset.
+ */
+uint32_t binlog_dropped(uint32_t hart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BINLOG_H */
@@ -0,0 +1,208 @@
+/*
+ * binlog_test.c - Host-side encode/decode round trip of lib/binlog.
+ *
+ * Every CHECK() records its arguments with BINLOG and writes the line the decoder should produce,
+ * formatted by the host printf, to the expected file. stdout is the "console": binlog_drain() output
+ * interleaved with ordinary printf lines the decoder has to skip. The Makefile decodes the console
+ * with scripts/trace/decode_binlog.py --sort and diffs it against the expected file, which covers
+ * the conversions the header promises (integers of every width, characters, pointers, float and
+ * double, %s of ELF strings), records from several harts, records that straddle the end of the ring
+ * across drains, and records that must not reach the console (full ring, unknown hart, reset).
+ *
+ * Usage: binlog_test <expected.txt> > console.txt
+ */
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+static uint32_t g_test_hart;
+static uint64_t g_test_clock;
+
+#define BINLOG_HART_ID()        ((uint64_t)g_test_hart)
+#define BINLOG_TIMESTAMP()      (++g_test_clock)
+
+#include "binlog.h"
+
+static FILE *g_expected;
+static uint32_t g_errors;
+
+#define FAIL(...)                               \
+    do {                                        \
+        g_errors++;                             \
+        fprintf(stderr, "[FAIL] " __VA_ARGS__); \
+    } while (0)
+
+static void expect(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void expect(const char *fmt, ...) {
+    va_list ap;
+
+    va_start(ap, fmt);
+    vfprintf(g_expected, fmt, ap);
+    va_end(ap);
+}
+
+/* One record, and the decoder's rendering of it: "[h<hart> <timestamp>] <text>". */
+#define CHECK(fmt, ...)                                                                \
+    do {                                                                               \
+        BINLOG(fmt, ##__VA_ARGS__);                                                    \
+        expect("[h%u %14llu] " fmt, g_test_hart, (unsigned long long)g_test_clock,     \
+               ##__VA_ARGS__);                                                         \
+    } while (0)
+
+static void drain(size_t want, const char *what) {
+    size_t got;
+
+    fflush(stdout);     /* binlog_drain writes around stdio */
+    got = binlog_drain();
+    if (got != want) {
+        FAIL("%s: drained %zu records, want %zu\n", what, got, want);
+    }
+}
+
+static const char *const k_words[] = { "yes", "no", "stop", "go" };
+
+static void check_conversions(void) {
+    static const char local_text[] = "static array";
+    const double pi = 3.14159265358979;
+    const float third = 1.0f / 3.0f;
+    const int neg = -42;
+
+    CHECK("no arguments\n");
+    CHECK("int %d, negative %d, unsigned of negative %u\n", 7, neg, neg);
+    CHECK("hex %x %X %#x, octal %o\n", 0xbeefu, 0xbeefu, 255u, 8u);
+    CHECK("long %ld %lu, long long %lld %llx, size %zu\n",
+          -1234567890123L, 1234567890123UL, -9LL, 0x0123456789abcdefULL, sizeof(binlog_ring_t));
+    CHECK("width [%5d] [%-5d] [%05d] [%+d] [% d]\n", 42, 42, 42, 42, 42);
+    CHECK("star width [%*d] precision [%.*f]\n", 6, 17, 2, pi);
+    drain(6, "integer conversions");     /* the 64-word ring doesn't hold them all */
+
+    CHECK("double %f %.2f %e %g %G\n", pi, pi, pi * 1e6, 1e-5, 2.5e20);
+    CHECK("float %f %.3e, negative zero %f, big %g\n", third, third, -0.0, 1e300);
+    CHECK("char %c [%3c]\n", 'A', 'z');
+    CHECK("string %s [%-8s] [%.3s] %s\n", "literal", k_words[1], k_words[2], local_text);
+    CHECK("pointer %p percent %% done\n", (void *)&g_test_clock);
+    CHECK("eight %d %d %d %d %d %d %d %d\n", 1, 2, 3, 4, 5, 6, 7, 8);
+    CHECK("no newline, the decoder adds it");
+    expect("\n");
+    drain(7, "conversions");
+}
+
+/* Harts log into their own rings; --sort merges them back into timestamp order. */
+static void check_harts(void) {
+    size_t records = 0;
+
+    for (uint32_t i = 0; i < 12; i++) {
+        g_test_hart = (i * 3U) % BINLOG_MAX_HARTS;
+        CHECK("hart %u step %u word %s\n", g_test_hart, i, k_words[i % 4]);
+        records++;
+    }
+    printf("ordinary console output between records\n");
+    g_test_hart = 0;
+    drain(records, "harts");
+}
+
+/*
+ * Records of 2 to 10 words through a 64-word ring, drained every few records, so the head wraps
+ * many times and records straddle the end of the ring.
+ */
+static void check_wrap(void) {
+    size_t pending = 0;
+
+    for (uint32_t i = 0; i < 60; i++) {
+        switch (i % 4) {
+        case 0: CHECK("wrap %u\n", i); break;
+        case 1: CHECK("wrap %u %d %f\n", i, -(int)i, (double)i / 8.0); break;
+        case 2: CHECK("wrap\n"); break;
+        default: CHECK("wrap %u %u %u %u %u %u %u %s\n", i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6,
+                       k_words[i % 4]); break;
+        }
+        pending++;
+        if (i % 5 == 4) {
+            printf("drain after record %u\n", i);
+            drain(pending, "wrap");
+            pending = 0;
+        }
+    }
+}
+
+static void check_full_ring(void) {
+    const uint64_t clock = g_test_clock;
+
+    /* 32 two-word records fill the 64-word ring exactly; the next one is dropped. */
+    for (uint32_t i = 0; i < BINLOG_RING_WORDS / 2U; i++) {
+        CHECK("fill\n");
+    }
+    BINLOG("dropped, ring full\n");
+    BINLOG("dropped too %d\n", 1);
+    if (binlog_dropped(0) != 2) {
+        FAIL("full ring: dropped=%u, want 2\n", binlog_dropped(0));
+    }
+    if (g_test_clock != clock + BINLOG_RING_WORDS / 2U) {
+        FAIL("full ring: dropped records read the timestamp\n");
+    }
+    drain(BINLOG_RING_WORDS / 2U, "full ring");
+
+    /* Draining makes room again; the drop counter stays until binlog_reset(). */
+    CHECK("after drain %u\n", 1u);
+    drain(1, "after full ring");
+    if (binlog_dropped(0) != 2) {
+        FAIL("after drain: dropped=%u, want 2\n", binlog_dropped(0));
+    }
+}
+
+static void check_unknown_hart(void) {
+    const uint64_t clock = g_test_clock;
+
+    g_test_hart = BINLOG_MAX_HARTS + 3U;
+    BINLOG("hart out of range %d\n", 1);
+    if (g_test_clock != clock || binlog_dropped(g_test_hart) != 0) {
+        FAIL("unknown hart: record was not ignored\n");
+    }
+    g_test_hart = 0;
+    drain(0, "unknown hart");
+}
+
+static void check_reset(void) {
+    for (uint32_t hart = 0; hart < BINLOG_MAX_HARTS; hart++) {
+        g_test_hart = hart;
+        BINLOG("discarded by reset %u\n", hart);
+    }
+    g_test_hart = 0;
+    binlog_reset();
+    if (binlog_dropped(0) != 0) {
+        FAIL("reset: dropped=%u, want 0\n", binlog_dropped(0));
+    }
+    drain(0, "reset");
+
+    CHECK("after reset\n");
+    drain(1, "after reset");
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <expected.txt>\n", argv[0]);
+        return 2;
+    }
+    g_expected = fopen(argv[1], "w");
+    if (g_expected == NULL) {
+        perror(argv[1]);
+        return 2;
+    }
+
+    printf("binlog host test: console starts here\n");
+    check_conversions();
+    check_harts();
+    check_wrap();
+    check_full_ring();
+    check_unknown_hart();
+    check_reset();
+    printf("binlog host test: console ends here\n");
+
+    fclose(g_expected);
+    if (g_errors) {
+        fprintf(stderr, "[FAIL] binlog: %u errors\n", g_errors);
+        return 1;
+    }
+    return 0;
+}
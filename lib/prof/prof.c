@@ -0,0 +1,239 @@
+#include "prof.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+  uint64_t calls;
+  uint64_t cycles;                      /** inclusive */
+  uint64_t self_cycles;                 /** minus cycles spent in nested regions */
+  uint64_t instret;
+  uint64_t events[PROF_MAX_EVENTS];
+} prof_totals_t;
+
+typedef struct {
+  prof_region_t region;
+  uint64_t child_cycles;
+  uint64_t instret;
+  uint64_t events[PROF_MAX_EVENTS];
+  uint64_t cycles;
+} prof_frame_t;
+
+typedef struct {
+  uint32_t depth;
+  uint32_t skipped;                     /** open regions not recorded (too deep or no id) */
+  prof_frame_t stack[PROF_MAX_DEPTH];
+  prof_totals_t totals[PROF_MAX_REGIONS];
+} __attribute__((aligned(64))) prof_hart_t;
+
+static prof_hart_t prof_harts[PROF_MAX_HARTS];
+
+static const char *prof_names[PROF_MAX_REGIONS];
+static uint32_t prof_region_count;
+static uint32_t prof_lock;
+
+static prof_event_t prof_events[PROF_MAX_EVENTS];
+static uint32_t prof_event_count;
+
+static inline prof_hart_t *prof_this_hart(void) {
+  uint64_t hartid = READ_CSR("mhartid");
+  return (hartid < PROF_MAX_HARTS) ? &prof_harts[hartid] : NULL;
+}
+
+/* The CSR number is part of the instruction, hence one case per counter. */
+static inline void prof_read_events(uint64_t *out) {
+  switch (prof_event_count) {
+    case 4: out[3] = PMU_COUNTER_READ(6);  /* fall through */
+    case 3: out[2] = PMU_COUNTER_READ(5);  /* fall through */
+    case 2: out[1] = PMU_COUNTER_READ(4);  /* fall through */
+    case 1: out[0] = PMU_COUNTER_READ(3);  /* fall through */
+    default: break;
+  }
+}
+
+static void prof_program(uint32_t counter, uint64_t event) {
+  switch (counter) {
+    case 3: PMU_EVENT_ENABLE(event, 3); PMU_INHIBIT_DISABLE(3); PMU_COUNTER_RESET(3); break;
+    case 4: PMU_EVENT_ENABLE(event, 4); PMU_INHIBIT_DISABLE(4); PMU_COUNTER_RESET(4); break;
+    case 5: PMU_EVENT_ENABLE(event, 5); PMU_INHIBIT_DISABLE(5); PMU_COUNTER_RESET(5); break;
+    case 6: PMU_EVENT_ENABLE(event, 6); PMU_INHIBIT_DISABLE(6); PMU_COUNTER_RESET(6); break;
+    default: break;
+  }
+}
+
+void prof_hart_init(void) {
+  for (uint32_t i = 0; i < prof_event_count; i += 1) {
+    prof_program(PROF_FIRST_COUNTER + i, prof_events[i].event);
+  }
+}
+
+void prof_init(const prof_event_t *events, uint32_t count) {
+  if (events == NULL) {
+    count = 0U;
+  } else if (count > PROF_MAX_EVENTS) {
+    count = PROF_MAX_EVENTS;
+  }
+  for (uint32_t i = 0; i < count; i += 1) {
+    prof_events[i] = events[i];
+  }
+  prof_event_count = count;
+  prof_hart_init();
+  prof_reset();
+}
+
+prof_region_t prof_region(const char *name) {
+  prof_region_t id;
+
+  while (__atomic_exchange_n(&prof_lock, 1U, __ATOMIC_ACQUIRE)) {
+    while (__atomic_load_n(&prof_lock, __ATOMIC_RELAXED));
+  }
+  for (id = 0; id < prof_region_count; id += 1) {
+    if (prof_names[id] == name || strcmp(prof_names[id], name) == 0) {
+      break;
+    }
+  }
+  if (id == prof_region_count) {
+    if (prof_region_count < PROF_MAX_REGIONS) {
+      prof_names[id] = name;
+      __atomic_store_n(&prof_region_count, id + 1U, __ATOMIC_RELEASE);
+    } else {
+      id = PROF_REGION_NONE;
+    }
+  }
+  __atomic_store_n(&prof_lock, 0U, __ATOMIC_RELEASE);
+  return id;
+}
+
+void prof_begin(prof_region_t region) {
+  prof_hart_t *hart = prof_this_hart();
+  prof_frame_t *frame;
+
+  if (hart == NULL) {
+    return;
+  }
+  if (region >= PROF_MAX_REGIONS || hart->depth >= PROF_MAX_DEPTH || hart->skipped != 0U) {
+    hart->skipped += 1U;
+    return;
+  }
+
+  frame = &hart->stack[hart->depth];
+  hart->depth += 1U;
+  frame->region = region;
+  frame->child_cycles = 0U;
+  frame->instret = READ_CSR("minstret");
+  prof_read_events(frame->events);
+  frame->cycles = prof_cycles();
+}
+
+void prof_end(void) {
+  const uint64_t cycles = prof_cycles();
+  prof_hart_t *hart = prof_this_hart();
+  uint64_t events[PROF_MAX_EVENTS];
+  uint64_t instret;
+  prof_frame_t *frame;
+  prof_totals_t *totals;
+  uint64_t elapsed;
+
+  prof_read_events(events);
+  instret = READ_CSR("minstret");
+  if (hart == NULL) {
+    return;
+  }
+  if (hart->skipped != 0U) {
+    hart->skipped -= 1U;
+    return;
+  }
+  if (hart->depth == 0U) {
+    return;
+  }
+
+  hart->depth -= 1U;
+  frame = &hart->stack[hart->depth];
+  totals = &hart->totals[frame->region];
+  elapsed = cycles - frame->cycles;
+
+  totals->calls += 1U;
+  totals->cycles += elapsed;
+  totals->self_cycles += elapsed - frame->child_cycles;
+  totals->instret += instret - frame->instret;
+  for (uint32_t i = 0; i < prof_event_count; i += 1) {
+    totals->events[i] += events[i] - frame->events[i];
+  }
+  if (hart->depth > 0U) {
+    hart->stack[hart->depth - 1U].child_cycles += elapsed;
+  }
+}
+
+void prof_reset(void) {
+  for (uint32_t h = 0; h < PROF_MAX_HARTS; h += 1) {
+    memset(prof_harts[h].totals, 0, sizeof(prof_harts[h].totals));
+  }
+}
+
+void prof_report_csv(void) {
+  const uint32_t regions = __atomic_load_n(&prof_region_count, __ATOMIC_ACQUIRE);
+
+  printf("hart,region,calls,cycles,self_cycles,instret");
+  for (uint32_t i = 0; i < prof_event_count; i += 1) {
+    printf(",%s", prof_events[i].name);
+  }
+  printf("\n");
+
+  for (uint32_t h = 0; h < PROF_MAX_HARTS; h += 1) {
+    for (uint32_t r = 0; r < regions; r += 1) {
+      const prof_totals_t *t = &prof_harts[h].totals[r];
+      if (t->calls == 0U) {
+        continue;
+      }
+      printf("%lu,%s,%llu,%llu,%llu,%llu", (unsigned long)h, prof_names[r], (unsigned long long)t->calls,
+             (unsigned long long)t->cycles, (unsigned long long)t->self_cycles,
+             (unsigned long long)t->instret);
+      for (uint32_t i = 0; i < prof_event_count; i += 1) {
+        printf(",%llu", (unsigned long long)t->events[i]);
+      }
+      printf("\n");
+    }
+  }
+}
+
+void prof_report_json(void) {
+  const uint32_t regions = __atomic_load_n(&prof_region_count, __ATOMIC_ACQUIRE);
+  const char *hart_sep = "";
+
+  printf("{\"events\":[");
+  for (uint32_t i = 0; i < prof_event_count; i += 1) {
+    printf("%s\"%s\"", (i > 0U) ? "," : "", prof_events[i].name);
+  }
+  printf("],\"harts\":[");
+
+  for (uint32_t h = 0; h < PROF_MAX_HARTS; h += 1) {
+    const char *region_sep = "";
+    int any = 0;
+
+    for (uint32_t r = 0; r < regions; r += 1) {
+      any |= (prof_harts[h].totals[r].calls != 0U);
+    }
+    if (!any) {
+      continue;
+    }
+
+    printf("%s{\"hart\":%lu,\"regions\":[", hart_sep, (unsigned long)h);
+    hart_sep = ",";
+    for (uint32_t r = 0; r < regions; r += 1) {
+      const prof_totals_t *t = &prof_harts[h].totals[r];
+      if (t->calls == 0U) {
+        continue;
+      }
+      printf("%s{\"region\":\"%s\",\"calls\":%llu,\"cycles\":%llu,\"self_cycles\":%llu,\"instret\":%llu",
+             region_sep, prof_names[r], (unsigned long long)t->calls, (unsigned long long)t->cycles,
+             (unsigned long long)t->self_cycles, (unsigned long long)t->instret);
+      for (uint32_t i = 0; i < prof_event_count; i += 1) {
+        printf(",\"%s\":%llu", prof_events[i].name, (unsigned long long)t->events[i]);
+      }
+      printf("}");
+      region_sep = ",";
+    }
+    printf("]}");
+  }
+  printf("]}\n");
+}
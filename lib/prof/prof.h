@@ -0,0 +1,160 @@
+/**
+ * @file prof.h
+ * @brief Named, nestable cycle/PMU profiling regions with per-hart totals.
+ *
+ * One measurement method for every benchmark: each region records calls, mcycle (inclusive and
+ * self, i.e. minus nested regions), minstret and up to PROF_MAX_EVENTS hardware events counted in
+ * mhpmcounter3.. (event encodings from pmu.h). Totals are kept per hart without locks; each hart
+ * only touches its own slot. Reports are printed over the console as CSV or JSON.
+ *
+ *   static const prof_event_t events[] = { PROF_EVENTS_MISSES };
+ *   prof_init(events, PROF_COUNT(events));    // on the boot hart; other harts call prof_hart_init()
+ *
+ *   PROF_BEGIN("conv2");
+ *   ...
+ *   PROF_END();
+ *
+ *   void layer(void) {
+ *     PROF_SCOPE("layer");                     // closed when the enclosing block exits
+ *     ...
+ *   }
+ *
+ *   prof_report_csv();
+ *
+ * Region names must be string literals without commas or quotes. Regions close in LIFO order per
+ * hart. Build with -DPROF_DISABLE to compile the macros out.
+ */
+
+#ifndef __PROF_H
+#define __PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "riscv.h"
+#include "pmu.h"
+
+#ifndef PROF_MAX_HARTS
+#define PROF_MAX_HARTS          4U
+#endif
+
+#ifndef PROF_MAX_REGIONS
+#define PROF_MAX_REGIONS        32U
+#endif
+
+#define PROF_MAX_DEPTH          8U
+#define PROF_MAX_EVENTS         4U      /* mhpmcounter3 .. mhpmcounter6 */
+#define PROF_FIRST_COUNTER      3U
+
+#define PROF_REGION_NONE        0xFFFFFFFFU
+
+typedef uint32_t prof_region_t;
+
+typedef struct {
+  const char *name;
+  uint64_t event;         /** mhpmevent encoding, PMU_EVENT(SET, EVENT) */
+} prof_event_t;
+
+#define PROF_EVENT(SET, EVENT)  { #EVENT, PMU_EVENT(SET, EVENT) }
+#define PROF_COUNT(array)       ((uint32_t)(sizeof(array) / sizeof((array)[0])))
+
+/* Ready-made event sets, one mhpmcounter each. */
+#define PROF_EVENTS_MISSES      PROF_EVENT(2, ICACHE_MISS), PROF_EVENT(2, DCACHE_MISS),                 \
+                                PROF_EVENT(2, DTLB_MISS), PROF_EVENT(2, L2_TLB_MISS)
+#define PROF_EVENTS_STALLS      PROF_EVENT(1, LOAD_USE_INTERLOCK), PROF_EVENT(1, DCACHE_BLOCKED),       \
+                                PROF_EVENT(1, ICACHE_BLOCKED), PROF_EVENT(1, BRANCH_MISPREDICTION)
+#define PROF_EVENTS_MIX         PROF_EVENT(0, LOAD), PROF_EVENT(0, STORE), PROF_EVENT(0, BRANCH),       \
+                                PROF_EVENT(0, FP_MUL)
+
+/**
+ * @brief Cycle counter of the calling hart; the shared replacement for per-benchmark rdcycle helpers.
+ */
+static inline uint64_t prof_cycles(void) {
+  return READ_CSR("mcycle");
+}
+
+/**
+ * @brief Selects the events to count, programs them on the calling hart and clears all totals.
+ * @param events  event list, at most PROF_MAX_EVENTS entries are used; NULL/0 counts cycles only
+ * @param count   number of entries in events
+ */
+void prof_init(const prof_event_t *events, uint32_t count);
+
+/**
+ * @brief Programs the events chosen by prof_init on the calling hart (for secondary harts).
+ */
+void prof_hart_init(void);
+
+/**
+ * @brief Looks a region up by name, registering it on first use.
+ * @return prof_region_t region id, PROF_REGION_NONE once PROF_MAX_REGIONS are registered
+ */
+prof_region_t prof_region(const char *name);
+
+/**
+ * @brief Opens a region on the calling hart.
+ */
+void prof_begin(prof_region_t region);
+
+/**
+ * @brief Closes the innermost open region of the calling hart.
+ */
+void prof_end(void);
+
+/**
+ * @brief Clears the totals of every hart. Call while no region is open.
+ */
+void prof_reset(void);
+
+/**
+ * @brief Prints one line per (hart, region):
+ *        hart,region,calls,cycles,self_cycles,instret,<event>...
+ */
+void prof_report_csv(void);
+
+/**
+ * @brief Prints the totals as a single JSON object:
+ *        {"events":[...],"harts":[{"hart":0,"regions":[{"region":"...","calls":...},...]},...]}
+ */
+void prof_report_json(void);
+
+static inline void prof_scope_exit(int *unused) {
+  (void)unused;
+  prof_end();
+}
+
+#define PROF_CAT_(a, b)         a##b
+#define PROF_CAT(a, b)          PROF_CAT_(a, b)
+
+#ifndef PROF_DISABLE
+
+#define PROF_BEGIN(name) do {                                                                     \
+    static prof_region_t prof_region_id_ = PROF_REGION_NONE;                                      \
+    if (prof_region_id_ == PROF_REGION_NONE) {                                                    \
+      prof_region_id_ = prof_region(name);                                                        \
+    }                                                                                             \
+    prof_begin(prof_region_id_);                                                                  \
+  } while (0)
+
+#define PROF_END()              prof_end()
+
+#define PROF_SCOPE(name)                                                                          \
+  PROF_BEGIN(name);                                                                               \
+  int PROF_CAT(prof_scope_, __LINE__) __attribute__((cleanup(prof_scope_exit), unused)) = 0
+
+#else
+
+#define PROF_BEGIN(name)        do { } while (0)
+#define PROF_END()              do { } while (0)
+#define PROF_SCOPE(name)        do { } while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROF_H */
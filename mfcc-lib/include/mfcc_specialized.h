@@ -16,6 +16,14 @@ void mfcc_tinyspeech_1024_23_12_f32(const riscv_mfcc_instance_f32 *S,
                                    float32_t *pDst,
                                    float32_t *pTmp);
 
+/* Same pipeline for a frame that is already windowed (pSrc = x * window, used as scratch), without
+ * the absmax normalization: in f32 the |FFT| scale round trip only changes rounding. Used by the
+ * streaming context (mfcc_stream.h), which windows while copying out of its history. */
+void mfcc_tinyspeech_1024_23_12_windowed_f32(const riscv_mfcc_instance_f32 *S,
+                                            float32_t *pSrc,
+                                            float32_t *pDst,
+                                            float32_t *pTmp);
+
 #if defined(RISCV_FLOAT16_SUPPORTED)
 void mfcc_tinyspeech_1024_23_12_f16(const riscv_mfcc_instance_f16 *S,
                                    float16_t *pSrc,
@@ -0,0 +1,80 @@
+#ifndef MFCC_STREAM_H
+#define MFCC_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mfcc_driver.h"
+
+/* Streaming MFCC over a continuous signal.
+ *
+ * Samples are pushed in chunks of any size. Every `hop` samples the latest MFCC_DRIVER_FFT_LEN
+ * samples are analyzed (same window, mel filterbank and DCT as mfcc_driver_run_sp1024x23x12_f32, all
+ * built once by mfcc_driver_init) and the MFCC_DRIVER_NUM_DCT coefficients are written into the next
+ * column of a circular buffer of `num_frames` columns. mfcc_stream_features linearizes it into
+ * TinySpeech's input layout: coefficient-major, features[k * num_frames + f], oldest frame first,
+ * so it can be quantized or handed to the model without reshuffling. Each frame thus stores 12
+ * floats; the 12 x num_frames reorder is paid once per read, not once per frame.
+ *
+ * Per frame, compared with a run_sp1024x23x12 call on a copied window: no 1024-sample copy (the
+ * frame is read in place from the history), windowing only touches the non-zero span of the window,
+ * and the absmax normalize/rescale passes are skipped (see mfcc_tinyspeech_1024_23_12_windowed_f32).
+ */
+
+#define MFCC_STREAM_MAX_FRAMES 128U
+/* History holds one frame plus up to another frame's worth of new samples before compacting. */
+#define MFCC_STREAM_HISTORY_LEN (2U * MFCC_DRIVER_FFT_LEN)
+
+typedef struct {
+  const mfcc_driver_t *drv;
+  uint32_t hop;
+  uint32_t num_frames;
+  uint32_t win_start;  /* non-zero span of the analysis window */
+  uint32_t win_len;
+
+  uint32_t start;      /* history index of the next frame's first sample */
+  uint32_t fill;       /* history samples written */
+  uint32_t col;        /* ring column the next frame is written to (== oldest frame once full) */
+  bool linear;         /* features[] matches ring[] */
+  uint64_t frames;     /* frames emitted since reset */
+  uint64_t cycles;     /* cycles spent in frame analysis since reset */
+
+  float32_t history[MFCC_STREAM_HISTORY_LEN];
+  float32_t ring[MFCC_STREAM_MAX_FRAMES][MFCC_DRIVER_NUM_DCT];
+  float32_t features[MFCC_DRIVER_NUM_DCT * MFCC_STREAM_MAX_FRAMES];
+  float32_t frame[MFCC_DRIVER_FFT_LEN];
+  float32_t tmp[2U * MFCC_DRIVER_FFT_LEN];
+} mfcc_stream_t;
+
+/* Binds an initialized driver (tables only; the stream never writes to it) and resets the stream.
+ * hop: 1..MFCC_DRIVER_FFT_LEN samples. num_frames: 1..MFCC_STREAM_MAX_FRAMES matrix columns. */
+mfcc_driver_status_t mfcc_stream_init(mfcc_stream_t *s,
+                                      const mfcc_driver_t *drv,
+                                      uint32_t hop,
+                                      uint32_t num_frames);
+
+/* Drops the history and clears the feature matrix. */
+void mfcc_stream_reset(mfcc_stream_t *s);
+
+/* Appends `count` samples; returns how many frames were emitted into the matrix. */
+uint32_t mfcc_stream_push(mfcc_stream_t *s, const float32_t *samples, size_t count);
+
+/* True once the matrix holds num_frames real frames (no leading zero columns). */
+static inline bool mfcc_stream_full(const mfcc_stream_t *s) {
+  return s->frames >= (uint64_t)s->num_frames;
+}
+
+/* Rolling feature matrix, MFCC_DRIVER_NUM_DCT rows of num_frames columns. Linearizes the ring if
+ * frames were pushed since the last call; the pointer stays valid until the next push or reset. */
+const float32_t *mfcc_stream_features(mfcc_stream_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -37,6 +37,41 @@ __STATIC_FORCEINLINE void mfcc_tinyspeech_apply_dct_f32(const riscv_mfcc_instanc
   riscv_mat_vec_mult_f32(&pDctMat, mel, out);
 }
 
+/* Windowed frame in pSrc (used as scratch) -> magnitude spectrum in pSrc[0..fftLen/2]. */
+__STATIC_FORCEINLINE void mfcc_tinyspeech_magnitude_f32(const riscv_mfcc_instance_f32 *S,
+                                                         float32_t *pSrc,
+                                                         float32_t *pTmp)
+{
+#if defined(RISCV_MFCC_CFFT_BASED)
+  for (uint32_t i = 0; i < S->fftLen; i++) {
+    pTmp[2U * i] = pSrc[i];
+    pTmp[(2U * i) + 1U] = 0.0f;
+  }
+  riscv_cfft_f32(&(S->cfft), pTmp, 0, 1);
+#else
+  riscv_rfft_fast_f32(&(S->rfft), pSrc, pTmp, 0);
+  pTmp[S->fftLen] = pTmp[1];
+  pTmp[S->fftLen + 1U] = 0.0f;
+  pTmp[1] = 0.0f;
+#endif
+
+  riscv_cmplx_mag_f32(pTmp, pSrc, S->fftLen);
+}
+
+/* Magnitude spectrum -> log-mel -> DCT. */
+__STATIC_FORCEINLINE void mfcc_tinyspeech_cepstrum_f32(const riscv_mfcc_instance_f32 *S,
+                                                        const float32_t *spectrum,
+                                                        float32_t *pDst,
+                                                        float32_t *pTmp)
+{
+  mfcc_tinyspeech_apply_mel_f32(S, spectrum, pTmp);
+
+  riscv_offset_f32(pTmp, 1.0e-6f, pTmp, MFCC_TINYSPEECH_NUM_MEL);
+  riscv_vlog_f32(pTmp, pTmp, MFCC_TINYSPEECH_NUM_MEL);
+
+  mfcc_tinyspeech_apply_dct_f32(S, pTmp, pDst);
+}
+
 void mfcc_tinyspeech_1024_23_12_f32(const riscv_mfcc_instance_f32 *S,
                                    float32_t *pSrc,
                                    float32_t *pDst,
@@ -62,29 +97,20 @@ void mfcc_tinyspeech_1024_23_12_f32(const riscv_mfcc_instance_f32 *S,
 
   riscv_mult_f32(pSrc, S->windowCoefs, pSrc, S->fftLen);
 
-#if defined(RISCV_MFCC_CFFT_BASED)
-  for (uint32_t i = 0; i < S->fftLen; i++) {
-    pTmp[2U * i] = pSrc[i];
-    pTmp[(2U * i) + 1U] = 0.0f;
-  }
-  riscv_cfft_f32(&(S->cfft), pTmp, 0, 1);
-#else
-  riscv_rfft_fast_f32(&(S->rfft), pSrc, pTmp, 0);
-  pTmp[S->fftLen] = pTmp[1];
-  pTmp[S->fftLen + 1U] = 0.0f;
-  pTmp[1] = 0.0f;
-#endif
-
-  riscv_cmplx_mag_f32(pTmp, pSrc, S->fftLen);
+  mfcc_tinyspeech_magnitude_f32(S, pSrc, pTmp);
 
   if (maxValue != 0.0f) {
     riscv_scale_f32(pSrc, maxValue, pSrc, S->fftLen);
   }
 
-  mfcc_tinyspeech_apply_mel_f32(S, pSrc, pTmp);
-
-  riscv_offset_f32(pTmp, 1.0e-6f, pTmp, MFCC_TINYSPEECH_NUM_MEL);
-  riscv_vlog_f32(pTmp, pTmp, MFCC_TINYSPEECH_NUM_MEL);
+  mfcc_tinyspeech_cepstrum_f32(S, pSrc, pDst, pTmp);
+}
 
-  mfcc_tinyspeech_apply_dct_f32(S, pTmp, pDst);
+void mfcc_tinyspeech_1024_23_12_windowed_f32(const riscv_mfcc_instance_f32 *S,
+                                            float32_t *pSrc,
+                                            float32_t *pDst,
+                                            float32_t *pTmp)
+{
+  mfcc_tinyspeech_magnitude_f32(S, pSrc, pTmp);
+  mfcc_tinyspeech_cepstrum_f32(S, pSrc, pDst, pTmp);
 }
@@ -0,0 +1,134 @@
+#include "mfcc_stream.h"
+
+#include <string.h>
+
+#include "dsp/basic_math_functions.h"
+
+static inline uint64_t mfcc_stream_rdcycle64(void) {
+#if defined(__riscv)
+  uint64_t x;
+  asm volatile("rdcycle %0" : "=r"(x));
+  return x;
+#else
+  return 0U; /* host test build */
+#endif
+}
+
+static void mfcc_stream_analyze(mfcc_stream_t *s, const float32_t *x) {
+  const riscv_mfcc_instance_f32 *S = &s->drv->mfcc_f32;
+  const uint32_t win_end = s->win_start + s->win_len;
+  uint64_t t0 = mfcc_stream_rdcycle64();
+
+  /* The RFFT uses its input as scratch, so the zero padding around the window is rewritten. */
+  memset(s->frame, 0, s->win_start * sizeof(float32_t));
+  riscv_mult_f32(x + s->win_start, S->windowCoefs + s->win_start, s->frame + s->win_start, s->win_len);
+  memset(s->frame + win_end, 0, (MFCC_DRIVER_FFT_LEN - win_end) * sizeof(float32_t));
+
+  /* The new frame overwrites the oldest column; mfcc_stream_features restores the order. */
+  mfcc_tinyspeech_1024_23_12_windowed_f32(S, s->frame, s->ring[s->col], s->tmp);
+  if (++s->col == s->num_frames) {
+    s->col = 0U;
+  }
+  s->linear = false;
+
+  s->frames++;
+  s->cycles += mfcc_stream_rdcycle64() - t0;
+}
+
+mfcc_driver_status_t mfcc_stream_init(mfcc_stream_t *s,
+                                      const mfcc_driver_t *drv,
+                                      uint32_t hop,
+                                      uint32_t num_frames) {
+  uint32_t first = MFCC_DRIVER_FFT_LEN;
+  uint32_t last = 0U;
+
+  if ((s == NULL) || (drv == NULL) || (drv->initialized == 0U)) {
+    return MFCC_DRIVER_ERR_BAD_ARG;
+  }
+  if ((hop == 0U) || (hop > MFCC_DRIVER_FFT_LEN) ||
+      (num_frames == 0U) || (num_frames > MFCC_STREAM_MAX_FRAMES)) {
+    return MFCC_DRIVER_ERR_BAD_ARG;
+  }
+
+  for (uint32_t n = 0; n < MFCC_DRIVER_FFT_LEN; n++) {
+    if (drv->window_f32[n] != 0.0f) {
+      if (first == MFCC_DRIVER_FFT_LEN) {
+        first = n;
+      }
+      last = n;
+    }
+  }
+  if (first == MFCC_DRIVER_FFT_LEN) {
+    return MFCC_DRIVER_ERR_INIT;
+  }
+
+  s->drv = drv;
+  s->hop = hop;
+  s->num_frames = num_frames;
+  s->win_start = first;
+  s->win_len = (last - first) + 1U;
+  mfcc_stream_reset(s);
+  return MFCC_DRIVER_OK;
+}
+
+void mfcc_stream_reset(mfcc_stream_t *s) {
+  s->start = 0U;
+  s->fill = 0U;
+  s->col = 0U;
+  s->linear = true;
+  s->frames = 0U;
+  s->cycles = 0U;
+  memset(s->ring, 0, sizeof(s->ring));
+  memset(s->features, 0, sizeof(s->features));
+}
+
+const float32_t *mfcc_stream_features(mfcc_stream_t *s) {
+  const uint32_t cols = s->num_frames;
+
+  if (!s->linear) {
+    /* Column `col` is the oldest: zero-filled before the ring wraps, which keeps the leading
+     * zero columns of a partly filled matrix. */
+    for (uint32_t f = 0, c = s->col; f < cols; f++) {
+      for (uint32_t k = 0; k < MFCC_DRIVER_NUM_DCT; k++) {
+        s->features[k * cols + f] = s->ring[c][k];
+      }
+      if (++c == cols) {
+        c = 0U;
+      }
+    }
+    s->linear = true;
+  }
+  return s->features;
+}
+
+uint32_t mfcc_stream_push(mfcc_stream_t *s, const float32_t *samples, size_t count) {
+  uint32_t emitted = 0U;
+
+  while (count > 0U) {
+    uint32_t n;
+
+    if (s->fill == MFCC_STREAM_HISTORY_LEN) {
+      /* Fewer than FFT_LEN samples are still needed; move them to the front. */
+      memmove(s->history, s->history + s->start, (s->fill - s->start) * sizeof(float32_t));
+      s->fill -= s->start;
+      s->start = 0U;
+    }
+
+    n = MFCC_STREAM_HISTORY_LEN - s->fill;
+    if ((size_t)n > count) {
+      n = (uint32_t)count;
+    }
+    memcpy(s->history + s->fill, samples, n * sizeof(float32_t));
+    s->fill += n;
+    samples += n;
+    count -= n;
+
+    while ((s->fill - s->start) >= MFCC_DRIVER_FFT_LEN) {
+      mfcc_stream_analyze(s, s->history + s->start);
+      s->start += s->hop;
+      emitted++;
+    }
+  }
+
+  return emitted;
+}
@@ -0,0 +1,186 @@
+/*
+ * mfcc_stream_test.c - Host-side check that mfcc_stream matches per-frame analysis.
+ *
+ * Pushes a synthetic signal through mfcc_stream in random-sized chunks and, after
+ * every push, compares the linearized feature matrix with a reference built one
+ * frame at a time: frame j is signal[j * hop, + FFT_LEN), windowed and analyzed
+ * on its own, and the matrix holds the last num_frames of them, oldest first,
+ * behind zero columns until it fills.
+ *
+ * The FFT/mel/DCT kernel and riscv_mult_f32 are replaced by small deterministic
+ * stand-ins (the NMSIS tables do not build on the host). The stand-in kernel
+ * depends on every sample and its position and scribbles over its scratch, as
+ * the real one does, so this checks the stream's history, windowing span, ring
+ * and linearization; the MFCC math itself is covered on target by mfcc_driver.
+ *
+ * Usage: mfcc_stream_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mfcc_stream.h"
+
+#define SIGNAL_LEN 24000U
+
+static uint32_t g_errors;
+
+#define FAIL(...)                       \
+    do {                                \
+        g_errors++;                     \
+        printf("[FAIL] " __VA_ARGS__);  \
+    } while (0)
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---- Stand-ins for the NMSIS pieces mfcc_stream.c calls ------------------- */
+
+void riscv_mult_f32(const float32_t* pSrcA, const float32_t* pSrcB, float32_t* pDst,
+                    uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = pSrcA[i] * pSrcB[i];
+    }
+}
+
+void mfcc_tinyspeech_1024_23_12_windowed_f32(const riscv_mfcc_instance_f32* S, float32_t* pSrc,
+                                             float32_t* pDst, float32_t* pTmp) {
+    (void) S;
+    for (uint32_t k = 0; k < MFCC_DRIVER_NUM_DCT; k++) {
+        float32_t acc = 0.0f;
+        for (uint32_t n = 0; n < MFCC_DRIVER_FFT_LEN; n++) {
+            acc += pSrc[n] * (float32_t) ((int32_t) ((n * (2U * k + 3U)) % 29U) - 14);
+        }
+        pDst[k] = acc;
+    }
+    /* The real kernel runs the RFFT in place and uses pTmp as scratch. */
+    for (uint32_t n = 0; n < MFCC_DRIVER_FFT_LEN; n++) {
+        pSrc[n] = 1e30f;
+    }
+    for (uint32_t n = 0; n < 2U * MFCC_DRIVER_FFT_LEN; n++) {
+        pTmp[n] = -1e30f;
+    }
+}
+
+/* ---- Reference -------------------------------------------------------------- */
+
+static mfcc_driver_t g_drv;
+static mfcc_stream_t g_stream;
+static float32_t g_signal[SIGNAL_LEN];
+static float32_t g_ref_frames[SIGNAL_LEN][MFCC_DRIVER_NUM_DCT];
+
+static void reference_frame(const float32_t* x, float32_t* out) {
+    float32_t frame[MFCC_DRIVER_FFT_LEN];
+    float32_t tmp[2U * MFCC_DRIVER_FFT_LEN];
+
+    for (uint32_t n = 0; n < MFCC_DRIVER_FFT_LEN; n++) {
+        frame[n] = x[n] * g_drv.window_f32[n];
+    }
+    mfcc_tinyspeech_1024_23_12_windowed_f32(&g_drv.mfcc_f32, frame, out, tmp);
+}
+
+/* Compare the stream matrix with the last num_frames of `frames` reference frames. */
+static void check_matrix(uint32_t hop, uint32_t cols, uint32_t frames, size_t pushed) {
+    const float32_t* got = mfcc_stream_features(&g_stream);
+
+    for (uint32_t f = 0; f < cols; f++) {
+        /* Column f holds frame frames - cols + f, or zeros before the matrix fills. */
+        int64_t j = (int64_t) frames - (int64_t) cols + (int64_t) f;
+        for (uint32_t k = 0; k < MFCC_DRIVER_NUM_DCT; k++) {
+            float32_t want = (j < 0) ? 0.0f : g_ref_frames[j][k];
+            float32_t have = got[k * cols + f];
+            if (have != want) {
+                FAIL("hop=%u cols=%u after %zu samples: coef %u col %u = %g, want %g\n",
+                     (unsigned) hop, (unsigned) cols, pushed, (unsigned) k, (unsigned) f,
+                     (double) have, (double) want);
+                return;
+            }
+        }
+    }
+}
+
+static void run_case(uint32_t hop, uint32_t cols) {
+    uint32_t frames = 0;
+    size_t pushed = 0;
+
+    if (mfcc_stream_init(&g_stream, &g_drv, hop, cols) != MFCC_DRIVER_OK) {
+        FAIL("hop=%u cols=%u: init failed\n", (unsigned) hop, (unsigned) cols);
+        return;
+    }
+    for (uint32_t j = 0; (size_t) j * hop + MFCC_DRIVER_FFT_LEN <= SIGNAL_LEN; j++) {
+        reference_frame(&g_signal[(size_t) j * hop], g_ref_frames[j]);
+    }
+
+    while (pushed < SIGNAL_LEN) {
+        size_t n = 1U + rng() % 3000U;
+        if (n > SIGNAL_LEN - pushed) {
+            n = SIGNAL_LEN - pushed;
+        }
+        frames += mfcc_stream_push(&g_stream, &g_signal[pushed], n);
+        pushed += n;
+
+        uint32_t want = (pushed < MFCC_DRIVER_FFT_LEN)
+                            ? 0U
+                            : (uint32_t) ((pushed - MFCC_DRIVER_FFT_LEN) / hop) + 1U;
+        if (frames != want) {
+            FAIL("hop=%u cols=%u after %zu samples: %u frames, want %u\n", (unsigned) hop,
+                 (unsigned) cols, pushed, (unsigned) frames, (unsigned) want);
+            return;
+        }
+        if (mfcc_stream_full(&g_stream) != (frames >= cols)) {
+            FAIL("hop=%u cols=%u: mfcc_stream_full wrong at %u frames\n", (unsigned) hop,
+                 (unsigned) cols, (unsigned) frames);
+        }
+        check_matrix(hop, cols, frames, pushed);
+        if ((rng() & 3U) == 0U) {
+            check_matrix(hop, cols, frames, pushed); /* a second read must not re-rotate */
+        }
+    }
+
+    mfcc_stream_reset(&g_stream);
+    check_matrix(hop, cols, 0U, 0U);
+}
+
+int main(void) {
+    static const uint32_t hops[] = {1U, 160U, 320U, 333U, 512U, MFCC_DRIVER_FFT_LEN};
+    static const uint32_t cols[] = {1U, 7U, 49U, MFCC_STREAM_MAX_FRAMES};
+    uint32_t cases = 0;
+
+    /* Window with zero ends, so the stream's non-zero span differs from the full frame. */
+    for (uint32_t n = 0; n < MFCC_DRIVER_FFT_LEN; n++) {
+        g_drv.window_f32[n] = (n < 37U || n >= MFCC_DRIVER_FFT_LEN - 21U)
+                                  ? 0.0f
+                                  : 0.5f + (float32_t) (n % 64U) / 128.0f;
+    }
+    g_drv.mfcc_f32.windowCoefs = g_drv.window_f32;
+    g_drv.initialized = 1U;
+
+    for (uint32_t i = 0; i < SIGNAL_LEN; i++) {
+        g_signal[i] = (float32_t) ((int32_t) (rng() % 2001U) - 1000) / 1000.0f;
+    }
+
+    for (size_t h = 0; h < sizeof(hops) / sizeof(hops[0]); h++) {
+        for (size_t c = 0; c < sizeof(cols) / sizeof(cols[0]); c++) {
+            /* hop=1 emits a frame per sample; keep it to the small matrices. */
+            if (hops[h] == 1U && cols[c] > 7U) {
+                continue;
+            }
+            run_case(hops[h], cols[c]);
+            cases++;
+        }
+    }
+
+    if (g_errors != 0) {
+        printf("[FAIL] %u mismatch(es)\n", g_errors);
+        return 1;
+    }
+    printf("[PASS] stream matrix matches per-frame analysis for %u hop/column configurations\n",
+           cases);
+    return 0;
+}
@@ -22,6 +22,7 @@ extern "C" {
 #include "hal_mmio.h"
 #include "hal_rcc.h"
 #include "hal_ope.h"
+#include "hal_plic.h"
 
 
 // ================================
@@ -34,6 +35,34 @@ extern "C" {
 #define MTIME_FREQ     50000
 
 
+// ================================
+//  Harts
+// ================================
+// number of harts scheduled by thread-lib (override with -DHTHREAD_N_HARTS=<n>);
+// bmark-lib and other code keep their own N_HARTS
+#ifndef HTHREAD_N_HARTS
+#define HTHREAD_N_HARTS 2
+#endif
+
+// per-hart work-stealing deque capacity, must be a power of two
+#ifndef WSQ_SIZE
+#define WSQ_SIZE       64
+#endif
+
+// L1 data cache line size in bytes
+#define CACHE_LINE_SIZE 64
+
+
+// ================================
+//  PLIC sources
+// ================================
+// UART0 is the first PLIC source, as on bearlyml23 (PLIC_IRQn_Type); source 0 is reserved.
+// Override with -DUART0_IRQ_ID=<n> if a tape-out's device tree says otherwise.
+#ifndef UART0_IRQ_ID
+#define UART0_IRQ_ID            1U
+#endif
+
+
 // ================================
 //  MMIO devices
 // ================================
@@ -0,0 +1,64 @@
+/**
+ * \file    hal_plic.h
+ * \brief   External interrupt dispatch on the PLIC: drivers register a handler per source.
+ * \version 0.1
+ *
+ * \copyright Copyright (c) 2025
+ *
+ * The PLIC gives every hart one machine-mode context (enables at 0x2000 + 0x80 * hart, threshold
+ * and claim/complete at 0x200000 + 0x1000 * hart). machine_external_interrupt_callback claims on
+ * the calling hart's context, runs every handler registered for the claimed source, then
+ * platform_external_irq_callback (weak no-op), and completes the claim. Same interface as dsp25's
+ * hal_dma.h, so drivers that register there (a buffered UART console, ...) work unchanged.
+ *
+ * Source IDs are in chip_config.h (UART0_IRQ_ID, ...).
+ */
+
+#ifndef __HAL_PLIC_H__
+#define __HAL_PLIC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "uart.h"
+
+#define PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS (8U)
+
+typedef void (*platform_irq_handler_t)(uint32_t irq_id, void *arg);
+
+/**
+ * \brief   Enables irq_id at the given priority (1-7) on the calling hart and turns on machine
+ *          external interrupts.
+ */
+void setup_external_interrupt(uint32_t irq_id, uint32_t priority);
+
+/**
+ * \brief   Adds handler(irq_id, arg) to the claims of irq_id. Registering the same triple again is a
+ *          no-op. Register before enabling the source.
+ * \return  0, or -1 when the table is full.
+ */
+int platform_external_irq_register(uint32_t irq_id, platform_irq_handler_t handler, void *arg);
+
+void platform_external_irq_unregister(uint32_t irq_id, platform_irq_handler_t handler, void *arg);
+
+/**
+ * \brief   Called for every claimed source after its registered handlers. Weak no-op.
+ */
+void platform_external_irq_callback(uint32_t irq_id);
+
+/**
+ * \brief   Moves a live buffered UART (e.g. glossy's uart_console) to interrupt-driven servicing:
+ *          routes irq_id to uart_buffered_irq_dispatch, enables it on the calling hart, then calls
+ *          uart_buffered_set_interrupts. Queued bytes are kept.
+ * \return  0, or -1 if the handler could not be registered (the UART stays polled).
+ */
+int platform_uart_irq_enable(UART_BufferedType *huart, uint32_t irq_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HAL_PLIC_H__ */
@@ -0,0 +1,96 @@
+#include "hal_plic.h"
+
+#include <stddef.h>
+
+#include "chip_config.h"
+#include "rocketcore.h"
+
+#define PLIC_PRIORITY(irq)        (PLIC_BASE + 4UL * (irq))
+#define PLIC_ENABLE(hart, irq)    (PLIC_BASE + 0x2000UL + 0x80UL * (hart) + 4UL * ((irq) / 32U))
+#define PLIC_THRESHOLD(hart)      (PLIC_BASE + 0x200000UL + 0x1000UL * (hart))
+#define PLIC_CLAIM(hart)          (PLIC_BASE + 0x200004UL + 0x1000UL * (hart))
+
+typedef struct {
+  uint32_t irq_id;
+  platform_irq_handler_t handler;
+  void *arg;
+} platform_irq_slot_t;
+
+static platform_irq_slot_t g_platform_irqs[PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS];
+
+void setup_external_interrupt(uint32_t irq_id, uint32_t priority) {
+  size_t hart = READ_CSR("mhartid");
+  uintptr_t enable = PLIC_ENABLE(hart, irq_id);
+
+  if (irq_id == 0U) {
+    return;
+  }
+  reg_write32(PLIC_PRIORITY(irq_id), priority);
+  reg_write32(enable, reg_read32(enable) | (1U << (irq_id % 32U)));
+  reg_write32(PLIC_THRESHOLD(hart), 0U);
+  enable_irq(MIE_MEIE_POS);
+  enable_global_interrupt();
+}
+
+int platform_external_irq_register(uint32_t irq_id, platform_irq_handler_t handler, void *arg) {
+  platform_irq_slot_t *free_slot = NULL;
+
+  if (irq_id == 0U || handler == NULL) {
+    return -1;
+  }
+  for (size_t i = 0; i < PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS; i++) {
+    platform_irq_slot_t *slot = &g_platform_irqs[i];
+    if (slot->irq_id == irq_id && slot->handler == handler && slot->arg == arg) {
+      return 0;
+    }
+    if (slot->irq_id == 0U && free_slot == NULL) {
+      free_slot = slot;
+    }
+  }
+  if (free_slot == NULL) {
+    return -1;
+  }
+  free_slot->handler = handler;
+  free_slot->arg = arg;
+  __atomic_store_n(&free_slot->irq_id, irq_id, __ATOMIC_RELEASE);  /* publish last */
+  return 0;
+}
+
+void platform_external_irq_unregister(uint32_t irq_id, platform_irq_handler_t handler, void *arg) {
+  for (size_t i = 0; i < PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS; i++) {
+    platform_irq_slot_t *slot = &g_platform_irqs[i];
+    if (slot->irq_id == irq_id && slot->handler == handler && slot->arg == arg) {
+      __atomic_store_n(&slot->irq_id, 0U, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+__attribute__((weak)) void platform_external_irq_callback(uint32_t irq_id) {
+  (void)irq_id;
+}
+
+void machine_external_interrupt_callback(void) {
+  size_t hart = READ_CSR("mhartid");
+  uint32_t irq_id = reg_read32(PLIC_CLAIM(hart));
+
+  if (irq_id == 0U) {
+    return;
+  }
+  for (size_t i = 0; i < PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS; i++) {
+    platform_irq_slot_t *slot = &g_platform_irqs[i];
+    if (__atomic_load_n(&slot->irq_id, __ATOMIC_ACQUIRE) == irq_id) {
+      slot->handler(irq_id, slot->arg);
+    }
+  }
+  platform_external_irq_callback(irq_id);
+  reg_write32(PLIC_CLAIM(hart), irq_id);
+}
+
+int platform_uart_irq_enable(UART_BufferedType *huart, uint32_t irq_id) {
+  if (platform_external_irq_register(irq_id, uart_buffered_irq_dispatch, huart) != 0) {
+    return -1;
+  }
+  setup_external_interrupt(irq_id, 1U);
+  uart_buffered_set_interrupts(huart, 1U);
+  return 0;
+}
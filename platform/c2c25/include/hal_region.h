@@ -0,0 +1,117 @@
+/**
+ * \file    hal_region.h
+ * \brief   Placement of buffers in DRAM, the MBUS scratchpad and the core-local TCMs.
+ * \version 0.1
+ *
+ * \copyright Copyright (c) 2025
+ *
+ * Memory map (c2c25.ld):
+ *   scratchpad  0x08000000  64 KB, shared over the MBUS
+ *   tcm0        0x08010000   8 KB, core 0
+ *   tcm1        0x08012000   8 KB, core 1
+ *   dram        0x80000000  everything the linker does not place elsewhere
+ *
+ * Two ways to put data in the fast memories:
+ *  - statically, with REGION_SCRATCHPAD_DATA / REGION_TCM0_DATA / REGION_TCM1_DATA on a global. These
+ *    sections are neither loaded nor zeroed at boot; initialize such buffers before reading them.
+ *  - at run time, with region_alloc(). Each SRAM region hands out the space after its static data
+ *    with a bump pointer plus an address-ordered free list; REGION_DRAM goes to the malloc heap.
+ *
+ * region_track() names a buffer for region_report(), which prints what each region holds and where
+ * every tracked buffer ended up.
+ */
+
+#ifndef __HAL_REGION_H__
+#define __HAL_REGION_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define REGION_SCRATCHPAD_DATA  __attribute__((section(".scratchpad")))
+#define REGION_TCM0_DATA        __attribute__((section(".tcm0")))
+#define REGION_TCM1_DATA        __attribute__((section(".tcm1")))
+
+#define REGION_MAX_TRACKED      32U
+
+/**
+ * \brief   Memory regions known to the placement API.
+ * \note    REGION_TCM_LOCAL resolves to the calling hart's TCM.
+ */
+typedef enum {
+  REGION_DRAM = 0,
+  REGION_SCRATCHPAD,
+  REGION_TCM0,
+  REGION_TCM1,
+  REGION_COUNT,
+  REGION_TCM_LOCAL = REGION_COUNT,
+} region_id_t;
+
+/**
+ * \brief   Occupancy of one region, in bytes.
+ */
+typedef struct {
+  uintptr_t base;
+  size_t size;          // whole region; 0 for REGION_DRAM
+  size_t static_bytes;  // placed by the linker
+  size_t alloc_bytes;   // currently handed out by region_alloc, headers and padding included
+  size_t peak_bytes;    // high-water mark of alloc_bytes
+  size_t free_bytes;    // still available to region_alloc; 0 for REGION_DRAM
+} region_stats_t;
+
+/**
+ * \brief           Allocates from a region.
+ * \param[in]       region: Region to allocate from
+ * \param[in]       size: Bytes to allocate
+ * \param[in]       align: Alignment of the returned pointer, a power of two (at least 16 is used)
+ * \return          Pointer to the buffer, or NULL if the region has no room
+ */
+void *region_alloc(region_id_t region, size_t size, size_t align);
+
+/**
+ * \brief           Returns a buffer from region_alloc() to its region.
+ * \param[in]       ptr: Buffer to release, may be NULL
+ */
+void region_free(void *ptr);
+
+/**
+ * \brief           Drops every region_alloc() allocation of an SRAM region at once.
+ * \param[in]       region: Region to reset; REGION_DRAM is left untouched
+ */
+void region_reset(region_id_t region);
+
+/**
+ * \brief           Region an address belongs to.
+ * \param[in]       ptr: Any address
+ * \return          The SRAM region containing ptr, REGION_DRAM otherwise
+ */
+region_id_t region_of(const void *ptr);
+
+/**
+ * \brief           Fills in the occupancy of a region.
+ * \param[in]       region: Region to query
+ * \param[out]      stats: Occupancy
+ */
+void region_get_stats(region_id_t region, region_stats_t *stats);
+
+/**
+ * \brief           Records a named buffer for region_report().
+ * \param[in]       name: Label, must outlive the report (a string literal)
+ * \param[in]       ptr: Start of the buffer
+ * \param[in]       size: Buffer size in bytes
+ */
+void region_track(const char *name, const void *ptr, size_t size);
+
+/**
+ * \brief           Prints per-region occupancy and the placement of every tracked buffer.
+ */
+void region_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HAL_REGION_H__
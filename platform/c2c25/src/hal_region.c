@@ -0,0 +1,312 @@
+#include "hal_region.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "riscv.h"
+
+#define REGION_ALIGN            16U
+
+/* Defined by the linker script: [start, end) is static data, [end, limit) is left to region_alloc. */
+extern char __scratchpad_start[], __scratchpad_end[], __scratchpad_limit[];
+extern char __tcm0_start[], __tcm0_end[], __tcm0_limit[];
+extern char __tcm1_start[], __tcm1_end[], __tcm1_limit[];
+
+/* Header in front of every region_alloc block. */
+typedef struct {
+  char *span;                 // start of the span the block was carved from (padding included)
+  size_t span_size;           // bytes from the span start to the end of the block
+} region_header_t;
+
+/* Freed spans, kept in address order in the spans themselves. */
+typedef struct region_span {
+  struct region_span *next;
+  size_t size;
+} region_span_t;
+
+typedef struct {
+  const char *name;
+  char *start;
+  char *end;
+  char *limit;
+  char *brk;
+  region_span_t *free;        // address-ordered free spans
+  uint32_t lock;
+  size_t alloc_bytes;
+  size_t peak_bytes;
+} region_state_t;
+
+typedef struct {
+  const char *name;
+  const void *ptr;
+  size_t size;
+} region_tracked_t;
+
+static region_state_t regions[REGION_COUNT] = {
+  [REGION_DRAM]       = { .name = "dram" },
+  [REGION_SCRATCHPAD] = { .name = "scratchpad", .start = __scratchpad_start, .end = __scratchpad_end,
+                          .limit = __scratchpad_limit },
+  [REGION_TCM0]       = { .name = "tcm0", .start = __tcm0_start, .end = __tcm0_end, .limit = __tcm0_limit },
+  [REGION_TCM1]       = { .name = "tcm1", .start = __tcm1_start, .end = __tcm1_end, .limit = __tcm1_limit },
+};
+
+static region_tracked_t tracked[REGION_MAX_TRACKED];
+static uint32_t tracked_count;
+
+static inline uintptr_t region_align_up(uintptr_t x, size_t align) {
+  return (x + align - 1U) & ~(uintptr_t)(align - 1U);
+}
+
+static void region_lock(region_state_t *r) {
+  while (__atomic_exchange_n(&r->lock, 1U, __ATOMIC_ACQUIRE)) {
+    while (__atomic_load_n(&r->lock, __ATOMIC_RELAXED));
+  }
+}
+
+static void region_unlock(region_state_t *r) {
+  __atomic_store_n(&r->lock, 0U, __ATOMIC_RELEASE);
+}
+
+static region_id_t region_resolve(region_id_t region) {
+  if (region == REGION_TCM_LOCAL) {
+    uint64_t hartid = READ_CSR("mhartid");
+    return (hartid == 0U) ? REGION_TCM0 : (hartid == 1U) ? REGION_TCM1 : REGION_COUNT;
+  }
+  return region;
+}
+
+/* Places a block of `size` bytes aligned to `align` inside [span, span_end); returns the payload. */
+static char *region_fit(char *span, char *span_end, size_t size, size_t align) {
+  char *payload = (char *)region_align_up((uintptr_t)span + sizeof(region_header_t), align);
+
+  if (payload + size > span_end || payload + size < payload) {
+    return NULL;
+  }
+  return payload;
+}
+
+static void region_free_locked(region_state_t *r, char *span, size_t span_size) {
+  region_span_t **link = &r->free;
+  region_span_t *block = (region_span_t *)span;
+
+  while (*link != NULL && (char *)*link < span) {
+    link = &(*link)->next;
+  }
+  block->next = *link;
+  block->size = span_size;
+  *link = block;
+
+  /* Coalesce neighbours; a span ending at the bump pointer goes back to it. */
+  link = &r->free;
+  while (*link != NULL) {
+    region_span_t *cur = *link;
+
+    if (cur->next != NULL && (char *)cur + cur->size == (char *)cur->next) {
+      cur->size += cur->next->size;
+      cur->next = cur->next->next;
+      continue;
+    }
+    if (cur->next == NULL && (char *)cur + cur->size == r->brk) {
+      r->brk = (char *)cur;
+      *link = NULL;
+      break;
+    }
+    link = &cur->next;
+  }
+}
+
+void *region_alloc(region_id_t region, size_t size, size_t align) {
+  region_state_t *r;
+  region_span_t **link;
+  char *span = NULL;
+  char *payload = NULL;
+  char *block_end;
+
+  region = region_resolve(region);
+  if (region >= REGION_COUNT || align == 0U || (align & (align - 1U)) != 0U) {
+    return NULL;
+  }
+  if (align < REGION_ALIGN) {
+    align = REGION_ALIGN;
+  }
+  if (region == REGION_DRAM) {
+    payload = memalign(align, size);
+    if (payload != NULL) {
+      r = &regions[REGION_DRAM];
+      region_lock(r);
+      r->alloc_bytes += malloc_usable_size(payload);
+      if (r->alloc_bytes > r->peak_bytes) {
+        r->peak_bytes = r->alloc_bytes;
+      }
+      region_unlock(r);
+    }
+    return payload;
+  }
+
+  r = &regions[region];
+  size = region_align_up(size, REGION_ALIGN);
+  region_lock(r);
+  if (r->brk == NULL) {
+    r->brk = (char *)region_align_up((uintptr_t)r->end, REGION_ALIGN);
+  }
+
+  /* First fit among freed spans, then the untouched space above brk. */
+  for (link = &r->free; *link != NULL; link = &(*link)->next) {
+    region_span_t *free_span = *link;
+    char *span_end = (char *)free_span + free_span->size;
+
+    payload = region_fit((char *)free_span, span_end, size, align);
+    if (payload != NULL) {
+      span = (char *)free_span;
+      block_end = payload + size;
+      if ((size_t)(span_end - block_end) >= 2U * sizeof(region_span_t)) {
+        region_span_t *rest = (region_span_t *)block_end;
+        rest->next = free_span->next;
+        rest->size = (size_t)(span_end - block_end);
+        *link = rest;
+      } else {
+        *link = free_span->next;
+        block_end = span_end;
+      }
+      break;
+    }
+  }
+
+  if (payload == NULL) {
+    span = r->brk;
+    payload = region_fit(r->brk, r->limit, size, align);
+    if (payload == NULL) {
+      region_unlock(r);
+      return NULL;
+    }
+    block_end = payload + size;
+    r->brk = block_end;
+  }
+
+  ((region_header_t *)payload - 1)->span = span;
+  ((region_header_t *)payload - 1)->span_size = (size_t)(block_end - span);
+  r->alloc_bytes += (size_t)(block_end - span);
+  if (r->alloc_bytes > r->peak_bytes) {
+    r->peak_bytes = r->alloc_bytes;
+  }
+  region_unlock(r);
+  return payload;
+}
+
+void region_free(void *ptr) {
+  region_id_t region;
+  region_state_t *r;
+  region_header_t *header;
+
+  if (ptr == NULL) {
+    return;
+  }
+  region = region_of(ptr);
+  if (region == REGION_DRAM) {
+    r = &regions[REGION_DRAM];
+    region_lock(r);
+    r->alloc_bytes -= malloc_usable_size(ptr);
+    region_unlock(r);
+    free(ptr);
+    return;
+  }
+
+  r = &regions[region];
+  header = (region_header_t *)ptr - 1;
+  region_lock(r);
+  r->alloc_bytes -= header->span_size;
+  region_free_locked(r, header->span, header->span_size);
+  region_unlock(r);
+}
+
+void region_reset(region_id_t region) {
+  region_state_t *r;
+
+  region = region_resolve(region);
+  if (region == REGION_DRAM || region >= REGION_COUNT) {
+    return;
+  }
+  r = &regions[region];
+  region_lock(r);
+  r->brk = (char *)region_align_up((uintptr_t)r->end, REGION_ALIGN);
+  r->free = NULL;
+  r->alloc_bytes = 0U;
+  region_unlock(r);
+}
+
+region_id_t region_of(const void *ptr) {
+  for (uint32_t i = REGION_SCRATCHPAD; i < REGION_COUNT; i += 1) {
+    if ((const char *)ptr >= regions[i].start && (const char *)ptr < regions[i].limit) {
+      return (region_id_t)i;
+    }
+  }
+  return REGION_DRAM;
+}
+
+void region_get_stats(region_id_t region, region_stats_t *stats) {
+  region_state_t *r;
+
+  region = region_resolve(region);
+  if (region >= REGION_COUNT) {
+    *stats = (region_stats_t){ 0 };
+    return;
+  }
+  r = &regions[region];
+  region_lock(r);
+  stats->base = (uintptr_t)r->start;
+  stats->size = (size_t)(r->limit - r->start);
+  stats->static_bytes = (size_t)(r->end - r->start);
+  stats->alloc_bytes = r->alloc_bytes;
+  stats->peak_bytes = r->peak_bytes;
+  stats->free_bytes = 0U;
+  if (region != REGION_DRAM) {
+    char *brk = (r->brk != NULL) ? r->brk : (char *)region_align_up((uintptr_t)r->end, REGION_ALIGN);
+    stats->free_bytes = (size_t)(r->limit - brk);
+    for (region_span_t *span = r->free; span != NULL; span = span->next) {
+      stats->free_bytes += span->size;
+    }
+  }
+  region_unlock(r);
+}
+
+void region_track(const char *name, const void *ptr, size_t size) {
+  uint32_t slot = __atomic_fetch_add(&tracked_count, 1U, __ATOMIC_RELAXED);
+
+  if (slot < REGION_MAX_TRACKED) {
+    tracked[slot] = (region_tracked_t){ .name = name, .ptr = ptr, .size = size };
+  }
+}
+
+void region_report(void) {
+  uint32_t count = (tracked_count < REGION_MAX_TRACKED) ? tracked_count : REGION_MAX_TRACKED;
+  size_t per_region[REGION_COUNT] = { 0 };
+
+  for (uint32_t i = 0; i < count; i += 1) {
+    per_region[region_of(tracked[i].ptr)] += tracked[i].size;
+  }
+
+  printf("region      base        size    static  alloc   peak    free    tracked\n");
+  for (uint32_t i = REGION_SCRATCHPAD; i < REGION_COUNT; i += 1) {
+    region_stats_t s;
+    region_get_stats((region_id_t)i, &s);
+    printf("%-11s 0x%08lx  %-7lu %-7lu %-7lu %-7lu %-7lu %lu\n", regions[i].name, (unsigned long)s.base,
+           (unsigned long)s.size, (unsigned long)s.static_bytes, (unsigned long)s.alloc_bytes,
+           (unsigned long)s.peak_bytes, (unsigned long)s.free_bytes, (unsigned long)per_region[i]);
+  }
+  printf("%-11s -           -       -       %-7lu %-7lu -       %lu\n", regions[REGION_DRAM].name,
+         (unsigned long)regions[REGION_DRAM].alloc_bytes, (unsigned long)regions[REGION_DRAM].peak_bytes,
+         (unsigned long)per_region[REGION_DRAM]);
+
+  if (count > 0U) {
+    printf("\nbuffer                    address     bytes     region\n");
+    for (uint32_t i = 0; i < count; i += 1) {
+      printf("%-25s 0x%08lx  %-9lu %s\n", tracked[i].name, (unsigned long)(uintptr_t)tracked[i].ptr,
+             (unsigned long)tracked[i].size, regions[region_of(tracked[i].ptr)].name);
+    }
+  }
+  if (tracked_count > REGION_MAX_TRACKED) {
+    printf("(%lu more buffers not tracked, raise REGION_MAX_TRACKED)\n",
+           (unsigned long)(tracked_count - REGION_MAX_TRACKED));
+  }
+}
@@ -25,6 +25,7 @@ extern "C" {
 #include "hal_dma.h"
 // #include "hal_wavelet.h"
 #include "hal_conv.h"
+#include "hal_conv_long.h"
 
 
 // ================================
@@ -37,6 +38,24 @@ extern "C" {
 #define MTIME_FREQ     50000
 
 
+// ================================
+//  Harts
+// ================================
+// number of harts scheduled by thread-lib (override with -DHTHREAD_N_HARTS=<n>);
+// bmark-lib and other code keep their own N_HARTS
+#ifndef HTHREAD_N_HARTS
+#define HTHREAD_N_HARTS 2
+#endif
+
+// per-hart work-stealing deque capacity, must be a power of two
+#ifndef WSQ_SIZE
+#define WSQ_SIZE       64
+#endif
+
+// L1 data cache line size in bytes
+#define CACHE_LINE_SIZE 64
+
+
 // ================================
 //  MMIO devices
 // ================================
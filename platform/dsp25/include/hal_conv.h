@@ -261,7 +261,15 @@ uint8_t perform_convolution_1D_preconfigured(
 // 64-bit beat = 2 FP32
 #define FP32_PER_PACKET         2
 
-// TODO: needs documentation
+/**
+ * \brief One-shot DMA convolution: kernel, then output and input on peripheral channels.
+ *
+ * Completion is detected by waiting for DMA_IDLE_THRESHOLD cycles of bus silence, and the whole
+ * signal must fit one descriptor (<= 0xFFFF packets). Long signals and callers that want the CPU
+ * back during the run should use the conv_dma_stream_* API below.
+ *
+ * \return bool: false when a descriptor could not be programmed or the bus never went idle.
+ */
 bool dma_1dConvDriver(
     uint32_t *input_buffer_ptr,
     uint32_t *output_buffer_ptr,
@@ -272,6 +280,79 @@ bool dma_1dConvDriver(
     uint32_t  base_id
 );
 
+// --- DMA Streaming Driver ---
+
+/*
+ * Streams an input of any (even) length through the accelerator in chunks of `chunk_length`
+ * elements using the DMA descriptor rings (hal_dma.h) on DMA_KERNEL_CORE, DMA_INPUT_CORE and
+ * DMA_OUTPUT_CORE. Per chunk:
+ *   1. clear the datapath, program LENGTH, queue the kernel descriptor
+ *   2. kernel done -> START, queue the output chain, then the input descriptor
+ *   3. output done -> arm the next chunk, then overlap-add the previous chunk's tail
+ *
+ * The output chain writes the chunk's first chunk_length results straight into `output` and its
+ * last kernel_length results into one of CONV_DMA_STREAM_TAILS rotating tail buffers. Because the
+ * next chunk is armed before the fold, its kernel load is already in flight while the CPU folds;
+ * three buffers keep the tail being folded, the tail just written and the tail the next chunk
+ * will write apart. Completions arrive by interrupt; all
+ * sequencing runs from dma_cq_dispatch (conv_dma_stream_poll), so the CPU is free between polls.
+ *
+ * Output layout matches perform_convolution_1D: input_length + kernel_length elements.
+ * Dilation is fixed at 1. One stream at a time (conv_accelerator_busy reports one in flight);
+ * the rings belong to the hart that started it.
+ */
+#define CONV_DMA_STREAM_DEFAULT_CHUNK 1024U
+#define CONV_DMA_STREAM_MAX_KERNEL    16U
+#define CONV_DMA_STREAM_TAILS         3U
+
+typedef struct {
+    uint32_t *input;
+    uint32_t *kernel;
+    uint32_t *output;
+    size_t input_length;
+    size_t chunk_length;
+    size_t kernel_packets;
+    size_t num_chunks;
+    size_t next_chunk;       // next chunk to arm
+    size_t chunks_done;      // chunks whose output has been folded into `output`
+    uint32_t tail[CONV_DMA_STREAM_TAILS][CONV_DMA_STREAM_MAX_KERNEL] __attribute__((aligned(8)));
+    volatile bool done;
+    uint8_t status;
+} conv_dma_stream_t;
+
+/**
+ * \brief Starts a chunked DMA convolution and returns as soon as the first kernel load is queued.
+ * \param s Stream state, owned by the caller until conv_dma_stream_poll/wait report done.
+ * \param input Input FP32 buffer, 8-byte aligned.
+ * \param input_length Input FP32 element count (even, > 0).
+ * \param kernel Kernel FP32 buffer, 8-byte aligned.
+ * \param kernel_length Kernel FP32 element count (8 or 16).
+ * \param output Output FP32 buffer of input_length + kernel_length elements, 8-byte aligned.
+ * \param chunk_length Elements per chunk (even, >= kernel_length); 0 picks CONV_DMA_STREAM_DEFAULT_CHUNK.
+ * \return int: 0 on success, -1 on invalid arguments or when the conv DMA channels are busy.
+ */
+int conv_dma_stream_start(conv_dma_stream_t *s, uint32_t *input, uint32_t input_length,
+                          uint32_t *kernel, uint8_t kernel_length, uint32_t *output,
+                          uint32_t chunk_length);
+
+/**
+ * \brief Runs pending DMA completions (advancing the stream) without blocking.
+ * \return bool: true once the last chunk has been folded into the output.
+ */
+bool conv_dma_stream_poll(conv_dma_stream_t *s);
+
+/**
+ * \brief Blocks until the stream is done.
+ * \return uint8_t: status register after the last chunk, with STATUS_ERROR set on a DMA error.
+ */
+uint8_t conv_dma_stream_wait(conv_dma_stream_t *s);
+
+/**
+ * \brief Reports whether a DMA stream currently owns the accelerator.
+ * \return bool: true between conv_dma_stream_start and the stream's completion.
+ */
+bool conv_accelerator_busy(void);
+
  // Deprecated or removed function (kept for reference of old structure)
  // Deprecated or removed functions (kept for reference of old structure)
  // int conv_set_params(uint32_t* input, uint32_t input_length, uint16_t dilation, uint32_t* kernel, uint8_t kernel_length);
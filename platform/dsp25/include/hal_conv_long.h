@@ -0,0 +1,88 @@
+/**
+ * \file    hal_conv_long.h
+ * \brief   Long-kernel, long-signal FIR filtering on top of the 1D Conv Engine.
+ *
+ * The engine only takes 8- or 16-tap kernels and a bounded input per run. This layer filters a
+ * stream with an impulse response of any length (up to CONV_LONG_MAX_TAPS):
+ *
+ *  - the impulse response h is split into P segments of S = 16 taps (8 when it is that short),
+ *    zero padded, and stored reversed because the engine computes out[i] = sum_j k[j] x[i+j-(S-1)]
+ *  - samples are processed in blocks of up to block_len; the last P*S inputs are kept as history
+ *  - overlap-save: for segment p the engine runs on a (block + S)-sample window that starts
+ *    (p + 1) * S samples before the block, and outputs [S, S + block) are accumulated into y
+ *  - all P runs of a block share one conv_begin_preconfigured_session
+ *
+ * A block goes to the vector (RVV, or scalar without the V extension) direct-form kernel instead
+ * when a conv DMA stream owns the accelerator, when its length is odd, or when a run reports an
+ * error. Both paths compute y[n] = sum_m h[m] x[n - m] and share the same history.
+ */
+
+#ifndef __HAL_CONV_LONG_H__
+#define __HAL_CONV_LONG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal_conv.h"
+
+#ifndef CONV_LONG_MAX_TAPS
+#define CONV_LONG_MAX_TAPS   2048U   // impulse response length after padding to whole segments
+#endif
+
+#ifndef CONV_LONG_MAX_BLOCK
+#define CONV_LONG_MAX_BLOCK  512U    // samples per engine block
+#endif
+
+#define CONV_LONG_SEGMENT    16U     // preferred engine kernel length
+
+typedef struct {
+    uint32_t seg_kernel[CONV_LONG_MAX_TAPS] __attribute__((aligned(8)));  // reversed segments, FP32 bits
+    float taps[CONV_LONG_MAX_TAPS];                                        // h, zero padded
+    float history[CONV_LONG_MAX_TAPS + CONV_LONG_MAX_BLOCK] __attribute__((aligned(8)));
+    uint32_t hw_out[CONV_LONG_MAX_BLOCK + 2U * CONV_LONG_SEGMENT] __attribute__((aligned(8)));
+    size_t taps_len;       // P * S
+    size_t segment_len;    // S
+    size_t num_segments;   // P
+    size_t block_len;
+    bool use_accel;        // clear to force the vector path (A/B comparisons)
+
+    // Statistics since conv_long_init.
+    uint32_t accel_blocks;
+    uint32_t fallback_blocks;
+    uint32_t accel_errors;
+} conv_long_t;
+
+/**
+ * \brief Prepares a filter for impulse response `ir` and clears its history.
+ * \param c Filter state (large: keep it static).
+ * \param ir Impulse response, natural order (ir[0] applies to the current sample).
+ * \param ir_len Number of taps, 1..CONV_LONG_MAX_TAPS.
+ * \param block_len Samples per engine block, even, 2..CONV_LONG_MAX_BLOCK. Longer blocks amortize
+ *        the per-run kernel load; shorter ones lower the latency of each conv_long_process call.
+ * \return int: 0 on success, -1 on invalid arguments.
+ */
+int conv_long_init(conv_long_t *c, const float *ir, size_t ir_len, size_t block_len);
+
+/**
+ * \brief Forgets past input (the next output starts from silence).
+ */
+void conv_long_reset(conv_long_t *c);
+
+/**
+ * \brief Filters n samples, continuing from the previous call.
+ * \param in Input samples; may alias `out`.
+ * \param out Output samples, y[n] = sum_m ir[m] in[n - m].
+ * \param n Any number of samples.
+ */
+void conv_long_process(conv_long_t *c, const float *in, float *out, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HAL_CONV_LONG_H__
@@ -69,6 +69,21 @@ typedef struct {
 
 /* DMA setup and programming */
 void setup_interrupts(void);
+/* Enable another PLIC source on the calling hart. The DMA's external interrupt handler passes every
+ * other claim to the handlers registered for it (platform_external_irq_register; hal_i2s_stream's
+ * watermarks, a buffered UART console via uart_buffered_irq_dispatch, ...), then to
+ * platform_external_irq_callback (weak no-op). */
+void setup_external_interrupt(uint32_t irq_id, uint32_t priority);
+
+#define PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS (8U)
+
+typedef void (*platform_irq_handler_t)(uint32_t irq_id, void *arg);
+
+/* Adds handler(irq_id, arg) to the claims of irq_id. Registering the same triple again is a no-op.
+ * Returns 0, or -1 when the table is full. Register before enabling the source. */
+int platform_external_irq_register(uint32_t irq_id, platform_irq_handler_t handler, void *arg);
+void platform_external_irq_unregister(uint32_t irq_id, platform_irq_handler_t handler, void *arg);
+void platform_external_irq_callback(uint32_t irq_id);
 bool set_DMA_C(uint32_t channel, dma_transaction_t transaction, bool retry);
 bool set_DMA_P(uint32_t channel, dma_transaction_t transaction, bool retry);
 void start_DMA(uint32_t channel, uint16_t transaction_id, bool *finished);
@@ -83,6 +98,114 @@ void dma_wait_till_done(size_t mhartid, bool *finished);
 /* Optional polling helper for interrupt MMIO slots */
 bool dma_poll_interrupt(size_t mhartid, dma_interrupt_t *out);
 
+/*
+ * Descriptor rings and completion queue.
+ *
+ * Each channel can own a ring of DMA_RING_DEPTH queued transactions. The DMA interrupt handler
+ * retires the descriptor in flight and programs the next one, so a chain of segments (a strided
+ * frame gather, a list of conv tiles) runs back to back without the CPU. Completions are posted
+ * to a per-hart single-producer/single-consumer queue (the interrupt handler produces, the hart's
+ * main code consumes) and their callbacks run from dma_cq_dispatch, never in interrupt context.
+ *
+ * A ring belongs to the hart that called dma_ring_init: its transactions are issued with
+ * `core` = that hart so the completion interrupt comes back to it, and only that hart may submit.
+ * Rings need setup_interrupts(); they reserve transaction ids with DMA_RING_TID_FLAG set, so
+ * direct set_DMA_C/set_DMA_P users must keep their ids below 0x8000.
+ */
+#ifndef DMA_RING_DEPTH
+#define DMA_RING_DEPTH (16U)   /* descriptors per channel, power of two */
+#endif
+
+#ifndef DMA_CQ_DEPTH
+#define DMA_CQ_DEPTH   (32U)   /* completion entries per hart, power of two */
+#endif
+
+#define DMA_HART_COUNT       (2U)
+#define DMA_RING_TID_FLAG    (0x8000U)
+#define DMA_RING_TID_SEQ_MASK (0x07FFU)
+#define DMA_RING_TID(channel, seq) \
+  ((uint16_t)(DMA_RING_TID_FLAG | (((channel) & 0x7U) << 11) | ((seq) & DMA_RING_TID_SEQ_MASK)))
+
+struct dma_completion_s;
+typedef void (*dma_callback_t)(const struct dma_completion_s *completion, void *arg);
+
+typedef struct dma_completion_s {
+  uint8_t channel;
+  uint16_t transaction_id;
+  bool is_error;
+  uint64_t address;
+  uint32_t seq;              /* ring sequence number returned by dma_ring_submit* */
+  dma_callback_t callback;
+  void *arg;
+} dma_completion_t;
+
+/* Reset channel's ring and bind it to the calling hart. The channel must be idle. */
+bool dma_ring_init(uint32_t channel);
+/* Queue one transaction (transaction_id and core are assigned by the ring). Returns its sequence
+ * number (never 0), or 0 when the ring is full. `callback` may be NULL. */
+uint32_t dma_ring_submit(uint32_t channel, const dma_transaction_t *transaction,
+                         dma_callback_t callback, void *arg);
+/* Queue `count` segments as one chain: all of them or none. Only the last segment carries
+ * `callback`. Returns the sequence number of the last segment, or 0 when they do not fit. */
+uint32_t dma_ring_submit_chain(uint32_t channel, const dma_transaction_t *segments, size_t count,
+                               dma_callback_t callback, void *arg);
+uint32_t dma_ring_free(uint32_t channel);
+bool dma_ring_done(uint32_t channel, uint32_t seq);
+/* Spin until `seq` has completed, dispatching this hart's completions meanwhile. */
+void dma_ring_wait(uint32_t channel, uint32_t seq);
+/* Descriptors that completed with is_error set since dma_ring_init. */
+uint32_t dma_ring_errors(uint32_t channel);
+
+/* Completion queue of the calling hart. Entries are posted for descriptors with a callback and
+ * for every error. */
+bool dma_cq_pop(dma_completion_t *out);
+/* Pop every pending completion and run its callback. Returns the number of entries popped. */
+size_t dma_cq_dispatch(void);
+/* Completions lost because the calling hart's queue was full. */
+uint32_t dma_cq_overflows(void);
+
+/*
+ * DMA-backed memcpy/memset.
+ *
+ * Each hart copies on its own core channel (hart h uses channel DMA_MEMCPY_CHANNEL + h) through
+ * that channel's descriptor ring. Copies shorter than the crossover threshold, copies whose source
+ * and destination disagree mod 4, and calls made with interrupts disabled (e.g. from a trap
+ * handler) run on the CPU instead. Misaligned head and tail bytes are copied by the CPU around a
+ * DMA body of 8- or 4-byte packets. The threshold starts at DMA_MEMCPY_DEFAULT_THRESHOLD and can
+ * be measured with dma_memcpy_calibrate.
+ *
+ * Opt-in libc override: link a target with -Wl,--wrap=memcpy and every large memcpy goes through
+ * dma_memcpy once dma_memcpy_init has run on the calling hart.
+ */
+#ifndef DMA_MEMCPY_CHANNEL
+#define DMA_MEMCPY_CHANNEL           (0U)
+#endif
+
+#ifndef DMA_MEMCPY_DEFAULT_THRESHOLD
+#define DMA_MEMCPY_DEFAULT_THRESHOLD (2048U)   /* bytes */
+#endif
+
+#define DMA_MEMCPY_MIN_THRESHOLD     (64U)
+#define DMA_MEMCPY_MAX_PACKETS       (0xFFFFU) /* `len` is 16 bits */
+
+/* Enable DMA interrupts and bind this hart's memcpy channel ring. */
+bool dma_memcpy_init(void);
+/* Start a copy. Returns the ring sequence to pass to dma_ring_wait/dma_memcpy_wait, or 0 when the
+ * copy already completed on the CPU (callback, if any, has then already run). */
+uint32_t dma_memcpy_async(void *dst, const void *src, size_t n, dma_callback_t callback, void *arg);
+void dma_memcpy_wait(uint32_t seq);
+void *dma_memcpy(void *dst, const void *src, size_t n);
+void *dma_memset(void *dst, int c, size_t n);
+/* True when a copy of these arguments would be offloaded to the DMA. */
+bool dma_memcpy_offloadable(const void *dst, const void *src, size_t n);
+
+/* Time CPU memcpy against the DMA on doubling sizes up to bytes/2, using `scratch` as source and
+ * destination halves, and set the threshold to the smallest size from which the DMA wins on
+ * every larger size. Returns the new threshold (SIZE_MAX if the DMA never wins). */
+size_t dma_memcpy_calibrate(void *scratch, size_t bytes);
+size_t dma_memcpy_threshold(void);
+void dma_memcpy_set_threshold(size_t bytes);
+
 /* Test helpers */
 bool check_val8(int i, unsigned int ref, unsigned long addr, int print);
 bool check_val16(int i, unsigned int ref, unsigned long addr, int print);
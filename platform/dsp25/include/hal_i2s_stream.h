@@ -0,0 +1,150 @@
+/** I2S Streaming Layer
+*
+* Continuous I2S capture (RX) and playback (TX) through a sample ring buffer, so the CPU never
+* stalls on an I2S FIFO access. One stream drives one channel side (LEFT or RIGHT) in one direction.
+*
+* Two ways to move data between the FIFO and the ring:
+*
+* - I2S_STREAM_DMA: a peripheral DMA channel (set_DMA_P, through the descriptor rings in hal_dma.h)
+*   moves one period at a time, address-gated on the I2S FIFO. Completions are handled from
+*   i2s_stream_poll (dma_cq_dispatch), which re-arms the channel.
+*
+* - I2S_STREAM_WATERMARK: the FIFO is drained (RX) or filled (TX) by the CPU whenever it crosses the
+*   configured watermark. With I2S_STREAM_WATERMARK_IRQ(channel) set to the PLIC source of the
+*   channel's watermark line this runs in the external interrupt handler; otherwise (the default,
+*   the line is not routed to the PLIC on every tape-out) it runs from i2s_stream_poll.
+*
+* RX consumers read through frame views: i2s_stream_frame_acquire returns a pointer into the ring
+* to `window` contiguous samples (for MFCC: FFT length) and i2s_stream_frame_release advances by
+* `hop`. Views are zero-copy even across the ring's wrap point: the first window - 1 samples of each
+* lap are mirrored past the end of the ring, so the buffer is capacity + window words long.
+*
+* Samples are the raw 32-bit slots of each 64-bit FIFO block (two samples per block, low word
+* first). With rx_fp/tx_fp enabled in i2s_params_t the slots are FP32 and views can be used as
+* float arrays directly.
+*/
+
+#ifndef hal_i2s_stream_H
+#define hal_i2s_stream_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal_i2s.h"
+#include "hal_dma.h"
+
+// PLIC source for a channel's watermark interrupt, 0 when not routed (serviced by polling).
+#ifndef I2S_STREAM_WATERMARK_IRQ
+#define I2S_STREAM_WATERMARK_IRQ(channel)    (0U)
+#endif
+
+// Peripheral id presented by DMA descriptors that access the I2S FIFOs.
+#ifndef I2S_STREAM_DMA_PERIPHERAL_ID
+#define I2S_STREAM_DMA_PERIPHERAL_ID         (0U)
+#endif
+
+// Streams that can be serviced from the watermark interrupt at the same time.
+#define I2S_STREAM_MAX_IRQ_STREAMS           (4U)
+
+// Words of storage a stream needs: the ring plus the wrap mirror.
+#define I2S_STREAM_BUFFER_WORDS(capacity, window)   ((capacity) + (window))
+
+typedef enum {
+    I2S_STREAM_RX = 0,
+    I2S_STREAM_TX = 1
+} i2s_stream_dir_t;
+
+typedef enum {
+    I2S_STREAM_DMA = 0,
+    I2S_STREAM_WATERMARK = 1
+} i2s_stream_mode_t;
+
+typedef struct i2s_stream_config {
+    int channel;                    // I2S channel, already set up with config_I2S
+    i2s_channel_side_t side;
+    i2s_stream_dir_t dir;
+    i2s_stream_mode_t mode;
+    uint32_t dma_channel;           // peripheral DMA channel (I2S_STREAM_DMA)
+    uint32_t *buffer;               // I2S_STREAM_BUFFER_WORDS(capacity, window) words, 8-byte aligned
+    uint32_t capacity;              // ring samples, a multiple of period
+    uint32_t period;                // samples per DMA descriptor, even
+    uint32_t window;                // RX: samples per frame view (1 for TX)
+    uint32_t hop;                   // RX: samples released per frame (1 for TX)
+    uint8_t watermark;              // FIFO level in 64-bit blocks (I2S_STREAM_WATERMARK)
+} i2s_stream_config_t;
+
+typedef struct i2s_stream {
+    i2s_stream_config_t cfg;
+    volatile uint64_t head;         // samples written into the ring (RX: captured, TX: queued)
+    volatile uint64_t tail;         // samples taken out (RX: released, TX: sent)
+    uint64_t dma_pos;               // RX: ring space handed to the DMA; TX: samples handed to the DMA
+    uint32_t overruns;              // RX: times the ring was full with the FIFO still filling
+    uint32_t underruns;             // TX: times the FIFO was left to run dry
+    uint32_t dma_errors;
+    bool running;
+} i2s_stream_t;
+
+typedef struct i2s_frame {
+    const uint32_t *samples;        // `window` contiguous samples inside the ring
+    uint32_t length;
+    uint64_t index;                 // stream position of samples[0]
+} i2s_frame_t;
+
+/**
+ * @brief Validates the configuration and binds the ring. Does not touch the hardware.
+ * @return int 0 on success, -1 on an invalid configuration.
+ */
+int i2s_stream_init(i2s_stream_t* stream, const i2s_stream_config_t* config);
+
+/**
+ * @brief Starts moving samples: enables the channel direction, arms the DMA or the watermark.
+ *
+ * DMA mode binds the descriptor ring of cfg.dma_channel to the calling hart, which must also be
+ * the one calling i2s_stream_poll.
+ * @return int 0 on success, -1 if the DMA channel or interrupt slot is unavailable.
+ */
+int i2s_stream_start(i2s_stream_t* stream);
+
+/**
+ * @brief Stops re-arming. Transfers already queued on the DMA complete and are accounted.
+ */
+void i2s_stream_stop(i2s_stream_t* stream);
+
+/**
+ * @brief Services completions and re-arms the transfer. Call from the main loop; cheap when idle.
+ */
+void i2s_stream_poll(i2s_stream_t* stream);
+
+/**
+ * @brief RX: samples captured and not yet released. TX: samples queued and not yet sent.
+ */
+uint32_t i2s_stream_level(const i2s_stream_t* stream);
+
+/**
+ * @brief RX: returns a view of the next `window` samples without copying, if they have arrived.
+ * @return bool true with `frame` filled, false if fewer than `window` samples are available.
+ */
+bool i2s_stream_frame_acquire(i2s_stream_t* stream, i2s_frame_t* frame);
+
+/**
+ * @brief RX: drops the oldest `hop` samples, ending the current view.
+ */
+void i2s_stream_frame_release(i2s_stream_t* stream);
+
+/**
+ * @brief TX: copies up to `count` samples into the ring.
+ * @return size_t number of samples queued (less than `count` when the ring is full).
+ */
+size_t i2s_stream_write(i2s_stream_t* stream, const uint32_t* samples, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // hal_i2s_stream_H
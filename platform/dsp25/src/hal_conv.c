@@ -496,3 +496,207 @@ bool dma_1dConvDriver(
     }
     return true;
 }
+
+// --- DMA Streaming Driver ---
+
+static volatile bool g_conv_stream_active = false;
+
+static inline uint32_t conv_f32_add_bits(uint32_t a, uint32_t b) {
+    union { uint32_t u; float f; } x, y;
+    x.u = a;
+    y.u = b;
+    x.f += y.f;
+    return x.u;
+}
+
+static size_t conv_stream_chunk_length(const conv_dma_stream_t *s, size_t chunk) {
+    size_t remaining = s->input_length - chunk * s->chunk_length;
+    return (remaining < s->chunk_length) ? remaining : s->chunk_length;
+}
+
+static dma_transaction_t conv_stream_tx(uintptr_t addr_r, uint16_t inc_r,
+                                        uintptr_t addr_w, uint16_t inc_w, size_t packets) {
+    dma_transaction_t tx = {
+        .core            = 0,        // assigned by the ring
+        .transaction_id  = 0,        // assigned by the ring
+        .addr_r          = (uint64_t)addr_r,
+        .addr_w          = (uint64_t)addr_w,
+        .inc_r           = inc_r,
+        .inc_w           = inc_w,
+        .len             = (uint16_t)packets,
+        .logw            = DMA_WORD_LOGW,
+        .do_interrupt    = true,
+        .do_address_gate = true
+    };
+    return tx;
+}
+
+static void conv_stream_finish(conv_dma_stream_t *s, uint8_t extra_status) {
+    s->status = get_register_status() | extra_status;
+    if (extra_status != 0U) {
+        reg_write8(START_ADDR, 0);
+        reg_write8(CLEAR_ADDR, 1);
+    }
+    s->done = true;
+    g_conv_stream_active = false;
+}
+
+static void conv_stream_on_kernel(const dma_completion_t *c, void *arg);
+static void conv_stream_on_output(const dma_completion_t *c, void *arg);
+
+// Step 1: reset the datapath for the next chunk and queue its kernel load.
+static void conv_stream_arm(conv_dma_stream_t *s) {
+    size_t len = conv_stream_chunk_length(s, s->next_chunk);
+    dma_transaction_t k_tx = conv_stream_tx((uintptr_t)s->kernel, DMA_WORD_INC,
+                                            KERNEL_ADDR, 0, s->kernel_packets);
+
+    reg_write8(START_ADDR, 0);
+    reg_write8(CLEAR_ADDR, 1);
+    reg_write8(CLEAR_ADDR, 0);
+    reg_write32(LENGTH_ADDR, (uint32_t)len);
+
+    if (dma_ring_submit(DMA_KERNEL_CORE, &k_tx, conv_stream_on_kernel, s) == 0U) {
+        conv_stream_finish(s, STATUS_ERROR);
+    }
+}
+
+// Step 2: kernel is loaded; start the engine and stream the chunk through it.
+static void conv_stream_on_kernel(const dma_completion_t *c, void *arg) {
+    conv_dma_stream_t *s = (conv_dma_stream_t *)arg;
+    size_t chunk = s->next_chunk;
+    size_t len = conv_stream_chunk_length(s, chunk);
+    size_t in_packets = len / FP32_PER_PACKET;
+    uintptr_t out = (uintptr_t)(s->output + chunk * s->chunk_length);
+    dma_transaction_t out_tx[2];
+    size_t out_segments;
+    dma_transaction_t in_tx;
+
+    if (c->is_error) {
+        conv_stream_finish(s, STATUS_ERROR);
+        return;
+    }
+
+    reg_write8(START_ADDR, 1);
+
+    if (chunk + 1U == s->num_chunks) {
+        // Last chunk: its tail is the tail of the whole convolution.
+        out_tx[0] = conv_stream_tx(OUTPUT_ADDR, 0, out, DMA_WORD_INC, in_packets + s->kernel_packets);
+        out_segments = 1U;
+    } else {
+        out_tx[0] = conv_stream_tx(OUTPUT_ADDR, 0, out, DMA_WORD_INC, in_packets);
+        out_tx[1] = conv_stream_tx(OUTPUT_ADDR, 0, (uintptr_t)s->tail[chunk % CONV_DMA_STREAM_TAILS],
+                                   DMA_WORD_INC, s->kernel_packets);
+        out_segments = 2U;
+    }
+    in_tx = conv_stream_tx((uintptr_t)(s->input + chunk * s->chunk_length), DMA_WORD_INC,
+                           INPUT_ADDR, 0, in_packets);
+
+    // Output first, as in dma_1dConvDriver: its reads must be waiting when results appear.
+    if (dma_ring_submit_chain(DMA_OUTPUT_CORE, out_tx, out_segments, conv_stream_on_output, s) == 0U ||
+        dma_ring_submit(DMA_INPUT_CORE, &in_tx, 0, 0) == 0U) {
+        conv_stream_finish(s, STATUS_ERROR);
+    }
+}
+
+// Step 3: chunk drained. Arm the next chunk first so its kernel load overlaps the fold, then fold
+// the previous tail into this chunk's head. The next chunk writes a third tail buffer, so neither
+// the tail being folded nor this chunk's tail is overwritten.
+static void conv_stream_on_output(const dma_completion_t *c, void *arg) {
+    conv_dma_stream_t *s = (conv_dma_stream_t *)arg;
+    size_t chunk = s->next_chunk;
+    bool last = (chunk + 1U == s->num_chunks);
+
+    if (c->is_error || dma_ring_errors(DMA_INPUT_CORE) != 0U) {
+        conv_stream_finish(s, STATUS_ERROR);
+        return;
+    }
+
+    if (!last) {
+        s->next_chunk = chunk + 1U;
+        conv_stream_arm(s);
+    }
+
+    if (chunk > 0U) {
+        uint32_t *head = s->output + chunk * s->chunk_length;
+        const uint32_t *tail = s->tail[(chunk - 1U) % CONV_DMA_STREAM_TAILS];
+        for (size_t i = 0U; i < s->kernel_packets * FP32_PER_PACKET; ++i) {
+            head[i] = conv_f32_add_bits(head[i], tail[i]);
+        }
+    }
+    s->chunks_done = chunk + 1U;
+
+    if (last) {
+        conv_stream_finish(s, 0U);
+    }
+}
+
+int conv_dma_stream_start(conv_dma_stream_t *s, uint32_t *input, uint32_t input_length,
+                          uint32_t *kernel, uint8_t kernel_length, uint32_t *output,
+                          uint32_t chunk_length) {
+    size_t kernel_packets = 0U;
+    uint8_t kernel_len_encoding = 0U;
+
+    if (s == NULL || input == NULL || kernel == NULL || output == NULL) {
+        return -1;
+    }
+    if (conv_kernel_meta(kernel_length, &kernel_packets, &kernel_len_encoding) != 0) {
+        return -1;
+    }
+    if (chunk_length == 0U) {
+        chunk_length = CONV_DMA_STREAM_DEFAULT_CHUNK;
+    }
+    if (input_length == 0U || (input_length % FP32_PER_PACKET) != 0U ||
+        (chunk_length % FP32_PER_PACKET) != 0U || chunk_length < kernel_length ||
+        (chunk_length / FP32_PER_PACKET) + kernel_packets > 0xFFFFU) {
+        return -1;
+    }
+    if (((uintptr_t)input | (uintptr_t)kernel | (uintptr_t)output) & (DMA_WORD_INC - 1U)) {
+        return -1;
+    }
+
+    if (g_conv_stream_active) {
+        return -1;
+    }
+
+    setup_interrupts();
+    if (!dma_ring_init(DMA_KERNEL_CORE) || !dma_ring_init(DMA_INPUT_CORE) ||
+        !dma_ring_init(DMA_OUTPUT_CORE)) {
+        return -1;
+    }
+
+    s->input = input;
+    s->kernel = kernel;
+    s->output = output;
+    s->input_length = input_length;
+    s->chunk_length = chunk_length;
+    s->kernel_packets = kernel_packets;
+    s->num_chunks = (input_length + chunk_length - 1U) / chunk_length;
+    s->next_chunk = 0U;
+    s->chunks_done = 0U;
+    s->status = 0U;
+    s->done = false;
+    g_conv_stream_active = true;
+
+    conv_init();
+    reg_write8((uintptr_t)(MMIO_BASE + CONV_MMIO_RESET), 0);
+    reg_write16(DILATION_ADDR, 1);
+    reg_write8((uintptr_t)(MMIO_BASE + CONV_KERNEL_LEN_ADDR), kernel_len_encoding);
+
+    conv_stream_arm(s);
+    return 0;
+}
+
+bool conv_dma_stream_poll(conv_dma_stream_t *s) {
+    (void)dma_cq_dispatch();
+    return s->done;
+}
+
+uint8_t conv_dma_stream_wait(conv_dma_stream_t *s) {
+    while (!conv_dma_stream_poll(s)) {
+    }
+    return s->status;
+}
+
+bool conv_accelerator_busy(void) {
+    return g_conv_stream_active;
+}
@@ -0,0 +1,143 @@
+#include "hal_conv_long.h"
+#include "chip_config.h"
+
+#if defined(__riscv_vector)
+#include <riscv_vector.h>
+#endif
+
+static inline float conv_long_bits_to_f32(uint32_t x) {
+    union { uint32_t u; float f; } c;
+    c.u = x;
+    return c.f;
+}
+
+static inline uint32_t conv_long_f32_to_bits(float x) {
+    union { uint32_t u; float f; } c;
+    c.f = x;
+    return c.u;
+}
+
+// Direct form over the history: out[j] = sum_m taps[m] * x[j - m], where x[j] = history[taps_len + j].
+static void conv_long_vector_block(const conv_long_t *c, float *out, size_t b) {
+    const float *x = c->history + c->taps_len;
+
+#if defined(__riscv_vector)
+    size_t j = 0U;
+    while (j < b) {
+        size_t vl = __riscv_vsetvl_e32m8(b - j);
+        vfloat32m8_t vacc = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+        for (size_t m = 0U; m < c->taps_len; ++m) {
+            vacc = __riscv_vfmacc_vf_f32m8(vacc, c->taps[m], __riscv_vle32_v_f32m8(x + j - m, vl), vl);
+        }
+        __riscv_vse32_v_f32m8(out + j, vacc, vl);
+        j += vl;
+    }
+#else
+    for (size_t j = 0U; j < b; ++j) {
+        float acc = 0.0f;
+        for (size_t m = 0U; m < c->taps_len; ++m) {
+            acc += c->taps[m] * x[(ptrdiff_t)j - (ptrdiff_t)m];
+        }
+        out[j] = acc;
+    }
+#endif
+}
+
+// Overlap-save over all segments. Returns false (out unspecified) if any run failed.
+static bool conv_long_accel_block(conv_long_t *c, float *out, size_t b) {
+    const size_t s_len = c->segment_len;
+    const uint32_t run_len = (uint32_t)(b + s_len);
+
+    if (conv_begin_preconfigured_session(run_len, 1U, (uint8_t)s_len) != 0) {
+        return false;
+    }
+
+    for (size_t p = 0U; p < c->num_segments; ++p) {
+        uint32_t *window = (uint32_t *)(c->history + (c->num_segments - 1U - p) * s_len);
+        uint8_t status = perform_convolution_1D_preconfigured(
+            window, run_len, (uint32_t *)&c->seg_kernel[p * s_len], (uint8_t)s_len, c->hw_out);
+
+        if ((status & (STATUS_ERROR | STATUS_INVALID)) != 0U) {
+            return false;
+        }
+
+        // Outputs before S saw the zero-padded edge of the window: discard them.
+        if (p == 0U) {
+            for (size_t j = 0U; j < b; ++j) {
+                out[j] = conv_long_bits_to_f32(c->hw_out[s_len + j]);
+            }
+        } else {
+            for (size_t j = 0U; j < b; ++j) {
+                out[j] += conv_long_bits_to_f32(c->hw_out[s_len + j]);
+            }
+        }
+    }
+
+    return true;
+}
+
+int conv_long_init(conv_long_t *c, const float *ir, size_t ir_len, size_t block_len) {
+    if (c == NULL || ir == NULL || ir_len == 0U || ir_len > CONV_LONG_MAX_TAPS) {
+        return -1;
+    }
+    if (block_len < FP32_PER_PACKET || block_len > CONV_LONG_MAX_BLOCK ||
+        (block_len % FP32_PER_PACKET) != 0U) {
+        return -1;
+    }
+
+    c->segment_len = (ir_len <= 8U) ? 8U : CONV_LONG_SEGMENT;
+    c->num_segments = (ir_len + c->segment_len - 1U) / c->segment_len;
+    c->taps_len = c->num_segments * c->segment_len;
+    if (c->taps_len > CONV_LONG_MAX_TAPS) {
+        return -1;
+    }
+    c->block_len = block_len;
+    c->use_accel = true;
+    c->accel_blocks = 0U;
+    c->fallback_blocks = 0U;
+    c->accel_errors = 0U;
+
+    for (size_t m = 0U; m < c->taps_len; ++m) {
+        c->taps[m] = (m < ir_len) ? ir[m] : 0.0f;
+    }
+    for (size_t p = 0U; p < c->num_segments; ++p) {
+        for (size_t k = 0U; k < c->segment_len; ++k) {
+            c->seg_kernel[p * c->segment_len + k] =
+                conv_long_f32_to_bits(c->taps[p * c->segment_len + (c->segment_len - 1U - k)]);
+        }
+    }
+
+    conv_long_reset(c);
+    return 0;
+}
+
+void conv_long_reset(conv_long_t *c) {
+    memset(c->history, 0, sizeof(c->history));
+}
+
+void conv_long_process(conv_long_t *c, const float *in, float *out, size_t n) {
+    while (n > 0U) {
+        size_t b = (n < c->block_len) ? n : c->block_len;
+        bool done = false;
+
+        memcpy(c->history + c->taps_len, in, b * sizeof(float));
+
+        if (c->use_accel && (b % FP32_PER_PACKET) == 0U && !conv_accelerator_busy()) {
+            done = conv_long_accel_block(c, out, b);
+            if (done) {
+                c->accel_blocks++;
+            } else {
+                c->accel_errors++;
+            }
+        }
+        if (!done) {
+            conv_long_vector_block(c, out, b);
+            c->fallback_blocks++;
+        }
+
+        memmove(c->history, c->history + b, c->taps_len * sizeof(float));
+        in += b;
+        out += b;
+        n -= b;
+    }
+}
@@ -55,6 +55,39 @@ typedef struct {
 
 static dma_completion_slot_t g_completion_slots[DMA_MAX_TRACKED_TRANSACTIONS];
 
+_Static_assert((DMA_RING_DEPTH & (DMA_RING_DEPTH - 1U)) == 0U, "DMA_RING_DEPTH must be a power of two");
+_Static_assert((DMA_CQ_DEPTH & (DMA_CQ_DEPTH - 1U)) == 0U, "DMA_CQ_DEPTH must be a power of two");
+_Static_assert(DMA_RING_DEPTH <= DMA_RING_TID_SEQ_MASK, "DMA_RING_DEPTH exceeds the transaction id sequence field");
+_Static_assert(DMA_TOTAL_CHANNEL_COUNT <= 8U, "ring transaction ids encode the channel in 3 bits");
+
+/* head = descriptors submitted, tail = descriptors retired; slot of descriptor n is (n - 1) & mask.
+ * Only the owner hart touches a ring, the submit path from main code and the retire path from the
+ * interrupt handler, which cannot interleave with each other except by the handler preempting
+ * main code. */
+typedef struct {
+  dma_transaction_t desc[DMA_RING_DEPTH];
+  dma_callback_t callback[DMA_RING_DEPTH];
+  void *arg[DMA_RING_DEPTH];
+  uint32_t head;
+  uint32_t tail;
+  uint32_t active;
+  uint32_t errors;
+  uint8_t hart;
+  bool ready;
+} dma_ring_t;
+
+typedef struct {
+  dma_completion_t entry[DMA_CQ_DEPTH];
+  uint32_t head;
+  uint32_t tail;
+  uint32_t overflows;
+} dma_cq_t;
+
+static dma_ring_t g_rings[DMA_TOTAL_CHANNEL_COUNT];
+static dma_cq_t g_cqs[DMA_HART_COUNT];
+
+static bool ring_complete(size_t mhartid, uint16_t tid, bool is_error, uint64_t address);
+
 static uintptr_t dma_channel_offset(uint32_t channel) {
   return ((uintptr_t)channel) * CHANNEL_OFFSET;
 }
@@ -167,8 +200,9 @@ static bool set_DMA_common(uint32_t channel, dma_transaction_t transaction, bool
 }
 
 void setup_interrupts(void) {
-  reg_write32(PLIC_ENABLE_CORE_0, (1U << DMA_INTERRUPT_ID_CORE_0));
-  reg_write32(PLIC_ENABLE_CORE_1, (1U << DMA_INTERRUPT_ID_CORE_1));
+  /* Read-modify-write: keep sources enabled through setup_external_interrupt. */
+  reg_write32(PLIC_ENABLE_CORE_0, reg_read32(PLIC_ENABLE_CORE_0) | (1U << DMA_INTERRUPT_ID_CORE_0));
+  reg_write32(PLIC_ENABLE_CORE_1, reg_read32(PLIC_ENABLE_CORE_1) | (1U << DMA_INTERRUPT_ID_CORE_1));
 
   reg_write32(PLIC_PRIO_DMA_CORE_0, 5U);
   reg_write32(PLIC_PRIO_DMA_CORE_1, 5U);
@@ -177,6 +211,74 @@ void setup_interrupts(void) {
   set_csr(mstatus, MSTATUS_MIE);
 }
 
+void setup_external_interrupt(uint32_t irq_id, uint32_t priority) {
+  size_t mhartid = read_csr(mhartid);
+  uintptr_t enable = ((mhartid == 0U) ? PLIC_ENABLE_CORE_0 : PLIC_ENABLE_CORE_1) + 4UL * (irq_id / 32U);
+
+  if (irq_id == 0U || mhartid >= DMA_HART_COUNT) {
+    return;
+  }
+  reg_write32(PLIC_BASE + 4UL * irq_id, priority);
+  reg_write32(enable, reg_read32(enable) | (1U << (irq_id % 32U)));
+  set_csr(mie, MIP_MEIP);
+  set_csr(mstatus, MSTATUS_MIE);
+}
+
+typedef struct {
+  uint32_t irq_id;
+  platform_irq_handler_t handler;
+  void *arg;
+} platform_irq_slot_t;
+
+static platform_irq_slot_t g_platform_irqs[PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS];
+
+int platform_external_irq_register(uint32_t irq_id, platform_irq_handler_t handler, void *arg) {
+  platform_irq_slot_t *free_slot = NULL;
+
+  if (irq_id == 0U || handler == NULL) {
+    return -1;
+  }
+  for (size_t i = 0; i < PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS; i++) {
+    platform_irq_slot_t *slot = &g_platform_irqs[i];
+    if (slot->irq_id == irq_id && slot->handler == handler && slot->arg == arg) {
+      return 0;
+    }
+    if (slot->irq_id == 0U && free_slot == NULL) {
+      free_slot = slot;
+    }
+  }
+  if (free_slot == NULL) {
+    return -1;
+  }
+  free_slot->handler = handler;
+  free_slot->arg = arg;
+  __atomic_store_n(&free_slot->irq_id, irq_id, __ATOMIC_RELEASE);  /* publish last */
+  return 0;
+}
+
+void platform_external_irq_unregister(uint32_t irq_id, platform_irq_handler_t handler, void *arg) {
+  for (size_t i = 0; i < PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS; i++) {
+    platform_irq_slot_t *slot = &g_platform_irqs[i];
+    if (slot->irq_id == irq_id && slot->handler == handler && slot->arg == arg) {
+      __atomic_store_n(&slot->irq_id, 0U, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+static void platform_external_irq_dispatch(uint32_t irq_id) {
+  for (size_t i = 0; i < PLATFORM_EXTERNAL_IRQ_MAX_HANDLERS; i++) {
+    platform_irq_slot_t *slot = &g_platform_irqs[i];
+    if (__atomic_load_n(&slot->irq_id, __ATOMIC_ACQUIRE) == irq_id) {
+      slot->handler(irq_id, slot->arg);
+    }
+  }
+  platform_external_irq_callback(irq_id);
+}
+
+__attribute__((weak)) void platform_external_irq_callback(uint32_t irq_id) {
+  (void)irq_id;
+}
+
 void machine_external_interrupt_callback(void) {
   size_t mhartid = read_csr(mhartid);
   uintptr_t plic_claim_addr;
@@ -199,9 +301,15 @@ void machine_external_interrupt_callback(void) {
 
   if (irq_id == expected_irq) {
     uint16_t tid = reg_read16(DMA_INT_TID + core_offset);
+    bool is_error = reg_read8(DMA_INT_IS_ERROR + core_offset) != 0;
+    uint64_t address = reg_read64(DMA_INT_ADDRESS + core_offset);
 
     reg_write8(DMA_INT_SERVICED + core_offset, 1U);
-    tracker_complete(tid);
+    if (!ring_complete(mhartid, tid, is_error, address)) {
+      tracker_complete(tid);
+    }
+  } else if (irq_id != 0U) {
+    platform_external_irq_dispatch((uint32_t)irq_id);
   }
 
   if (irq_id != 0U) {
@@ -312,23 +420,29 @@ bool dma_poll_interrupt(size_t mhartid, dma_interrupt_t *out) {
   uintptr_t core_offset = dma_core_offset(mhartid);
   bool valid = reg_read8(DMA_INT_VALID + core_offset) != 0;
   uint16_t tid;
+  bool is_error;
+  uint64_t address;
 
   if (!valid) {
     return false;
   }
 
   tid = reg_read16(DMA_INT_TID + core_offset);
+  is_error = (reg_read8(DMA_INT_IS_ERROR + core_offset) != 0);
+  address = reg_read64(DMA_INT_ADDRESS + core_offset);
 
   if (out != 0) {
     out->valid = true;
     out->core_id = (uint8_t)mhartid;
     out->transaction_id = tid;
-    out->is_error = (reg_read8(DMA_INT_IS_ERROR + core_offset) != 0);
-    out->address = reg_read64(DMA_INT_ADDRESS + core_offset);
+    out->is_error = is_error;
+    out->address = address;
   }
 
   reg_write8(DMA_INT_SERVICED + core_offset, 1U);
-  tracker_complete(tid);
+  if (!ring_complete(mhartid, tid, is_error, address)) {
+    tracker_complete(tid);
+  }
 
   return true;
 }
@@ -346,6 +460,223 @@ void dma_wait_till_done(size_t mhartid, bool *finished) {
   }
 }
 
+static bool ring_channel_valid(uint32_t channel) {
+  return (channel < DMA_TOTAL_CHANNEL_COUNT) && g_rings[channel].ready &&
+         (g_rings[channel].hart == (uint8_t)read_csr(mhartid));
+}
+
+/* Program and start the oldest queued descriptor. Caller guarantees the ring is not empty and
+ * nothing of this ring is on the channel. */
+static void ring_start(uint32_t channel, dma_ring_t *ring) {
+  uint32_t seq = ring->tail + 1U;
+  dma_transaction_t transaction = ring->desc[ring->tail & (DMA_RING_DEPTH - 1U)];
+
+  transaction.core = ring->hart;
+  transaction.transaction_id = DMA_RING_TID(channel, seq);
+  transaction.do_interrupt = true;
+  if (dma_channel_is_core(channel)) {
+    (void)set_DMA_C(channel, transaction, true);
+  } else {
+    (void)set_DMA_P(channel, transaction, true);
+  }
+  start_DMA(channel, transaction.transaction_id, 0);
+}
+
+static void cq_push(size_t mhartid, const dma_completion_t *completion) {
+  dma_cq_t *cq = &g_cqs[mhartid];
+  uint32_t head = cq->head;
+
+  if ((head - __atomic_load_n(&cq->tail, __ATOMIC_ACQUIRE)) >= DMA_CQ_DEPTH) {
+    cq->overflows++;
+    return;
+  }
+  cq->entry[head & (DMA_CQ_DEPTH - 1U)] = *completion;
+  __atomic_store_n(&cq->head, head + 1U, __ATOMIC_RELEASE);
+}
+
+/* Retire the descriptor a ring transaction id refers to, post its completion and start the next
+ * one. Returns false for ids that do not belong to a ring. */
+static bool ring_complete(size_t mhartid, uint16_t tid, bool is_error, uint64_t address) {
+  uint32_t channel;
+  dma_ring_t *ring;
+  uint32_t seq;
+  uint32_t slot;
+
+  if ((tid & DMA_RING_TID_FLAG) == 0U) {
+    return false;
+  }
+  channel = ((uint32_t)tid >> 11) & 0x7U;
+  if (channel >= DMA_TOTAL_CHANNEL_COUNT || mhartid >= DMA_HART_COUNT) {
+    return true;
+  }
+  ring = &g_rings[channel];
+  seq = ring->tail + 1U;
+  if (!ring->active || (seq & DMA_RING_TID_SEQ_MASK) != ((uint32_t)tid & DMA_RING_TID_SEQ_MASK)) {
+    return true; /* stale or duplicate completion */
+  }
+
+  slot = ring->tail & (DMA_RING_DEPTH - 1U);
+  if (is_error) {
+    ring->errors++;
+  }
+  if (is_error || ring->callback[slot] != 0) {
+    dma_completion_t completion;
+
+    completion.channel = (uint8_t)channel;
+    completion.transaction_id = tid;
+    completion.is_error = is_error;
+    completion.address = address;
+    completion.seq = seq;
+    completion.callback = ring->callback[slot];
+    completion.arg = ring->arg[slot];
+    cq_push(mhartid, &completion);
+  }
+
+  __atomic_store_n(&ring->tail, seq, __ATOMIC_RELEASE);
+  if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != seq) {
+    ring_start(channel, ring);
+  } else {
+    __atomic_store_n(&ring->active, 0U, __ATOMIC_RELEASE);
+  }
+
+  return true;
+}
+
+bool dma_ring_init(uint32_t channel) {
+  dma_ring_t *ring;
+
+  if (channel >= DMA_TOTAL_CHANNEL_COUNT) {
+    printf("[dma] dma_ring_init invalid channel %u\n", (unsigned)channel);
+    return false;
+  }
+  ring = &g_rings[channel];
+  if (ring->ready && __atomic_load_n(&ring->active, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+
+  ring->head = 0U;
+  ring->tail = 0U;
+  ring->active = 0U;
+  ring->errors = 0U;
+  ring->hart = (uint8_t)read_csr(mhartid);
+  ring->ready = true;
+
+  return true;
+}
+
+uint32_t dma_ring_free(uint32_t channel) {
+  dma_ring_t *ring;
+
+  if (!ring_channel_valid(channel)) {
+    return 0U;
+  }
+  ring = &g_rings[channel];
+  return DMA_RING_DEPTH - (ring->head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+}
+
+uint32_t dma_ring_submit_chain(uint32_t channel, const dma_transaction_t *segments, size_t count,
+                               dma_callback_t callback, void *arg) {
+  dma_ring_t *ring;
+  uint32_t head;
+  size_t i;
+
+  if (count == 0U || segments == 0 || dma_ring_free(channel) < count) {
+    return 0U;
+  }
+  ring = &g_rings[channel];
+  head = ring->head;
+
+  for (i = 0; i < count; ++i) {
+    uint32_t slot = (head + (uint32_t)i) & (DMA_RING_DEPTH - 1U);
+    bool last = (i + 1U) == count;
+
+    ring->desc[slot] = segments[i];
+    ring->callback[slot] = last ? callback : 0;
+    ring->arg[slot] = last ? arg : 0;
+  }
+  head += (uint32_t)count;
+  __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+
+  /* An idle ring has no completion interrupt coming to pick the chain up: start it here. When the
+   * ring is active, the handler sees the new head on its next retire. */
+  if (!__atomic_load_n(&ring->active, __ATOMIC_ACQUIRE)) {
+    ring->active = 1U;
+    ring_start(channel, ring);
+  }
+
+  return head;
+}
+
+uint32_t dma_ring_submit(uint32_t channel, const dma_transaction_t *transaction,
+                         dma_callback_t callback, void *arg) {
+  return dma_ring_submit_chain(channel, transaction, 1U, callback, arg);
+}
+
+bool dma_ring_done(uint32_t channel, uint32_t seq) {
+  if (channel >= DMA_TOTAL_CHANNEL_COUNT) {
+    return true;
+  }
+  return (int32_t)(__atomic_load_n(&g_rings[channel].tail, __ATOMIC_ACQUIRE) - seq) >= 0;
+}
+
+void dma_ring_wait(uint32_t channel, uint32_t seq) {
+  while (!dma_ring_done(channel, seq)) {
+    (void)dma_cq_dispatch();
+  }
+  (void)dma_cq_dispatch();
+}
+
+uint32_t dma_ring_errors(uint32_t channel) {
+  if (channel >= DMA_TOTAL_CHANNEL_COUNT) {
+    return 0U;
+  }
+  return g_rings[channel].errors;
+}
+
+bool dma_cq_pop(dma_completion_t *out) {
+  size_t mhartid = read_csr(mhartid);
+  dma_cq_t *cq;
+  uint32_t tail;
+
+  if (mhartid >= DMA_HART_COUNT) {
+    return false;
+  }
+  cq = &g_cqs[mhartid];
+  tail = cq->tail;
+  if (tail == __atomic_load_n(&cq->head, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  if (out != 0) {
+    *out = cq->entry[tail & (DMA_CQ_DEPTH - 1U)];
+  }
+  __atomic_store_n(&cq->tail, tail + 1U, __ATOMIC_RELEASE);
+
+  return true;
+}
+
+size_t dma_cq_dispatch(void) {
+  dma_completion_t completion;
+  size_t n = 0;
+
+  while (dma_cq_pop(&completion)) {
+    if (completion.callback != 0) {
+      completion.callback(&completion, completion.arg);
+    }
+    n++;
+  }
+
+  return n;
+}
+
+uint32_t dma_cq_overflows(void) {
+  size_t mhartid = read_csr(mhartid);
+
+  if (mhartid >= DMA_HART_COUNT) {
+    return 0U;
+  }
+  return g_cqs[mhartid].overflows;
+}
+
 #define CHECK_VAL_BODY(bits) \
   do { \
     unsigned int poll = reg_read##bits(addr); \
@@ -395,5 +726,16 @@ size_t ticks(void) {
 }
 
 void end_dma(void) {
+  size_t i;
+
   tracker_clear();
+  for (i = 0; i < DMA_TOTAL_CHANNEL_COUNT; ++i) {
+    g_rings[i].ready = false;
+    g_rings[i].active = 0U;
+  }
+  for (i = 0; i < DMA_HART_COUNT; ++i) {
+    g_cqs[i].head = 0U;
+    g_cqs[i].tail = 0U;
+    g_cqs[i].overflows = 0U;
+  }
 }
@@ -0,0 +1,232 @@
+#include "hal_dma.h"
+#include "chip_config.h"
+#include <string.h>
+
+#define DMA_MEMCPY_HART_COUNT DMA_HART_COUNT
+
+_Static_assert(DMA_MEMCPY_CHANNEL + DMA_MEMCPY_HART_COUNT <= DMA_CORE_CHANNEL_COUNT,
+               "each hart needs its own core channel for dma_memcpy");
+
+static bool g_memcpy_ready[DMA_MEMCPY_HART_COUNT];
+static size_t g_memcpy_threshold = DMA_MEMCPY_DEFAULT_THRESHOLD;
+
+/* memset source: the DMA reads the same packet over and over (inc_r = 0). */
+static uint64_t g_memset_pattern[DMA_MEMCPY_HART_COUNT] __attribute__((aligned(8)));
+
+static uint32_t memcpy_channel(size_t mhartid) {
+  return DMA_MEMCPY_CHANNEL + (uint32_t)mhartid;
+}
+
+static bool memcpy_hart_ready(size_t *mhartid) {
+  size_t hart = read_csr(mhartid);
+
+  if (hart >= DMA_MEMCPY_HART_COUNT || !g_memcpy_ready[hart]) {
+    return false;
+  }
+  /* Completion comes by interrupt: with MIE clear (trap handler, critical section) it never would. */
+  if ((read_csr(mstatus) & MSTATUS_MIE) == 0U) {
+    return false;
+  }
+  *mhartid = hart;
+  return true;
+}
+
+/* Short copies around the DMA body; a plain loop so the --wrap=memcpy override never recurses. */
+static void cpu_copy_bytes(uint8_t *dst, const uint8_t *src, size_t n) {
+  while (n--) {
+    *dst++ = *src++;
+  }
+}
+
+static uint8_t body_logw(uintptr_t dst, uintptr_t src) {
+  return (((dst ^ src) & 7U) == 0U) ? 3U : 2U;
+}
+
+/* Queue the packet-aligned body as a chain of segments of at most DMA_MEMCPY_MAX_PACKETS packets,
+ * waiting for ring space as needed. inc_r = 0 replays one source packet (memset). */
+static uint32_t dma_submit_body(uint32_t channel, uintptr_t dst, uintptr_t src, size_t bytes,
+                                uint8_t logw, uint16_t inc_r, dma_callback_t callback, void *arg) {
+  const size_t max_bytes = (size_t)DMA_MEMCPY_MAX_PACKETS << logw;
+  dma_transaction_t segs[DMA_RING_DEPTH];
+  uint32_t seq = 0;
+
+  while (bytes > 0U) {
+    uint32_t free_slots;
+    size_t count = 0;
+
+    while ((free_slots = dma_ring_free(channel)) == 0U) {
+      (void)dma_cq_dispatch();
+    }
+    while (bytes > 0U && count < free_slots) {
+      size_t chunk = (bytes < max_bytes) ? bytes : max_bytes;
+      dma_transaction_t *tx = &segs[count++];
+
+      tx->core = 0;
+      tx->transaction_id = 0;
+      tx->transaction_priority = 1;
+      tx->peripheral_id = 0;
+      tx->addr_r = src;
+      tx->addr_w = dst;
+      tx->inc_r = inc_r;
+      tx->inc_w = (uint16_t)(1U << logw);
+      tx->len = (uint16_t)(chunk >> logw);
+      tx->logw = logw;
+      tx->do_interrupt = true;
+      tx->do_address_gate = false;
+
+      dst += chunk;
+      if (inc_r != 0U) {
+        src += chunk;
+      }
+      bytes -= chunk;
+    }
+    seq = dma_ring_submit_chain(channel, segs, count, (bytes == 0U) ? callback : 0,
+                                (bytes == 0U) ? arg : 0);
+  }
+
+  return seq;
+}
+
+bool dma_memcpy_init(void) {
+  size_t hart = read_csr(mhartid);
+
+  if (hart >= DMA_MEMCPY_HART_COUNT) {
+    return false;
+  }
+  setup_interrupts();
+  g_memcpy_ready[hart] = dma_ring_init(memcpy_channel(hart));
+
+  return g_memcpy_ready[hart];
+}
+
+bool dma_memcpy_offloadable(const void *dst, const void *src, size_t n) {
+  size_t hart;
+
+  if (n < g_memcpy_threshold || (((uintptr_t)dst ^ (uintptr_t)src) & 3U) != 0U) {
+    return false;
+  }
+  return memcpy_hart_ready(&hart);
+}
+
+uint32_t dma_memcpy_async(void *dst, const void *src, size_t n, dma_callback_t callback, void *arg) {
+  uintptr_t d = (uintptr_t)dst;
+  uintptr_t s = (uintptr_t)src;
+  size_t hart;
+  uint8_t logw;
+  size_t head;
+  size_t body;
+
+  if (!dma_memcpy_offloadable(dst, src, n) || !memcpy_hart_ready(&hart)) {
+    memcpy(dst, src, n);
+    if (callback != 0) {
+      dma_completion_t completion = {0};
+      completion.callback = callback;
+      completion.arg = arg;
+      callback(&completion, arg);
+    }
+    return 0U;
+  }
+
+  logw = body_logw(d, s);
+  head = (size_t)((-d) & ((1U << logw) - 1U));
+  body = (n - head) & ~(size_t)((1U << logw) - 1U);
+
+  cpu_copy_bytes((uint8_t *)d, (const uint8_t *)s, head);
+  cpu_copy_bytes((uint8_t *)(d + head + body), (const uint8_t *)(s + head + body), n - head - body);
+
+  return dma_submit_body(memcpy_channel(hart), d + head, s + head, body, logw,
+                         (uint16_t)(1U << logw), callback, arg);
+}
+
+void dma_memcpy_wait(uint32_t seq) {
+  if (seq != 0U) {
+    dma_ring_wait(memcpy_channel(read_csr(mhartid)), seq);
+  }
+}
+
+void *dma_memcpy(void *dst, const void *src, size_t n) {
+  dma_memcpy_wait(dma_memcpy_async(dst, src, n, 0, 0));
+  return dst;
+}
+
+void *dma_memset(void *dst, int c, size_t n) {
+  uintptr_t d = (uintptr_t)dst;
+  size_t hart;
+  size_t head;
+  size_t body;
+  uint8_t *p;
+
+  if (n < g_memcpy_threshold || !memcpy_hart_ready(&hart)) {
+    return memset(dst, c, n);
+  }
+
+  head = (size_t)((-d) & 7U);
+  body = (n - head) & ~(size_t)7U;
+  p = (uint8_t *)dst;
+  for (size_t i = 0; i < head; ++i) {
+    p[i] = (uint8_t)c;
+  }
+  for (size_t i = head + body; i < n; ++i) {
+    p[i] = (uint8_t)c;
+  }
+
+  /* The pattern is shared by every memset on this hart, so this one completes before returning. */
+  g_memset_pattern[hart] = 0x0101010101010101ULL * (uint8_t)c;
+  dma_ring_wait(memcpy_channel(hart),
+                dma_submit_body(memcpy_channel(hart), d + head, (uintptr_t)&g_memset_pattern[hart],
+                                body, 3U, 0U, 0, 0));
+  return dst;
+}
+
+size_t dma_memcpy_threshold(void) {
+  return g_memcpy_threshold;
+}
+
+void dma_memcpy_set_threshold(size_t bytes) {
+  g_memcpy_threshold = (bytes < DMA_MEMCPY_MIN_THRESHOLD) ? DMA_MEMCPY_MIN_THRESHOLD : bytes;
+}
+
+size_t dma_memcpy_calibrate(void *scratch, size_t bytes) {
+  uint8_t *src = (uint8_t *)(((uintptr_t)scratch + 7U) & ~(uintptr_t)7U);
+  size_t half = ((bytes - (size_t)(src - (uint8_t *)scratch)) / 2U) & ~(size_t)7U;
+  uint8_t *dst = src + half;
+  size_t threshold = SIZE_MAX;
+  size_t saved = g_memcpy_threshold;
+  size_t hart;
+
+  if (!memcpy_hart_ready(&hart) || half < DMA_MEMCPY_MIN_THRESHOLD) {
+    return g_memcpy_threshold;
+  }
+
+  /* Keep --wrap=memcpy on the CPU path while the CPU side is timed. */
+  g_memcpy_threshold = SIZE_MAX;
+  for (size_t n = DMA_MEMCPY_MIN_THRESHOLD; n <= half; n *= 2U) {
+    size_t t0, cpu_ticks, dma_ticks;
+
+    memcpy(dst, src, n); /* warm both buffers, as the bench does for each size */
+    t0 = ticks();
+    memcpy(dst, src, n);
+    cpu_ticks = ticks() - t0;
+
+    t0 = ticks();
+    dma_ring_wait(memcpy_channel(hart),
+                  dma_submit_body(memcpy_channel(hart), (uintptr_t)dst, (uintptr_t)src, n, 3U, 8U, 0, 0));
+    dma_ticks = ticks() - t0;
+
+    if (dma_ticks < cpu_ticks) {
+      if (threshold == SIZE_MAX) {
+        threshold = n;
+      }
+    } else {
+      threshold = SIZE_MAX;
+    }
+  }
+
+  g_memcpy_threshold = saved;
+  if (threshold != SIZE_MAX) {
+    dma_memcpy_set_threshold(threshold);
+  } else {
+    g_memcpy_threshold = SIZE_MAX;
+  }
+  return g_memcpy_threshold;
+}
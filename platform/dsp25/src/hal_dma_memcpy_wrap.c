@@ -0,0 +1,12 @@
+#include "hal_dma.h"
+
+/* Opt-in libc override, only linked into targets built with -Wl,--wrap=memcpy. Kept out of
+ * hal_dma_memcpy.c so targets without the wrap never reference __real_memcpy. */
+extern void *__real_memcpy(void *dst, const void *src, size_t n);
+
+void *__wrap_memcpy(void *dst, const void *src, size_t n) {
+  if (dma_memcpy_offloadable(dst, src, n)) {
+    return dma_memcpy(dst, src, n);
+  }
+  return __real_memcpy(dst, src, n);
+}
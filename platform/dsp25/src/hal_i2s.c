@@ -39,23 +39,21 @@ int get_I2S_rx_empty(int channel, i2s_channel_side_t left_right) {
 }
 
 int get_I2S_tx_watermark(int channel, i2s_channel_side_t left_right) {
-    volatile int *watermark_reg;
+    // Single-byte registers at odd offsets: a wider access is misaligned and hangs the core.
     if (left_right == I2S_LEFT) {
-        watermark_reg = (volatile int *)(I2S_WATERMARK_TX_L(channel));
+        return reg_read8(I2S_WATERMARK_TX_L(channel));
     } else {
-        watermark_reg = (volatile int *)(I2S_WATERMARK_TX_R(channel));
+        return reg_read8(I2S_WATERMARK_TX_R(channel));
     }
-    return *watermark_reg;
 }
 
 int get_I2S_rx_watermark(int channel, i2s_channel_side_t left_right) {
-    volatile int *watermark_reg;
+    // Single-byte registers at odd offsets: a wider access is misaligned and hangs the core.
     if (left_right == I2S_LEFT) {
-        watermark_reg = (volatile int *)(I2S_WATERMARK_RX_L(channel));
+        return reg_read8(I2S_WATERMARK_RX_L(channel));
     } else {
-        watermark_reg = (volatile int *)(I2S_WATERMARK_RX_R(channel));
+        return reg_read8(I2S_WATERMARK_RX_R(channel));
     }
-    return *watermark_reg;
 }
 
 void set_I2S_clkdiv(int channel, uint16_t clkdiv) {
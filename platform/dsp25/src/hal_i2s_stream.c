@@ -0,0 +1,332 @@
+#include "hal_i2s_stream.h"
+#include "hal_mmio.h"
+
+static i2s_stream_t* g_irq_streams[I2S_STREAM_MAX_IRQ_STREAMS];
+
+static inline uint64_t stream_load(const volatile uint64_t* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void stream_store(volatile uint64_t* p, uint64_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static uintptr_t stream_fifo_addr(const i2s_stream_config_t* cfg) {
+    if (cfg->dir == I2S_STREAM_RX) {
+        return (cfg->side == I2S_LEFT) ? I2S_RX_L(cfg->channel) : I2S_RX_R(cfg->channel);
+    }
+    return (cfg->side == I2S_LEFT) ? I2S_TX_L(cfg->channel) : I2S_TX_R(cfg->channel);
+}
+
+// Copy the part of ring range [idx, idx + count) that falls in the first window - 1 samples
+// behind the end of the ring, so a view starting near the end stays contiguous.
+static void stream_mirror(i2s_stream_t* s, uint32_t idx, uint32_t count) {
+    const uint32_t mirror_len = s->cfg.window - 1U;
+    uint32_t* buf = s->cfg.buffer;
+
+    if (idx >= mirror_len) {
+        return;
+    }
+    if (count > mirror_len - idx) {
+        count = mirror_len - idx;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        buf[s->cfg.capacity + idx + i] = buf[idx + i];
+    }
+}
+
+// ================================
+//  Watermark (CPU) transfer
+// ================================
+
+static void stream_rx_drain(i2s_stream_t* s) {
+    const uintptr_t fifo = stream_fifo_addr(&s->cfg);
+    uint64_t head = s->head;
+
+    while (!get_I2S_rx_empty(s->cfg.channel, s->cfg.side)) {
+        uint64_t block = reg_read64(fifo);
+        uint32_t idx;
+
+        // Ring full: drop the block rather than leave the FIFO (and the interrupt) asserted.
+        if (head + 2U - stream_load(&s->tail) > s->cfg.capacity) {
+            s->overruns++;
+            continue;
+        }
+        idx = (uint32_t)(head % s->cfg.capacity);
+        s->cfg.buffer[idx] = (uint32_t)block;
+        s->cfg.buffer[idx + 1U] = (uint32_t)(block >> 32);
+        stream_mirror(s, idx, 2U);
+        head += 2U;
+    }
+    stream_store(&s->head, head);
+}
+
+static void stream_tx_fill(i2s_stream_t* s, bool from_irq) {
+    const uintptr_t fifo = stream_fifo_addr(&s->cfg);
+    uint64_t tail = s->tail;
+    uint64_t head = stream_load(&s->head);
+
+    while (!get_I2S_tx_full(s->cfg.channel, s->cfg.side)) {
+        uint32_t idx;
+
+        if (head - tail < 2U) {
+            // Below the watermark with nothing queued: send silence so the interrupt deasserts.
+            if (from_irq) {
+                s->underruns++;
+                reg_write64(fifo, 0U);
+            }
+            break;
+        }
+        idx = (uint32_t)(tail % s->cfg.capacity);
+        reg_write64(fifo, (uint64_t)s->cfg.buffer[idx] | ((uint64_t)s->cfg.buffer[idx + 1U] << 32));
+        tail += 2U;
+    }
+    stream_store(&s->tail, tail);
+}
+
+static void stream_service_watermark(i2s_stream_t* s, bool from_irq) {
+    if (s->cfg.dir == I2S_STREAM_RX) {
+        stream_rx_drain(s);
+    } else {
+        stream_tx_fill(s, from_irq);
+    }
+}
+
+// Registered with platform_external_irq_register for each watermark IRQ in use.
+static void stream_watermark_irq(uint32_t irq_id, void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < I2S_STREAM_MAX_IRQ_STREAMS; i++) {
+        i2s_stream_t* s = g_irq_streams[i];
+        if (s != NULL && s->running && I2S_STREAM_WATERMARK_IRQ(s->cfg.channel) == irq_id) {
+            stream_service_watermark(s, true);
+        }
+    }
+}
+
+// ================================
+//  DMA transfer
+// ================================
+
+static dma_transaction_t stream_dma_tx(const i2s_stream_t* s, uintptr_t ring_addr) {
+    const uintptr_t fifo = stream_fifo_addr(&s->cfg);
+    const bool rx = (s->cfg.dir == I2S_STREAM_RX);
+    dma_transaction_t tx = {
+        .core            = 0,        // assigned by the ring
+        .transaction_id  = 0,        // assigned by the ring
+        .peripheral_id   = I2S_STREAM_DMA_PERIPHERAL_ID,
+        .addr_r          = (uint64_t)(rx ? fifo : ring_addr),
+        .addr_w          = (uint64_t)(rx ? ring_addr : fifo),
+        .inc_r           = rx ? 0 : 8,
+        .inc_w           = rx ? 8 : 0,
+        .len             = (uint16_t)(s->cfg.period / 2U),   // 64-bit blocks
+        .logw            = 3,
+        .do_interrupt    = true,
+        .do_address_gate = true
+    };
+    return tx;
+}
+
+static void stream_dma_arm(i2s_stream_t* s);
+
+static void stream_on_dma_period(const dma_completion_t* c, void* arg) {
+    i2s_stream_t* s = (i2s_stream_t*)arg;
+    const uint32_t period = s->cfg.period;
+
+    if (c->is_error) {
+        s->dma_errors++;
+    }
+
+    if (s->cfg.dir == I2S_STREAM_RX) {
+        stream_mirror(s, (uint32_t)(s->head % s->cfg.capacity), period);
+        stream_store(&s->head, s->head + period);
+    } else {
+        stream_store(&s->tail, s->tail + period);
+    }
+
+    stream_dma_arm(s);
+    if (s->running && s->dma_pos == ((s->cfg.dir == I2S_STREAM_RX) ? s->head : s->tail)) {
+        // Nothing left queued: RX has no free period (the FIFO will overflow), TX ran dry.
+        if (s->cfg.dir == I2S_STREAM_RX) {
+            s->overruns++;
+        } else {
+            s->underruns++;
+        }
+    }
+}
+
+// Queue as many whole periods as the ring allows (RX: free space, TX: queued samples).
+static void stream_dma_arm(i2s_stream_t* s) {
+    const uint32_t period = s->cfg.period;
+
+    while (s->running && dma_ring_free(s->cfg.dma_channel) > 0U) {
+        dma_transaction_t tx;
+
+        if (s->cfg.dir == I2S_STREAM_RX) {
+            if (s->dma_pos + period - stream_load(&s->tail) > s->cfg.capacity) {
+                break;
+            }
+        } else if (stream_load(&s->head) - s->dma_pos < period) {
+            break;
+        }
+
+        tx = stream_dma_tx(s, (uintptr_t)&s->cfg.buffer[s->dma_pos % s->cfg.capacity]);
+        if (dma_ring_submit(s->cfg.dma_channel, &tx, stream_on_dma_period, s) == 0U) {
+            break;
+        }
+        s->dma_pos += period;
+    }
+}
+
+// ================================
+//  Public API
+// ================================
+
+int i2s_stream_init(i2s_stream_t* stream, const i2s_stream_config_t* config) {
+    i2s_stream_config_t cfg;
+
+    if (stream == NULL || config == NULL || config->buffer == NULL) {
+        return -1;
+    }
+    cfg = *config;
+    if (cfg.dir == I2S_STREAM_TX) {
+        cfg.window = 1U;
+        cfg.hop = 1U;
+    }
+
+    if (((uintptr_t)cfg.buffer & 7U) != 0U || cfg.period == 0U || (cfg.period % 2U) != 0U ||
+        (cfg.period / 2U) > 0xFFFFU || cfg.capacity == 0U || (cfg.capacity % cfg.period) != 0U) {
+        return -1;
+    }
+    if (cfg.window == 0U || cfg.hop == 0U || cfg.hop > cfg.window ||
+        cfg.capacity < cfg.window + cfg.period) {
+        return -1;
+    }
+    if (cfg.mode == I2S_STREAM_DMA &&
+        (cfg.dma_channel < DMA_CORE_CHANNEL_COUNT || cfg.dma_channel >= DMA_TOTAL_CHANNEL_COUNT)) {
+        return -1;
+    }
+
+    stream->cfg = cfg;
+    stream->head = 0U;
+    stream->tail = 0U;
+    stream->dma_pos = 0U;
+    stream->overruns = 0U;
+    stream->underruns = 0U;
+    stream->dma_errors = 0U;
+    stream->running = false;
+    return 0;
+}
+
+int i2s_stream_start(i2s_stream_t* stream) {
+    const i2s_stream_config_t* cfg = &stream->cfg;
+    volatile i2s_config_t* reg = (i2s_config_t*)I2S_CONFIG(cfg->channel);
+    i2s_config_t config;
+
+    if (cfg->mode == I2S_STREAM_DMA) {
+        setup_interrupts();
+        if (!dma_ring_init(cfg->dma_channel)) {
+            return -1;
+        }
+    } else if (I2S_STREAM_WATERMARK_IRQ(cfg->channel) != 0U) {
+        uint32_t slot = 0;
+        while (slot < I2S_STREAM_MAX_IRQ_STREAMS && g_irq_streams[slot] != NULL &&
+               g_irq_streams[slot] != stream) {
+            slot++;
+        }
+        if (slot == I2S_STREAM_MAX_IRQ_STREAMS) {
+            return -1;
+        }
+        g_irq_streams[slot] = stream;
+    }
+
+    if (cfg->mode == I2S_STREAM_WATERMARK) {
+        if (cfg->dir == I2S_STREAM_RX) {
+            reg_write8(I2S_RX_WATERMARK(cfg->channel), cfg->watermark);
+        } else {
+            reg_write8(I2S_TX_WATERMARK(cfg->channel), cfg->watermark);
+        }
+    }
+
+    // Enable only this stream's direction; the other may belong to another stream.
+    config = *reg;
+    if (cfg->dir == I2S_STREAM_RX) {
+        config.rx_en = 1;
+    } else {
+        config.tx_en = 1;
+    }
+    *reg = config;
+
+    stream->running = true;
+    if (cfg->mode == I2S_STREAM_DMA) {
+        stream_dma_arm(stream);
+    } else if (I2S_STREAM_WATERMARK_IRQ(cfg->channel) != 0U) {
+        if (platform_external_irq_register(I2S_STREAM_WATERMARK_IRQ(cfg->channel),
+                                           stream_watermark_irq, NULL) != 0) {
+            // Release the slot too, or the dispatcher keeps servicing a stream nobody started.
+            i2s_stream_stop(stream);
+            return -1;
+        }
+        setup_external_interrupt(I2S_STREAM_WATERMARK_IRQ(cfg->channel), 5U);
+    }
+    return 0;
+}
+
+void i2s_stream_stop(i2s_stream_t* stream) {
+    stream->running = false;
+    for (uint32_t i = 0; i < I2S_STREAM_MAX_IRQ_STREAMS; i++) {
+        if (g_irq_streams[i] == stream) {
+            g_irq_streams[i] = NULL;
+        }
+    }
+}
+
+void i2s_stream_poll(i2s_stream_t* stream) {
+    if (stream->cfg.mode == I2S_STREAM_DMA) {
+        (void)dma_cq_dispatch();
+        stream_dma_arm(stream);
+    } else if (stream->running && I2S_STREAM_WATERMARK_IRQ(stream->cfg.channel) == 0U) {
+        stream_service_watermark(stream, false);
+    }
+}
+
+uint32_t i2s_stream_level(const i2s_stream_t* stream) {
+    return (uint32_t)(stream_load(&stream->head) - stream_load(&stream->tail));
+}
+
+bool i2s_stream_frame_acquire(i2s_stream_t* stream, i2s_frame_t* frame) {
+    uint64_t tail = stream->tail;
+
+    if (stream_load(&stream->head) - tail < stream->cfg.window) {
+        return false;
+    }
+    frame->samples = &stream->cfg.buffer[tail % stream->cfg.capacity];
+    frame->length = stream->cfg.window;
+    frame->index = tail;
+    return true;
+}
+
+void i2s_stream_frame_release(i2s_stream_t* stream) {
+    uint64_t tail = stream->tail;
+
+    if (stream_load(&stream->head) - tail >= stream->cfg.hop) {
+        stream_store(&stream->tail, tail + stream->cfg.hop);
+    }
+    if (stream->cfg.mode == I2S_STREAM_DMA) {
+        stream_dma_arm(stream);
+    }
+}
+
+size_t i2s_stream_write(i2s_stream_t* stream, const uint32_t* samples, size_t count) {
+    uint64_t head = stream->head;
+    uint64_t space = stream->cfg.capacity - (head - stream_load(&stream->tail));
+    size_t n = (count < space) ? count : (size_t)space;
+
+    for (size_t i = 0; i < n; i++) {
+        stream->cfg.buffer[(head + i) % stream->cfg.capacity] = samples[i];
+    }
+    stream_store(&stream->head, head + n);
+    if (stream->cfg.mode == I2S_STREAM_DMA) {
+        stream_dma_arm(stream);
+    }
+    return n;
+}
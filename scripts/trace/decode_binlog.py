@@ -0,0 +1,136 @@
+"""Render a binlog stream (lib/binlog) captured from the console.
+
+The chip prints "@BL <hex>" lines (binlog_drain); everything else in the log is ignored. Format
+strings and %s arguments are read from the ELF the program was built into.
+
+  python decode_binlog.py --elf build/app.elf --log console.txt [--sort]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LINE_PATTERN = re.compile(r"@BL ([0-9a-f]+)\s*$")
+SPEC_PATTERN = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t|L)?([diouxXeEfFgGcsp%])")
+
+
+class Elf:
+    """Just enough ELF64 (little endian) to read bytes at a virtual address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 2 or self.data[5] != 1:
+            raise ValueError(f"{path}: not a little-endian ELF64 file")
+        e_shoff, = struct.unpack_from("<Q", self.data, 0x28)
+        e_shentsize, e_shnum = struct.unpack_from("<HH", self.data, 0x3A)
+        self.sections = []
+        for i in range(e_shnum):
+            off = e_shoff + i * e_shentsize
+            sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack_from("<IQQQQ", self.data, off + 4)
+            SHT_PROGBITS, SHF_ALLOC = 1, 0x2
+            if sh_type == SHT_PROGBITS and (sh_flags & SHF_ALLOC) and sh_size:
+                self.sections.append((sh_addr, sh_size, sh_offset))
+
+    def string(self, addr):
+        for sh_addr, sh_size, sh_offset in self.sections:
+            if sh_addr <= addr < sh_addr + sh_size:
+                start = sh_offset + (addr - sh_addr)
+                end = self.data.index(b"\x00", start, sh_offset + sh_size)
+                return self.data[start:end].decode("utf-8", errors="replace")
+        return None
+
+
+def read_stream(log_path):
+    payload = bytearray()
+    with open(log_path, "r", errors="replace") as log_file:
+        for line in log_file:
+            match = LINE_PATTERN.search(line)
+            if match:
+                payload += bytes.fromhex(match.group(1))
+    return bytes(payload)
+
+
+def parse_records(stream):
+    pos = 0
+    while pos + 18 <= len(stream):
+        hart, nargs = stream[pos], stream[pos + 1]
+        fmt_addr, cycles = struct.unpack_from("<QQ", stream, pos + 2)
+        pos += 18
+        if pos + 8 * nargs > len(stream):
+            print(f"warning: truncated record at byte {pos - 18}", file=sys.stderr)
+            return
+        args = list(struct.unpack_from(f"<{nargs}Q", stream, pos))
+        pos += 8 * nargs
+        yield hart, cycles, fmt_addr, args
+
+
+def render(elf, fmt, args):
+    out = []
+    last = 0
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    for spec in SPEC_PATTERN.finditer(fmt):
+        out.append(fmt[last:spec.start()])
+        last = spec.end()
+        flags, width, precision, length, conv = spec.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            width = str(take())
+        if precision == "*":
+            precision = str(take())
+        pyfmt = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        raw = take()
+        if conv in "di":
+            bits = 64 if length in ("l", "ll", "z", "j", "t") else 32
+            value = raw & ((1 << bits) - 1)
+            if value >> (bits - 1):
+                value -= 1 << bits
+            out.append((pyfmt + "d") % value)
+        elif conv in "ouxX":
+            bits = 64 if length in ("l", "ll", "z", "j", "t") else 32
+            out.append((pyfmt + conv.replace("u", "d")) % (raw & ((1 << bits) - 1)))
+        elif conv in "eEfFgG":
+            out.append((pyfmt + conv) % struct.unpack("<d", struct.pack("<Q", raw))[0])
+        elif conv == "c":
+            out.append((pyfmt + "c") % chr(raw & 0xFF))
+        elif conv == "p":
+            out.append((pyfmt + "s") % f"0x{raw:x}")
+        elif conv == "s":
+            text = elf.string(raw)
+            out.append((pyfmt + "s") % (text if text is not None else f"<str@0x{raw:x}>"))
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a binlog stream from a console log")
+    parser.add_argument("--elf", required=True, help="ELF the program was built into")
+    parser.add_argument("--log", required=True, help="captured console output")
+    parser.add_argument("--sort", action="store_true", help="merge harts by timestamp")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    records = list(parse_records(read_stream(args.log)))
+    if args.sort:
+        records.sort(key=lambda r: r[1])
+
+    for hart, cycles, fmt_addr, fmt_args in records:
+        fmt = elf.string(fmt_addr)
+        if fmt is None:
+            text = f"<unknown format 0x{fmt_addr:x}> {fmt_args}\n"
+        else:
+            text = render(elf, fmt, fmt_args)
+        sys.stdout.write(f"[h{hart} {cycles:>14}] {text}")
+        if not text.endswith("\n"):
+            sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
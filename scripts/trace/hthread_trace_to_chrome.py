@@ -0,0 +1,157 @@
+"""Convert an hthread_trace_dump() capture into Chrome trace JSON.
+
+The input is a raw capture of the console (UART log, or HTIF stdout); the
+binary trace block between the "HTRC" and "HTRE" markers is located and
+decoded, and the rest of the log is ignored. Load the output in
+chrome://tracing or https://ui.perfetto.dev.
+"""
+import argparse
+import json
+import struct
+import subprocess
+import sys
+
+EV_TASK_BEGIN = 1
+EV_TASK_END = 2
+EV_PUSH = 3
+EV_POST = 4
+EV_STEAL = 5
+EV_STEAL_FAIL = 6
+EV_IDLE_BEGIN = 7
+EV_IDLE_END = 8
+EV_SLEEP = 9
+EV_WAKE = 10
+EV_BARRIER_ENTER = 11
+EV_BARRIER_EXIT = 12
+EV_MARK = 13
+
+# begin type -> (end type, slice name)
+SPANS = {
+    EV_TASK_BEGIN: (EV_TASK_END, "task"),
+    EV_IDLE_BEGIN: (EV_IDLE_END, "idle"),
+    EV_SLEEP: (EV_WAKE, "wfi"),
+    EV_BARRIER_ENTER: (EV_BARRIER_EXIT, "barrier"),
+}
+SPAN_ENDS = {end: begin for begin, (end, _) in SPANS.items()}
+
+
+def parse_dump(data, index=0):
+    start = -1
+    for _ in range(index + 1):
+        start = data.find(b"HTRC", start + 1)
+        if start < 0:
+            raise ValueError("trace block %d not found in capture" % index)
+    off = start + 4
+    ver_harts, per_hart, hz_lo, hz_hi = struct.unpack_from("<IIII", data, off)
+    off += 16
+    version = ver_harts & 0xFFFF
+    n_harts = ver_harts >> 16
+    if version != 1:
+        raise ValueError("unsupported trace version %d" % version)
+
+    harts = []
+    for _ in range(n_harts):
+        hart, count, dropped = struct.unpack_from("<III", data, off)
+        off += 12
+        events = []
+        for _ in range(count):
+            cycle, arg, type_aux = struct.unpack_from("<QII", data, off)
+            off += 16
+            events.append((cycle, type_aux & 0xFFFF, type_aux >> 16, arg))
+        harts.append({"hart": hart, "dropped": dropped, "events": events})
+
+    if data[off:off + 4] != b"HTRE":
+        raise ValueError("trace block truncated (missing HTRE trailer)")
+    return {"cycle_hz": hz_lo | (hz_hi << 32), "per_hart": per_hart, "harts": harts}
+
+
+def load_symbols(elf, nm_tool):
+    out = subprocess.run([nm_tool, "-C", elf], check=True,
+                         capture_output=True, text=True).stdout
+    syms = {}
+    for line in out.splitlines():
+        parts = line.split(maxsplit=2)
+        if len(parts) == 3 and parts[1] in "tTwW":
+            syms[int(parts[0], 16) & 0xFFFFFFFF] = parts[2]
+    return syms
+
+
+def to_chrome(trace, syms, cycle_hz):
+    if cycle_hz <= 0:
+        cycle_hz = 1e6  # unknown clock: one "us" per cycle
+    t0 = min((h["events"][0][0] for h in trace["harts"] if h["events"]), default=0)
+    out = []
+    summary = []
+
+    for h in trace["harts"]:
+        tid = h["hart"]
+        out.append({"ph": "M", "name": "thread_name", "pid": 0, "tid": tid,
+                    "args": {"name": "hart%d" % tid}})
+        open_spans = {}
+        busy = {name: 0 for _, name in SPANS.values()}
+        steals = fails = 0
+
+        for cycle, etype, aux, arg in h["events"]:
+            ts = (cycle - t0) * 1e6 / cycle_hz
+            ev = {"pid": 0, "tid": tid, "ts": ts}
+
+            if etype in SPANS:
+                name = SPANS[etype][1]
+                if etype == EV_TASK_BEGIN:
+                    name = syms.get(arg, "task@0x%08x" % arg)
+                open_spans.setdefault(etype, []).append(cycle)
+                ev.update(ph="B", name=name)
+            elif etype in SPAN_ENDS:
+                stack = open_spans.get(SPAN_ENDS[etype])
+                if not stack:
+                    continue  # begin was overwritten in the ring
+                busy[SPANS[SPAN_ENDS[etype]][1]] += cycle - stack.pop()
+                ev.update(ph="E")
+                if etype == EV_IDLE_END:
+                    ev["args"] = {"empty_sweeps": arg}
+            elif etype == EV_PUSH:
+                ev.update(ph="C", name="deque_depth.hart%d" % tid, args={"depth": aux})
+            elif etype in (EV_POST, EV_STEAL, EV_STEAL_FAIL):
+                key = {EV_POST: "target", EV_STEAL: "victim", EV_STEAL_FAIL: "victim"}[etype]
+                name = {EV_POST: "post", EV_STEAL: "steal", EV_STEAL_FAIL: "steal_fail"}[etype]
+                steals += etype == EV_STEAL
+                fails += etype == EV_STEAL_FAIL
+                ev.update(ph="i", s="t", name=name, args={key: arg})
+            elif etype == EV_MARK:
+                ev.update(ph="i", s="g", name="mark %d" % arg)
+            else:
+                continue
+            out.append(ev)
+
+        summary.append((tid, busy, steals, fails, h["dropped"]))
+
+    return out, summary
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--log_path", type=str, required=True,
+                        help="raw console capture containing the trace dump")
+    parser.add_argument("--index", type=int, default=0,
+                        help="which dump to convert when the log holds several")
+    parser.add_argument("--out", type=str, default="hthread_trace.json")
+    parser.add_argument("--elf", type=str, default=None,
+                        help="firmware ELF used to name task functions")
+    parser.add_argument("--nm", type=str, default="riscv64-unknown-elf-nm")
+    parser.add_argument("--freq_hz", type=float, default=0.0,
+                        help="override the cycle clock stored in the dump")
+    args = parser.parse_args()
+
+    with open(args.log_path, "rb") as f:
+        trace = parse_dump(f.read(), args.index)
+    syms = load_symbols(args.elf, args.nm) if args.elf else {}
+    events, summary = to_chrome(trace, syms, args.freq_hz or trace["cycle_hz"])
+
+    with open(args.out, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+
+    for tid, busy, steals, fails, dropped in summary:
+        sys.stderr.write("hart%d: task=%d idle=%d wfi=%d barrier=%d cycles, "
+                         "steals=%d failed=%d dropped_events=%d\n"
+                         % (tid, busy["task"], busy["idle"], busy["wfi"],
+                            busy["barrier"], steals, fails, dropped))
@@ -1,48 +1,143 @@
 /*
  * hthread.c - Work-stealing thread runtime for Bearly25.
  *
- * Implements per-hart deques, atomic steal, and CLINT MSIP wakeups to
- * schedule tasks across cores. Exposes issue/dispatch/join/barrier plus
- * the worker loop for non-hart0 cores.
+ * Implements per-hart lock-free Chase–Lev deques (plus an MPSC inbox for
+ * hart-pinned work) and CLINT MSIP wakeups to schedule tasks across cores.
+ * Exposes issue/dispatch/join/barrier, fork/join task groups and
+ * parallel_for, plus the worker loop for non-hart0 cores.
  */
 #include "hthread.h"
 #include "chip_config.h"
+#include "riscv_encoding.h"
 
-static wsdeque_t deques[N_HARTS];
-static volatile uint32_t deque_locks[N_HARTS] __attribute__((aligned(64)));
-static volatile uint32_t pending_tasks[N_HARTS] __attribute__((aligned(64)));
-static volatile uint32_t dispatch_rr __attribute__((aligned(64))) = 0;
-static volatile uint32_t runtime_cookie __attribute__((aligned(64))) = 0;
+#if HTHREAD_TRACE
+#include <stdio.h>
+#endif
 
-static volatile uint32_t barrier_count = 0;
-static volatile uint32_t barrier_epoch = 0;
+#define HTHREAD_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))
+
+/*
+ * Per-hart runtime state. Every member that another hart writes sits on its
+ * own cache line: thieves CAS the deque's top, posters CAS the inbox tail,
+ * and whoever finishes a task decrements `pending`.
+ */
+typedef struct {
+    wsdeque_t deque HTHREAD_ALIGNED;
+    wsinbox_t inbox HTHREAD_ALIGNED;
+    volatile uint32_t pending HTHREAD_ALIGNED;
+    /* Set while the hart is (about to be) parked in wfi; wakers read it
+     * to skip the CLINT store when the hart is already running. */
+    volatile uint32_t sleeping HTHREAD_ALIGNED;
+    /* rdcycle of the first wake request since the hart went to sleep. */
+    volatile uint64_t wake_stamp;
+    /* Owner-private xorshift state for victim selection. */
+    uint32_t steal_seed HTHREAD_ALIGNED;
+    hthread_idle_stats_t stats;
+} hthread_hart_t;
+
+static hthread_hart_t harts[HTHREAD_N_HARTS];
+static volatile uint32_t dispatch_rr HTHREAD_ALIGNED = 0;
+static volatile uint32_t runtime_cookie HTHREAD_ALIGNED = 0;
+
+static volatile uint32_t barrier_count HTHREAD_ALIGNED = 0;
+static volatile uint32_t barrier_epoch HTHREAD_ALIGNED = 0;
+
+static volatile uint32_t idle_spin_budget = HTHREAD_IDLE_SPIN_BUDGET;
+static volatile uint32_t barrier_spin_budget = HTHREAD_BARRIER_SPIN_BUDGET;
 
 #define HTHREAD_RUNTIME_COOKIE 0x48545244u
 
-static inline void lock_deque(uint32_t hartid) {
-    while (__sync_lock_test_and_set(&deque_locks[hartid], 1u) != 0u) {
-        while (deque_locks[hartid] != 0u) {
-            asm volatile("nop");
-        }
+static inline uint64_t hthread_rdcycle(void) {
+    uint64_t x;
+    asm volatile("rdcycle %0" : "=r"(x));
+    return x;
+}
+
+#define HTHREAD_BACKOFF_MAX_NOPS 64u
+
+// Growing nop back-off between polls of a shared line, capped at
+// HTHREAD_BACKOFF_MAX_NOPS. Callers zero *spins after making progress.
+static inline void hthread_backoff(uint32_t *spins) {
+    uint32_t n = *spins;
+
+    if (n < HTHREAD_BACKOFF_MAX_NOPS) {
+        *spins = ++n;
+    }
+    for (uint32_t j = 0; j < n; j++) {
+        asm volatile("nop");
     }
 }
 
-static inline void unlock_deque(uint32_t hartid) {
-    __sync_lock_release(&deque_locks[hartid]);
+// ----------------------
+// Trace rings
+// ----------------------
+
+#if HTHREAD_TRACE
+#if (HTHREAD_TRACE_EVENTS & (HTHREAD_TRACE_EVENTS - 1)) != 0
+#error "HTHREAD_TRACE_EVENTS must be a power of two"
+#endif
+
+/*
+ * Each ring has exactly one writer (its hart), so recording is a slot store
+ * followed by a release store of `head`; the dumping hart only reads.
+ */
+typedef struct {
+    volatile uint32_t head HTHREAD_ALIGNED;
+    uint32_t idle_sweeps;
+    hthread_trace_event_t events[HTHREAD_TRACE_EVENTS];
+} hthread_trace_ring_t;
+
+static hthread_trace_ring_t trace_rings[HTHREAD_N_HARTS];
+static volatile uint32_t trace_enabled = 1;
+
+static inline void trace_emit(uint32_t hartid, uint32_t type, uint32_t aux, uint32_t arg) {
+    if (hartid >= HTHREAD_N_HARTS || !trace_enabled) {
+        return;
+    }
+    hthread_trace_ring_t *ring = &trace_rings[hartid];
+    uint32_t h = ring->head;
+    hthread_trace_event_t *ev = &ring->events[h & (HTHREAD_TRACE_EVENTS - 1u)];
+
+    ev->cycle = hthread_rdcycle();
+    ev->arg = arg;
+    ev->type = (uint16_t)type;
+    ev->aux = (uint16_t)aux;
+    __atomic_store_n(&ring->head, h + 1u, __ATOMIC_RELEASE);
 }
 
+#define HTRACE(hart, type, aux, arg) \
+    trace_emit((hart), (type), (uint32_t)(aux), (uint32_t)(arg))
+#define HTRACE_SELF(type, aux, arg) \
+    HTRACE((uint32_t)READ_CSR("mhartid"), (type), (aux), (arg))
+#else
+#define HTRACE(hart, type, aux, arg) do { } while (0)
+#define HTRACE_SELF(type, aux, arg) do { } while (0)
+#endif
+
 static inline void run_task(const htask_t *task) {
+    HTRACE_SELF(HTHREAD_EV_TASK_BEGIN, 0, (uintptr_t)task->fn);
     task->fn(task->arg);
+    HTRACE_SELF(HTHREAD_EV_TASK_END, 0, (uintptr_t)task->fn);
     __sync_synchronize();
-    __sync_fetch_and_sub(&pending_tasks[task->owner], 1u);
+    __sync_fetch_and_sub(task->done, 1u);
 }
 
+// Raise MSIP only if the hart is parked. The full fence orders the caller's
+// task publication before the `sleeping` check; hart_sleep() does the
+// mirror-image store/fence/load, so either we see it asleep or it sees the task.
 static inline void wake_hart(uint32_t hartid) {
+    __sync_synchronize();
+    if (harts[hartid].sleeping == 0u) {
+        return;
+    }
+    if (harts[hartid].wake_stamp == 0u) {
+        harts[hartid].wake_stamp = hthread_rdcycle();
+    }
     CLINT->MSIP[hartid] = 1;
 }
 
 static inline void wake_other_harts(uint32_t self) {
-    for (uint32_t h = 0; h < N_HARTS; ++h) {
+    for (uint32_t h = 0; h < HTHREAD_N_HARTS; ++h) {
         if (h == self) {
             continue;
         }
@@ -50,89 +145,157 @@ static inline void wake_other_harts(uint32_t self) {
     }
 }
 
-// Add a task to the bottom of a hart’s deque (owner push)
-static inline void ws_push(uint32_t hartid, const htask_t *task) {
-    wsdeque_t *dq = &deques[hartid];
-
-    while (1) {
-        lock_deque(hartid);
+// Add a task to the bottom of the calling hart's own deque (owner push)
+static inline void ws_push(uint32_t self, const htask_t *task) {
+    htask_t local;
 
-        uint32_t t = dq->top;
-        uint32_t b = dq->bottom;
-        if ((b - t) < WSQ_SIZE) {
-            dq->tasks[b & (WSQ_SIZE - 1)] = *task;
-            __sync_synchronize();
-            __sync_fetch_and_add(&pending_tasks[task->owner], 1u);
-            dq->bottom = b + 1u;
-            unlock_deque(hartid);
-            break;
+    __sync_fetch_and_add(task->done, 1u);
+    while (!wsq_push(&harts[self].deque, task)) {
+        // Deque full: run our newest task to make room instead of spinning.
+        if (wsq_pop(&harts[self].deque, &local)) {
+            run_task(&local);
         }
+    }
+    HTRACE(self, HTHREAD_EV_PUSH, wsq_size(&harts[self].deque), 0);
+}
 
-        unlock_deque(hartid);
-        asm volatile("nop");
+// Hand a task to another hart through its inbox; it keeps hart affinity
+static inline void ws_post(uint32_t hartid, const htask_t *task) {
+    HTRACE_SELF(HTHREAD_EV_POST, 0, hartid);
+    uint32_t spins = 0;
+
+    __sync_fetch_and_add(task->done, 1u);
+    while (!wsinbox_push(&harts[hartid].inbox, task)) {
+        wake_hart(hartid);
+        hthread_backoff(&spins);
     }
 }
 
-// Pop a local task from the bottom of the hart’s deque
+// Take the next local task: newest deque entry first, then the inbox
 static inline int ws_pop(uint32_t hartid, htask_t *out) {
-    wsdeque_t *dq = &deques[hartid];
-    lock_deque(hartid);
-
-    uint32_t t = dq->top;
-    uint32_t b = dq->bottom;
-    if (t == b) {
-        unlock_deque(hartid);
-        return 0;
+    // The size check is exact for the owner and skips the pop fence when idle.
+    if (wsq_size(&harts[hartid].deque) != 0u && wsq_pop(&harts[hartid].deque, out)) {
+        return 1;
     }
+    return wsinbox_pop(&harts[hartid].inbox, out);
+}
 
-    b -= 1u;
-    *out = dq->tasks[b & (WSQ_SIZE - 1u)];
-    dq->bottom = b;
+// Attempt to steal a task from the top of another hart's deque
+static inline int ws_steal(uint32_t victim, htask_t *out) {
+    return wsq_steal(&harts[victim].deque, out, HTHREAD_TASK_STEALABLE) == WSQ_STEAL_OK;
+}
 
-    unlock_deque(hartid);
-    return 1;
+// Sweep all other harts once, starting from a random victim so thieves
+// spread out instead of all hammering hart0's deque first
+static inline int ws_steal_any(uint32_t self, htask_t *out) {
+#if HTHREAD_N_HARTS > 1
+    uint32_t x = harts[self].steal_seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    harts[self].steal_seed = x;
+
+    uint32_t start = x % (HTHREAD_N_HARTS - 1u);
+    for (uint32_t i = 0; i < HTHREAD_N_HARTS - 1u; i++) {
+        uint32_t victim = (self + 1u + (start + i) % (HTHREAD_N_HARTS - 1u)) % HTHREAD_N_HARTS;
+        if (wsq_size(&harts[victim].deque) != 0u) {
+            if (ws_steal(victim, out)) {
+                HTRACE(self, HTHREAD_EV_STEAL, 0, victim);
+                return 1;
+            }
+            HTRACE(self, HTHREAD_EV_STEAL_FAIL, 0, victim);
+        }
+    }
+#if HTHREAD_TRACE
+    trace_rings[self].idle_sweeps++;
+#endif
+#else
+    (void)self;
+    (void)out;
+#endif
+    return 0;
 }
 
-// Attempt to steal a task from the top of another hart’s queue
-static inline int ws_steal(uint32_t victim, htask_t *out) {
-    wsdeque_t *dq = &deques[victim];
-    lock_deque(victim);
+// Withdraw a sleep announcement without sleeping. A waker may already have
+// seen `sleeping` set and raised our MSIP; clear it so it does not linger
+// until someone enables mstatus.MIE. A waker racing past this clear leaves
+// at most one spurious wake, which the next wfi or the default MSIP handler
+// absorbs.
+static inline void hart_cancel_sleep(uint32_t self) {
+    harts[self].sleeping = 0u;
+    __sync_synchronize();
+    CLINT->MSIP[self] = 0u;
+    harts[self].wake_stamp = 0u;
+}
 
-    uint32_t t = dq->top;
-    uint32_t b = dq->bottom;
+/*
+ * Park the calling hart in wfi until its MSIP is raised. `sleeping` must
+ * already be set and the caller must have re-checked for work after setting
+ * it. MSIE is enabled in mie and mstatus.MIE is held off, so the MSIP
+ * wakes wfi without taking a trap; it is cleared and the caller's mie and
+ * mstatus.MIE are restored afterwards. A level-triggered MSIP raised before
+ * the wfi makes it fall straight through, so no wake is lost.
+ */
+static void hart_sleep(uint32_t self) {
+    hthread_hart_t *me = &harts[self];
+    unsigned long mstatus = CLEAR_CSR_BITS("mstatus", MSTATUS_MIE);
+    unsigned long mie = SET_CSR_BITS("mie", MIP_MSIP);
+
+    HTRACE(self, HTHREAD_EV_SLEEP, 0, 0);
+    uint64_t t0 = hthread_rdcycle();
+    asm volatile("wfi");
+    uint64_t t1 = hthread_rdcycle();
+    HTRACE(self, HTHREAD_EV_WAKE, 0, 0);
+
+    CLINT->MSIP[self] = 0u;
+    me->sleeping = 0u;
+    __sync_synchronize();
 
-    if (t == b) {
-        unlock_deque(victim);
-        return 0;
+    uint64_t stamp = me->wake_stamp;
+    me->wake_stamp = 0u;
+
+    me->stats.sleeps++;
+    me->stats.sleep_cycles += t1 - t0;
+    // rdcycle is per hart; harts share a clock and reset together here, so
+    // the cross-hart difference is a usable (approximate) wake latency.
+    if (stamp != 0u && t1 > stamp) {
+        uint64_t lat = t1 - stamp;
+        me->stats.wakeups++;
+        me->stats.wake_latency_total += lat;
+        if (lat > me->stats.wake_latency_max) {
+            me->stats.wake_latency_max = lat;
+        }
     }
 
-    htask_t task = dq->tasks[t & (WSQ_SIZE - 1u)];
-    if ((task.flags & HTHREAD_TASK_STEALABLE) == 0u) {
-        unlock_deque(victim);
-        return 0;
+    if ((mie & MIP_MSIP) == 0u) {
+        CLEAR_CSR_BITS("mie", MIP_MSIP);
+    }
+    if (mstatus & MSTATUS_MIE) {
+        SET_CSR_BITS("mstatus", MSTATUS_MIE);
     }
-
-    dq->top = t + 1u;
-    unlock_deque(victim);
-
-    *out = task;
-    return 1;
 }
 
-// Pushes a task directly onto a specific hart’s queue and wakes that hart
+// Pins a task to a specific hart (own deque or its inbox) and wakes that hart
 void hthread_issue(uint32_t hartid, void (*fn)(void *), void *arg) {
-    if (hartid >= N_HARTS || fn == 0) {
+    if (hartid >= HTHREAD_N_HARTS || fn == 0) {
         return;
     }
 
     htask_t t = {
         .fn = fn,
         .arg = arg,
+        .done = &harts[hartid].pending,
         .owner = hartid,
         .flags = 0u,
     };
 
-    ws_push(hartid, &t);
+    uint32_t self = (uint32_t)READ_CSR("mhartid");
+    if (hartid == self) {
+        ws_push(self, &t);
+        return;
+    }
+
+    ws_post(hartid, &t);
     wake_hart(hartid);
 }
 
@@ -143,7 +306,7 @@ void hthread_dispatch(void (*fn)(void *), void *arg) {
     }
 
     uint32_t self = (uint32_t)READ_CSR("mhartid");
-    uint32_t target = __sync_fetch_and_add(&dispatch_rr, 1u) % N_HARTS;
+    uint32_t target = __sync_fetch_and_add(&dispatch_rr, 1u) % HTHREAD_N_HARTS;
 
     // Keep the caller productive while still distributing tasks to other harts.
     if (target == self) {
@@ -151,62 +314,301 @@ void hthread_dispatch(void (*fn)(void *), void *arg) {
         return;
     }
 
+    // Only the owner may push onto a Chase–Lev deque, so publish the task on
+    // our own deque and let the idle harts steal it. Completion is still
+    // counted against the round-robin target, so hthread_join(target) waits
+    // for it and the caller's own pending count is left alone.
     htask_t t = {
         .fn = fn,
         .arg = arg,
-        .owner = target,
+        .done = &harts[target].pending,
+        .owner = self,
         .flags = HTHREAD_TASK_STEALABLE,
     };
 
-    ws_push(target, &t);
+    ws_push(self, &t);
     wake_other_harts(self);
 }
 
 // Block until a specific hart has no more pending tasks
 void hthread_join(uint32_t hartid) {
-    if (hartid >= N_HARTS) {
+    if (hartid >= HTHREAD_N_HARTS) {
         return;
     }
 
     uint32_t self = (uint32_t)READ_CSR("mhartid");
+    uint32_t spins = 0;
     htask_t task;
 
-    while (__atomic_load_n(&pending_tasks[hartid], __ATOMIC_ACQUIRE) != 0u) {
+    while (__atomic_load_n(&harts[hartid].pending, __ATOMIC_ACQUIRE) != 0u) {
         // If we're waiting on our own queue, make forward progress locally
         if (self == hartid) {
             if (ws_pop(hartid, &task)) {
                 run_task(&task);
+                spins = 0;
                 continue;
             }
         } else {
             // Help remote completion if the victim's front task is stealable.
-            if (ws_steal(hartid, &task)) {
+            // Tasks dispatched to hartid may still sit on our own deque.
+            if (ws_steal(hartid, &task) || ws_pop(self, &task)) {
                 run_task(&task);
+                spins = 0;
                 continue;
             }
         }
 
         wake_hart(hartid);
-        asm volatile("nop");
+        hthread_backoff(&spins);
     }
 }
 
-// Synchronizes all harts so they reach the same point before proceeding
+void hthread_group_init(hthread_group_t *group) {
+    group->pending = 0u;
+}
+
+// Fork a stealable child that only `group` tracks
+void hthread_group_spawn(hthread_group_t *group, void (*fn)(void *), void *arg) {
+    if (group == 0 || fn == 0) {
+        return;
+    }
+
+    uint32_t self = (uint32_t)READ_CSR("mhartid");
+    htask_t t = {
+        .fn = fn,
+        .arg = arg,
+        .done = &group->pending,
+        .owner = self,
+        .flags = HTHREAD_TASK_STEALABLE,
+    };
+
+    ws_push(self, &t);
+    wake_other_harts(self);
+}
+
+// Wait for the group's own children, running local or stolen work meanwhile
+void hthread_group_wait(hthread_group_t *group) {
+    uint32_t self = (uint32_t)READ_CSR("mhartid");
+    uint32_t spins = 0;
+    htask_t task;
+
+    while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) != 0u) {
+        // Our own children sit at the bottom of our deque unless stolen.
+        if (ws_pop(self, &task) || ws_steal_any(self, &task)) {
+            run_task(&task);
+            spins = 0;
+            continue;
+        }
+        hthread_backoff(&spins);
+    }
+    __sync_synchronize();
+}
+
+typedef struct {
+    hthread_range_fn_t fn;
+    void *ctx;
+    size_t grain;
+} pfor_job_t;
+
+typedef struct {
+    const pfor_job_t *job;
+    size_t begin;
+    size_t end;
+} pfor_range_t;
+
+static void pfor_run(void *arg);
+
+// Split [begin, end) in halves: fork the upper half, recurse into the lower
+// half, then join. The upper halves stay at the top of our deque, so a thief
+// always takes the largest remaining piece and splits it further itself.
+static void pfor_range(const pfor_job_t *job, size_t begin, size_t end) {
+    if (end - begin <= job->grain) {
+        job->fn(begin, end, job->ctx);
+        return;
+    }
+
+    size_t mid = begin + (end - begin) / 2u;
+    pfor_range_t upper = { .job = job, .begin = mid, .end = end };
+    hthread_group_t group;
+
+    hthread_group_init(&group);
+    hthread_group_spawn(&group, pfor_run, &upper);
+    pfor_range(job, begin, mid);
+    hthread_group_wait(&group);
+}
+
+static void pfor_run(void *arg) {
+    const pfor_range_t *r = (const pfor_range_t *)arg;
+    pfor_range(r->job, r->begin, r->end);
+}
+
+// Run fn over [begin, end) in chunks of at most `grain` across all harts
+void hthread_parallel_for(size_t begin, size_t end, size_t grain,
+                          hthread_range_fn_t fn, void *ctx) {
+    if (fn == 0 || end <= begin) {
+        return;
+    }
+
+    if (grain == 0u) {
+        // Default: ~4 chunks per hart leaves room for stealing to rebalance.
+        grain = (end - begin + 4u * HTHREAD_N_HARTS - 1u) / (4u * HTHREAD_N_HARTS);
+        if (grain == 0u) {
+            grain = 1u;
+        }
+    }
+
+    pfor_job_t job = { .fn = fn, .ctx = ctx, .grain = grain };
+    pfor_range(&job, begin, end);
+    __sync_synchronize();
+}
+
+// Synchronizes all harts so they reach the same point before proceeding.
+// Waiters spin for barrier_spin_budget polls, then sleep until the last
+// arrival bumps the epoch and wakes them.
 void hthread_barrier() {
+    uint32_t self = (uint32_t)READ_CSR("mhartid");
+    HTRACE(self, HTHREAD_EV_BARRIER_ENTER, 0, 0);
     uint32_t epoch = barrier_epoch;
     uint32_t arrived = __sync_add_and_fetch(&barrier_count, 1u);
 
-    if (arrived == N_HARTS) {
+    if (arrived == HTHREAD_N_HARTS) {
         barrier_count = 0u;
         __sync_synchronize();
         barrier_epoch = epoch + 1u;
+        wake_other_harts(self);
     } else {
+        uint64_t t0 = hthread_rdcycle();
+        uint32_t budget = barrier_spin_budget;
+        uint32_t spins = 0;
+
         while (barrier_epoch == epoch) {
-            asm volatile("nop");
+            if (spins < budget || self >= HTHREAD_N_HARTS) {
+                spins++;
+                asm volatile("nop");
+                continue;
+            }
+
+            harts[self].sleeping = 1u;
+            __sync_synchronize();
+            if (barrier_epoch != epoch) {
+                hart_cancel_sleep(self);
+                break;
+            }
+            hart_sleep(self);
+        }
+
+        if (self < HTHREAD_N_HARTS) {
+            harts[self].stats.idle_cycles += hthread_rdcycle() - t0;
         }
     }
 
     __sync_synchronize();
+    HTRACE(self, HTHREAD_EV_BARRIER_EXIT, 0, 0);
+}
+
+// ----------------------
+// Trace API
+// ----------------------
+
+static inline void trace_idle_end(uint32_t hartid) {
+#if HTHREAD_TRACE
+    HTRACE(hartid, HTHREAD_EV_IDLE_END, 0, trace_rings[hartid].idle_sweeps);
+    trace_rings[hartid].idle_sweeps = 0;
+#else
+    (void)hartid;
+#endif
+}
+
+#if HTHREAD_TRACE
+static void trace_write_u32(uint32_t v) {
+    uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+    fwrite(b, 1, sizeof(b), stdout);
+}
+
+static void trace_write_event(const hthread_trace_event_t *ev) {
+    trace_write_u32((uint32_t)ev->cycle);
+    trace_write_u32((uint32_t)(ev->cycle >> 32));
+    trace_write_u32(ev->arg);
+    trace_write_u32((uint32_t)ev->type | ((uint32_t)ev->aux << 16));
+}
+#endif
+
+void hthread_trace_reset(void) {
+#if HTHREAD_TRACE
+    for (uint32_t i = 0; i < HTHREAD_N_HARTS; i++) {
+        trace_rings[i].head = 0u;
+        trace_rings[i].idle_sweeps = 0u;
+    }
+    __sync_synchronize();
+#endif
+}
+
+void hthread_trace_mark(uint32_t id) {
+    HTRACE_SELF(HTHREAD_EV_MARK, 0, id);
+    (void)id;
+}
+
+/*
+ * Stream layout (all little-endian words):
+ *   "HTRC", version(1) | n_harts << 16, events_per_hart, cycle_hz lo, cycle_hz hi
+ *   per hart: hartid, count, dropped, then `count` 16-byte events oldest first
+ *   "HTRE"
+ */
+void hthread_trace_dump(uint64_t cycle_hz) {
+#if HTHREAD_TRACE
+    trace_enabled = 0u;
+    __sync_synchronize();
+    fflush(stdout);
+
+    fwrite("HTRC", 1, 4, stdout);
+    trace_write_u32(1u | ((uint32_t)HTHREAD_N_HARTS << 16));
+    trace_write_u32(HTHREAD_TRACE_EVENTS);
+    trace_write_u32((uint32_t)cycle_hz);
+    trace_write_u32((uint32_t)(cycle_hz >> 32));
+
+    for (uint32_t h = 0; h < HTHREAD_N_HARTS; h++) {
+        hthread_trace_ring_t *ring = &trace_rings[h];
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint32_t count = head < HTHREAD_TRACE_EVENTS ? head : HTHREAD_TRACE_EVENTS;
+
+        trace_write_u32(h);
+        trace_write_u32(count);
+        trace_write_u32(head - count);
+        for (uint32_t i = head - count; i != head; i++) {
+            trace_write_event(&ring->events[i & (HTHREAD_TRACE_EVENTS - 1u)]);
+        }
+    }
+
+    fwrite("HTRE", 1, 4, stdout);
+    fflush(stdout);
+
+    __sync_synchronize();
+    trace_enabled = 1u;
+#else
+    (void)cycle_hz;
+#endif
+}
+
+void hthread_set_idle_policy(uint32_t idle_spins, uint32_t barrier_spins) {
+    idle_spin_budget = idle_spins;
+    barrier_spin_budget = barrier_spins;
+    __sync_synchronize();
+}
+
+void hthread_idle_stats(uint32_t hartid, hthread_idle_stats_t *out) {
+    if (hartid >= HTHREAD_N_HARTS || out == 0) {
+        return;
+    }
+    __sync_synchronize();
+    *out = harts[hartid].stats;
+}
+
+void hthread_idle_stats_reset(void) {
+    for (uint32_t i = 0; i < HTHREAD_N_HARTS; i++) {
+        hthread_idle_stats_t zero = {0};
+        harts[i].stats = zero;
+    }
+    __sync_synchronize();
 }
 
 // Initializes the entire threading subsystem before any parallel work happens
@@ -216,11 +618,15 @@ void hthread_init() {
     barrier_count = 0u;
     barrier_epoch = 0u;
 
-    for (uint32_t i = 0; i < N_HARTS; i++) {
-        deques[i].top = 0;
-        deques[i].bottom = 0;
-        pending_tasks[i] = 0;
-        deque_locks[i] = 0;
+    hthread_idle_stats_reset();
+    hthread_trace_reset();
+    for (uint32_t i = 0; i < HTHREAD_N_HARTS; i++) {
+        wsq_init(&harts[i].deque);
+        wsinbox_init(&harts[i].inbox);
+        harts[i].pending = 0;
+        harts[i].steal_seed = 0x9E3779B9u * (i + 1u);
+        harts[i].sleeping = 0u;
+        harts[i].wake_stamp = 0u;
         CLINT->MSIP[i] = 0u;
     }
 
@@ -234,6 +640,16 @@ void __main(void) {
     uint32_t mhartid = (uint32_t)READ_CSR("mhartid");
     htask_t task;
     uint32_t idle_spins = 0;
+    uint64_t idle_start = 0;
+
+    // Harts beyond the configured HTHREAD_N_HARTS have no runtime state; park them.
+    if (mhartid >= HTHREAD_N_HARTS) {
+        while (1) {
+            asm volatile("wfi");
+        }
+    }
+
+    hthread_hart_t *me = &harts[mhartid];
 
     while (1) {
         // Secondary harts can reach __main before hart0 finishes runtime init.
@@ -243,40 +659,42 @@ void __main(void) {
             continue;
         }
 
-        int did_work = 0;
-
-        // Check if own deque has work before acquiring the lock
-        wsdeque_t *my_dq = &deques[mhartid];
-        if (my_dq->top != my_dq->bottom) {
-            if (ws_pop(mhartid, &task)) {
-                run_task(&task);
-                did_work = 1;
+        // Local work first: own deque (LIFO), then tasks posted to us, then steal
+        if (ws_pop(mhartid, &task) || ws_steal_any(mhartid, &task)) {
+            if (idle_spins != 0u) {
+                me->stats.idle_cycles += hthread_rdcycle() - idle_start;
                 idle_spins = 0;
+                trace_idle_end(mhartid);
             }
+            run_task(&task);
+            continue;
         }
 
-        if (!did_work) {
-            for (uint32_t victim = 0; victim < N_HARTS; victim++) {
-                if (victim == mhartid) {
-                    continue;
-                }
-                if (deques[victim].top != deques[victim].bottom) {
-                    if (ws_steal(victim, &task)) {
-                        run_task(&task);
-                        did_work = 1;
-                        idle_spins = 0;
-                        break;
-                    }
-                }
-            }
+        if (idle_spins == 0u) {
+            idle_start = hthread_rdcycle();
+            HTRACE(mhartid, HTHREAD_EV_IDLE_BEGIN, 0, 0);
         }
+        idle_spins++;
 
-        if (!did_work) {
-            idle_spins++;
-            // Back off to reduce lock contention when idle
-            for (uint32_t j = 0; j < (idle_spins < 64u ? idle_spins : 64u); j++) {
-                asm volatile("nop");
-            }
+        if (idle_spins <= idle_spin_budget) {
+            // Back off to reduce steal traffic when idle
+            uint32_t backoff = idle_spins - 1u;
+            hthread_backoff(&backoff);
+            continue;
+        }
+
+        // Spin budget exhausted: announce we are going to sleep, then look
+        // once more so a task published concurrently is not slept through.
+        me->sleeping = 1u;
+        __sync_synchronize();
+        if (ws_pop(mhartid, &task) || ws_steal_any(mhartid, &task)) {
+            hart_cancel_sleep(mhartid);
+            me->stats.idle_cycles += hthread_rdcycle() - idle_start;
+            idle_spins = 0;
+            trace_idle_end(mhartid);
+            run_task(&task);
+            continue;
         }
+        hart_sleep(mhartid);
     }
 }
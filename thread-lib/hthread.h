@@ -1,39 +1,169 @@
 /*
  * hthread.h - Public API for the bare-metal work-stealing runtime.
  *
- * Defines task/deque types and exposes init/dispatch/join/barrier APIs used
- * by tests and demos on the multi-hart Bearly25 platform.
+ * Pulls in the lock-free task queues from wsdeque.h and exposes
+ * init/issue/dispatch/join/barrier APIs used by tests and demos on the
+ * multi-hart Bearly25 platform.
  */
 #ifndef __HTHREAD_H
 #define __HTHREAD_H
 
 #include "clint.h"
 #include "riscv.h"
+#include "chip_config.h"
+#include <stddef.h>
 #include <stdint.h>
 
-#define N_HARTS 2
+/*
+ * Worker hart count and deque capacity come from the platform's
+ * chip_config.h. Thread-lib clients size their per-hart arrays with
+ * N_HARTS, which always equals HTHREAD_N_HARTS here.
+ */
+#ifndef HTHREAD_N_HARTS
+#define HTHREAD_N_HARTS 2
+#endif
+
+#ifndef N_HARTS
+#define N_HARTS HTHREAD_N_HARTS
+#endif
+
+#if N_HARTS != HTHREAD_N_HARTS
+#error "N_HARTS must match HTHREAD_N_HARTS for thread-lib; set HTHREAD_N_HARTS instead"
+#endif
+
+#ifndef WSQ_SIZE
 #define WSQ_SIZE 64
+#endif
 
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+/*
+ * Idle policy. A worker with nothing to run or steal polls this many times
+ * (with growing nop back-off) before parking in wfi until another hart
+ * raises its MSIP; barrier waiters likewise spin this many polls before
+ * sleeping. HTHREAD_SPIN_FOREVER disables sleeping. Adjustable at run time
+ * with hthread_set_idle_policy().
+ */
+#define HTHREAD_SPIN_FOREVER 0xFFFFFFFFu
+
+#ifndef HTHREAD_IDLE_SPIN_BUDGET
+#define HTHREAD_IDLE_SPIN_BUDGET 256u
+#endif
+
+#ifndef HTHREAD_BARRIER_SPIN_BUDGET
+#define HTHREAD_BARRIER_SPIN_BUDGET 4096u
+#endif
+
+/*
+ * Scheduler trace. With HTHREAD_TRACE=1 every hart records rdcycle-stamped
+ * scheduler events into its own ring of HTHREAD_TRACE_EVENTS entries (the
+ * oldest are overwritten). hthread_trace_dump() writes all rings to stdout
+ * as a binary stream; scripts/trace/hthread_trace_to_chrome.py turns a
+ * captured log into Chrome trace JSON. With HTHREAD_TRACE=0 the hooks
+ * compile away and the trace API is a no-op.
+ */
+#ifndef HTHREAD_TRACE
+#define HTHREAD_TRACE 0
+#endif
+
+#ifndef HTHREAD_TRACE_EVENTS
+#define HTHREAD_TRACE_EVENTS 1024
+#endif
+
+#define WSQ_CACHE_LINE CACHE_LINE_SIZE
+#include "wsdeque.h"
+
+#define HTHREAD_TASK_STEALABLE (1u << 0)
+
+/*
+ * Fork/join task group (a countdown latch). hthread_group_wait() returns
+ * once every task spawned into this group has finished, independent of any
+ * other work queued on the same harts. The group may live on the stack of
+ * the waiting hart.
+ */
 typedef struct {
-    void (*fn)(void *);
-    void *arg;
-    /* Runtime-managed metadata for ownership/steal policy. */
-    uint32_t owner;
-    uint32_t flags;
-} htask_t;
+    volatile uint32_t pending;
+} hthread_group_t;
 
+/*
+ * Per-hart idle counters (cycles from rdcycle). idle_cycles covers all time
+ * spent looking for work or waiting in a barrier, sleep_cycles the part of
+ * it spent in wfi. Wake latency is measured from the first wake request to
+ * the sleeper leaving wfi.
+ */
 typedef struct {
-    volatile uint32_t top;
-    volatile uint32_t bottom;
-    htask_t tasks[WSQ_SIZE];
-} wsdeque_t;
+    uint64_t idle_cycles;
+    uint64_t sleep_cycles;
+    uint64_t wake_latency_total;
+    uint64_t wake_latency_max;
+    uint32_t sleeps;
+    uint32_t wakeups;
+} hthread_idle_stats_t;
 
-#define HTHREAD_TASK_STEALABLE (1u << 0)
+/* Trace event types; keep in sync with scripts/trace/hthread_trace_to_chrome.py. */
+#define HTHREAD_EV_TASK_BEGIN     1   /* arg = task fn address */
+#define HTHREAD_EV_TASK_END       2   /* arg = task fn address */
+#define HTHREAD_EV_PUSH           3   /* aux = own deque depth after push */
+#define HTHREAD_EV_POST           4   /* arg = target hart */
+#define HTHREAD_EV_STEAL          5   /* arg = victim hart */
+#define HTHREAD_EV_STEAL_FAIL     6   /* arg = victim hart (lost race or pinned top) */
+#define HTHREAD_EV_IDLE_BEGIN     7
+#define HTHREAD_EV_IDLE_END       8   /* arg = empty steal sweeps while idle */
+#define HTHREAD_EV_SLEEP          9
+#define HTHREAD_EV_WAKE           10
+#define HTHREAD_EV_BARRIER_ENTER  11
+#define HTHREAD_EV_BARRIER_EXIT   12
+#define HTHREAD_EV_MARK           13  /* arg = user id, see hthread_trace_mark() */
+
+/* One trace record, 16 bytes, little-endian in the dump stream. */
+typedef struct {
+    uint64_t cycle;
+    uint32_t arg;
+    uint16_t type;
+    uint16_t aux;
+} hthread_trace_event_t;
+
+/* Body of hthread_parallel_for(): process indices [begin, end). */
+typedef void (*hthread_range_fn_t)(size_t begin, size_t end, void *ctx);
 
 void hthread_init();
 void hthread_issue(uint32_t hartid, void (*fn)(void *), void *arg);
+/*
+ * hthread_dispatch() picks a target hart round-robin. The task either runs
+ * inline (target == caller) or is queued as stealable work, and in both cases
+ * it counts toward the target's pending tasks: hthread_join(target) waits for
+ * it no matter which hart ends up running it.
+ */
 void hthread_dispatch(void (*fn)(void *), void *arg);
 void hthread_join(uint32_t hartid);
 void hthread_barrier();
 
+void hthread_set_idle_policy(uint32_t idle_spins, uint32_t barrier_spins);
+void hthread_idle_stats(uint32_t hartid, hthread_idle_stats_t *out);
+void hthread_idle_stats_reset(void);
+
+/*
+ * Trace control. Call hthread_trace_dump() from hart0 while the other harts
+ * are idle; recording is paused for the duration of the dump. cycle_hz is
+ * stored in the stream header so the converter can scale to microseconds
+ * (0 if unknown).
+ */
+void hthread_trace_reset(void);
+void hthread_trace_mark(uint32_t id);
+void hthread_trace_dump(uint64_t cycle_hz);
+
+void hthread_group_init(hthread_group_t *group);
+void hthread_group_spawn(hthread_group_t *group, void (*fn)(void *), void *arg);
+void hthread_group_wait(hthread_group_t *group);
+
+/*
+ * Run fn over [begin, end) split recursively into chunks of at most `grain`
+ * indices (0 picks a default); idle harts steal half-ranges. Returns after
+ * the whole range is done. Safe to nest inside another parallel task.
+ */
+void hthread_parallel_for(size_t begin, size_t end, size_t grain,
+                          hthread_range_fn_t fn, void *ctx);
+
 #endif
@@ -0,0 +1,275 @@
+/*
+ * wsdeque_stress.c - Host-side stress test for the thread-lib task queues.
+ *
+ * Builds wsdeque.h unmodified against pthreads, with one thread per
+ * simulated hart, and checks the queues against their sequential spec:
+ *
+ *  - deque: every pushed task is taken exactly once; owner pops always
+ *    return the newest task not yet taken; each thief observes strictly
+ *    increasing (FIFO) ids; tasks without the steal flag never migrate.
+ *  - inbox: every posted task is consumed exactly once and each producer's
+ *    tasks come out in the order it posted them.
+ *
+ * Usage: wsdeque_stress [thieves] [tasks] [rounds]
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WSQ_SIZE 64
+#include "wsdeque.h"
+
+#define STEALABLE  (1u << 0)
+#define PIN_EVERY  7u       /* every Nth task is pinned to the owner */
+#define MAX_HARTS  16u
+
+static wsdeque_t g_dq;
+static wsinbox_t g_inbox;
+
+static uint32_t g_tasks;
+static uint32_t *g_taken;           /* per-id take count */
+static uint32_t g_done;
+static uint32_t g_errors;
+static uint64_t g_steals;
+
+#define FAIL(...)                                     \
+    do {                                              \
+        __atomic_fetch_add(&g_errors, 1u, __ATOMIC_RELAXED); \
+        fprintf(stderr, "[FAIL] " __VA_ARGS__);       \
+    } while (0)
+
+static void dummy_fn(void *arg) {
+    (void)arg;
+}
+
+static htask_t make_task(uint32_t id, uint32_t owner) {
+    htask_t t = {
+        .fn = dummy_fn,
+        .arg = (void *)(uintptr_t)id,
+        .owner = owner,
+        .flags = (id % PIN_EVERY == 0u) ? 0u : STEALABLE,
+    };
+    return t;
+}
+
+static void record_take(const htask_t *t, uint32_t hart) {
+    uint32_t id = (uint32_t)(uintptr_t)t->arg;
+
+    if (id >= g_tasks || t->fn != dummy_fn) {
+        FAIL("hart %u took corrupt task id=%u\n", hart, id);
+        return;
+    }
+    if (hart != 0u && (t->flags & STEALABLE) == 0u) {
+        FAIL("hart %u stole pinned task %u\n", hart, id);
+    }
+    __atomic_fetch_add(&g_taken[id], 1u, __ATOMIC_RELAXED);
+}
+
+// ----------------------
+// Deque: one owner, many thieves
+// ----------------------
+
+static void *thief_main(void *arg) {
+    uint32_t hart = (uint32_t)(uintptr_t)arg;
+    int64_t last = -1;
+    htask_t t;
+
+    while (1) {
+        int r = wsq_steal(&g_dq, &t, STEALABLE);
+        if (r == WSQ_STEAL_OK) {
+            uint32_t id = (uint32_t)(uintptr_t)t.arg;
+            if ((int64_t)id <= last) {
+                FAIL("thief %u saw id %u after %lld (not FIFO)\n",
+                     hart, id, (long long)last);
+            }
+            last = id;
+            record_take(&t, hart);
+            __atomic_fetch_add(&g_steals, 1u, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (r == WSQ_STEAL_EMPTY && __atomic_load_n(&g_done, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void owner_run(void) {
+    // Model of the deque as seen by the owner: ids it pushed and has not
+    // popped itself, newest last. Thieves only ever remove from the front,
+    // so a successful pop must return exactly the newest entry.
+    uint32_t *model = malloc(sizeof(uint32_t) * g_tasks);
+    uint32_t depth = 0;
+    uint32_t next = 0;
+    uint32_t rng = 0x12345678u;
+    htask_t t;
+
+    while (next < g_tasks) {
+        // Random bursts of pushes and pops so the deque sweeps through
+        // empty, single-element and full states.
+        rng = rng * 1664525u + 1013904223u;
+        uint32_t burst = 1u + ((rng >> 16) % (WSQ_SIZE + 8u));
+        int do_push = ((rng >> 8) & 3u) != 0u;
+
+        // Give thieves a window even when the host has a single CPU.
+        if (((rng >> 4) & 15u) == 0u) {
+            sched_yield();
+        }
+
+        for (uint32_t i = 0; i < burst; i++) {
+            if (do_push && next < g_tasks) {
+                htask_t nt = make_task(next, 0u);
+                if (!wsq_push(&g_dq, &nt)) {
+                    break;
+                }
+                model[depth++] = next++;
+            } else {
+                if (!wsq_pop(&g_dq, &t)) {
+                    // Everything left in the model was stolen.
+                    depth = 0;
+                    break;
+                }
+                uint32_t id = (uint32_t)(uintptr_t)t.arg;
+                if (depth == 0u || model[depth - 1u] != id) {
+                    FAIL("owner popped %u, expected newest %u\n",
+                         id, depth ? model[depth - 1u] : 0xFFFFFFFFu);
+                } else {
+                    depth--;
+                }
+                record_take(&t, 0u);
+            }
+        }
+    }
+
+    while (wsq_pop(&g_dq, &t)) {
+        uint32_t id = (uint32_t)(uintptr_t)t.arg;
+        if (depth == 0u || model[depth - 1u] != id) {
+            FAIL("owner drained %u, expected newest %u\n",
+                 id, depth ? model[depth - 1u] : 0xFFFFFFFFu);
+        } else {
+            depth--;
+        }
+        record_take(&t, 0u);
+    }
+
+    free(model);
+}
+
+static void run_deque_round(uint32_t thieves) {
+    pthread_t tid[MAX_HARTS];
+
+    wsq_init(&g_dq);
+    memset(g_taken, 0, sizeof(uint32_t) * g_tasks);
+    __atomic_store_n(&g_done, 0u, __ATOMIC_RELEASE);
+
+    for (uint32_t h = 0; h < thieves; h++) {
+        pthread_create(&tid[h], NULL, thief_main, (void *)(uintptr_t)(h + 1u));
+    }
+
+    owner_run();
+    __atomic_store_n(&g_done, 1u, __ATOMIC_RELEASE);
+
+    for (uint32_t h = 0; h < thieves; h++) {
+        pthread_join(tid[h], NULL);
+    }
+
+    for (uint32_t i = 0; i < g_tasks; i++) {
+        if (g_taken[i] != 1u) {
+            FAIL("deque task %u taken %u times\n", i, g_taken[i]);
+        }
+    }
+}
+
+// ----------------------
+// Inbox: many producers, one consumer
+// ----------------------
+
+static uint32_t g_per_producer;
+
+static void *producer_main(void *arg) {
+    uint32_t p = (uint32_t)(uintptr_t)arg;
+
+    for (uint32_t i = 0; i < g_per_producer; i++) {
+        htask_t t = {
+            .fn = dummy_fn,
+            .arg = (void *)(uintptr_t)i,
+            .owner = p,
+            .flags = 0u,
+        };
+        while (!wsinbox_push(&g_inbox, &t)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void run_inbox_round(uint32_t producers) {
+    pthread_t tid[MAX_HARTS];
+    uint32_t expect[MAX_HARTS] = {0};
+    uint32_t total = producers * g_per_producer;
+    htask_t t;
+
+    wsinbox_init(&g_inbox);
+    for (uint32_t p = 0; p < producers; p++) {
+        pthread_create(&tid[p], NULL, producer_main, (void *)(uintptr_t)p);
+    }
+
+    for (uint32_t got = 0; got < total;) {
+        if (!wsinbox_pop(&g_inbox, &t)) {
+            sched_yield();
+            continue;
+        }
+        uint32_t i = (uint32_t)(uintptr_t)t.arg;
+        if (t.owner >= producers || t.fn != dummy_fn) {
+            FAIL("inbox returned corrupt task owner=%u\n", t.owner);
+        } else if (i != expect[t.owner]) {
+            FAIL("inbox producer %u: got seq %u, expected %u\n",
+                 t.owner, i, expect[t.owner]);
+            expect[t.owner] = i + 1u;
+        } else {
+            expect[t.owner]++;
+        }
+        got++;
+    }
+
+    for (uint32_t p = 0; p < producers; p++) {
+        pthread_join(tid[p], NULL);
+    }
+    if (wsinbox_pop(&g_inbox, &t)) {
+        FAIL("inbox not empty after all tasks consumed\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t thieves = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 3u;
+    uint32_t rounds = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 20u;
+    g_tasks = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 200000u;
+
+    if (thieves == 0u || thieves >= MAX_HARTS) {
+        fprintf(stderr, "thieves must be in [1, %u)\n", MAX_HARTS);
+        return 2;
+    }
+
+    g_taken = calloc(g_tasks, sizeof(uint32_t));
+    g_per_producer = g_tasks / thieves;
+
+    printf("wsdeque stress: %u thieves, %u tasks, %u rounds\n", thieves, g_tasks, rounds);
+    for (uint32_t r = 0; r < rounds; r++) {
+        run_deque_round(thieves);
+        run_inbox_round(thieves);
+    }
+
+    free(g_taken);
+
+    if (g_errors != 0u) {
+        printf("[FAIL] %u violation(s)\n", g_errors);
+        return 1;
+    }
+    printf("[PASS] deque and inbox linearizable over %u rounds (%llu steals)\n",
+           rounds, (unsigned long long)g_steals);
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * wsdeque.h - Lock-free task queues for the hthread work-stealing runtime.
+ *
+ * wsdeque_t is a bounded Chase–Lev deque (Lê et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models", PPoPP'13): the owning hart pushes
+ * and pops at `bottom` with plain stores plus fences, thieves CAS on `top`.
+ *
+ * wsinbox_t is a bounded multi-producer/single-consumer ring used when one
+ * hart hands a task to a *specific* other hart (hthread_issue), since only
+ * the owner may push onto a Chase–Lev deque.
+ *
+ * Both are header-only and depend on nothing but the GCC __atomic builtins,
+ * so the exact same code runs on the harts and in the host-side pthread
+ * stress test under thread-lib/test.
+ */
+#ifndef __WSDEQUE_H
+#define __WSDEQUE_H
+
+#include <stdint.h>
+
+#ifndef WSQ_SIZE
+#define WSQ_SIZE 64
+#endif
+
+/* top/bottom/head/tail each get their own line to avoid false sharing. */
+#ifndef WSQ_CACHE_LINE
+#define WSQ_CACHE_LINE 64
+#endif
+
+#if (WSQ_SIZE & (WSQ_SIZE - 1)) != 0
+#error "WSQ_SIZE must be a power of two"
+#endif
+
+#define WSQ_MASK ((uint32_t)(WSQ_SIZE - 1))
+
+typedef struct {
+    void (*fn)(void *);
+    void *arg;
+    /* Completion counter decremented once fn returns (hart or group). */
+    volatile uint32_t *done;
+    /* Runtime-managed metadata for ownership/steal policy. */
+    uint32_t owner;
+    uint32_t flags;
+} htask_t;
+
+typedef struct {
+    /* next slot thieves take (CAS) */
+    uint32_t top __attribute__((aligned(WSQ_CACHE_LINE)));
+    /* next free slot, written by the owner only */
+    uint32_t bottom __attribute__((aligned(WSQ_CACHE_LINE)));
+    htask_t tasks[WSQ_SIZE] __attribute__((aligned(WSQ_CACHE_LINE)));
+} wsdeque_t;
+
+typedef struct {
+    uint32_t seq;
+    htask_t task;
+} wsinbox_slot_t;
+
+typedef struct {
+    /* consumer cursor, owner only */
+    uint32_t head __attribute__((aligned(WSQ_CACHE_LINE)));
+    /* producer cursor (CAS) */
+    uint32_t tail __attribute__((aligned(WSQ_CACHE_LINE)));
+    wsinbox_slot_t slots[WSQ_SIZE] __attribute__((aligned(WSQ_CACHE_LINE)));
+} wsinbox_t;
+
+/* Return codes of wsq_steal(). */
+#define WSQ_STEAL_EMPTY   0
+#define WSQ_STEAL_OK      1
+#define WSQ_STEAL_ABORT  -1   /* lost a race with the owner or another thief */
+
+/*
+ * Slots may be read by a thief while the owner recycles them after the
+ * ring wraps. The thief's CAS on `top` then fails and the value is thrown
+ * away, but the accesses themselves must still be atomic, so copy field
+ * by field with relaxed atomics instead of a struct assignment.
+ */
+static inline void wsq_slot_store(htask_t *slot, const htask_t *task) {
+    __atomic_store_n(&slot->fn, task->fn, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->arg, task->arg, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->done, task->done, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->owner, task->owner, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->flags, task->flags, __ATOMIC_RELAXED);
+}
+
+static inline void wsq_slot_load(const htask_t *slot, htask_t *out) {
+    out->fn = __atomic_load_n(&slot->fn, __ATOMIC_RELAXED);
+    out->arg = __atomic_load_n(&slot->arg, __ATOMIC_RELAXED);
+    out->done = __atomic_load_n(&slot->done, __ATOMIC_RELAXED);
+    out->owner = __atomic_load_n(&slot->owner, __ATOMIC_RELAXED);
+    out->flags = __atomic_load_n(&slot->flags, __ATOMIC_RELAXED);
+}
+
+// ----------------------
+// Chase–Lev deque
+// ----------------------
+
+static inline void wsq_init(wsdeque_t *dq) {
+    __atomic_store_n(&dq->top, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->bottom, 0u, __ATOMIC_RELAXED);
+}
+
+// Approximate number of queued tasks; safe to call from any hart.
+static inline uint32_t wsq_size(const wsdeque_t *dq) {
+    uint32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    uint32_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+    int32_t n = (int32_t)(b - t);
+    return n > 0 ? (uint32_t)n : 0u;
+}
+
+// Owner only: push at the bottom. Returns 0 when the deque is full.
+static inline int wsq_push(wsdeque_t *dq, const htask_t *task) {
+    uint32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    uint32_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+
+    if ((int32_t)(b - t) >= (int32_t)WSQ_SIZE) {
+        return 0;
+    }
+
+    wsq_slot_store(&dq->tasks[b & WSQ_MASK], task);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&dq->bottom, b + 1u, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// Owner only: pop the most recently pushed task. Returns 0 when empty.
+static inline int wsq_pop(wsdeque_t *dq, htask_t *out) {
+    uint32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED) - 1u;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+
+    if ((int32_t)(b - t) < 0) {
+        // Already empty; restore bottom.
+        __atomic_store_n(&dq->bottom, b + 1u, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    wsq_slot_load(&dq->tasks[b & WSQ_MASK], out);
+    if (b != t) {
+        // More than one task left, no thief can reach this slot.
+        return 1;
+    }
+
+    // Last task: race thieves for it through `top`.
+    int won = __atomic_compare_exchange_n(&dq->top, &t, t + 1u, 0,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->bottom, b + 1u, __ATOMIC_RELAXED);
+    return won;
+}
+
+/*
+ * Any hart: take the oldest task if its flags contain `required_flags`.
+ * A task that is not eligible is left in place and reported as empty, so
+ * tasks pinned to their owner are never migrated.
+ */
+static inline int wsq_steal(wsdeque_t *dq, htask_t *out, uint32_t required_flags) {
+    uint32_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+
+    if ((int32_t)(b - t) <= 0) {
+        return WSQ_STEAL_EMPTY;
+    }
+
+    htask_t task;
+    wsq_slot_load(&dq->tasks[t & WSQ_MASK], &task);
+    if ((task.flags & required_flags) != required_flags) {
+        return WSQ_STEAL_EMPTY;
+    }
+
+    if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1u, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return WSQ_STEAL_ABORT;
+    }
+
+    *out = task;
+    return WSQ_STEAL_OK;
+}
+
+// ----------------------
+// MPSC inbox (bounded, per-slot sequence numbers)
+// ----------------------
+
+static inline void wsinbox_init(wsinbox_t *ib) {
+    for (uint32_t i = 0; i < WSQ_SIZE; i++) {
+        __atomic_store_n(&ib->slots[i].seq, i, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&ib->head, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&ib->tail, 0u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline int wsinbox_empty(const wsinbox_t *ib) {
+    uint32_t h = __atomic_load_n(&ib->head, __ATOMIC_RELAXED);
+    return __atomic_load_n(&ib->slots[h & WSQ_MASK].seq, __ATOMIC_ACQUIRE) != h + 1u;
+}
+
+// Any hart: enqueue for the owner. Returns 0 when the inbox is full.
+static inline int wsinbox_push(wsinbox_t *ib, const htask_t *task) {
+    uint32_t pos = __atomic_load_n(&ib->tail, __ATOMIC_RELAXED);
+    wsinbox_slot_t *slot;
+
+    while (1) {
+        slot = &ib->slots[pos & WSQ_MASK];
+        uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ib->tail, &pos, pos + 1u, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = __atomic_load_n(&ib->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->task = *task;
+    __atomic_store_n(&slot->seq, pos + 1u, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Owner only: dequeue in FIFO order. Returns 0 when empty.
+static inline int wsinbox_pop(wsinbox_t *ib, htask_t *out) {
+    uint32_t pos = __atomic_load_n(&ib->head, __ATOMIC_RELAXED);
+    wsinbox_slot_t *slot = &ib->slots[pos & WSQ_MASK];
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1u) {
+        return 0;
+    }
+
+    *out = slot->task;
+    __atomic_store_n(&ib->head, pos + 1u, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->seq, pos + WSQ_SIZE, __ATOMIC_RELEASE);
+    return 1;
+}
+
+#endif
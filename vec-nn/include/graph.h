@@ -0,0 +1,122 @@
+#ifndef VECNN_GRAPH_H
+#define VECNN_GRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*---------------------------------------------*/
+/*                                             */
+/* Model graph + activation arena planner      */
+/*                                             */
+/*---------------------------------------------*/
+/*
+ * A model is described as tensors (CHW shapes) and ops in execution order.
+ * vecnn_graph_plan() computes each tensor's live range [first_use,
+ * last_use] and packs all arena tensors into one buffer: tensors whose live
+ * ranges overlap never share bytes, everything else may. Elementwise ops
+ * (relu6, residual add) write in place over an input that dies at that op.
+ *
+ * The graph can be built at startup with the add_* helpers, or written out
+ * as static arrays. vecnn_graph_emit_c() prints the planned offsets as a
+ * header, so a plan can be frozen offline.
+ */
+
+#ifndef VECNN_GRAPH_ALIGN
+#define VECNN_GRAPH_ALIGN 64u
+#endif
+
+// Upper bound on tensors per graph (planner work arrays live on the stack).
+#ifndef VECNN_GRAPH_MAX_TENSORS
+#define VECNN_GRAPH_MAX_TENSORS 256u
+#endif
+
+typedef enum {
+    VECNN_OP_QUANT = 0,
+    VECNN_OP_DEQUANT,
+    VECNN_OP_CONV1X1,
+    VECNN_OP_DWCONV3X3,
+    VECNN_OP_INVERTED_RESIDUAL,
+    VECNN_OP_FULLY_CONNECTED,
+    VECNN_OP_MAXPOOL,
+    VECNN_OP_AVGPOOL,
+    VECNN_OP_RELU6,          // in place
+    VECNN_OP_RESIDUAL_ADD,   // in place
+    VECNN_OP_SOFTMAX,
+    VECNN_OP_OTHER,
+} vecnn_op_kind_t;
+
+// Tensor flags
+#define VECNN_TENSOR_INPUT     (1u << 0)   // live from before the first op
+#define VECNN_TENSOR_OUTPUT    (1u << 1)   // live after the last op
+#define VECNN_TENSOR_EXTERNAL  (1u << 2)   // caller-owned, not placed in the arena
+
+#define VECNN_OP_MAX_INPUTS 2
+
+typedef struct {
+    const char* name;
+    uint32_t c, h, w;
+    uint32_t elem_size;
+    uint32_t flags;
+    size_t   bytes;
+
+    // Filled in by vecnn_graph_plan()
+    size_t   offset;
+    int32_t  first_use, last_use;
+    int32_t  alias_of;       // tensor whose bytes this one reuses in place, or -1
+} vecnn_tensor_t;
+
+typedef struct {
+    vecnn_op_kind_t kind;
+    const char* name;
+    int32_t inputs[VECNN_OP_MAX_INPUTS];   // tensor ids, -1 when unused
+    int32_t output;
+} vecnn_op_t;
+
+typedef struct {
+    vecnn_tensor_t* tensors;
+    size_t n_tensors, max_tensors;
+    vecnn_op_t* ops;
+    size_t n_ops, max_ops;
+
+    // Filled in by vecnn_graph_plan()
+    size_t arena_bytes;      // planned arena size
+    size_t naive_bytes;      // one buffer per tensor
+} vecnn_graph_t;
+
+void vecnn_graph_init(
+    vecnn_graph_t* g,
+    vecnn_tensor_t* tensors, size_t max_tensors,
+    vecnn_op_t* ops, size_t max_ops
+);
+
+// Returns the tensor id, or -1 when the graph is full.
+int vecnn_graph_add_tensor(
+    vecnn_graph_t* g,
+    const char* name,
+    size_t c, size_t h, size_t w,
+    size_t elem_size,
+    uint32_t flags
+);
+
+// Ops must be added in execution order. Returns the op index or -1.
+int vecnn_graph_add_op(
+    vecnn_graph_t* g,
+    vecnn_op_kind_t kind,
+    const char* name,
+    int in0, int in1,
+    int out
+);
+
+// Returns 0 on success, -1 on a malformed graph.
+int vecnn_graph_plan(vecnn_graph_t* g);
+
+// Address of tensor `id` inside `arena` (NULL for external tensors).
+void* vecnn_graph_tensor(const vecnn_graph_t* g, void* arena, int id);
+
+// Per-tensor placement table plus arena vs. naive totals.
+void vecnn_graph_report(const vecnn_graph_t* g);
+
+// Planned offsets as #defines: <prefix>_ARENA_BYTES, <prefix>_T<id>_OFFSET.
+void vecnn_graph_emit_c(const vecnn_graph_t* g, const char* prefix);
+
+#endif
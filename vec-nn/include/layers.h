@@ -97,6 +97,63 @@ void quant_fully_connected_int8_t(
     float scale
 );
 
+/*
+ * Pre-panelized int8 weights for the packed GEMM path.
+ *
+ * vecnn_pack_weights_int8() reorders a K x N weight matrix once, at model
+ * load time, into column panels of nr = vsetvlmax(e32, m4) outputs. Each
+ * panel is contiguous and starts on a 64-byte boundary:
+ *
+ *   int32_t bias[nr] | float scale[nr] | int8_t w[K][nr]
+ *
+ * Columns past N in the last panel are zero. The packed kernels walk a
+ * panel with unit stride, block K so one slice stays in L1, and prefetch
+ * ahead into the next panel.
+ */
+typedef struct {
+    size_t  K, N;
+    size_t  nr;             // columns per panel
+    size_t  panel_stride;   // bytes between panels
+    int8_t* data;
+} vecnn_packed_weights_int8_t;
+
+// Bytes of buffer vecnn_pack_weights_int8() needs (alignment slack included).
+size_t vecnn_packed_weights_int8_size(size_t K, size_t N);
+
+/*
+ * weights: K rows of N int8 values, w_row_stride bytes apart.
+ * bias:    N int32 values, or NULL for zero bias.
+ * scale:   N per-output requantization scales.
+ */
+void vecnn_pack_weights_int8(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,
+    size_t K, size_t N,
+    const int8_t* weights, size_t w_row_stride,
+    const int32_t* bias,
+    const float* scale
+);
+
+// Same, for weights stored as N rows of K values (w_row_stride bytes apart).
+void vecnn_pack_weights_int8_nk(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,
+    size_t K, size_t N,
+    const int8_t* weights, size_t w_row_stride,
+    const int32_t* bias,
+    const float* scale
+);
+
+// quant_fully_connected_int8 on packed weights (bias and scale come from the panels).
+void quant_fully_connected_int8_packed(
+    size_t batches,
+    const int8_t* input,
+    const vecnn_packed_weights_int8_t* weights,
+    int8_t* output,
+    int relu,
+    int32_t zero_point
+);
+
 /*---------------------------------------------*/
 /*                                             */
 /* 2D Convolution Layers                       */
@@ -132,6 +189,109 @@ void conv_1x1_int8(
     requantization_params_t rqp
 );
 
+/*
+ * conv_1x1_int8 on packed weights. conv_1x1_int8_pack() repacks a
+ * conv_1x1_int8 weight blob (int32 bias[Cout] | int8 W[Cout][Cin]) with its
+ * per-channel scales, once at load time; the layer then transposes bands of
+ * pixels through `scratch` and runs the packed GEMM. Output is identical to
+ * conv_1x1_int8 with the same weights and rqp.
+ */
+size_t conv_1x1_int8_packed_size(size_t channels_in, size_t channels_out);
+
+void conv_1x1_int8_pack(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,          // conv_1x1_int8_packed_size() bytes
+    size_t channels_in,
+    size_t channels_out,
+    const void* weights,
+    const float* scale
+);
+
+// Scratch bytes for bands of `pixels` pixels (at least 1).
+size_t conv_1x1_int8_packed_scratch_size(
+    const vecnn_packed_weights_int8_t* weights,
+    size_t pixels
+);
+
+void conv_1x1_int8_packed(
+    size_t rows, size_t cols,
+    const int8_t* input,   // CHW: [K][rows][cols]
+    const vecnn_packed_weights_int8_t* weights,
+    int8_t* output,        // CHW: [N][rows][cols]
+    int relu,
+    int32_t zero_point,
+    void* scratch,
+    size_t scratch_bytes
+);
+
+/*---------------------------------------------*/
+/*                                             */
+/* Fused Inverted Residual (MobileNetV2)       */
+/*                                             */
+/*---------------------------------------------*/
+typedef enum {
+    VECNN_ACT_NONE = 0,
+    VECNN_ACT_RELU,
+    VECNN_ACT_RELU6,     // clamp to [0, 6] in the real domain of the stage's rq
+} vecnn_act_t;
+
+/*
+ * expand 1x1 -> depthwise 3x3 (SAME, stride 1 or 2) -> project 1x1
+ * [-> residual_add with the block input].
+ *
+ * Weight blobs use the same layouts as conv_1x1_int8 / dwconv2D_3x3_int8.
+ * w_expand may be NULL when hidden_ch == in_ch (expansion factor 1).
+ * The residual add uses rq_project, like residual_add() after the
+ * projection in the unfused pipeline.
+ *
+ * pk_expand / pk_project optionally point at the same 1x1 weights packed
+ * with conv_1x1_int8_pack(); the pointwise stages then run on the packed
+ * GEMM (same results, more scratch).
+ */
+typedef struct {
+    size_t in_ch, hidden_ch, out_ch;
+    size_t stride;
+    int    residual;
+    const void* w_expand;
+    const void* w_dw;
+    const void* w_project;
+    const vecnn_packed_weights_int8_t* pk_expand;     // may be NULL
+    const vecnn_packed_weights_int8_t* pk_project;    // may be NULL
+    requantization_params_t rq_expand, rq_dw, rq_project;
+    vecnn_act_t act_expand, act_dw, act_project;
+} inverted_residual_params_t;
+
+// Scratch bytes inverted_residual_int8() needs for strips of strip_rows output rows.
+size_t inverted_residual_int8_scratch_size(
+    const inverted_residual_params_t* p,
+    size_t H, size_t W,
+    size_t strip_rows
+);
+
+// Largest strip height whose scratch fits scratch_bytes (at least 1).
+size_t inverted_residual_int8_strip_rows(
+    const inverted_residual_params_t* p,
+    size_t H, size_t W,
+    size_t scratch_bytes
+);
+
+/*
+ * Computes the block one strip of output rows at a time. Expanded rows live
+ * in a ring of (strip_rows-1)*stride+3 rows per hidden channel and the
+ * depthwise output of one strip goes straight into the projection, so the
+ * hidden_ch x H x W intermediates are never materialized. `scratch` can be
+ * anywhere (L1-sized static buffer, scratchpad). input and output must not
+ * overlap.
+ */
+void inverted_residual_int8(
+    const inverted_residual_params_t* p,
+    size_t H, size_t W,
+    const int8_t* input,     // CHW: [in_ch][H][W]
+    int8_t* output,          // CHW: [out_ch][H_out][W_out]
+    void* scratch,
+    size_t strip_rows
+);
+
 /*---------------------------------------------*/
 /*                                             */
 /* Pooling Layers.                             */
@@ -161,6 +321,7 @@ void maxpool_f32(
 /* Softmax                                     */
 /*                                             */
 /*---------------------------------------------*/
+// Softmax across `channels` planes of innerSize floats, per inner position
 void softmax_vec(
     const float *i, 
     float *o, 
@@ -168,6 +329,35 @@ void softmax_vec(
     size_t innerSize
 );
 
+// Softmax over one contiguous row (attention scores, classifier logits)
+void softmax_row_f32(
+    const float *i,
+    float *o,
+    size_t size
+);
+
+// exp(-(max - x) * input_scale) for every int8 distance, built once per scale
+typedef struct {
+    float    input_scale;
+    uint16_t table[256];
+} softmax_int8_lut_t;
+
+void softmax_int8_lut_init(
+    softmax_int8_lut_t *lut,
+    float input_scale
+);
+
+// Row-wise int8 softmax, rows x size, output quantized with output_qp
+// (scale 1/256, zero_point -128 covers [0, 1))
+void softmax_int8(
+    const int8_t *input,
+    int8_t *output,
+    size_t rows,
+    size_t size,
+    const softmax_int8_lut_t *lut,
+    quantization_params_t output_qp
+);
+
 
 /*---------------------------------------------*/
 /*                                             */
@@ -0,0 +1,297 @@
+#include "graph.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Liveness-based arena planner, see graph.h.
+ *
+ * Placement is "greedy by size": arena tensors are taken largest first and
+ * each goes to the lowest aligned offset that does not overlap any already
+ * placed tensor with an intersecting live range. In-place outputs are folded
+ * into their input beforehand and take its offset.
+ */
+
+#define LIVE_BEFORE_FIRST  (-1)
+
+static size_t align_up(size_t x) {
+    return (x + VECNN_GRAPH_ALIGN - 1) / VECNN_GRAPH_ALIGN * VECNN_GRAPH_ALIGN;
+}
+
+static int op_in_place(vecnn_op_kind_t kind) {
+    return kind == VECNN_OP_RELU6 || kind == VECNN_OP_RESIDUAL_ADD;
+}
+
+static int root_of(const vecnn_graph_t* g, int id) {
+    while (g->tensors[id].alias_of >= 0) {
+        id = g->tensors[id].alias_of;
+    }
+    return id;
+}
+
+void vecnn_graph_init(
+    vecnn_graph_t* g,
+    vecnn_tensor_t* tensors, size_t max_tensors,
+    vecnn_op_t* ops, size_t max_ops)
+{
+    g->tensors = tensors;
+    g->n_tensors = 0;
+    g->max_tensors = max_tensors < VECNN_GRAPH_MAX_TENSORS ? max_tensors : VECNN_GRAPH_MAX_TENSORS;
+    g->ops = ops;
+    g->n_ops = 0;
+    g->max_ops = max_ops;
+    g->arena_bytes = 0;
+    g->naive_bytes = 0;
+}
+
+int vecnn_graph_add_tensor(
+    vecnn_graph_t* g,
+    const char* name,
+    size_t c, size_t h, size_t w,
+    size_t elem_size,
+    uint32_t flags)
+{
+    if (g->n_tensors >= g->max_tensors) {
+        return -1;
+    }
+    vecnn_tensor_t* t = &g->tensors[g->n_tensors];
+    t->name = name;
+    t->c = c;
+    t->h = h;
+    t->w = w;
+    t->elem_size = elem_size;
+    t->flags = flags;
+    t->bytes = c * h * w * elem_size;
+    t->offset = 0;
+    t->first_use = LIVE_BEFORE_FIRST;
+    t->last_use = LIVE_BEFORE_FIRST;
+    t->alias_of = -1;
+    return (int) g->n_tensors++;
+}
+
+int vecnn_graph_add_op(
+    vecnn_graph_t* g,
+    vecnn_op_kind_t kind,
+    const char* name,
+    int in0, int in1,
+    int out)
+{
+    if (g->n_ops >= g->max_ops) {
+        return -1;
+    }
+    vecnn_op_t* op = &g->ops[g->n_ops];
+    op->kind = kind;
+    op->name = name;
+    op->inputs[0] = in0;
+    op->inputs[1] = in1;
+    op->output = out;
+    return (int) g->n_ops++;
+}
+
+// ----------------------
+// Planning
+// ----------------------
+
+static int compute_live_ranges(vecnn_graph_t* g) {
+    const int32_t end = (int32_t) g->n_ops;
+
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        vecnn_tensor_t* t = &g->tensors[i];
+        t->first_use = (t->flags & VECNN_TENSOR_INPUT) ? 0 : end;
+        t->last_use = (t->flags & VECNN_TENSOR_OUTPUT) ? end : LIVE_BEFORE_FIRST;
+        t->alias_of = -1;
+    }
+
+    for (size_t o = 0; o < g->n_ops; o++) {
+        const vecnn_op_t* op = &g->ops[o];
+
+        if (op->output < 0 || (size_t) op->output >= g->n_tensors) {
+            return -1;
+        }
+        vecnn_tensor_t* out = &g->tensors[op->output];
+        if (out->first_use > (int32_t) o) {
+            out->first_use = (int32_t) o;
+        }
+        if (out->last_use < (int32_t) o) {
+            out->last_use = (int32_t) o;
+        }
+
+        for (int k = 0; k < VECNN_OP_MAX_INPUTS; k++) {
+            int in = op->inputs[k];
+            if (in < 0) {
+                continue;
+            }
+            if ((size_t) in >= g->n_tensors) {
+                return -1;
+            }
+            vecnn_tensor_t* t = &g->tensors[in];
+            if (t->first_use > (int32_t) o) {
+                // Read before anything produced it and not marked as an input.
+                return -1;
+            }
+            if (t->last_use < (int32_t) o) {
+                t->last_use = (int32_t) o;
+            }
+        }
+    }
+    return 0;
+}
+
+static void fold_in_place(vecnn_graph_t* g) {
+    for (size_t o = 0; o < g->n_ops; o++) {
+        const vecnn_op_t* op = &g->ops[o];
+        vecnn_tensor_t* out = &g->tensors[op->output];
+
+        if (!op_in_place(op->kind) || (out->flags & VECNN_TENSOR_EXTERNAL)) {
+            continue;
+        }
+
+        for (int k = 0; k < VECNN_OP_MAX_INPUTS; k++) {
+            int in = op->inputs[k];
+            if (in < 0 || in == op->output) {
+                continue;
+            }
+            int root = root_of(g, in);
+            vecnn_tensor_t* r = &g->tensors[root];
+
+            // The input must die here and own arena bytes of the same size.
+            if (g->tensors[in].last_use != (int32_t) o ||
+                r->last_use != (int32_t) o ||
+                (r->flags & (VECNN_TENSOR_EXTERNAL | VECNN_TENSOR_INPUT)) ||
+                r->bytes != out->bytes) {
+                continue;
+            }
+
+            out->alias_of = root;
+            r->last_use = out->last_use;
+            break;
+        }
+    }
+}
+
+static int overlaps(const vecnn_tensor_t* a, const vecnn_tensor_t* b) {
+    return a->first_use <= b->last_use && b->first_use <= a->last_use;
+}
+
+int vecnn_graph_plan(vecnn_graph_t* g) {
+    int16_t order[VECNN_GRAPH_MAX_TENSORS];
+    int16_t placed[VECNN_GRAPH_MAX_TENSORS];
+    size_t n_order = 0;
+    size_t n_placed = 0;
+
+    g->arena_bytes = 0;
+    g->naive_bytes = 0;
+
+    if (compute_live_ranges(g) != 0) {
+        return -1;
+    }
+    fold_in_place(g);
+
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        const vecnn_tensor_t* t = &g->tensors[i];
+        if (t->flags & VECNN_TENSOR_EXTERNAL) {
+            continue;
+        }
+        g->naive_bytes += align_up(t->bytes);
+        if (t->alias_of < 0 && t->last_use >= t->first_use) {
+            order[n_order++] = (int16_t) i;
+        }
+    }
+
+    // Largest first (insertion sort, graphs are small).
+    for (size_t i = 1; i < n_order; i++) {
+        int16_t id = order[i];
+        size_t j = i;
+        while (j > 0 && g->tensors[order[j - 1]].bytes < g->tensors[id].bytes) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = id;
+    }
+
+    for (size_t i = 0; i < n_order; i++) {
+        vecnn_tensor_t* t = &g->tensors[order[i]];
+        size_t offset = 0;
+        int moved;
+
+        // Bump past every conflicting tensor until a gap fits.
+        do {
+            moved = 0;
+            for (size_t j = 0; j < n_placed; j++) {
+                const vecnn_tensor_t* p = &g->tensors[placed[j]];
+                if (!overlaps(t, p)) {
+                    continue;
+                }
+                if (offset < p->offset + align_up(p->bytes) && p->offset < offset + align_up(t->bytes)) {
+                    offset = p->offset + align_up(p->bytes);
+                    moved = 1;
+                }
+            }
+        } while (moved);
+
+        t->offset = offset;
+        placed[n_placed++] = order[i];
+        if (offset + align_up(t->bytes) > g->arena_bytes) {
+            g->arena_bytes = offset + align_up(t->bytes);
+        }
+    }
+
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        vecnn_tensor_t* t = &g->tensors[i];
+        if (t->alias_of >= 0) {
+            t->offset = g->tensors[root_of(g, (int) i)].offset;
+        }
+    }
+    return 0;
+}
+
+void* vecnn_graph_tensor(const vecnn_graph_t* g, void* arena, int id) {
+    const vecnn_tensor_t* t = &g->tensors[id];
+    if (t->flags & VECNN_TENSOR_EXTERNAL) {
+        return NULL;
+    }
+    return (uint8_t*) arena + t->offset;
+}
+
+// ----------------------
+// Reports
+// ----------------------
+
+void vecnn_graph_report(const vecnn_graph_t* g) {
+    printf("arena plan: %u tensors, %u ops\n", (unsigned) g->n_tensors, (unsigned) g->n_ops);
+    printf("  id  %-16s %5s %4s %4s %9s %9s  live      note\n",
+           "name", "C", "H", "W", "bytes", "offset");
+
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        const vecnn_tensor_t* t = &g->tensors[i];
+        printf("  %-3u %-16s %5u %4u %4u %9u ",
+               (unsigned) i, t->name ? t->name : "-",
+               (unsigned) t->c, (unsigned) t->h, (unsigned) t->w,
+               (unsigned) t->bytes);
+        if (t->flags & VECNN_TENSOR_EXTERNAL) {
+            printf("%9s  [%3d,%3d]  external\n", "-", (int) t->first_use, (int) t->last_use);
+        } else if (t->alias_of >= 0) {
+            printf("%9u  [%3d,%3d]  in place of %d\n", (unsigned) t->offset,
+                   (int) t->first_use, (int) t->last_use, (int) t->alias_of);
+        } else {
+            printf("%9u  [%3d,%3d]\n", (unsigned) t->offset,
+                   (int) t->first_use, (int) t->last_use);
+        }
+    }
+
+    unsigned pct = g->naive_bytes ? (unsigned) ((uint64_t) g->arena_bytes * 100u / g->naive_bytes) : 0u;
+    printf("arena: %u bytes, naive: %u bytes (%u%%)\n",
+           (unsigned) g->arena_bytes, (unsigned) g->naive_bytes, pct);
+}
+
+void vecnn_graph_emit_c(const vecnn_graph_t* g, const char* prefix) {
+    printf("#define %s_ARENA_BYTES %uu\n", prefix, (unsigned) g->arena_bytes);
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        const vecnn_tensor_t* t = &g->tensors[i];
+        if (t->flags & VECNN_TENSOR_EXTERNAL) {
+            continue;
+        }
+        printf("#define %s_T%u_OFFSET %uu  /* %s */\n", prefix, (unsigned) i,
+               (unsigned) t->offset, t->name ? t->name : "-");
+    }
+}
@@ -17,18 +17,76 @@ void conv_1x1_int8(
 ) {
 
     if (relu) {
-        int8_qgemm_int32bias_conv1x1_relu(
+        int8_qgemm_int32bias_conv1x1_relu_mc(
             channels_out, rows*cols, channels_in, 
             weights, channels_in,
             input, 
             output, rows*cols, 1,
             rqp);
     } else {
-        int8_qgemm_int32bias_conv1x1(
+        int8_qgemm_int32bias_conv1x1_mc(
             channels_out, rows*cols, channels_in, 
             weights, channels_in,
             input, 
             output, rows*cols, 1,
             rqp);
     }
-}
\ No newline at end of file
+}
+size_t conv_1x1_int8_packed_size(size_t channels_in, size_t channels_out) {
+    return vecnn_packed_weights_int8_size(channels_in, channels_out);
+}
+
+void conv_1x1_int8_pack(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,
+    size_t channels_in,
+    size_t channels_out,
+    const void* weights,
+    const float* scale
+) {
+    const int32_t* bias = (const int32_t*) weights;
+    const int8_t* w = (const int8_t*) (bias + channels_out);
+
+    vecnn_pack_weights_int8_nk(out, buffer, channels_in, channels_out,
+                               w, channels_in, bias, scale);
+}
+
+size_t conv_1x1_int8_packed_scratch_size(
+    const vecnn_packed_weights_int8_t* weights,
+    size_t pixels
+) {
+    return pixels * (weights->K + weights->N);
+}
+
+void conv_1x1_int8_packed(
+    size_t rows, size_t cols,
+    const int8_t* input,
+    const vecnn_packed_weights_int8_t* weights,
+    int8_t* output,
+    int relu,
+    int32_t zero_point,
+    void* scratch,
+    size_t scratch_bytes
+) {
+    const size_t hw = rows * cols;
+    size_t band = scratch_bytes / (weights->K + weights->N);
+
+    // Whole 7-row micro-kernel blocks per band where the scratch allows.
+    if (band >= 7) {
+        band -= band % 7;
+    }
+    if (band == 0) {
+        return;
+    }
+
+    for (size_t p = 0; p < hw; p += band) {
+        size_t n = (hw - p < band) ? hw - p : band;
+        int8_qgemm_packed_chw_mc(
+            n,
+            input + p, hw,
+            weights,
+            output + p, hw,
+            zero_point, relu,
+            (int8_t*) scratch);
+    }
+}
@@ -52,7 +52,7 @@ void quant_fully_connected_int8_t(
     float* output,
     float scale)
 {
-    int8_qgemm_fout(
+    int8_qgemm_fout_mc(
         batches, output_size, input_size,
         input, input_size,
         (const int8_t*)weights_t_pack,
@@ -73,14 +73,14 @@ void quant_fully_connected_int8 (
 
     if (bias32) {
         if (relu) {
-            int8_qgemm_int32bias_relu(
+            int8_qgemm_int32bias_relu_mc(
                 batches, output_size, input_size, 
                 input, input_size, 
                 weights_with_bias, 
                 output, output_size, 1,
                 requant_params);
         } else {
-            int8_qgemm_int32bias(
+            int8_qgemm_int32bias_mc(
                 batches, output_size, input_size, 
                 input, input_size, 
                 weights_with_bias, 
@@ -89,14 +89,14 @@ void quant_fully_connected_int8 (
         }
     } else {
         if (relu) {
-            int8_qgemm_relu(
+            int8_qgemm_relu_mc(
                 batches, output_size, input_size, 
                 input, input_size, 
                 weights_with_bias, 
                 output, output_size, 1,
                 requant_params);
         } else {
-            int8_qgemm(
+            int8_qgemm_mc(
                 batches, output_size, input_size, 
                 input, input_size, 
                 weights_with_bias, 
@@ -104,4 +104,20 @@ void quant_fully_connected_int8 (
                 requant_params);
         }
     }
-}
\ No newline at end of file
+}
+
+void quant_fully_connected_int8_packed(
+    size_t batches,
+    const int8_t* input,
+    const vecnn_packed_weights_int8_t* weights,
+    int8_t* output,
+    int relu,
+    int32_t zero_point
+) {
+    int8_qgemm_packed_mc(
+        batches,
+        input, weights->K,
+        weights,
+        output, weights->N,
+        zero_point, relu);
+}
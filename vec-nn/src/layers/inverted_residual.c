@@ -0,0 +1,265 @@
+#include "layers.h"
+#include "ops/conv2D/conv2D.h"
+#include "ops/matmul/matmul.h"
+
+#include <math.h>
+#include <riscv_vector.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Row-strip MobileNetV2 inverted residual block, see layers.h.
+ *
+ * Scratch layout (each part 64-byte aligned):
+ *   ring    [hidden_ch][ring_rows][W + 2]  expanded input rows, zero pad columns
+ *   pad_row [W + 2]                        zeros, stands in for rows outside the image
+ *   dw_buf  [hidden_ch][strip_rows][W_out] depthwise output of one strip
+ *   pk_buf  transposes for the packed pointwise stages (only with pk_*)
+ *
+ * Input row y lives in ring slot y % ring_rows. A strip needs at most
+ * ring_rows consecutive input rows and rows are expanded in order, so the
+ * rows still needed are never overwritten; the 3 - stride rows shared with
+ * the previous strip are reused instead of expanded twice.
+ */
+
+#define IR_ALIGN 64u
+
+typedef struct {
+    size_t H_out, W_out;
+    size_t row_bytes;
+    size_t ring_rows;
+    size_t ring_bytes;
+    size_t pad_bytes;
+    size_t dw_bytes;
+    size_t pk_bytes;
+} ir_layout_t;
+
+static size_t ir_align(size_t x) {
+    return (x + IR_ALIGN - 1) / IR_ALIGN * IR_ALIGN;
+}
+
+static void ir_layout(const inverted_residual_params_t* p, size_t H, size_t W,
+                      size_t strip_rows, ir_layout_t* l)
+{
+    l->H_out = (H - 1) / p->stride + 1;
+    l->W_out = (W - 1) / p->stride + 1;
+    l->row_bytes = W + 2;
+    l->ring_rows = (strip_rows - 1) * p->stride + 3;
+    l->ring_bytes = ir_align(p->hidden_ch * l->ring_rows * l->row_bytes);
+    l->pad_bytes = ir_align(l->row_bytes);
+    l->dw_bytes = ir_align(p->hidden_ch * strip_rows * l->W_out);
+
+    // int8_qgemm_packed_chw() needs n * (K + N) bytes per call.
+    size_t pk_expand = (p->pk_expand && p->w_expand) ? W * (p->in_ch + p->hidden_ch) : 0;
+    size_t pk_project = p->pk_project
+                      ? strip_rows * l->W_out * (p->hidden_ch + p->out_ch) : 0;
+    l->pk_bytes = ir_align(pk_expand > pk_project ? pk_expand : pk_project);
+}
+
+// Output bounds of a stage in the quantized domain, matching relu6_int8().
+static int32_t ir_act_min(vecnn_act_t act, const requantization_params_t* rq) {
+    return act == VECNN_ACT_NONE ? -128 : rq->zero_point;
+}
+
+static int32_t ir_act_max(vecnn_act_t act, const requantization_params_t* rq, size_t c) {
+    if (act != VECNN_ACT_RELU6) {
+        return 127;
+    }
+    float scale_c = rq->scale[c];
+    if (scale_c <= 0.0f) {
+        scale_c = 1.0f;
+    }
+    int32_t hi = rq->zero_point + (int32_t) lrintf(6.0f * (1.0f / scale_c));
+    return hi < 127 ? hi : 127;
+}
+
+static void ir_clamp_max(int8_t* x, size_t n, int32_t hi) {
+    if (hi >= 127) {
+        return;
+    }
+    while (n > 0) {
+        size_t vl = __riscv_vsetvl_e8m8(n);
+        vint8m8_t v = __riscv_vle8_v_i8m8(x, vl);
+        v = __riscv_vmin_vx_i8m8(v, (int8_t) hi, vl);
+        __riscv_vse8_v_i8m8(x, v, vl);
+        x += vl;
+        n -= vl;
+    }
+}
+
+// Expand input row iy into its ring slot (columns 1..W).
+static void ir_expand_row(const inverted_residual_params_t* p, size_t H, size_t W,
+                          const ir_layout_t* l, const int8_t* input,
+                          int8_t* ring, int8_t* pk_buf, size_t iy)
+{
+    const size_t ch_stride = l->ring_rows * l->row_bytes;
+    int8_t* dst = ring + (iy % l->ring_rows) * l->row_bytes + 1;
+
+    if (p->w_expand == NULL) {
+        for (size_t c = 0; c < p->hidden_ch; c++) {
+            memcpy(dst + c * ch_stride, input + c * H * W + iy * W, W);
+        }
+        return;
+    }
+
+    if (p->pk_expand) {
+        int8_qgemm_packed_chw(
+            W, input + iy * W, H * W,
+            p->pk_expand,
+            dst, ch_stride,
+            p->rq_expand.zero_point, p->act_expand != VECNN_ACT_NONE,
+            pk_buf);
+    } else {
+        // B is the whole input (ldb = H*W) shifted to row iy; one row of N.
+        int8_qgemm_int32bias_conv1x1_tile(
+            p->hidden_ch, H * W, p->in_ch,
+            p->w_expand, p->in_ch,
+            input + iy * W,
+            dst, ch_stride, 1,
+            p->rq_expand, p->act_expand != VECNN_ACT_NONE,
+            0, p->hidden_ch, 0, W);
+    }
+
+    if (p->act_expand == VECNN_ACT_RELU6) {
+        for (size_t c = 0; c < p->hidden_ch; c++) {
+            ir_clamp_max(dst + c * ch_stride, W, ir_act_max(p->act_expand, &p->rq_expand, c));
+        }
+    }
+}
+
+size_t inverted_residual_int8_scratch_size(
+    const inverted_residual_params_t* p,
+    size_t H, size_t W,
+    size_t strip_rows)
+{
+    ir_layout_t l;
+    ir_layout(p, H, W, strip_rows ? strip_rows : 1, &l);
+    return l.ring_bytes + l.pad_bytes + l.dw_bytes + l.pk_bytes + IR_ALIGN;
+}
+
+size_t inverted_residual_int8_strip_rows(
+    const inverted_residual_params_t* p,
+    size_t H, size_t W,
+    size_t scratch_bytes)
+{
+    size_t H_out = (H - 1) / p->stride + 1;
+    size_t rows = 1;
+    while (rows < H_out &&
+           inverted_residual_int8_scratch_size(p, H, W, rows + 1) <= scratch_bytes) {
+        rows++;
+    }
+    return rows;
+}
+
+void inverted_residual_int8(
+    const inverted_residual_params_t* p,
+    size_t H, size_t W,
+    const int8_t* input,
+    int8_t* output,
+    void* scratch,
+    size_t strip_rows)
+{
+    ir_layout_t l;
+    size_t H_out = (H - 1) / p->stride + 1;
+
+    if (strip_rows == 0) {
+        strip_rows = 1;
+    }
+    if (strip_rows > H_out) {
+        strip_rows = H_out;
+    }
+    ir_layout(p, H, W, strip_rows, &l);
+
+    int8_t* ring = (int8_t*) ir_align((uintptr_t) scratch);
+    int8_t* pad_row = ring + l.ring_bytes;
+    int8_t* dw_buf = pad_row + l.pad_bytes;
+    int8_t* pk_buf = dw_buf + l.dw_bytes;
+    const size_t ring_ch_stride = l.ring_rows * l.row_bytes;
+    const size_t plane_out = l.H_out * l.W_out;
+
+    // Only the pad columns have to be zero; the rest is overwritten.
+    memset(ring, 0, l.ring_bytes);
+    memset(pad_row, 0, l.row_bytes);
+
+    const int32_t* dw_bias = (const int32_t*) p->w_dw;
+    const int8_t* dw_k = (const int8_t*) (dw_bias + p->hidden_ch);
+    const int32_t dw_min = ir_act_min(p->act_dw, &p->rq_dw);
+    size_t next_row = 0;
+
+    for (size_t oy0 = 0; oy0 < l.H_out; oy0 += strip_rows) {
+        size_t rows = (l.H_out - oy0 < strip_rows) ? l.H_out - oy0 : strip_rows;
+
+        // 1) expand the input rows this strip needs that are not in the ring yet
+        size_t last_row = (oy0 + rows - 1) * p->stride + 1;
+        if (last_row > H - 1) {
+            last_row = H - 1;
+        }
+        for (; next_row <= last_row; next_row++) {
+            ir_expand_row(p, H, W, &l, input, ring, pk_buf, next_row);
+        }
+
+        // 2) depthwise 3x3 over the ring into dw_buf
+        for (size_t c = 0; c < p->hidden_ch; c++) {
+            const int8_t* ring_c = ring + c * ring_ch_stride;
+            const int32_t dw_max = ir_act_max(p->act_dw, &p->rq_dw, c);
+
+            for (size_t r = 0; r < rows; r++) {
+                const int8_t* in_rows[3];
+                for (size_t t = 0; t < 3; t++) {
+                    // input row (oy * stride - 1 + t), shifted by one to stay unsigned
+                    size_t y1 = (oy0 + r) * p->stride + t;
+                    in_rows[t] = (y1 == 0 || y1 > H) ? pad_row
+                               : ring_c + ((y1 - 1) % l.ring_rows) * l.row_bytes;
+                }
+                dwconv_3x3_int8_row(
+                    l.W_out, p->stride,
+                    dw_k + c * 9,
+                    in_rows[0], in_rows[1], in_rows[2],
+                    dw_buf + (c * rows + r) * l.W_out,
+                    dw_bias[c],
+                    p->rq_dw.zero_point,
+                    p->rq_dw.scale[c],
+                    dw_min, dw_max);
+            }
+        }
+
+        // 3) project the strip straight into the output rows
+        int8_t* out = output + oy0 * l.W_out;
+        size_t n = rows * l.W_out;
+        if (p->pk_project) {
+            int8_qgemm_packed_chw(
+                n, dw_buf, n,
+                p->pk_project,
+                out, plane_out,
+                p->rq_project.zero_point, p->act_project != VECNN_ACT_NONE,
+                pk_buf);
+        } else {
+            int8_qgemm_int32bias_conv1x1_tile(
+                p->out_ch, n, p->hidden_ch,
+                p->w_project, p->hidden_ch,
+                dw_buf,
+                out, plane_out, 1,
+                p->rq_project, p->act_project != VECNN_ACT_NONE,
+                0, p->out_ch, 0, n);
+        }
+
+        for (size_t c = 0; c < p->out_ch; c++) {
+            int8_t* out_c = out + c * plane_out;
+
+            if (p->act_project == VECNN_ACT_RELU6) {
+                ir_clamp_max(out_c, n, ir_act_max(p->act_project, &p->rq_project, c));
+            }
+
+            // 4) residual (stride 1, so input and output rows line up)
+            if (p->residual) {
+                requantization_params_t rq_c = {
+                    .scale = p->rq_project.scale + c,
+                    .zero_point = p->rq_project.zero_point,
+                };
+                residual_add(rows, l.W_out, 1,
+                             (int8_t*) input + c * H * W + oy0 * W,
+                             out_c, out_c, rq_c);
+            }
+        }
+    }
+}
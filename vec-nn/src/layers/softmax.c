@@ -5,8 +5,8 @@
 #include "ops/ara/exp.h"
 
 void softmax_vec(
-    const float *i, 
-    float *o, 
+    const float *i,
+    float *o,
     size_t channels,
     size_t innerSize) {
 
@@ -23,10 +23,11 @@ void softmax_vec(
 
   // Vector registers
   vfloat32m1_t max_chunk_v;
+  vfloat32m1_t new_max_v;
   vfloat32m1_t buf_chunk_v;
-  vfloat32m1_t num_chunk_v;
   vfloat32m1_t den_chunk_v;
-  vfloat32m1_t res_chunk_v;
+  vfloat32m1_t inv_chunk_v;
+  vbool32_t    grew;
 
   // Stripmine on innerSize
   for (vl = __riscv_vsetvl_e32m1(avl); avl > 0; avl -= vl) {
@@ -34,11 +35,12 @@ void softmax_vec(
     vl = __riscv_vsetvl_e32m1(avl);
 
     /*
-      Calculate the maximum along the channel dimension
+      Online pass: running maximum and rescaled sum along the channel dimension
     */
 
-    // Initialize the max vector
+    // Initialize the max vector with channel 0, whose exp(x - max) is 1
     max_chunk_v = __riscv_vle32_v_f32m1(__i, vl);
+    den_chunk_v = __riscv_vfmv_v_f_f32m1(1.0f, vl);
     // Bump the pointer
     __i += innerSize;
     for (size_t ch = 1; ch < channels; ++ch) {
@@ -46,51 +48,43 @@ void softmax_vec(
       buf_chunk_v = __riscv_vle32_v_f32m1(__i, vl);
       // Bump the channel pointer
       __i += innerSize;
-      // Calculate the elm-wise maximum between the two chunks
-      max_chunk_v = __riscv_vfmax_vv_f32m1(max_chunk_v, buf_chunk_v, vl);
+      // Rescale the sum only if some lane saw a new maximum
+      grew = __riscv_vmfgt_vv_f32m1_b32(buf_chunk_v, max_chunk_v, vl);
+      if (__riscv_vcpop_m_b32(grew, vl)) {
+        new_max_v = __riscv_vfmax_vv_f32m1(max_chunk_v, buf_chunk_v, vl);
+        // sum *= exp(old_max - new_max), 1.0 on lanes that did not grow
+        max_chunk_v = __riscv_vfsub_vv_f32m1(max_chunk_v, new_max_v, vl);
+        den_chunk_v = __riscv_vfmul_vv_f32m1(den_chunk_v, __exp_f32m1(max_chunk_v, vl), vl);
+        max_chunk_v = new_max_v;
+      }
+      // Accumulate exp(x - max)
+      buf_chunk_v = __riscv_vfsub_vv_f32m1(buf_chunk_v, max_chunk_v, vl);
+      den_chunk_v = __riscv_vfadd_vv_f32m1(den_chunk_v, __exp_f32m1(buf_chunk_v, vl), vl);
     }
     // Restore the channel pointer
     __i = _i;
 
+    // One reciprocal per lane instead of one division per element
+    inv_chunk_v = __riscv_vfrdiv_vf_f32m1(den_chunk_v, 1.0f, vl);
+
     /*
-      Fetch, subtract, exponentiate along the channel dimension
+      Fetch, subtract, exponentiate and scale along the channel dimension
     */
 
-    // Initialize accumulator
-    den_chunk_v = __riscv_vfmv_v_f_f32m1(0, vl);
     for (size_t ch = 0; ch < channels; ++ch) {
       // Fetch one chunk from channel ch
       buf_chunk_v = __riscv_vle32_v_f32m1(__i, vl);
       // Subtract the maximum
       buf_chunk_v = __riscv_vfsub_vv_f32m1(buf_chunk_v, max_chunk_v, vl);
-      // Exponentiate
+      // Exponentiate and normalize
       buf_chunk_v = __exp_f32m1(buf_chunk_v, vl);
-      // Store the numerator to memory
+      buf_chunk_v = __riscv_vfmul_vv_f32m1(buf_chunk_v, inv_chunk_v, vl);
+      // Store the result to memory
       __riscv_vse32_v_f32m1(__o, buf_chunk_v, vl);
-      // Accumulate
-      den_chunk_v = __riscv_vfadd_vv_f32m1(den_chunk_v, buf_chunk_v, vl);
       // Bump channel pointers
       __i += innerSize;
       __o += innerSize;
     }
-    // Restore the pointers
-    __i = _i;
-    __o = _o;
-
-    /*
-      Divide by the computed sum
-    */
-
-    for (size_t ch = 0; ch < channels; ++ch) {
-      // Load numerator from memory
-      num_chunk_v = __riscv_vle32_v_f32m1(__o, vl);
-      // Divide
-      res_chunk_v = __riscv_vfdiv_vv_f32m1(num_chunk_v, den_chunk_v, vl);
-      // Store the result to memory
-      __riscv_vse32_v_f32m1(__o, res_chunk_v, vl);
-      // Bump channel pointers
-      __o += innerSize;
-    }
     // Bump stripmining pointers
     _i += vl;
     _o += vl;
@@ -98,4 +92,127 @@ void softmax_vec(
     __i = _i;
     __o = _o;
   }
-}
\ No newline at end of file
+}
+
+void softmax_row_f32(
+    const float *i,
+    float *o,
+    size_t size) {
+
+  if (size == 0) return;
+
+  size_t vl;
+  float max_val = i[0];
+  float sum = 0.0f;
+
+  /*
+    Online pass: each chunk is reduced to its maximum, the running sum is
+    rescaled by exp(old_max - new_max) when that maximum grows
+  */
+
+  for (size_t n = 0; n < size; n += vl) {
+    vl = __riscv_vsetvl_e32m4(size - n);
+    vfloat32m4_t x_v = __riscv_vle32_v_f32m4(i + n, vl);
+
+    vfloat32m1_t red_v = __riscv_vfmv_s_f_f32m1(max_val, 1);
+    red_v = __riscv_vfredmax_vs_f32m4_f32m1(x_v, red_v, vl);
+    float chunk_max = __riscv_vfmv_f_s_f32m1_f32(red_v);
+    if (chunk_max > max_val) {
+      sum *= expf(max_val - chunk_max);
+      max_val = chunk_max;
+    }
+
+    x_v = __riscv_vfsub_vf_f32m4(x_v, max_val, vl);
+    x_v = __exp_f32m4(x_v, vl);
+    red_v = __riscv_vfmv_s_f_f32m1(sum, 1);
+    red_v = __riscv_vfredusum_vs_f32m4_f32m1(x_v, red_v, vl);
+    sum = __riscv_vfmv_f_s_f32m1_f32(red_v);
+  }
+
+  /*
+    Second pass: recompute the numerators and scale by 1/sum
+  */
+
+  float inv_sum = 1.0f / sum;
+  for (size_t n = 0; n < size; n += vl) {
+    vl = __riscv_vsetvl_e32m4(size - n);
+    vfloat32m4_t x_v = __riscv_vle32_v_f32m4(i + n, vl);
+    x_v = __riscv_vfsub_vf_f32m4(x_v, max_val, vl);
+    x_v = __exp_f32m4(x_v, vl);
+    x_v = __riscv_vfmul_vf_f32m4(x_v, inv_sum, vl);
+    __riscv_vse32_v_f32m4(o + n, x_v, vl);
+  }
+}
+
+void softmax_int8_lut_init(
+    softmax_int8_lut_t *lut,
+    float input_scale) {
+
+  lut->input_scale = input_scale;
+  // table[d] = exp(-d * scale) in unsigned Q0.16, d = max - x in [0, 255]
+  for (int d = 0; d < 256; ++d) {
+    float e = expf(-(float)d * input_scale) * 65535.0f;
+    lut->table[d] = (uint16_t)(e + 0.5f);
+  }
+}
+
+void softmax_int8(
+    const int8_t *input,
+    int8_t *output,
+    size_t rows,
+    size_t size,
+    const softmax_int8_lut_t *lut,
+    quantization_params_t output_qp) {
+
+  if (size == 0) return;
+
+  size_t vl;
+  const int32_t zp = output_qp.zero_point;
+  const float min_less_zp = (float)(-128 - zp);
+  const float max_less_zp = (float)(127 - zp);
+
+  for (size_t r = 0; r < rows; ++r) {
+    const int8_t *x = input + r * size;
+    int8_t *y = output + r * size;
+
+    // Row maximum
+    vint8m1_t max_v = __riscv_vmv_s_x_i8m1(-128, 1);
+    for (size_t n = 0; n < size; n += vl) {
+      vl = __riscv_vsetvl_e8m1(size - n);
+      vint8m1_t x_v = __riscv_vle8_v_i8m1(x + n, vl);
+      max_v = __riscv_vredmax_vs_i8m1_i8m1(x_v, max_v, vl);
+    }
+    int16_t max_val = __riscv_vmv_x_s_i8m1_i8(max_v);
+
+    // Sum of table[max - x]; 65535 * size stays within 32 bits for any row
+    // under 65537 elements
+    vuint32m1_t sum_v = __riscv_vmv_s_x_u32m1(0, 1);
+    for (size_t n = 0; n < size; n += vl) {
+      vl = __riscv_vsetvl_e8m1(size - n);
+      vint16m2_t d_v = __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(x + n, vl), vl);
+      d_v = __riscv_vrsub_vx_i16m2(d_v, max_val, vl);
+      vuint16m2_t off_v = __riscv_vsll_vx_u16m2(__riscv_vreinterpret_v_i16m2_u16m2(d_v), 1, vl);
+      vuint16m2_t e_v = __riscv_vluxei16_v_u16m2(lut->table, off_v, vl);
+      sum_v = __riscv_vwredsumu_vs_u16m2_u32m1(e_v, sum_v, vl);
+    }
+    uint32_t sum = __riscv_vmv_x_s_u32m1_u32(sum_v);
+
+    // p = table[d] / sum, quantized as p / out_scale + zp
+    float inv = 1.0f / ((float)sum * output_qp.scale);
+    for (size_t n = 0; n < size; n += vl) {
+      vl = __riscv_vsetvl_e8m1(size - n);
+      vint16m2_t d_v = __riscv_vsext_vf2_i16m2(__riscv_vle8_v_i8m1(x + n, vl), vl);
+      d_v = __riscv_vrsub_vx_i16m2(d_v, max_val, vl);
+      vuint16m2_t off_v = __riscv_vsll_vx_u16m2(__riscv_vreinterpret_v_i16m2_u16m2(d_v), 1, vl);
+      vuint16m2_t e_v = __riscv_vluxei16_v_u16m2(lut->table, off_v, vl);
+
+      vfloat32m4_t p_v = __riscv_vfwcvt_f_xu_v_f32m4(e_v, vl);
+      p_v = __riscv_vfmul_vf_f32m4(p_v, inv, vl);
+      p_v = __riscv_vfmax_vf_f32m4(p_v, min_less_zp, vl);
+      p_v = __riscv_vfmin_vf_f32m4(p_v, max_less_zp, vl);
+      vint16m2_t q_v = __riscv_vfncvt_x_f_w_i16m2(p_v, vl);
+      q_v = __riscv_vadd_vx_i16m2(q_v, zp, vl);
+      __riscv_vse8_v_i8m1(y + n, __riscv_vncvt_x_x_w_i8m1(q_v, vl), vl);
+    }
+  }
+}
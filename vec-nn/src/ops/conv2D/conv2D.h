@@ -24,4 +24,15 @@ void dwconv_3x3_int8_VCO_relu(
     int8_t *input, 
     int8_t *output,
     requantization_params_t requant_params
-);
\ No newline at end of file
+);
+
+void dwconv_3x3_int8_row(
+    size_t cols, size_t stride,
+    const int8_t* k,
+    const int8_t* r0, const int8_t* r1, const int8_t* r2,
+    int8_t* out,
+    int32_t bias,
+    int32_t zero_point,
+    float scale,
+    int32_t out_min, int32_t out_max
+);
@@ -0,0 +1,63 @@
+#include "ops/conv2D/conv2D.h"
+
+#include <riscv_vector.h>
+#include <stdint.h>
+
+/*
+ * One output row of a 3x3 depthwise conv for one channel.
+ *
+ * r0/r1/r2 are the three input rows under the kernel, each already padded
+ * with one column on the left and right (SAME padding), so the row kernel
+ * never looks at image borders. Used by the row-strip operators, which keep
+ * only a few input rows resident and cannot use the whole-channel kernels.
+ */
+void dwconv_3x3_int8_row(
+    size_t cols, size_t stride,
+    const int8_t* k,
+    const int8_t* r0, const int8_t* r1, const int8_t* r2,
+    int8_t* out,
+    int32_t bias,
+    int32_t zero_point,
+    float scale,
+    int32_t out_min, int32_t out_max)
+{
+    const int16_t k0 = k[0], k1 = k[1], k2 = k[2];
+    const int16_t k3 = k[3], k4 = k[4], k5 = k[5];
+    const int16_t k6 = k[6], k7 = k[7], k8 = k[8];
+
+    const float vout_min_minus_zp = out_min - zero_point;
+    const float vout_max_minus_zp = out_max - zero_point;
+    const ptrdiff_t in_step = (ptrdiff_t) stride;
+
+    do {
+        size_t vl = __riscv_vsetvl_e32m4(cols);
+        vint32m4_t vacc = __riscv_vmv_v_x_i32m4(bias, vl);
+        vint16m2_t vin;
+
+#define DW_TAP(row, off, kk)                                                          \
+        vin = __riscv_vwcvt_x_x_v_i16m2(stride == 1                                   \
+            ? __riscv_vle8_v_i8m1((row) + (off), vl)                                  \
+            : __riscv_vlse8_v_i8m1((row) + (off), in_step, vl), vl);                  \
+        vacc = __riscv_vwmacc_vx_i32m4(vacc, (kk), vin, vl)
+
+        DW_TAP(r0, 0, k0); DW_TAP(r0, 1, k1); DW_TAP(r0, 2, k2);
+        DW_TAP(r1, 0, k3); DW_TAP(r1, 1, k4); DW_TAP(r1, 2, k5);
+        DW_TAP(r2, 0, k6); DW_TAP(r2, 1, k7); DW_TAP(r2, 2, k8);
+
+#undef DW_TAP
+
+        vfloat32m4_t vfacc = __riscv_vfcvt_f_x_v_f32m4(vacc, vl);
+        vfacc = __riscv_vfmul_vf_f32m4(vfacc, scale, vl);
+        vfacc = __riscv_vfmax_vf_f32m4(vfacc, vout_min_minus_zp, vl);
+        vfacc = __riscv_vfmin_vf_f32m4(vfacc, vout_max_minus_zp, vl);
+        vint16m2_t vout16 = __riscv_vfncvt_x_f_w_i16m2(vfacc, vl);
+        vout16 = __riscv_vadd_vx_i16m2(vout16, (int16_t) zero_point, vl);
+        __riscv_vse8_v_i8m1(out, __riscv_vncvt_x_x_w_i8m1(vout16, vl), vl);
+
+        r0 += vl * stride;
+        r1 += vl * stride;
+        r2 += vl * stride;
+        out += vl;
+        cols -= vl;
+    } while (cols != 0);
+}
@@ -93,4 +93,167 @@ void int8_qgemm_fout(
     const int8_t* B,
     float* C, size_t c_row_stride,
     size_t c_col_stride,
-    float scale);
\ No newline at end of file
+    float scale);
+
+/*
+ * Tile entry points: compute only C[m_begin:m_end, n_begin:n_end] of the
+ * full M x N problem. A, B, C and the requantization parameters describe
+ * the whole problem, so disjoint tiles may run on different harts.
+ */
+void int8_qgemm_tile(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params,
+    int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end);
+
+void int8_qgemm_int32bias_tile(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params,
+    int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end);
+
+void int8_qgemm_int32bias_conv1x1_tile(
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params,
+    int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end);
+
+void int8_qgemm_fout_tile(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    float* C, size_t c_row_stride,
+    size_t c_col_stride,
+    float scale,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end);
+
+/*
+ * Multi-hart versions (qgemm_int8_mc.c). Same arguments and results as the
+ * single-hart functions; the work is tiled across all harts with M- or
+ * N-split chosen from the shape. Fall back to the single-hart kernels when
+ * vecnn is built without VECNN_MULTICORE.
+ */
+void int8_qgemm_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params);
+
+void int8_qgemm_relu_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params);
+
+void int8_qgemm_int32bias_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params);
+
+void int8_qgemm_int32bias_relu_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params);
+
+void int8_qgemm_int32bias_conv1x1_mc(
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params);
+
+void int8_qgemm_int32bias_conv1x1_relu_mc(
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params);
+
+void int8_qgemm_fout_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    float* C, size_t c_row_stride,
+    size_t c_col_stride,
+    float scale);
+
+/*
+ * Packed-weight int8 GEMM (qgemm_int8_packed_rvv.c). B is a
+ * vecnn_packed_weights_int8_t, which carries N, K, bias and per-column
+ * scale; C is contiguous int8 with c_row_stride bytes between rows. For the
+ * tile version n_begin must be a multiple of B->nr.
+ */
+void int8_qgemm_packed(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu);
+
+void int8_qgemm_packed_tile(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end);
+
+void int8_qgemm_packed_mc(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu);
+
+/*
+ * Packed GEMM on channel-major activations, for 1x1 convolutions. The n
+ * pixels at `input` (B->K channels, in_ch_stride bytes apart) are
+ * transposed into scratch, multiplied by B and written back channel-major
+ * to `output` (B->N channels, out_ch_stride bytes apart). scratch holds
+ * n * (B->K + B->N) bytes. Results match int8_qgemm_int32bias_conv1x1 on
+ * the unpacked weights.
+ */
+void int8_qgemm_packed_chw(
+    size_t n,
+    const int8_t* input, size_t in_ch_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* output, size_t out_ch_stride,
+    int32_t zero_point, int relu,
+    int8_t* scratch);
+
+void int8_qgemm_packed_chw_mc(
+    size_t n,
+    const int8_t* input, size_t in_ch_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* output, size_t out_ch_stride,
+    int32_t zero_point, int relu,
+    int8_t* scratch);
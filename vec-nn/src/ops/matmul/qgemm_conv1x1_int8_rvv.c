@@ -31,7 +31,8 @@ void qgemm_i8_i32_7xm4_int32_conv1x1 (
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C 
     requantization_params_t requant_params, // requantization parameters
-    size_t row
+    size_t row,
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a = (const int8_t*) ((const int32_t*)a_v + mr);
@@ -62,7 +63,7 @@ void qgemm_i8_i32_7xm4_int32_conv1x1 (
   int8_t* c6 = (int8_t*) ((uintptr_t) c5 + cm_stride);
 
   // For NR="m4": we use a vsetvlmax for 32-bit int with LMUL=m4
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   const int8_t* w_new = w;
 
@@ -217,7 +218,8 @@ void qgemm_i8_i32_1xm4_int32_conv1x1(
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C
     requantization_params_t requant_params,
-    size_t row
+    size_t row,
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a = (const int8_t*) ((const int32_t*)a_v + mr);
@@ -229,7 +231,7 @@ void qgemm_i8_i32_1xm4_int32_conv1x1(
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
   const int32_t output_zero_point = requant_params.zero_point;
 
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   const int8_t* w_new = w;
   
@@ -278,7 +280,8 @@ void qgemm_i8_i32_7xm4_int32_conv1x1_relu (
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C 
     requantization_params_t requant_params, // requantization parameters
-    size_t row
+    size_t row,
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a = (const int8_t*) ((const int32_t*)a_v + mr);
@@ -309,7 +312,7 @@ void qgemm_i8_i32_7xm4_int32_conv1x1_relu (
   int8_t* c6 = (int8_t*) ((uintptr_t) c5 + cm_stride);
 
   // For NR="m4": we use a vsetvlmax for 32-bit int with LMUL=m4
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   const int8_t* w_new = w;
 
@@ -457,7 +460,8 @@ void qgemm_i8_i32_1xm4_int32_conv1x1_relu(
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C
     requantization_params_t requant_params,
-    size_t row
+    size_t row,
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a = (const int8_t*) ((const int32_t*)a_v + mr);
@@ -470,7 +474,7 @@ void qgemm_i8_i32_1xm4_int32_conv1x1_relu(
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
   const int32_t output_zero_point = requant_params.zero_point;
 
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   const int8_t* w_new = w;
   
@@ -508,57 +512,86 @@ void qgemm_i8_i32_1xm4_int32_conv1x1_relu(
   } while (nc != 0);
 }
 
-void int8_qgemm_int32bias_conv1x1_relu(
+/*
+ * Tile entry point, see int8_qgemm_tile(). Here A carries the per-row
+ * (output channel) int32 biases and scales, so only B and C are offset by
+ * the tile's first column.
+ */
+void int8_qgemm_int32bias_conv1x1_tile(
     size_t M, size_t N, size_t K,
     const void* A, size_t a_row_stride,
     const int8_t* B,
     int8_t* C, size_t c_row_stride,
     size_t c_col_stride,
-    requantization_params_t requant_params)
+    requantization_params_t requant_params,
+    int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end)
 {
     const size_t kc_bytes = K;
     const size_t a_stride_bytes = a_row_stride;
     const size_t cm_stride_bytes = c_row_stride;
     const size_t cn_stride_bytes = c_col_stride;
+    const size_t nc = n_end - n_begin;
+
+    if (nc == 0) {
+        return;
+    }
+
+    const int8_t* b_tile = B + n_begin;
+    int8_t* c_tile = C + n_begin * c_col_stride;
 
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
+    size_t row = m_begin;
+    while (row < m_end) {
+        size_t rows_left = m_end - row;
 
         if (rows_left >= 7) {
-            qgemm_i8_i32_7xm4_int32_conv1x1_relu(
+            (relu ? qgemm_i8_i32_7xm4_int32_conv1x1_relu : qgemm_i8_i32_7xm4_int32_conv1x1)(
                 M,
-                N,
+                nc,
                 kc_bytes,
                 A,
                 a_stride_bytes,
-                B,
-                C + row * c_row_stride,
+                b_tile,
+                c_tile + row * c_row_stride,
                 cm_stride_bytes,
                 cn_stride_bytes,
-                requant_params, 
-                row
+                requant_params,
+                row,
+                N
             );
             row += 7;
         } else {
-            qgemm_i8_i32_1xm4_int32_conv1x1_relu(
+            (relu ? qgemm_i8_i32_1xm4_int32_conv1x1_relu : qgemm_i8_i32_1xm4_int32_conv1x1)(
                 M,
-                N,
+                nc,
                 kc_bytes,
                 A,
                 a_stride_bytes,
-                B,
-                C + row * c_row_stride,
+                b_tile,
+                c_tile + row * c_row_stride,
                 cm_stride_bytes,
                 cn_stride_bytes,
                 requant_params,
-                row
+                row,
+                N
             );
             row += 1;
         }
     }
 }
 
+void int8_qgemm_int32bias_conv1x1_relu(
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    int8_qgemm_int32bias_conv1x1_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                                      requant_params, 1, 0, M, 0, N);
+}
 
 void int8_qgemm_int32bias_conv1x1(
     size_t M, size_t N, size_t K,
@@ -568,45 +601,6 @@ void int8_qgemm_int32bias_conv1x1(
     size_t c_col_stride,
     requantization_params_t requant_params)
 {
-    const size_t kc_bytes = K;
-    const size_t a_stride_bytes = a_row_stride;
-    const size_t cm_stride_bytes = c_row_stride;
-    const size_t cn_stride_bytes = c_col_stride;
-
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
-
-        if (rows_left >= 7) {
-            qgemm_i8_i32_7xm4_int32_conv1x1(
-                M,
-                N,
-                kc_bytes,
-                A,
-                a_stride_bytes,
-                B,
-                C + row * c_row_stride,
-                cm_stride_bytes,
-                cn_stride_bytes,
-                requant_params, 
-                row
-            );
-            row += 7;
-        } else {
-            qgemm_i8_i32_1xm4_int32_conv1x1(
-                M,
-                N,
-                kc_bytes,
-                A,
-                a_stride_bytes,
-                B,
-                C + row * c_row_stride,
-                cm_stride_bytes,
-                cn_stride_bytes,
-                requant_params,
-                row
-            );
-            row += 1;
-        }
-    }
-}
\ No newline at end of file
+    int8_qgemm_int32bias_conv1x1_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                                      requant_params, 0, 0, M, 0, N);
+}
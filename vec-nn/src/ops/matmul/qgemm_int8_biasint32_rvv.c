@@ -13,12 +13,14 @@ void qgemm_i8_i32_7xm4_int32bias_relu (
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C 
-    requantization_params_t requant_params // requantization parameters
+    requantization_params_t requant_params, // requantization parameters
+    size_t n0,                 // first column of B handled by this call
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a0 = a;
   int8_t* c0 = c;
-  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + nc);
+  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + ldb) + n0;
 
   const int32_t output_min_less_zero_point = 0;
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
@@ -43,10 +45,10 @@ void qgemm_i8_i32_7xm4_int32bias_relu (
   int8_t* c6 = (int8_t*) ((uintptr_t) c5 + cm_stride);
 
   // For NR="m4": we use a vsetvlmax for 32-bit int with LMUL=m4
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   size_t scale_ptr = 0;
-  const int32_t* w_new = (const int32_t*) w;
+  const int32_t* w_new = (const int32_t*) w + n0;
   // Loop over columns in chunks of VL
   do {
     // If fewer than nr columns remain, reduce VL
@@ -186,13 +188,15 @@ void qgemm_i8_i32_1xm4_int32bias_relu(
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C
-    requantization_params_t requant_params 
+    requantization_params_t requant_params, // requantization parameters
+    size_t n0,                 // first column of B handled by this call
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
 
   const int8_t* a0 = a;
   int8_t* c0 = c;
-  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + nc);
+  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + ldb) + n0;
   // printf("first element: %d \n", start_weights[0]);
 
   // float scale = qp_output.scale;
@@ -200,9 +204,9 @@ void qgemm_i8_i32_1xm4_int32bias_relu(
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
   const int32_t output_zero_point = requant_params.zero_point;
 
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
-  const int32_t* w_new = (const int32_t*) w;
+  const int32_t* w_new = (const int32_t*) w + n0;
   size_t scale_ptr = 0;
   
   do {
@@ -250,12 +254,14 @@ void qgemm_i8_i32_7xm4_int32bias (
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C 
-    requantization_params_t requant_params // requantization parameters
+    requantization_params_t requant_params, // requantization parameters
+    size_t n0,                 // first column of B handled by this call
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a0 = a;
   int8_t* c0 = c;
-  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + nc);
+  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + ldb) + n0;
 
   const int32_t output_min_less_zero_point = -128 - requant_params.zero_point;
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
@@ -280,10 +286,10 @@ void qgemm_i8_i32_7xm4_int32bias (
   int8_t* c6 = (int8_t*) ((uintptr_t) c5 + cm_stride);
 
   // For NR="m4": we use a vsetvlmax for 32-bit int with LMUL=m4
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   size_t scale_ptr = 0;
-  const int32_t* w_new = (const int32_t*) w;
+  const int32_t* w_new = (const int32_t*) w + n0;
   // Loop over columns in chunks of VL
   do {
     // If fewer than nr columns remain, reduce VL
@@ -423,13 +429,15 @@ void qgemm_i8_i32_1xm4_int32bias(
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C
-    requantization_params_t requant_params 
+    requantization_params_t requant_params, // requantization parameters
+    size_t n0,                 // first column of B handled by this call
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
 
   const int8_t* a0 = a;
   int8_t* c0 = c;
-  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + nc);
+  const int8_t* start_weights = (const int8_t*) ((const int32_t*)w + ldb) + n0;
   // printf("first element: %d \n", start_weights[0]);
 
   // float scale = qp_output.scale;
@@ -437,9 +445,9 @@ void qgemm_i8_i32_1xm4_int32bias(
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
   const int32_t output_zero_point = requant_params.zero_point;
 
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
-  const int32_t* w_new = (const int32_t*) w;
+  const int32_t* w_new = (const int32_t*) w + n0;
   size_t scale_ptr = 0;
   
   do {
@@ -477,56 +485,79 @@ void qgemm_i8_i32_1xm4_int32bias(
   } while (nc != 0);
 }
 
-void int8_qgemm_int32bias(
+/*
+ * Tile entry point, see int8_qgemm_tile(). B keeps its packed layout
+ * (N int32 biases, then K rows of N int8 weights); the kernels index into
+ * it with the tile's first column.
+ */
+void int8_qgemm_int32bias_tile(
     size_t M, size_t N, size_t K,
     const int8_t* A, size_t a_row_stride,
     const void* B,
     int8_t* C, size_t c_row_stride,
     size_t c_col_stride,
-    requantization_params_t requant_params)
+    requantization_params_t requant_params,
+    int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end)
 {
     const size_t kc_bytes = K;
     const size_t a_stride_bytes = a_row_stride;
     const size_t cm_stride_bytes = c_row_stride;
     const size_t cn_stride_bytes = c_col_stride;
+    const size_t nc = n_end - n_begin;
+
+    (void) M;
+    if (nc == 0) {
+        return;
+    }
+
+    requantization_params_t tile_params = requant_params;
+    tile_params.scale = requant_params.scale + n_begin;
+
+    int8_t* c_tile = C + n_begin * c_col_stride;
 
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
+    size_t row = m_begin;
+    while (row < m_end) {
+        size_t rows_left = m_end - row;
 
         if (rows_left >= 7) {
-            qgemm_i8_i32_7xm4_int32bias(
+            (relu ? qgemm_i8_i32_7xm4_int32bias_relu : qgemm_i8_i32_7xm4_int32bias)(
                 7,
-                N,
+                nc,
                 kc_bytes,
                 A + row * a_row_stride,
                 a_stride_bytes,
                 B,
-                C + row * c_row_stride,
+                c_tile + row * c_row_stride,
                 cm_stride_bytes,
                 cn_stride_bytes,
-                requant_params
+                tile_params,
+                n_begin,
+                N
             );
             row += 7;
         } else {
-            qgemm_i8_i32_1xm4_int32bias(
+            (relu ? qgemm_i8_i32_1xm4_int32bias_relu : qgemm_i8_i32_1xm4_int32bias)(
                 1,
-                N,
+                nc,
                 kc_bytes,
                 A + row * a_row_stride,
                 a_stride_bytes,
                 B,
-                C + row * c_row_stride,
+                c_tile + row * c_row_stride,
                 cm_stride_bytes,
                 cn_stride_bytes,
-                requant_params
+                tile_params,
+                n_begin,
+                N
             );
             row += 1;
         }
     }
 }
 
-void int8_qgemm_int32bias_relu(
+void int8_qgemm_int32bias(
     size_t M, size_t N, size_t K,
     const int8_t* A, size_t a_row_stride,
     const void* B,
@@ -534,44 +565,18 @@ void int8_qgemm_int32bias_relu(
     size_t c_col_stride,
     requantization_params_t requant_params)
 {
-    const size_t kc_bytes = K;
-    const size_t a_stride_bytes = a_row_stride;
-    const size_t cm_stride_bytes = c_row_stride;
-    const size_t cn_stride_bytes = c_col_stride;
-
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
-
-        if (rows_left >= 7) {
-            qgemm_i8_i32_7xm4_int32bias_relu(
-                7,
-                N,
-                kc_bytes,
-                A + row * a_row_stride,
-                a_stride_bytes,
-                B,
-                C + row * c_row_stride,
-                cm_stride_bytes,
-                cn_stride_bytes,
-                requant_params
-            );
-            row += 7;
-        } else {
-            qgemm_i8_i32_1xm4_int32bias_relu(
-                1,
-                N,
-                kc_bytes,
-                A + row * a_row_stride,
-                a_stride_bytes,
-                B,
-                C + row * c_row_stride,
-                cm_stride_bytes,
-                cn_stride_bytes,
-                requant_params
-            );
-            row += 1;
-        }
-    }
+    int8_qgemm_int32bias_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                              requant_params, 0, 0, M, 0, N);
 }
 
+void int8_qgemm_int32bias_relu(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    int8_qgemm_int32bias_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                              requant_params, 1, 0, M, 0, N);
+}
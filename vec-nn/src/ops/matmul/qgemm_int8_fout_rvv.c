@@ -39,12 +39,13 @@ static void qgemm_i8_fout_1xm4(
     float* c,
     size_t cm_stride,
     size_t cn_stride,
-    float scale)
+    float scale,
+    size_t ldb)
 {
     const int8_t* a0 = a;
     float* c0 = c;
 
-    size_t nr = nc;
+    size_t nr = ldb;
     const int8_t* w_new = w;
 
     do {
@@ -93,7 +94,8 @@ static void qgemm_i8_fout_7xm4(
     float* c,
     size_t cm_stride,
     size_t cn_stride,
-    float scale)
+    float scale,
+    size_t ldb)
 {
     const int8_t* a0 = a;
     float* c0 = c;
@@ -110,7 +112,7 @@ static void qgemm_i8_fout_7xm4(
     const int8_t* a6 = a5 + a_stride;
     float* c6 = (float*)((uintptr_t)c5 + cm_stride);
 
-    size_t nr = nc;
+    size_t nr = ldb;
     const int8_t* w_new = w;
 
     do {
@@ -177,40 +179,67 @@ static void qgemm_i8_fout_7xm4(
 }
 
 /* -------------------------------------------------------------------------
- * Public dispatcher: loops over M in tiles of 7 or 1.
+ * Tile entry point: computes C[m_begin:m_end, n_begin:n_end] of the full
+ * problem (see int8_qgemm_tile in qgemm_int8_rvv.c).
  * ------------------------------------------------------------------------- */
-void int8_qgemm_fout(
+void int8_qgemm_fout_tile(
     size_t M, size_t N, size_t K,
     const int8_t* A, size_t a_row_stride,
     const int8_t* B,
     float* C, size_t c_row_stride,
     size_t c_col_stride,
-    float scale)
+    float scale,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end)
 {
     const size_t cm_stride_bytes = c_row_stride;
+    const size_t nc = n_end - n_begin;
+
+    (void)M;
+    if (nc == 0) {
+        return;
+    }
+
+    const int8_t* b_tile = B + n_begin;
+    float* c_tile = C + n_begin;
 
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
+    size_t row = m_begin;
+    while (row < m_end) {
+        size_t rows_left = m_end - row;
 
         if (rows_left >= 7) {
             qgemm_i8_fout_7xm4(
-                7, N, K,
+                7, nc, K,
                 A + row * a_row_stride, a_row_stride,
-                B,
-                C + row * (c_row_stride / sizeof(float)),
+                b_tile,
+                c_tile + row * (c_row_stride / sizeof(float)),
                 cm_stride_bytes, c_col_stride,
-                scale);
+                scale, N);
             row += 7;
         } else {
             qgemm_i8_fout_1xm4(
-                1, N, K,
+                1, nc, K,
                 A + row * a_row_stride, a_row_stride,
-                B,
-                C + row * (c_row_stride / sizeof(float)),
+                b_tile,
+                c_tile + row * (c_row_stride / sizeof(float)),
                 cm_stride_bytes, c_col_stride,
-                scale);
+                scale, N);
             row += 1;
         }
     }
 }
+
+/* -------------------------------------------------------------------------
+ * Public dispatcher: the whole problem as one tile.
+ * ------------------------------------------------------------------------- */
+void int8_qgemm_fout(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    float* C, size_t c_row_stride,
+    size_t c_col_stride,
+    float scale)
+{
+    int8_qgemm_fout_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                         scale, 0, M, 0, N);
+}
@@ -0,0 +1,346 @@
+/*
+ * qgemm_int8_mc.c
+ *
+ * Multi-hart front end for the int8 GEMM micro-kernels.
+ *
+ * C (M x N) is cut into tiles that are handed to all harts through
+ * thread-lib's hthread_parallel_for(); idle harts steal tiles, so uneven
+ * tile costs even out. The split follows the shape:
+ *
+ *   - M-split: when there are at least QGEMM_MR rows per hart, tiles are
+ *     bands of whole 7-row micro-kernel blocks. conv_1x1_int8 (M = Cout)
+ *     and batched fully-connected layers land here.
+ *   - N-split: otherwise (e.g. fully_connected with batches = 1) all rows
+ *     stay in one band and the columns are divided between harts.
+ *
+ * In both cases panels are at most VECNN_QGEMM_L1_BYTES of B wide, and the
+ * tile index runs M-fastest so that consecutive tiles taken by one hart
+ * reuse the same B panel from L1.
+ *
+ * Without VECNN_MULTICORE (or for problems below VECNN_QGEMM_MC_MIN_MACS)
+ * every entry point is a straight call into the single-hart kernels.
+ */
+
+#include "ops/matmul/matmul.h"
+
+#include <stdint.h>
+
+#if VECNN_MULTICORE
+#include "hthread.h"
+#endif
+
+// Data-cache budget for one B panel (K x tile_n bytes) per hart.
+#ifndef VECNN_QGEMM_L1_BYTES
+#define VECNN_QGEMM_L1_BYTES (16u * 1024u)
+#endif
+
+// Below this many multiply-accumulates the fork/join overhead dominates.
+#ifndef VECNN_QGEMM_MC_MIN_MACS
+#define VECNN_QGEMM_MC_MIN_MACS (32u * 1024u)
+#endif
+
+// Tiles per hart to aim for; more gives stealing room to balance.
+#ifndef VECNN_QGEMM_TILES_PER_HART
+#define VECNN_QGEMM_TILES_PER_HART 2u
+#endif
+
+#define QGEMM_MR        7u    // rows per micro-kernel call
+#define QGEMM_NR_ALIGN  16u   // panel widths stay a multiple of this
+
+typedef enum {
+    QGEMM_KIND_INT8,
+    QGEMM_KIND_INT32BIAS,
+    QGEMM_KIND_CONV1X1,
+    QGEMM_KIND_FOUT,
+    QGEMM_KIND_PACKED,
+} qgemm_kind_t;
+
+typedef struct {
+    qgemm_kind_t kind;
+    int relu;
+    size_t M, N, K;
+    const void* A;
+    size_t a_row_stride;
+    const void* B;
+    void* C;
+    size_t c_row_stride;
+    size_t c_col_stride;
+    requantization_params_t requant_params;
+    float scale;
+    int32_t zero_point;
+
+    size_t tile_m, tile_n;
+    size_t tiles_m;
+} qgemm_job_t;
+
+static void qgemm_run_tile(const qgemm_job_t* job,
+                           size_t m_begin, size_t m_end,
+                           size_t n_begin, size_t n_end)
+{
+    switch (job->kind) {
+    case QGEMM_KIND_INT8:
+        int8_qgemm_tile(job->M, job->N, job->K,
+                        (const int8_t*) job->A, job->a_row_stride,
+                        (const int8_t*) job->B,
+                        (int8_t*) job->C, job->c_row_stride, job->c_col_stride,
+                        job->requant_params, job->relu,
+                        m_begin, m_end, n_begin, n_end);
+        break;
+    case QGEMM_KIND_INT32BIAS:
+        int8_qgemm_int32bias_tile(job->M, job->N, job->K,
+                                  (const int8_t*) job->A, job->a_row_stride,
+                                  job->B,
+                                  (int8_t*) job->C, job->c_row_stride, job->c_col_stride,
+                                  job->requant_params, job->relu,
+                                  m_begin, m_end, n_begin, n_end);
+        break;
+    case QGEMM_KIND_CONV1X1:
+        int8_qgemm_int32bias_conv1x1_tile(job->M, job->N, job->K,
+                                          job->A, job->a_row_stride,
+                                          (const int8_t*) job->B,
+                                          (int8_t*) job->C, job->c_row_stride, job->c_col_stride,
+                                          job->requant_params, job->relu,
+                                          m_begin, m_end, n_begin, n_end);
+        break;
+    case QGEMM_KIND_FOUT:
+        int8_qgemm_fout_tile(job->M, job->N, job->K,
+                             (const int8_t*) job->A, job->a_row_stride,
+                             (const int8_t*) job->B,
+                             (float*) job->C, job->c_row_stride, job->c_col_stride,
+                             job->scale,
+                             m_begin, m_end, n_begin, n_end);
+        break;
+    case QGEMM_KIND_PACKED:
+        int8_qgemm_packed_tile(job->M,
+                               (const int8_t*) job->A, job->a_row_stride,
+                               (const vecnn_packed_weights_int8_t*) job->B,
+                               (int8_t*) job->C, job->c_row_stride,
+                               job->zero_point, job->relu,
+                               m_begin, m_end, n_begin, n_end);
+        break;
+    }
+}
+
+#if VECNN_MULTICORE
+
+static size_t div_up(size_t a, size_t b) {
+    return (a + b - 1) / b;
+}
+
+static size_t round_up(size_t a, size_t b) {
+    return div_up(a, b) * b;
+}
+
+// Choose tile sizes for `harts` harts; see the file comment.
+static void qgemm_plan(qgemm_job_t* job, size_t harts) {
+    const size_t M = job->M;
+    const size_t N = job->N;
+    const size_t want = harts * VECNN_QGEMM_TILES_PER_HART;
+
+    // Widest panel of B (K+1 rows incl. bias, at least one byte per entry)
+    // that fits the per-hart cache budget.
+    size_t panel_n = (VECNN_QGEMM_L1_BYTES / (job->K + 1)) / QGEMM_NR_ALIGN * QGEMM_NR_ALIGN;
+    if (panel_n < QGEMM_NR_ALIGN) {
+        panel_n = QGEMM_NR_ALIGN;
+    }
+
+    if (M >= QGEMM_MR * harts) {
+        // M-split: bands of whole 7-row blocks.
+        size_t row_blocks = div_up(M, QGEMM_MR);
+        size_t bands = row_blocks < want ? row_blocks : want;
+        job->tile_m = QGEMM_MR * div_up(row_blocks, bands);
+        job->tile_n = N < panel_n ? N : panel_n;
+    } else {
+        // N-split: one band of all rows, columns shared between harts.
+        job->tile_m = M;
+        job->tile_n = round_up(div_up(N, want), QGEMM_NR_ALIGN);
+        if (job->tile_n > panel_n) {
+            job->tile_n = panel_n;
+        }
+    }
+
+    // Packed tiles must not split a panel.
+    if (job->kind == QGEMM_KIND_PACKED) {
+        size_t nr = ((const vecnn_packed_weights_int8_t*) job->B)->nr;
+        job->tile_n = round_up(job->tile_n, nr);
+    }
+
+    if (job->tile_m == 0) {
+        job->tile_m = 1;
+    }
+    if (job->tile_n == 0 || job->tile_n > N) {
+        job->tile_n = N;
+    }
+    job->tiles_m = div_up(M, job->tile_m);
+}
+
+static void qgemm_tiles_body(size_t begin, size_t end, void* ctx) {
+    const qgemm_job_t* job = (const qgemm_job_t*) ctx;
+
+    for (size_t t = begin; t < end; t++) {
+        size_t mb = t % job->tiles_m;
+        size_t nb = t / job->tiles_m;
+        size_t m_begin = mb * job->tile_m;
+        size_t n_begin = nb * job->tile_n;
+        size_t m_end = m_begin + job->tile_m < job->M ? m_begin + job->tile_m : job->M;
+        size_t n_end = n_begin + job->tile_n < job->N ? n_begin + job->tile_n : job->N;
+
+        qgemm_run_tile(job, m_begin, m_end, n_begin, n_end);
+    }
+}
+
+#endif
+
+static void qgemm_run(qgemm_job_t* job) {
+    if (job->M == 0 || job->N == 0) {
+        return;
+    }
+
+#if VECNN_MULTICORE
+    if (N_HARTS > 1 && (uint64_t) job->M * job->N * job->K >= VECNN_QGEMM_MC_MIN_MACS) {
+        qgemm_plan(job, N_HARTS);
+        size_t tiles = job->tiles_m * ((job->N + job->tile_n - 1) / job->tile_n);
+        if (tiles > 1) {
+            hthread_parallel_for(0, tiles, 1, qgemm_tiles_body, job);
+            return;
+        }
+    }
+#endif
+
+    qgemm_run_tile(job, 0, job->M, 0, job->N);
+}
+
+// ----------------------
+// Public entry points (same arguments as the single-hart versions)
+// ----------------------
+
+static void qgemm_int8_common(
+    qgemm_kind_t kind, int relu,
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_job_t job = {
+        .kind = kind,
+        .relu = relu,
+        .M = M, .N = N, .K = K,
+        .A = A, .a_row_stride = a_row_stride,
+        .B = B,
+        .C = C, .c_row_stride = c_row_stride, .c_col_stride = c_col_stride,
+        .requant_params = requant_params,
+    };
+    qgemm_run(&job);
+}
+
+void int8_qgemm_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_int8_common(QGEMM_KIND_INT8, 0, M, N, K, A, a_row_stride, B,
+                      C, c_row_stride, c_col_stride, requant_params);
+}
+
+void int8_qgemm_relu_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_int8_common(QGEMM_KIND_INT8, 1, M, N, K, A, a_row_stride, B,
+                      C, c_row_stride, c_col_stride, requant_params);
+}
+
+void int8_qgemm_int32bias_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_int8_common(QGEMM_KIND_INT32BIAS, 0, M, N, K, A, a_row_stride, B,
+                      C, c_row_stride, c_col_stride, requant_params);
+}
+
+void int8_qgemm_int32bias_relu_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const void* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_int8_common(QGEMM_KIND_INT32BIAS, 1, M, N, K, A, a_row_stride, B,
+                      C, c_row_stride, c_col_stride, requant_params);
+}
+
+void int8_qgemm_int32bias_conv1x1_mc(
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_int8_common(QGEMM_KIND_CONV1X1, 0, M, N, K, A, a_row_stride, B,
+                      C, c_row_stride, c_col_stride, requant_params);
+}
+
+void int8_qgemm_int32bias_conv1x1_relu_mc(
+    size_t M, size_t N, size_t K,
+    const void* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    qgemm_int8_common(QGEMM_KIND_CONV1X1, 1, M, N, K, A, a_row_stride, B,
+                      C, c_row_stride, c_col_stride, requant_params);
+}
+
+void int8_qgemm_fout_mc(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    float* C, size_t c_row_stride,
+    size_t c_col_stride,
+    float scale)
+{
+    qgemm_job_t job = {
+        .kind = QGEMM_KIND_FOUT,
+        .M = M, .N = N, .K = K,
+        .A = A, .a_row_stride = a_row_stride,
+        .B = B,
+        .C = C, .c_row_stride = c_row_stride, .c_col_stride = c_col_stride,
+        .scale = scale,
+    };
+    qgemm_run(&job);
+}
+
+void int8_qgemm_packed_mc(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu)
+{
+    qgemm_job_t job = {
+        .kind = QGEMM_KIND_PACKED,
+        .relu = relu,
+        .M = M, .N = B->N, .K = B->K,
+        .A = A, .a_row_stride = a_row_stride,
+        .B = B,
+        .C = C, .c_row_stride = c_row_stride, .c_col_stride = 1,
+        .zero_point = zero_point,
+    };
+    qgemm_run(&job);
+}
@@ -0,0 +1,445 @@
+/*
+ * qgemm_int8_packed_rvv.c
+ *
+ * Int8 GEMM on pre-panelized weights (see vecnn_packed_weights_int8_t in
+ * layers.h).
+ *
+ * The unpacked kernels walk B row by row with a stride of N bytes, so a
+ * 7-row block touches K different cache lines per vector chunk and nothing
+ * keeps B resident between row blocks. Here each panel of `nr` columns is
+ * one contiguous run of header + K x nr weights:
+ *
+ *   - the kernel streams a panel with unit stride and software-prefetches
+ *     VECNN_PACK_PREFETCH_ROWS rows ahead (this runs into the next panel's
+ *     header at the end of a panel);
+ *   - K is blocked so that one kc x nr slice of the panel fits in
+ *     VECNN_PACK_L1_BYTES, and that slice is applied to a group of up to
+ *     VECNN_PACK_GROUP_ROWS rows of A before moving on. Partial int32 sums
+ *     for the group live in a fixed VECNN_PACK_ACC_BYTES stack buffer
+ *     between K blocks; on wide-vector configurations the group shrinks to
+ *     fit it, so the stack cost does not grow with VLEN.
+ *
+ * The _chw entry points serve 1x1 convolutions on channel-major feature
+ * maps: a band of pixels is transposed to pixel-major rows of A, run
+ * through the same kernels, and the result transposed back.
+ */
+
+#include "ops/matmul/matmul.h"
+
+#include <riscv_vector.h>
+#include <stdint.h>
+#include <string.h>
+
+// Cache budget for one K block of a panel.
+#ifndef VECNN_PACK_L1_BYTES
+#define VECNN_PACK_L1_BYTES (16u * 1024u)
+#endif
+
+// Rows of A that share one K block of a panel (multiple of 7).
+#ifndef VECNN_PACK_GROUP_ROWS
+#define VECNN_PACK_GROUP_ROWS 28u
+#endif
+
+// Stack budget for the partial sums of one row group when K is blocked.
+// Must hold at least one panel row (nr int32).
+#ifndef VECNN_PACK_ACC_BYTES
+#define VECNN_PACK_ACC_BYTES 2048u
+#endif
+
+// How many panel rows ahead of the current one to prefetch.
+#ifndef VECNN_PACK_PREFETCH_ROWS
+#define VECNN_PACK_PREFETCH_ROWS 8u
+#endif
+
+#define QPACK_ALIGN 64u
+
+static size_t qpack_align_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+static size_t qpack_panel_stride(size_t K, size_t nr) {
+    return qpack_align_up(nr * (sizeof(int32_t) + sizeof(float)) + K * nr, QPACK_ALIGN);
+}
+
+// ----------------------
+// Packing
+// ----------------------
+
+size_t vecnn_packed_weights_int8_size(size_t K, size_t N) {
+    size_t nr = __riscv_vsetvlmax_e32m4();
+    size_t panels = (N + nr - 1) / nr;
+    return panels * qpack_panel_stride(K, nr) + QPACK_ALIGN;
+}
+
+// Weight (k, n) is at weights[k * k_stride + n * n_stride].
+static void qpack_panels(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,
+    size_t K, size_t N,
+    const int8_t* weights, size_t k_stride, size_t n_stride,
+    const int32_t* bias,
+    const float* scale)
+{
+    size_t nr = __riscv_vsetvlmax_e32m4();
+    size_t panel_stride = qpack_panel_stride(K, nr);
+    int8_t* data = (int8_t*) qpack_align_up((uintptr_t) buffer, QPACK_ALIGN);
+
+    out->K = K;
+    out->N = N;
+    out->nr = nr;
+    out->panel_stride = panel_stride;
+    out->data = data;
+
+    for (size_t n0 = 0; n0 < N; n0 += nr) {
+        int8_t* panel = data + (n0 / nr) * panel_stride;
+        int32_t* pbias = (int32_t*) panel;
+        float* pscale = (float*) (panel + nr * sizeof(int32_t));
+        int8_t* pw = panel + nr * (sizeof(int32_t) + sizeof(float));
+        size_t cols = (N - n0 < nr) ? N - n0 : nr;
+
+        memset(panel, 0, panel_stride);
+        for (size_t c = 0; c < cols; c++) {
+            pbias[c] = bias ? bias[n0 + c] : 0;
+            pscale[c] = scale[n0 + c];
+        }
+        for (size_t k = 0; k < K; k++) {
+            const int8_t* src = weights + k * k_stride + n0 * n_stride;
+            if (n_stride == 1) {
+                memcpy(pw + k * nr, src, cols);
+            } else {
+                for (size_t c = 0; c < cols; c++) {
+                    pw[k * nr + c] = src[c * n_stride];
+                }
+            }
+        }
+    }
+}
+
+void vecnn_pack_weights_int8(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,
+    size_t K, size_t N,
+    const int8_t* weights, size_t w_row_stride,
+    const int32_t* bias,
+    const float* scale)
+{
+    qpack_panels(out, buffer, K, N, weights, w_row_stride, 1, bias, scale);
+}
+
+void vecnn_pack_weights_int8_nk(
+    vecnn_packed_weights_int8_t* out,
+    void* buffer,
+    size_t K, size_t N,
+    const int8_t* weights, size_t w_row_stride,
+    const int32_t* bias,
+    const float* scale)
+{
+    qpack_panels(out, buffer, K, N, weights, 1, w_row_stride, bias, scale);
+}
+
+// ----------------------
+// Micro-kernels
+// ----------------------
+
+typedef struct {
+    const int32_t* bias;
+    const float* scale;
+    int32_t out_min;       // clamp bounds relative to the zero point
+    int32_t out_max;
+    int32_t zero_point;
+} qpack_out_t;
+
+#define QPACK_INIT_ACC(vacc, r)                                              \
+    vint32m4_t vacc = first ? vbias : __riscv_vle32_v_i32m4(acc + (r) * nr, vl)
+
+#define QPACK_FINISH(vacc, r, cp)                                            \
+    do {                                                                     \
+        if (!last) {                                                         \
+            __riscv_vse32_v_i32m4(acc + (r) * nr, (vacc), vl);               \
+        } else {                                                             \
+            vfloat32m4_t _vf = __riscv_vfcvt_f_x_v_f32m4((vacc), vl);        \
+            _vf = __riscv_vfmul_vv_f32m4(_vf, vscale, vl);                   \
+            _vf = __riscv_vfmax_vf_f32m4(_vf, out->out_min, vl);             \
+            _vf = __riscv_vfmin_vf_f32m4(_vf, out->out_max, vl);             \
+            vint16m2_t _v16 = __riscv_vfncvt_x_f_w_i16m2(_vf, vl);           \
+            _v16 = __riscv_vadd_vx_i16m2(_v16, (int16_t) out->zero_point, vl); \
+            __riscv_vse8_v_i8m1((cp), __riscv_vncvt_x_x_w_i8m1(_v16, vl), vl); \
+        }                                                                    \
+    } while (0)
+
+/*
+ * 7 rows x vl columns over kc entries of K. `w` points at row k0 of the
+ * panel, `a` at column k0 of the first row. On the first K block the
+ * accumulators start from the bias, otherwise from `acc`; on the last they
+ * are requantized into C, otherwise written back to `acc`.
+ */
+static void qgemm_i8_packed_7xm4(
+    size_t vl, size_t nr, size_t kc,
+    const int8_t* a, size_t a_stride,
+    const int8_t* w,
+    int8_t* c, size_t cm_stride,
+    int32_t* acc, int first, int last,
+    const qpack_out_t* out)
+{
+    const int8_t* a0 = a;
+    const int8_t* a1 = a0 + a_stride;
+    const int8_t* a2 = a1 + a_stride;
+    const int8_t* a3 = a2 + a_stride;
+    const int8_t* a4 = a3 + a_stride;
+    const int8_t* a5 = a4 + a_stride;
+    const int8_t* a6 = a5 + a_stride;
+
+    vint32m4_t vbias = __riscv_vle32_v_i32m4(out->bias, vl);
+    QPACK_INIT_ACC(vacc0, 0);
+    QPACK_INIT_ACC(vacc1, 1);
+    QPACK_INIT_ACC(vacc2, 2);
+    QPACK_INIT_ACC(vacc3, 3);
+    QPACK_INIT_ACC(vacc4, 4);
+    QPACK_INIT_ACC(vacc5, 5);
+    QPACK_INIT_ACC(vacc6, 6);
+
+    size_t k = kc;
+    do {
+        __builtin_prefetch(w + VECNN_PACK_PREFETCH_ROWS * nr);
+
+        vint16m2_t vb = __riscv_vwcvt_x_x_v_i16m2(__riscv_vle8_v_i8m1(w, vl), vl);
+        w += nr;
+
+        vacc0 = __riscv_vwmacc_vx_i32m4(vacc0, *a0++, vb, vl);
+        vacc1 = __riscv_vwmacc_vx_i32m4(vacc1, *a1++, vb, vl);
+        vacc2 = __riscv_vwmacc_vx_i32m4(vacc2, *a2++, vb, vl);
+        vacc3 = __riscv_vwmacc_vx_i32m4(vacc3, *a3++, vb, vl);
+        vacc4 = __riscv_vwmacc_vx_i32m4(vacc4, *a4++, vb, vl);
+        vacc5 = __riscv_vwmacc_vx_i32m4(vacc5, *a5++, vb, vl);
+        vacc6 = __riscv_vwmacc_vx_i32m4(vacc6, *a6++, vb, vl);
+
+        k -= 1;
+    } while (k != 0);
+
+    vfloat32m4_t vscale = __riscv_vle32_v_f32m4(out->scale, vl);
+    QPACK_FINISH(vacc0, 0, c);
+    QPACK_FINISH(vacc1, 1, c + 1 * cm_stride);
+    QPACK_FINISH(vacc2, 2, c + 2 * cm_stride);
+    QPACK_FINISH(vacc3, 3, c + 3 * cm_stride);
+    QPACK_FINISH(vacc4, 4, c + 4 * cm_stride);
+    QPACK_FINISH(vacc5, 5, c + 5 * cm_stride);
+    QPACK_FINISH(vacc6, 6, c + 6 * cm_stride);
+}
+
+static void qgemm_i8_packed_1xm4(
+    size_t vl, size_t nr, size_t kc,
+    const int8_t* a,
+    const int8_t* w,
+    int8_t* c,
+    int32_t* acc, int first, int last,
+    const qpack_out_t* out)
+{
+    vint32m4_t vbias = __riscv_vle32_v_i32m4(out->bias, vl);
+    QPACK_INIT_ACC(vacc0, 0);
+
+    size_t k = kc;
+    do {
+        __builtin_prefetch(w + VECNN_PACK_PREFETCH_ROWS * nr);
+
+        vint16m2_t vb = __riscv_vwcvt_x_x_v_i16m2(__riscv_vle8_v_i8m1(w, vl), vl);
+        w += nr;
+        vacc0 = __riscv_vwmacc_vx_i32m4(vacc0, *a++, vb, vl);
+
+        k -= 1;
+    } while (k != 0);
+
+    vfloat32m4_t vscale = __riscv_vle32_v_f32m4(out->scale, vl);
+    QPACK_FINISH(vacc0, 0, c);
+}
+
+#undef QPACK_INIT_ACC
+#undef QPACK_FINISH
+
+// ----------------------
+// Drivers
+// ----------------------
+
+// Rows per group: VECNN_PACK_GROUP_ROWS, cut down (to a multiple of 7 where
+// possible) so that a group's partial sums fit VECNN_PACK_ACC_BYTES.
+static size_t qpack_group_rows(size_t nr) {
+    size_t rows = VECNN_PACK_ACC_BYTES / (nr * sizeof(int32_t));
+    if (rows >= VECNN_PACK_GROUP_ROWS) {
+        return VECNN_PACK_GROUP_ROWS;
+    }
+    if (rows >= 7) {
+        return rows - rows % 7;
+    }
+    return rows;
+}
+
+// Largest K block whose panel slice fits the L1 budget.
+static size_t qpack_kc(size_t K, size_t nr) {
+    size_t kc = VECNN_PACK_L1_BYTES / nr;
+    if (kc < 16) {
+        kc = 16;
+    }
+    return (kc < K) ? kc : K;
+}
+
+/*
+ * Tile entry point, see int8_qgemm_tile(). n_begin must be a multiple of
+ * B->nr (tiles are whole panels, except the one that ends at N).
+ */
+void int8_qgemm_packed_tile(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end)
+{
+    const size_t K = B->K;
+    const size_t nr = B->nr;
+    size_t kc = qpack_kc(K, nr);
+    size_t group_rows = VECNN_PACK_GROUP_ROWS;
+
+    (void) M;
+    if (K == 0 || n_begin >= n_end) {
+        return;
+    }
+
+    if (kc < K) {
+        group_rows = qpack_group_rows(nr);
+        if (group_rows == 0) {
+            // Not even one row of partial sums fits: run K unblocked.
+            kc = K;
+            group_rows = VECNN_PACK_GROUP_ROWS;
+        }
+    }
+    const int blocked = kc < K;
+
+    // Partial sums for one row group, only used when K is blocked.
+    int32_t acc[VECNN_PACK_ACC_BYTES / sizeof(int32_t)];
+
+    qpack_out_t out = {
+        .out_min = relu ? 0 : -128 - zero_point,
+        .out_max = 127 - zero_point,
+        .zero_point = zero_point,
+    };
+
+    for (size_t n0 = n_begin; n0 < n_end; n0 += nr) {
+        const int8_t* panel = B->data + (n0 / nr) * B->panel_stride;
+        const int8_t* pw = panel + nr * (sizeof(int32_t) + sizeof(float));
+        size_t vl = __riscv_vsetvl_e32m4((n_end - n0 < nr) ? n_end - n0 : nr);
+
+        out.bias = (const int32_t*) panel;
+        out.scale = (const float*) (panel + nr * sizeof(int32_t));
+
+        for (size_t g = m_begin; g < m_end; g += group_rows) {
+            size_t g_end = (m_end - g < group_rows) ? m_end : g + group_rows;
+
+            for (size_t k0 = 0; k0 < K; k0 += kc) {
+                size_t kn = (K - k0 < kc) ? K - k0 : kc;
+                int first = (k0 == 0);
+                int last = (k0 + kn == K);
+                const int8_t* w = pw + k0 * nr;
+
+                size_t row = g;
+                while (row < g_end) {
+                    int32_t* racc = acc + (blocked ? (row - g) * nr : 0);
+                    const int8_t* a = A + row * a_row_stride + k0;
+                    int8_t* c = C + row * c_row_stride + n0;
+
+                    if (g_end - row >= 7) {
+                        qgemm_i8_packed_7xm4(vl, nr, kn, a, a_row_stride, w,
+                                             c, c_row_stride, racc, first, last, &out);
+                        row += 7;
+                    } else {
+                        qgemm_i8_packed_1xm4(vl, nr, kn, a, w,
+                                             c, racc, first, last, &out);
+                        row += 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void int8_qgemm_packed(
+    size_t M,
+    const int8_t* A, size_t a_row_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    int32_t zero_point, int relu)
+{
+    int8_qgemm_packed_tile(M, A, a_row_stride, B, C, c_row_stride,
+                           zero_point, relu, 0, M, 0, B->N);
+}
+
+// ----------------------
+// Channel-major activations
+// ----------------------
+
+// dst[j * dst_stride + i] = src[i * src_stride + j] for a rows x cols block.
+static void qpack_transpose(
+    const int8_t* src, size_t src_stride,
+    int8_t* dst, size_t dst_stride,
+    size_t rows, size_t cols)
+{
+    for (size_t i = 0; i < rows; i++) {
+        const int8_t* s = src + i * src_stride;
+        int8_t* d = dst + i;
+        size_t c = cols;
+
+        while (c > 0) {
+            size_t vl = __riscv_vsetvl_e8m8(c);
+            __riscv_vsse8_v_i8m8(d, (ptrdiff_t) dst_stride, __riscv_vle8_v_i8m8(s, vl), vl);
+            s += vl;
+            d += vl * dst_stride;
+            c -= vl;
+        }
+    }
+}
+
+static void qpack_chw(
+    size_t n,
+    const int8_t* input, size_t in_ch_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* output, size_t out_ch_stride,
+    int32_t zero_point, int relu,
+    int8_t* scratch, int multicore)
+{
+    int8_t* xt = scratch;               // [n][K]
+    int8_t* yt = scratch + n * B->K;    // [n][N]
+
+    if (n == 0) {
+        return;
+    }
+    qpack_transpose(input, in_ch_stride, xt, B->K, B->K, n);
+    if (multicore) {
+        int8_qgemm_packed_mc(n, xt, B->K, B, yt, B->N, zero_point, relu);
+    } else {
+        int8_qgemm_packed(n, xt, B->K, B, yt, B->N, zero_point, relu);
+    }
+    qpack_transpose(yt, B->N, output, out_ch_stride, n, B->N);
+}
+
+void int8_qgemm_packed_chw(
+    size_t n,
+    const int8_t* input, size_t in_ch_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* output, size_t out_ch_stride,
+    int32_t zero_point, int relu,
+    int8_t* scratch)
+{
+    qpack_chw(n, input, in_ch_stride, B, output, out_ch_stride,
+              zero_point, relu, scratch, 0);
+}
+
+void int8_qgemm_packed_chw_mc(
+    size_t n,
+    const int8_t* input, size_t in_ch_stride,
+    const vecnn_packed_weights_int8_t* B,
+    int8_t* output, size_t out_ch_stride,
+    int32_t zero_point, int relu,
+    int8_t* scratch)
+{
+    qpack_chw(n, input, in_ch_stride, B, output, out_ch_stride,
+              zero_point, relu, scratch, 1);
+}
@@ -13,7 +13,8 @@ void qgemm_i8_i32_7xm4_relu(
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C 
-    requantization_params_t requant_params // requantization parameters
+    requantization_params_t requant_params, // requantization parameters
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a0 = a;
@@ -42,7 +43,7 @@ void qgemm_i8_i32_7xm4_relu(
   int8_t* c6 = (int8_t*) ((uintptr_t) c5 + cm_stride);
 
   // For NR="m4": we use a vsetvlmax for 32-bit int with LMUL=m4
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   size_t scale_ptr = 0;
   const int8_t* w_new = w;
@@ -187,7 +188,8 @@ void qgemm_i8_i32_1xm4_relu(
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C
-    requantization_params_t requant_params 
+    requantization_params_t requant_params, // requantization parameters
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
 
@@ -198,7 +200,7 @@ void qgemm_i8_i32_1xm4_relu(
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
   const int32_t output_zero_point = requant_params.zero_point;
 
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   const int8_t* w_new = w;
   size_t scale_ptr = 0;
@@ -247,7 +249,8 @@ void qgemm_i8_i32_7xm4(
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C 
-    requantization_params_t requant_params // requantization parameters
+    requantization_params_t requant_params, // requantization parameters
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
   const int8_t* a0 = a;
@@ -276,7 +279,7 @@ void qgemm_i8_i32_7xm4(
   int8_t* c6 = (int8_t*) ((uintptr_t) c5 + cm_stride);
 
   // For NR="m4": we use a vsetvlmax for 32-bit int with LMUL=m4
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   size_t scale_ptr = 0;
   const int8_t* w_new = w;
@@ -421,7 +424,8 @@ void qgemm_i8_i32_1xm4(
     int8_t* c,       // output matrix C (int32)
     size_t cm_stride,          // byte stride between consecutive rows of C
     size_t cn_stride,           // byte stride between consecutive columns-blocks of C
-    requantization_params_t requant_params 
+    requantization_params_t requant_params, // requantization parameters
+    size_t ldb                 // elements between consecutive rows of B
 )
 {
 
@@ -432,7 +436,7 @@ void qgemm_i8_i32_1xm4(
   const int32_t output_max_less_zero_point = 127 - requant_params.zero_point;
   const int32_t output_zero_point = requant_params.zero_point;
 
-  size_t nr = nc;
+  size_t nr = ldb;
   size_t vl = nr;
   const int8_t* w_new = w;
   size_t scale_ptr = 0;
@@ -471,56 +475,79 @@ void qgemm_i8_i32_1xm4(
   } while (nc != 0);
 }
 
-void int8_qgemm(
+/*
+ * Compute the tile C[m_begin:m_end, n_begin:n_end] of the M x N product.
+ * A, B, C and requant_params describe the whole problem, so disjoint tiles
+ * of one GEMM can run concurrently on different harts.
+ */
+void int8_qgemm_tile(
     size_t M, size_t N, size_t K,
     const int8_t* A, size_t a_row_stride,
     const int8_t* B,
     int8_t* C, size_t c_row_stride,
     size_t c_col_stride,
-    requantization_params_t requant_params)
+    requantization_params_t requant_params,
+    int relu,
+    size_t m_begin, size_t m_end,
+    size_t n_begin, size_t n_end)
 {
     const size_t kc_bytes = K;
     const size_t a_stride_bytes = a_row_stride;
     const size_t cm_stride_bytes = c_row_stride;
     const size_t cn_stride_bytes = c_col_stride;
+    const size_t nc = n_end - n_begin;
+
+    (void) M;
+    if (nc == 0) {
+        return;
+    }
+
+    // Per-channel scales follow the column offset of the tile.
+    requantization_params_t tile_params = requant_params;
+    tile_params.scale = requant_params.scale + n_begin;
+
+    const int8_t* b_tile = B + n_begin;
+    int8_t* c_tile = C + n_begin * c_col_stride;
 
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
+    size_t row = m_begin;
+    while (row < m_end) {
+        size_t rows_left = m_end - row;
 
         if (rows_left >= 7) {
-            qgemm_i8_i32_7xm4(
+            (relu ? qgemm_i8_i32_7xm4_relu : qgemm_i8_i32_7xm4)(
                 7,
-                N,
+                nc,
                 kc_bytes,
                 A + row * a_row_stride,
                 a_stride_bytes,
-                B,
-                C + row * c_row_stride,
+                b_tile,
+                c_tile + row * c_row_stride,
                 cm_stride_bytes,
                 cn_stride_bytes,
-                requant_params
+                tile_params,
+                N
             );
             row += 7;
         } else {
-            qgemm_i8_i32_1xm4(
+            (relu ? qgemm_i8_i32_1xm4_relu : qgemm_i8_i32_1xm4)(
                 1,
-                N,
+                nc,
                 kc_bytes,
                 A + row * a_row_stride,
                 a_stride_bytes,
-                B,
-                C + row * c_row_stride,
+                b_tile,
+                c_tile + row * c_row_stride,
                 cm_stride_bytes,
                 cn_stride_bytes,
-                requant_params
+                tile_params,
+                N
             );
             row += 1;
         }
     }
 }
 
-void int8_qgemm_relu(
+void int8_qgemm(
     size_t M, size_t N, size_t K,
     const int8_t* A, size_t a_row_stride,
     const int8_t* B,
@@ -528,43 +555,18 @@ void int8_qgemm_relu(
     size_t c_col_stride,
     requantization_params_t requant_params)
 {
-    const size_t kc_bytes = K;
-    const size_t a_stride_bytes = a_row_stride;
-    const size_t cm_stride_bytes = c_row_stride;
-    const size_t cn_stride_bytes = c_col_stride;
-
-    size_t row = 0;
-    while (row < M) {
-        size_t rows_left = M - row;
+    int8_qgemm_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                    requant_params, 0, 0, M, 0, N);
+}
 
-        if (rows_left >= 7) {
-            qgemm_i8_i32_7xm4_relu(
-                7,
-                N,
-                kc_bytes,
-                A + row * a_row_stride,
-                a_stride_bytes,
-                B,
-                C + row * c_row_stride,
-                cm_stride_bytes,
-                cn_stride_bytes,
-                requant_params
-            );
-            row += 7;
-        } else {
-            qgemm_i8_i32_1xm4_relu(
-                1,
-                N,
-                kc_bytes,
-                A + row * a_row_stride,
-                a_stride_bytes,
-                B,
-                C + row * c_row_stride,
-                cm_stride_bytes,
-                cn_stride_bytes,
-                requant_params
-            );
-            row += 1;
-        }
-    }
-}
\ No newline at end of file
+void int8_qgemm_relu(
+    size_t M, size_t N, size_t K,
+    const int8_t* A, size_t a_row_stride,
+    const int8_t* B,
+    int8_t* C, size_t c_row_stride,
+    size_t c_col_stride,
+    requantization_params_t requant_params)
+{
+    int8_qgemm_tile(M, N, K, A, a_row_stride, B, C, c_row_stride, c_col_stride,
+                    requant_params, 1, 0, M, 0, N);
+}
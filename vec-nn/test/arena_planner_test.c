@@ -0,0 +1,284 @@
+/*
+ * arena_planner_test.c - Host-side check of the vec-nn activation arena planner.
+ *
+ * Plans a MobileNetV2-shaped graph, a small residual graph and a series of
+ * random graphs, then verifies every plan against live ranges recomputed
+ * here from the op list (not the planner's own bookkeeping):
+ *
+ *  - arena offsets are VECNN_GRAPH_ALIGN-aligned and end within arena_bytes;
+ *  - two arena tensors whose live ranges intersect never share a byte,
+ *    except an in-place op's output and the input it overwrites, which may
+ *    share bytes at that single op;
+ *  - in-place outputs are folded where the input dies (relu6 chain).
+ *
+ * Usage: arena_planner_test [random_graphs]
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+
+#define MAX_T 128
+#define MAX_O 128
+
+static uint32_t g_errors;
+
+#define FAIL(...)                       \
+    do {                                \
+        g_errors++;                     \
+        printf("[FAIL] " __VA_ARGS__);  \
+    } while (0)
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int in_place(vecnn_op_kind_t kind) {
+    return kind == VECNN_OP_RELU6 || kind == VECNN_OP_RESIDUAL_ADD;
+}
+
+/* Op `o` overwrites tensor `in` with tensor `out`. */
+static int in_place_pair(const vecnn_graph_t* g, int32_t o, int in, int out) {
+    const vecnn_op_t* op = &g->ops[o];
+    if (!in_place(op->kind) || op->output != out) {
+        return 0;
+    }
+    return op->inputs[0] == in || op->inputs[1] == in;
+}
+
+static void check_plan(const vecnn_graph_t* g, const char* what) {
+    int32_t first[MAX_T], last[MAX_T];
+    const int32_t end = (int32_t) g->n_ops;
+
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        const vecnn_tensor_t* t = &g->tensors[i];
+        first[i] = (t->flags & VECNN_TENSOR_INPUT) ? 0 : end;
+        last[i] = (t->flags & VECNN_TENSOR_OUTPUT) ? end : -1;
+    }
+    for (int32_t o = 0; o < end; o++) {
+        const vecnn_op_t* op = &g->ops[o];
+        if (first[op->output] > o) first[op->output] = o;
+        if (last[op->output] < o) last[op->output] = o;
+        for (int k = 0; k < VECNN_OP_MAX_INPUTS; k++) {
+            if (op->inputs[k] >= 0 && last[op->inputs[k]] < o) {
+                last[op->inputs[k]] = o;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < g->n_tensors; i++) {
+        const vecnn_tensor_t* a = &g->tensors[i];
+        if ((a->flags & VECNN_TENSOR_EXTERNAL) || last[i] < first[i]) {
+            continue;
+        }
+        if (a->offset % VECNN_GRAPH_ALIGN != 0) {
+            FAIL("%s: tensor %u offset %u not aligned\n", what, (unsigned) i, (unsigned) a->offset);
+        }
+        if (a->offset + a->bytes > g->arena_bytes) {
+            FAIL("%s: tensor %u [%u, +%u) past arena end %u\n", what, (unsigned) i,
+                 (unsigned) a->offset, (unsigned) a->bytes, (unsigned) g->arena_bytes);
+        }
+
+        for (size_t j = i + 1; j < g->n_tensors; j++) {
+            const vecnn_tensor_t* b = &g->tensors[j];
+            if ((b->flags & VECNN_TENSOR_EXTERNAL) || last[j] < first[j]) {
+                continue;
+            }
+            if (!(first[i] <= last[j] && first[j] <= last[i])) {
+                continue;       /* never alive together */
+            }
+            if (!(a->offset < b->offset + b->bytes && b->offset < a->offset + a->bytes)) {
+                continue;       /* disjoint bytes */
+            }
+            /* Shared bytes are only legal across one in-place op. */
+            if (last[i] == first[j] && in_place_pair(g, last[i], (int) i, (int) j)) {
+                continue;
+            }
+            if (last[j] == first[i] && in_place_pair(g, last[j], (int) j, (int) i)) {
+                continue;
+            }
+            FAIL("%s: tensors %u [%d,%d] @%u and %u [%d,%d] @%u overlap while both live\n", what,
+                 (unsigned) i, (int) first[i], (int) last[i], (unsigned) a->offset,
+                 (unsigned) j, (int) first[j], (int) last[j], (unsigned) b->offset);
+        }
+    }
+
+    if (g->arena_bytes > g->naive_bytes) {
+        FAIL("%s: arena %u larger than naive %u\n", what,
+             (unsigned) g->arena_bytes, (unsigned) g->naive_bytes);
+    }
+}
+
+/* Stem plus the 17 MobileNetV2 inverted residual blocks (expanded form),
+ * with relu6 after every conv and a residual add where shapes allow it. */
+static void test_mobilenet(void) {
+    static const struct { uint32_t t, c, s; } cfg[] = {
+        {1, 16, 1}, {6, 24, 2}, {6, 24, 1}, {6, 32, 2}, {6, 32, 1}, {6, 32, 1},
+        {6, 64, 2}, {6, 64, 1}, {6, 64, 1}, {6, 64, 1}, {6, 96, 1}, {6, 96, 1},
+        {6, 96, 1}, {6, 160, 2}, {6, 160, 1}, {6, 160, 1}, {6, 320, 1},
+    };
+    static vecnn_tensor_t tensors[MAX_T];
+    static vecnn_op_t ops[MAX_O];
+    vecnn_graph_t g;
+    uint32_t h = 112, w = 112, ch = 32;
+    int cur;
+
+    vecnn_graph_init(&g, tensors, MAX_T, ops, MAX_O);
+    int in = vecnn_graph_add_tensor(&g, "input", 3, 224, 224, 1, VECNN_TENSOR_INPUT | VECNN_TENSOR_EXTERNAL);
+    int stem = vecnn_graph_add_tensor(&g, "stem", ch, h, w, 1, 0);
+    int stem6 = vecnn_graph_add_tensor(&g, "stem6", ch, h, w, 1, 0);
+    vecnn_graph_add_op(&g, VECNN_OP_CONV1X1, "stem", in, -1, stem);
+    vecnn_graph_add_op(&g, VECNN_OP_RELU6, "stem6", stem, -1, stem6);
+    cur = stem6;
+
+    for (size_t i = 0; i < sizeof(cfg) / sizeof(cfg[0]); i++) {
+        uint32_t hid = ch * cfg[i].t;
+        uint32_t oh = (h + cfg[i].s - 1) / cfg[i].s, ow = (w + cfg[i].s - 1) / cfg[i].s;
+        int x = cur;
+
+        if (cfg[i].t > 1) {
+            int e = vecnn_graph_add_tensor(&g, "expand", hid, h, w, 1, 0);
+            int e6 = vecnn_graph_add_tensor(&g, "expand6", hid, h, w, 1, 0);
+            vecnn_graph_add_op(&g, VECNN_OP_CONV1X1, "expand", x, -1, e);
+            vecnn_graph_add_op(&g, VECNN_OP_RELU6, "expand6", e, -1, e6);
+            x = e6;
+        }
+        int d = vecnn_graph_add_tensor(&g, "dw", hid, oh, ow, 1, 0);
+        int d6 = vecnn_graph_add_tensor(&g, "dw6", hid, oh, ow, 1, 0);
+        int p = vecnn_graph_add_tensor(&g, "project", cfg[i].c, oh, ow, 1, 0);
+        vecnn_graph_add_op(&g, VECNN_OP_DWCONV3X3, "dw", x, -1, d);
+        vecnn_graph_add_op(&g, VECNN_OP_RELU6, "dw6", d, -1, d6);
+        vecnn_graph_add_op(&g, VECNN_OP_CONV1X1, "project", d6, -1, p);
+        if (cfg[i].s == 1 && cfg[i].c == ch) {
+            int r = vecnn_graph_add_tensor(&g, "residual", cfg[i].c, oh, ow, 1, 0);
+            vecnn_graph_add_op(&g, VECNN_OP_RESIDUAL_ADD, "residual", p, cur, r);
+            p = r;
+        }
+        cur = p;
+        h = oh;
+        w = ow;
+        ch = cfg[i].c;
+    }
+    g.tensors[cur].flags |= VECNN_TENSOR_OUTPUT;
+
+    if (vecnn_graph_plan(&g) != 0) {
+        FAIL("mobilenet: plan failed\n");
+        return;
+    }
+    check_plan(&g, "mobilenet");
+
+    /* Every relu6 output should have been folded into its dying input. */
+    for (size_t o = 0; o < g.n_ops; o++) {
+        if (g.ops[o].kind == VECNN_OP_RELU6 && g.tensors[g.ops[o].output].alias_of < 0) {
+            FAIL("mobilenet: relu6 op %u not planned in place\n", (unsigned) o);
+        }
+    }
+    printf("mobilenet: %u tensors, arena %u bytes, naive %u bytes\n",
+           (unsigned) g.n_tensors, (unsigned) g.arena_bytes, (unsigned) g.naive_bytes);
+}
+
+/* A tensor still needed later must not be overwritten by an in-place op. */
+static void test_residual_keeps_skip(void) {
+    vecnn_tensor_t tensors[8];
+    vecnn_op_t ops[8];
+    vecnn_graph_t g;
+
+    vecnn_graph_init(&g, tensors, 8, ops, 8);
+    int in = vecnn_graph_add_tensor(&g, "in", 8, 4, 4, 1, VECNN_TENSOR_INPUT);
+    int x = vecnn_graph_add_tensor(&g, "x", 8, 4, 4, 1, 0);
+    int a6 = vecnn_graph_add_tensor(&g, "a6", 8, 4, 4, 1, 0);
+    int y = vecnn_graph_add_tensor(&g, "y", 8, 4, 4, 1, VECNN_TENSOR_OUTPUT);
+    vecnn_graph_add_op(&g, VECNN_OP_CONV1X1, "conv", in, -1, x);
+    vecnn_graph_add_op(&g, VECNN_OP_RELU6, "relu6", x, -1, a6);   /* x is still read below */
+    vecnn_graph_add_op(&g, VECNN_OP_RESIDUAL_ADD, "add", a6, x, y);
+
+    if (vecnn_graph_plan(&g) != 0) {
+        FAIL("residual: plan failed\n");
+        return;
+    }
+    if (g.tensors[a6].alias_of == x) {
+        FAIL("residual: relu6 overwrote x while it is still live\n");
+    }
+    check_plan(&g, "residual");
+}
+
+/* Random chains with branches: every op reads one or two tensors that are
+ * already produced, sizes vary, and some ops are in-place kinds. */
+static void test_random(uint32_t graphs) {
+    static vecnn_tensor_t tensors[MAX_T];
+    static vecnn_op_t ops[MAX_O];
+    char what[32];
+
+    for (uint32_t n = 0; n < graphs; n++) {
+        vecnn_graph_t g;
+        uint32_t n_ops = 4 + rng() % 40;
+
+        vecnn_graph_init(&g, tensors, MAX_T, ops, MAX_O);
+        vecnn_graph_add_tensor(&g, "in", 1 + rng() % 16, 8, 8, 1,
+                               VECNN_TENSOR_INPUT | ((rng() & 1) ? VECNN_TENSOR_EXTERNAL : 0));
+
+        for (uint32_t o = 0; o < n_ops; o++) {
+            int in0 = (int) (g.n_tensors - 1 - rng() % (g.n_tensors < 4 ? g.n_tensors : 4));
+            int in1 = (rng() % 3 == 0) ? (int) (rng() % g.n_tensors) : -1;
+            vecnn_op_kind_t kind;
+            uint32_t c;
+
+            switch (rng() % 4) {
+            case 0:
+                kind = VECNN_OP_RELU6;
+                c = g.tensors[in0].c;
+                in1 = -1;
+                break;
+            case 1:
+                kind = VECNN_OP_RESIDUAL_ADD;
+                c = g.tensors[in0].c;
+                if (in1 < 0 || g.tensors[in1].c != c) {
+                    in1 = in0;
+                }
+                break;
+            default:
+                kind = VECNN_OP_CONV1X1;
+                c = 1 + rng() % 32;
+                break;
+            }
+            int out = vecnn_graph_add_tensor(&g, "t", c, 8, 8, 1 + (rng() % 4 == 0) * 3, 0);
+            if (kind != VECNN_OP_CONV1X1 && g.tensors[out].elem_size != g.tensors[in0].elem_size) {
+                g.tensors[out].elem_size = g.tensors[in0].elem_size;
+                g.tensors[out].bytes = (size_t) c * 8 * 8 * g.tensors[out].elem_size;
+            }
+            vecnn_graph_add_op(&g, kind, "op", in0, in1, out);
+        }
+        g.tensors[g.n_tensors - 1].flags |= VECNN_TENSOR_OUTPUT;
+        if (rng() % 4 == 0) {
+            g.tensors[rng() % g.n_tensors].flags |= VECNN_TENSOR_OUTPUT;
+        }
+
+        snprintf(what, sizeof(what), "random %u", (unsigned) n);
+        if (vecnn_graph_plan(&g) != 0) {
+            FAIL("%s: plan failed\n", what);
+            continue;
+        }
+        check_plan(&g, what);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t graphs = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : 2000u;
+
+    test_mobilenet();
+    test_residual_keeps_skip();
+    test_random(graphs);
+
+    if (g_errors != 0u) {
+        printf("[FAIL] %u violation(s)\n", g_errors);
+        return 1;
+    }
+    printf("[PASS] arena plans valid for mobilenet, residual and %u random graphs\n", graphs);
+    return 0;
+}
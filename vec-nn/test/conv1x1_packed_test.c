@@ -0,0 +1,157 @@
+/*
+ * conv1x1_packed_test.c - Host-side check of conv_1x1_int8_packed.
+ *
+ * Runs every MobileNetV2 pointwise shape (stem, expand and project of each
+ * inverted residual block) with synthetic weights, scales and zero points
+ * through conv_1x1_int8 and through conv_1x1_int8_pack +
+ * conv_1x1_int8_packed, with and without relu and with scratch sizes that
+ * force several pixel bands, and requires the outputs to match byte for
+ * byte. Both paths are the real kernels built against rvv_host/.
+ *
+ * Usage: conv1x1_packed_test [seed]
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "layers.h"
+
+static uint32_t g_errors;
+
+#define FAIL(...)                       \
+    do {                                \
+        g_errors++;                     \
+        printf("[FAIL] " __VA_ARGS__);  \
+    } while (0)
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int32_t rng_range(int32_t lo, int32_t hi) {
+    return lo + (int32_t) (rng() % (uint32_t) (hi - lo + 1));
+}
+
+/* conv_1x1_int8 blob: int32 bias[cout] | int8 W[cout][cin]. */
+static void *make_weights(size_t cin, size_t cout) {
+    int32_t *bias = malloc(cout * sizeof(int32_t) + cout * cin);
+    int8_t *w = (int8_t *) (bias + cout);
+
+    for (size_t o = 0; o < cout; o++) {
+        bias[o] = rng_range(-4000, 4000);
+    }
+    for (size_t i = 0; i < cout * cin; i++) {
+        w[i] = (int8_t) rng_range(-64, 63);
+    }
+    return bias;
+}
+
+/* Per-channel scales that keep most outputs inside int8, some saturating. */
+static float *make_scales(size_t cin, size_t cout) {
+    float *scale = malloc(cout * sizeof(float));
+    const float base = 60.0f / (2700.0f * sqrtf((float) cin));
+
+    for (size_t o = 0; o < cout; o++) {
+        scale[o] = base * (0.25f + (float) (rng() % 1024) / 512.0f);
+    }
+    return scale;
+}
+
+static void check_shape(size_t h, size_t w, size_t cin, size_t cout, const char *what) {
+    const size_t hw = h * w;
+    int8_t *input = malloc(cin * hw);
+    int8_t *ref = malloc(cout * hw);
+    int8_t *out = malloc(cout * hw);
+    void *weights = make_weights(cin, cout);
+    float *scale = make_scales(cin, cout);
+    void *packed_buf = malloc(conv_1x1_int8_packed_size(cin, cout));
+    vecnn_packed_weights_int8_t packed;
+
+    for (size_t i = 0; i < cin * hw; i++) {
+        input[i] = (int8_t) rng_range(-128, 127);
+    }
+    conv_1x1_int8_pack(&packed, packed_buf, cin, cout, weights, scale);
+
+    /* One band of everything, a few 7-row bands, and a ragged band size. */
+    const size_t bands[] = { hw, 7 * 5, 13 };
+
+    for (int relu = 0; relu <= 1; relu++) {
+        requantization_params_t rq = { .scale = scale, .zero_point = rng_range(-20, 20) };
+
+        conv_1x1_int8(h, w, cin, cout, 1, 0, input, weights, ref, relu, rq);
+
+        for (size_t b = 0; b < sizeof(bands) / sizeof(bands[0]); b++) {
+            size_t bytes = conv_1x1_int8_packed_scratch_size(&packed, bands[b]);
+            int8_t *scratch = malloc(bytes);
+
+            for (size_t i = 0; i < cout * hw; i++) {
+                out[i] = (int8_t) (rng() & 0xff);
+            }
+            conv_1x1_int8_packed(h, w, input, &packed, out, relu, rq.zero_point, scratch, bytes);
+
+            for (size_t i = 0; i < cout * hw; i++) {
+                if (out[i] != ref[i]) {
+                    FAIL("%s %zux%zu %zu->%zu relu=%d band=%zu: ch %zu px %zu got %d want %d\n",
+                         what, h, w, cin, cout, relu, bands[b], i / hw, i % hw, out[i], ref[i]);
+                    break;
+                }
+            }
+            free(scratch);
+        }
+    }
+
+    free(input);
+    free(ref);
+    free(out);
+    free(weights);
+    free(scale);
+    free(packed_buf);
+}
+
+int main(int argc, char **argv) {
+    /* MobileNetV2 (t, c, s) after the 112x112x32 stem. */
+    static const struct { size_t t, c, s; } cfg[] = {
+        {1, 16, 1}, {6, 24, 2}, {6, 24, 1}, {6, 32, 2}, {6, 32, 1}, {6, 32, 1},
+        {6, 64, 2}, {6, 64, 1}, {6, 64, 1}, {6, 64, 1}, {6, 96, 1}, {6, 96, 1},
+        {6, 96, 1}, {6, 160, 2}, {6, 160, 1}, {6, 160, 1}, {6, 320, 1},
+    };
+    size_t h = 112, w = 112, ch = 32;
+
+    if (argc > 1) {
+        rng_state = (uint32_t) strtoul(argv[1], NULL, 0) | 1u;
+    }
+
+    check_shape(h, w, 3, 32, "stem");
+    for (size_t i = 0; i < sizeof(cfg) / sizeof(cfg[0]); i++) {
+        size_t hidden = ch * cfg[i].t;
+        size_t oh = (h - 1) / cfg[i].s + 1;
+        size_t ow = (w - 1) / cfg[i].s + 1;
+        char what[32];
+
+        if (cfg[i].t > 1) {
+            snprintf(what, sizeof(what), "block%zu.expand", i);
+            check_shape(h, w, ch, hidden, what);
+        }
+        snprintf(what, sizeof(what), "block%zu.project", i);
+        check_shape(oh, ow, hidden, cfg[i].c, what);
+
+        h = oh;
+        w = ow;
+        ch = cfg[i].c;
+    }
+    check_shape(h, w, ch, 1280, "head");
+
+    if (g_errors) {
+        printf("[FAIL] conv1x1_packed: %u mismatches (VLEN %d)\n", g_errors, RVV_HOST_VLEN);
+        return 1;
+    }
+    printf("[PASS] conv1x1_packed: all MobileNetV2 pointwise shapes bit-exact (VLEN %d)\n",
+           RVV_HOST_VLEN);
+    return 0;
+}
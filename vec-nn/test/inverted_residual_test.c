@@ -0,0 +1,243 @@
+/*
+ * inverted_residual_test.c - Host-side check of the fused inverted residual.
+ *
+ * For each of the 17 MobileNetV2 inverted residual blocks (shapes of the
+ * 224x224 network, synthetic weights, scales and zero points) runs the
+ * unfused layer sequence the MobileNet demo uses:
+ *
+ *   conv_1x1_int8 -> ReLU6 -> dwconv2D_3x3_int8 (SAME) -> ReLU6
+ *   -> conv_1x1_int8 -> ReLU6 [-> residual_add]
+ *
+ * where ReLU6 is the demo's dequantize + relu6_int8 step, and requires
+ * inverted_residual_int8 to produce the same bytes for several strip
+ * heights (1, 2, odd, what 64 KiB of scratch allows, whole image), with
+ * the unpacked and the packed pointwise weights. Everything runs the real
+ * kernels built against rvv_host/.
+ *
+ * Usage: inverted_residual_test [seed]
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "layers.h"
+
+#define DEMO_SCRATCH_BYTES (64 * 1024)
+
+static uint32_t g_errors;
+
+#define FAIL(...)                       \
+    do {                                \
+        g_errors++;                     \
+        printf("[FAIL] " __VA_ARGS__);  \
+    } while (0)
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int32_t rng_range(int32_t lo, int32_t hi) {
+    return lo + (int32_t) (rng() % (uint32_t) (hi - lo + 1));
+}
+
+/*
+ * Scales in the range where ReLU6's upper clamp (6 / scale in quantized
+ * units) lands inside int8 for some channels and outside for others.
+ */
+static requantization_params_t make_rq(size_t channels) {
+    float *scale = malloc(channels * sizeof(float));
+
+    for (size_t c = 0; c < channels; c++) {
+        scale[c] = 0.02f + 0.18f * (float) (rng() % 1024) / 1024.0f;
+    }
+    return (requantization_params_t) { .scale = scale, .zero_point = rng_range(-20, 20) };
+}
+
+/*
+ * int32 bias[n] | int8 w[n][taps], the conv_1x1_int8 / dwconv layouts.
+ * Weights shrink with the number of taps so that, with make_rq() scales,
+ * outputs cover the int8 range instead of saturating.
+ */
+static void *make_weights(size_t n, size_t taps) {
+    int32_t *bias = malloc(n * sizeof(int32_t) + n * taps);
+    int8_t *w = (int8_t *) (bias + n);
+    int32_t w_max = (int32_t) lrintf(18.0f / sqrtf((float) taps));
+    int32_t b_max;
+
+    if (w_max < 1) {
+        w_max = 1;
+    }
+    b_max = (int32_t) ((float) w_max * 40.0f * sqrtf((float) taps));
+    for (size_t i = 0; i < n; i++) {
+        bias[i] = rng_range(-b_max, b_max);
+    }
+    for (size_t i = 0; i < n * taps; i++) {
+        w[i] = (int8_t) rng_range(-w_max, w_max);
+    }
+    return bias;
+}
+
+/* The demo's relu6_apply_int8(): dequantize, relu6_int8 with the same rq. */
+static void relu6_apply(int8_t *x, size_t channels, size_t plane,
+                        const requantization_params_t *rq, float *tmp) {
+    for (size_t c = 0; c < channels; c++) {
+        for (size_t i = 0; i < plane; i++) {
+            tmp[c * plane + i] = ((float) x[c * plane + i] - (float) rq->zero_point) * rq->scale[c];
+        }
+    }
+    relu6_int8(channels, plane, tmp, x, *rq);
+}
+
+static void unfused(const inverted_residual_params_t *p, size_t H, size_t W,
+                    int8_t *input, int8_t *output) {
+    const size_t H_out = (H - 1) / p->stride + 1;
+    const size_t W_out = (W - 1) / p->stride + 1;
+    int8_t *expanded = malloc(p->hidden_ch * H * W);
+    int8_t *dw = malloc(p->hidden_ch * H_out * W_out);
+    float *tmp = malloc(p->hidden_ch * H * W * sizeof(float));
+
+    if (p->w_expand) {
+        conv_1x1_int8(H, W, p->in_ch, p->hidden_ch, 1, 0, input, p->w_expand,
+                      expanded, 0, p->rq_expand);
+        relu6_apply(expanded, p->hidden_ch, H * W, &p->rq_expand, tmp);
+    } else {
+        memcpy(expanded, input, p->hidden_ch * H * W);
+    }
+
+    dwconv2D_3x3_int8(H, W, p->hidden_ch, p->stride, 1, p->w_dw, expanded, dw, 0, p->rq_dw);
+    relu6_apply(dw, p->hidden_ch, H_out * W_out, &p->rq_dw, tmp);
+
+    conv_1x1_int8(H_out, W_out, p->hidden_ch, p->out_ch, 1, 0, dw, p->w_project,
+                  output, 0, p->rq_project);
+    relu6_apply(output, p->out_ch, H_out * W_out, &p->rq_project, tmp);
+
+    if (p->residual) {
+        residual_add(H_out, W_out, p->out_ch, input, output, output, p->rq_project);
+    }
+
+    free(expanded);
+    free(dw);
+    free(tmp);
+}
+
+static void check_block(size_t idx, size_t H, size_t W, size_t in_ch,
+                        size_t t, size_t out_ch, size_t stride) {
+    const size_t hidden = in_ch * t;
+    const size_t H_out = (H - 1) / stride + 1;
+    const size_t W_out = (W - 1) / stride + 1;
+    const size_t out_bytes = out_ch * H_out * W_out;
+    inverted_residual_params_t p = {
+        .in_ch = in_ch, .hidden_ch = hidden, .out_ch = out_ch,
+        .stride = stride,
+        .residual = stride == 1 && in_ch == out_ch,
+        .w_expand = t > 1 ? make_weights(hidden, in_ch) : NULL,
+        .w_dw = make_weights(hidden, 9),
+        .w_project = make_weights(out_ch, hidden),
+        .act_expand = VECNN_ACT_RELU6,
+        .act_dw = VECNN_ACT_RELU6,
+        .act_project = VECNN_ACT_RELU6,
+    };
+    p.rq_expand = t > 1 ? make_rq(hidden) : (requantization_params_t) { 0 };
+    p.rq_dw = make_rq(hidden);
+    p.rq_project = make_rq(out_ch);
+
+    int8_t *input = malloc(in_ch * H * W);
+    int8_t *ref = malloc(out_bytes);
+    int8_t *out = malloc(out_bytes);
+
+    for (size_t i = 0; i < in_ch * H * W; i++) {
+        input[i] = (int8_t) rng_range(-128, 127);
+    }
+    unfused(&p, H, W, input, ref);
+
+    vecnn_packed_weights_int8_t pk_expand, pk_project;
+    void *pk_expand_buf = NULL;
+    void *pk_project_buf = malloc(conv_1x1_int8_packed_size(hidden, out_ch));
+    conv_1x1_int8_pack(&pk_project, pk_project_buf, hidden, out_ch, p.w_project, p.rq_project.scale);
+    if (p.w_expand) {
+        pk_expand_buf = malloc(conv_1x1_int8_packed_size(in_ch, hidden));
+        conv_1x1_int8_pack(&pk_expand, pk_expand_buf, in_ch, hidden, p.w_expand, p.rq_expand.scale);
+    }
+
+    for (int packed = 0; packed <= 1; packed++) {
+        p.pk_expand = (packed && p.w_expand) ? &pk_expand : NULL;
+        p.pk_project = packed ? &pk_project : NULL;
+
+        const size_t strips[] = {
+            1, 2, 5,
+            inverted_residual_int8_strip_rows(&p, H, W, DEMO_SCRATCH_BYTES),
+            H_out,
+        };
+
+        for (size_t s = 0; s < sizeof(strips) / sizeof(strips[0]); s++) {
+            size_t bytes = inverted_residual_int8_scratch_size(&p, H, W, strips[s]);
+            void *scratch = malloc(bytes);
+
+            memset(scratch, 0x5a, bytes);
+            for (size_t i = 0; i < out_bytes; i++) {
+                out[i] = (int8_t) (rng() & 0xff);
+            }
+            inverted_residual_int8(&p, H, W, input, out, scratch, strips[s]);
+
+            for (size_t i = 0; i < out_bytes; i++) {
+                if (out[i] != ref[i]) {
+                    size_t plane = H_out * W_out;
+                    FAIL("block %zu (%zux%zux%zu t=%zu s=%zu -> %zu) strip=%zu packed=%d: "
+                         "ch %zu y %zu x %zu got %d want %d\n",
+                         idx, in_ch, H, W, t, stride, out_ch, strips[s], packed,
+                         i / plane, i % plane / W_out, i % W_out, out[i], ref[i]);
+                    break;
+                }
+            }
+            free(scratch);
+        }
+    }
+
+    free((void *) p.w_expand);
+    free((void *) p.w_dw);
+    free((void *) p.w_project);
+    free(p.rq_expand.scale);
+    free(p.rq_dw.scale);
+    free(p.rq_project.scale);
+    free(pk_expand_buf);
+    free(pk_project_buf);
+    free(input);
+    free(ref);
+    free(out);
+}
+
+int main(int argc, char **argv) {
+    /* MobileNetV2 (t, c, s) after the 112x112x32 stem, as in the demo. */
+    static const struct { size_t t, c, s; } cfg[] = {
+        {1, 16, 1}, {6, 24, 2}, {6, 24, 1}, {6, 32, 2}, {6, 32, 1}, {6, 32, 1},
+        {6, 64, 2}, {6, 64, 1}, {6, 64, 1}, {6, 64, 1}, {6, 96, 1}, {6, 96, 1},
+        {6, 96, 1}, {6, 160, 2}, {6, 160, 1}, {6, 160, 1}, {6, 320, 1},
+    };
+    size_t h = 112, w = 112, ch = 32;
+
+    if (argc > 1) {
+        rng_state = (uint32_t) strtoul(argv[1], NULL, 0) | 1u;
+    }
+
+    for (size_t i = 0; i < sizeof(cfg) / sizeof(cfg[0]); i++) {
+        check_block(i, h, w, ch, cfg[i].t, cfg[i].c, cfg[i].s);
+        h = (h - 1) / cfg[i].s + 1;
+        w = (w - 1) / cfg[i].s + 1;
+        ch = cfg[i].c;
+    }
+
+    if (g_errors) {
+        printf("[FAIL] inverted_residual: %u mismatches (VLEN %d)\n", g_errors, RVV_HOST_VLEN);
+        return 1;
+    }
+    printf("[PASS] inverted_residual: fused == unfused for all 17 MobileNetV2 blocks (VLEN %d)\n",
+           RVV_HOST_VLEN);
+    return 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * riscv_vector.h (host)
+ *
+ * Scalar stand-in for the subset of the RVV 1.0 intrinsics used by the
+ * vec-nn int8 layers, so the real kernels can be built and compared on the
+ * development machine. Only the host tests put this directory on the
+ * include path; firmware builds use the compiler's header.
+ *
+ * Semantics follow the spec for the operations that matter to the results:
+ * vfncvt.x.f.w rounds to nearest-even and saturates, vncvt.x.x.w truncates,
+ * vfcvt.f.x.v rounds to nearest-even, vfmacc is fused. Tail elements are
+ * left as they were (tail-undisturbed), which is one legal choice for the
+ * tail-agnostic policy the kernels ask for.
+ *
+ * VLEN is fixed at compile time by RVV_HOST_VLEN (bits, default 256).
+ */
+#ifndef VECNN_TEST_RVV_HOST_RISCV_VECTOR_H
+#define VECNN_TEST_RVV_HOST_RISCV_VECTOR_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef RVV_HOST_VLEN
+#define RVV_HOST_VLEN 256
+#endif
+
+#if RVV_HOST_VLEN < 64 || (RVV_HOST_VLEN & (RVV_HOST_VLEN - 1)) != 0
+#error "RVV_HOST_VLEN must be a power of two >= 64"
+#endif
+
+// Elements per register group: VLEN * LMUL / SEW.
+#define RVV_HOST_VLMAX(sew, lmul) ((RVV_HOST_VLEN * (lmul)) / (sew))
+
+typedef struct { int8_t  v[RVV_HOST_VLMAX(8, 1)];  } vint8m1_t;
+typedef struct { int8_t  v[RVV_HOST_VLMAX(8, 8)];  } vint8m8_t;
+typedef struct { int16_t v[RVV_HOST_VLMAX(16, 2)]; } vint16m2_t;
+typedef struct { int32_t v[RVV_HOST_VLMAX(32, 4)]; } vint32m4_t;
+typedef struct { float   v[RVV_HOST_VLMAX(32, 4)]; } vfloat32m4_t;
+
+// ----------------------
+// vsetvl
+// ----------------------
+
+static inline size_t rvv_host_vl(size_t avl, size_t vlmax) {
+    return avl < vlmax ? avl : vlmax;
+}
+
+static inline size_t __riscv_vsetvl_e8m1(size_t avl)  { return rvv_host_vl(avl, RVV_HOST_VLMAX(8, 1)); }
+static inline size_t __riscv_vsetvl_e8m8(size_t avl)  { return rvv_host_vl(avl, RVV_HOST_VLMAX(8, 8)); }
+static inline size_t __riscv_vsetvl_e32m4(size_t avl) { return rvv_host_vl(avl, RVV_HOST_VLMAX(32, 4)); }
+static inline size_t __riscv_vsetvlmax_e32m4(void)    { return RVV_HOST_VLMAX(32, 4); }
+
+// ----------------------
+// Loads and stores
+// ----------------------
+
+static inline vint8m1_t __riscv_vle8_v_i8m1(const int8_t* p, size_t vl) {
+    vint8m1_t r = {{0}};
+    memcpy(r.v, p, vl);
+    return r;
+}
+
+static inline vint8m8_t __riscv_vle8_v_i8m8(const int8_t* p, size_t vl) {
+    vint8m8_t r = {{0}};
+    memcpy(r.v, p, vl);
+    return r;
+}
+
+static inline vint8m1_t __riscv_vlse8_v_i8m1(const int8_t* p, ptrdiff_t stride, size_t vl) {
+    vint8m1_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = p[(ptrdiff_t) i * stride];
+    }
+    return r;
+}
+
+static inline vint32m4_t __riscv_vle32_v_i32m4(const int32_t* p, size_t vl) {
+    vint32m4_t r = {{0}};
+    memcpy(r.v, p, vl * sizeof(int32_t));
+    return r;
+}
+
+static inline vfloat32m4_t __riscv_vle32_v_f32m4(const float* p, size_t vl) {
+    vfloat32m4_t r = {{0}};
+    memcpy(r.v, p, vl * sizeof(float));
+    return r;
+}
+
+static inline void __riscv_vse8_v_i8m1(int8_t* p, vint8m1_t x, size_t vl) {
+    memcpy(p, x.v, vl);
+}
+
+static inline void __riscv_vse8_v_i8m8(int8_t* p, vint8m8_t x, size_t vl) {
+    memcpy(p, x.v, vl);
+}
+
+static inline void __riscv_vsse8_v_i8m8(int8_t* p, ptrdiff_t stride, vint8m8_t x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        p[(ptrdiff_t) i * stride] = x.v[i];
+    }
+}
+
+static inline void __riscv_vse32_v_i32m4(int32_t* p, vint32m4_t x, size_t vl) {
+    memcpy(p, x.v, vl * sizeof(int32_t));
+}
+
+static inline void __riscv_vse32_v_f32m4(float* p, vfloat32m4_t x, size_t vl) {
+    memcpy(p, x.v, vl * sizeof(float));
+}
+
+// ----------------------
+// Moves and slides
+// ----------------------
+
+static inline vint8m8_t __riscv_vmv_v_x_i8m8(int8_t x, size_t vl) {
+    vint8m8_t r = {{0}};
+    memset(r.v, x, vl);
+    return r;
+}
+
+static inline vint32m4_t __riscv_vmv_v_x_i32m4(int32_t x, size_t vl) {
+    vint32m4_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = x;
+    }
+    return r;
+}
+
+static inline vint32m4_t __riscv_vmv_v_v_i32m4(vint32m4_t x, size_t vl) {
+    (void) vl;
+    return x;
+}
+
+static inline vfloat32m4_t __riscv_vmv_v_v_f32m4(vfloat32m4_t x, size_t vl) {
+    (void) vl;
+    return x;
+}
+
+static inline vfloat32m4_t __riscv_vfmv_s_f_f32m4(float x, size_t vl) {
+    vfloat32m4_t r = {{0}};
+    if (vl > 0) {
+        r.v[0] = x;
+    }
+    return r;
+}
+
+static inline vint8m8_t __riscv_vslideup_vx_i8m8(vint8m8_t dest, vint8m8_t src, size_t off, size_t vl) {
+    for (size_t i = off; i < vl; i++) {
+        dest.v[i] = src.v[i - off];
+    }
+    return dest;
+}
+
+// ----------------------
+// Integer arithmetic
+// ----------------------
+
+static inline vint16m2_t __riscv_vwcvt_x_x_v_i16m2(vint8m1_t x, size_t vl) {
+    vint16m2_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = x.v[i];
+    }
+    return r;
+}
+
+static inline vint32m4_t __riscv_vwcvt_x_x_v_i32m4(vint16m2_t x, size_t vl) {
+    vint32m4_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = x.v[i];
+    }
+    return r;
+}
+
+static inline vint16m2_t __riscv_vwadd_vv_i16m2(vint8m1_t a, vint8m1_t b, size_t vl) {
+    vint16m2_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = (int16_t) (a.v[i] + b.v[i]);
+    }
+    return r;
+}
+
+static inline vint32m4_t __riscv_vwmacc_vx_i32m4(vint32m4_t acc, int16_t x, vint16m2_t b, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        acc.v[i] = (int32_t) ((uint32_t) acc.v[i] + (uint32_t) ((int32_t) x * b.v[i]));
+    }
+    return acc;
+}
+
+static inline vint16m2_t __riscv_vadd_vx_i16m2(vint16m2_t a, int16_t x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = (int16_t) (a.v[i] + x);
+    }
+    return a;
+}
+
+static inline vint16m2_t __riscv_vmax_vx_i16m2(vint16m2_t a, int16_t x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = a.v[i] > x ? a.v[i] : x;
+    }
+    return a;
+}
+
+static inline vint16m2_t __riscv_vmin_vx_i16m2(vint16m2_t a, int16_t x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = a.v[i] < x ? a.v[i] : x;
+    }
+    return a;
+}
+
+static inline vint8m8_t __riscv_vmin_vx_i8m8(vint8m8_t a, int8_t x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = a.v[i] < x ? a.v[i] : x;
+    }
+    return a;
+}
+
+static inline vint8m1_t __riscv_vncvt_x_x_w_i8m1(vint16m2_t x, size_t vl) {
+    vint8m1_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = (int8_t) (uint8_t) x.v[i];
+    }
+    return r;
+}
+
+// ----------------------
+// Floating point
+// ----------------------
+
+static inline vfloat32m4_t __riscv_vfcvt_f_x_v_f32m4(vint32m4_t x, size_t vl) {
+    vfloat32m4_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        r.v[i] = (float) x.v[i];
+    }
+    return r;
+}
+
+// float -> int16, round to nearest-even, saturating.
+static inline vint16m2_t __riscv_vfncvt_x_f_w_i16m2(vfloat32m4_t x, size_t vl) {
+    vint16m2_t r = {{0}};
+    for (size_t i = 0; i < vl; i++) {
+        float f = x.v[i];
+        if (isnan(f) || f >= 32767.0f) {
+            r.v[i] = INT16_MAX;
+        } else if (f <= -32768.0f) {
+            r.v[i] = INT16_MIN;
+        } else {
+            r.v[i] = (int16_t) lrintf(f);
+        }
+    }
+    return r;
+}
+
+static inline vfloat32m4_t __riscv_vfmul_vv_f32m4(vfloat32m4_t a, vfloat32m4_t b, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = a.v[i] * b.v[i];
+    }
+    return a;
+}
+
+static inline vfloat32m4_t __riscv_vfmul_vf_f32m4(vfloat32m4_t a, float x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = a.v[i] * x;
+    }
+    return a;
+}
+
+static inline vfloat32m4_t __riscv_vfmacc_vf_f32m4(vfloat32m4_t acc, float x, vfloat32m4_t b, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        acc.v[i] = fmaf(x, b.v[i], acc.v[i]);
+    }
+    return acc;
+}
+
+static inline vfloat32m4_t __riscv_vfmax_vf_f32m4(vfloat32m4_t a, float x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = fmaxf(a.v[i], x);
+    }
+    return a;
+}
+
+static inline vfloat32m4_t __riscv_vfmin_vf_f32m4(vfloat32m4_t a, float x, size_t vl) {
+    for (size_t i = 0; i < vl; i++) {
+        a.v[i] = fminf(a.v[i], x);
+    }
+    return a;
+}
+
+#endif